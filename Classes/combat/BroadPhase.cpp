@@ -0,0 +1,207 @@
+#include "BroadPhase.h"
+#include "HealthComponent.h"
+#include "CombatComponent.h"
+#include <algorithm>
+#include <cmath>
+
+USING_NS_CC;
+
+// 重建在贴地批处理（优先级 1）之后执行，此时本帧所有角色位置已确定
+static const int kBroadPhasePriority = 2;
+// 登记包围盒的外扩余量，覆盖重建之后到下次重建之前的移动
+static const float kProxyMargin = 20.0f;
+// 单个条目每个轴最多覆盖的网格数，超过的条目不插入网格，放入超大条目列表每次查询都检测
+static const int kMaxCellsPerAxis = 16;
+
+BroadPhase* BroadPhase::create(float cellSize) {
+    auto pRet = new (std::nothrow) BroadPhase();
+    if (pRet && pRet->init(cellSize)) {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return nullptr;
+}
+
+BroadPhase::BroadPhase() {
+}
+
+BroadPhase::~BroadPhase() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& e : _entries) {
+        e.proxy.owner->release();
+    }
+}
+
+bool BroadPhase::init(float cellSize) {
+    if (cellSize <= 0.0f) return false;
+    _cellSize = cellSize;
+    _invCellSize = 1.0f / cellSize;
+
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, kBroadPhasePriority, false);
+    return true;
+}
+
+void BroadPhase::add(Node* owner, const CharacterCollider* collider, unsigned int layer) {
+    if (!owner || !collider) return;
+
+    // 已登记（或待移除）的节点直接复用条目
+    for (auto& e : _entries) {
+        if (e.proxy.owner == owner) {
+            e.proxy.collider = collider;
+            e.proxy.layer = layer;
+            e.removed = false;
+            _dirty = true;
+            return;
+        }
+    }
+
+    Entry e;
+    e.proxy.owner = owner;
+    e.proxy.collider = collider;
+    e.proxy.health = dynamic_cast<HealthComponent*>(owner->getComponent("HealthComponent"));
+    e.proxy.combat = dynamic_cast<CombatComponent*>(owner->getComponent("CombatComponent"));
+    e.proxy.layer = layer;
+    e.removed = false;
+    e.queryStamp = 0;
+    owner->retain();
+    _entries.push_back(e);
+    _dirty = true;
+}
+
+void BroadPhase::remove(Node* owner) {
+    for (auto& e : _entries) {
+        if (e.proxy.owner == owner) {
+            e.removed = true;
+            _dirty = true;
+            return;
+        }
+    }
+}
+
+void BroadPhase::update(float dt) {
+    _dirty = true;
+    rebuild();
+}
+
+int BroadPhase::cellCoord(float v) const {
+    return (int)std::floor(v * _invCellSize);
+}
+
+unsigned int BroadPhase::bucketOf(int cx, int cz) const {
+    // 两个大质数混合网格坐标
+    unsigned int h = (unsigned int)cx * 73856093u ^ (unsigned int)cz * 19349663u;
+    return h & (unsigned int)(_buckets.size() - 1);
+}
+
+/**
+ * 重建空间哈希
+ * 先压缩掉已注销的条目，再把每个条目的外扩包围盒插入其覆盖的所有网格；
+ * 桶与链表节点容器只在容量不足时增长，稳定后每帧不再分配
+ */
+void BroadPhase::rebuild() {
+    if (!_dirty) return;
+    _dirty = false;
+
+    auto removedBegin = std::stable_partition(_entries.begin(), _entries.end(),
+                                              [](const Entry& e) { return !e.removed; });
+    for (auto it = removedBegin; it != _entries.end(); ++it) {
+        it->proxy.owner->release();
+    }
+    _entries.erase(removedBegin, _entries.end());
+
+    // 桶数量取不小于条目数 4 倍的 2 的幂
+    size_t bucketCount = 64;
+    while (bucketCount < _entries.size() * 4) bucketCount <<= 1;
+    _buckets.assign(bucketCount, -1);
+    _cellNodes.clear();
+    _oversized.clear();
+
+    for (int i = 0; i < (int)_entries.size(); ++i) {
+        const AABB& box = _entries[i].proxy.collider->worldAABB;
+        int x0 = cellCoord(box._min.x - kProxyMargin);
+        int z0 = cellCoord(box._min.z - kProxyMargin);
+        int x1 = cellCoord(box._max.x + kProxyMargin);
+        int z1 = cellCoord(box._max.z + kProxyMargin);
+        // 超大包围盒（Boss、小网格上的长攻击盒）插入网格代价过高，单独列出
+        if (x1 - x0 >= kMaxCellsPerAxis || z1 - z0 >= kMaxCellsPerAxis) {
+            _oversized.push_back(i);
+            continue;
+        }
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                unsigned int b = bucketOf(cx, cz);
+                _cellNodes.push_back({ i, _buckets[b] });
+                _buckets[b] = (int)_cellNodes.size() - 1;
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void BroadPhase::forEachCandidate(float minX, float minZ, float maxX, float maxZ,
+                                  unsigned int layerMask, Node* ignore, Visitor visit) {
+    rebuild();
+    if (_entries.empty()) return;
+
+    // 查询范围覆盖的网格过多时直接线性遍历（超大范围查询）
+    int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    int z0 = cellCoord(minZ), z1 = cellCoord(maxZ);
+    const long long cells = (long long)(x1 - x0 + 1) * (z1 - z0 + 1);
+
+    auto accept = [&](Entry& e) {
+        if (e.removed || e.proxy.owner == ignore || !(e.proxy.layer & layerMask)) return;
+        if (e.proxy.health && e.proxy.health->isDead()) return;
+        visit(e.proxy);
+    };
+
+    if (cells > (long long)_buckets.size()) {
+        for (auto& e : _entries) accept(e);
+        return;
+    }
+
+    // 同一条目可能出现在多个网格 / 哈希冲突的桶中，用查询戳去重
+    const unsigned int stamp = ++_queryStamp;
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            for (int n = _buckets[bucketOf(cx, cz)]; n >= 0; n = _cellNodes[n].next) {
+                Entry& e = _entries[_cellNodes[n].entry];
+                if (e.queryStamp == stamp) continue;
+                e.queryStamp = stamp;
+                accept(e);
+            }
+        }
+    }
+
+    // 超大条目不在网格中，每次查询都参与
+    for (int idx : _oversized) {
+        accept(_entries[idx]);
+    }
+}
+
+int BroadPhase::queryAABB(const AABB& box, unsigned int layerMask,
+                          std::vector<BroadPhaseProxy>& out, Node* ignore) {
+    out.clear();
+    forEachCandidate(box._min.x, box._min.z, box._max.x, box._max.z, layerMask, ignore,
+        [&](const BroadPhaseProxy& p) {
+            if (box.intersects(p.collider->worldAABB)) out.push_back(p);
+        });
+    return (int)out.size();
+}
+
+int BroadPhase::queryRadius(const Vec3& center, float radius, unsigned int layerMask,
+                            std::vector<BroadPhaseProxy>& out, Node* ignore) {
+    out.clear();
+    const float r2 = radius * radius;
+    forEachCandidate(center.x - radius, center.z - radius, center.x + radius, center.z + radius,
+                     layerMask, ignore,
+        [&](const BroadPhaseProxy& p) {
+            // 球心到包围盒的最近点距离
+            const AABB& b = p.collider->worldAABB;
+            float dx = std::max(b._min.x - center.x, std::max(0.0f, center.x - b._max.x));
+            float dy = std::max(b._min.y - center.y, std::max(0.0f, center.y - b._max.y));
+            float dz = std::max(b._min.z - center.z, std::max(0.0f, center.z - b._max.z));
+            if (dx * dx + dy * dy + dz * dz <= r2) out.push_back(p);
+        });
+    return (int)out.size();
+}
@@ -0,0 +1,127 @@
+#ifndef __BROAD_PHASE_H__
+#define __BROAD_PHASE_H__
+
+#include "cocos2d.h"
+#include "CharacterCollider.h"
+#include <vector>
+
+class HealthComponent;
+class CombatComponent;
+
+/**
+ * @struct BroadPhaseProxy
+ * @brief 宽相位中登记的角色条目（查询结果为拷贝，回调中增删条目不会使其失效）
+ */
+struct BroadPhaseProxy {
+    cocos2d::Node* owner = nullptr;               ///< 角色节点（登记期间被 retain）
+    const CharacterCollider* collider = nullptr;  ///< 角色碰撞器，窄相位使用其当前 worldAABB
+    HealthComponent* health = nullptr;            ///< 登记时缓存，查询时不再 getComponent / dynamic_cast
+    CombatComponent* combat = nullptr;
+    unsigned int layer = 0;                       ///< 所属层（BroadPhase::Layer）
+};
+
+/**
+ * @class BroadPhase
+ * @brief 角色之间的宽相位检测：XZ 平面均匀网格空间哈希
+ *
+ * 每帧在所有角色位置确定后重建一次（贴地批处理之后），
+ * 查询只访问覆盖区域内的网格，再用碰撞器当前的 worldAABB 做精确检测。
+ * 登记时的包围盒外扩一定余量，覆盖重建之后本帧内的移动。
+ * 覆盖网格过多的超大条目不插入网格，每次查询都直接检测。
+ */
+class BroadPhase : public cocos2d::Ref {
+public:
+    enum Layer : unsigned int {
+        LAYER_PLAYER = 1 << 0,
+        LAYER_ENEMY  = 1 << 1,
+        LAYER_ALL    = 0xFFFFFFFF
+    };
+
+    /**
+     * @brief 创建宽相位
+     * @param cellSize 网格边长（建议为角色包围盒宽度的 2~4 倍）
+     */
+    static BroadPhase* create(float cellSize = 200.0f);
+
+    BroadPhase();
+    virtual ~BroadPhase();
+
+    bool init(float cellSize);
+
+    /**
+     * @brief 登记角色
+     * @param owner 角色节点（需带 HealthComponent / CombatComponent 时会自动缓存）
+     * @param collider 角色碰撞器（生命周期与 owner 相同）
+     * @param layer 所属层
+     */
+    void add(cocos2d::Node* owner, const CharacterCollider* collider, unsigned int layer);
+
+    /**
+     * @brief 注销角色（下次重建时真正移除并 release）
+     */
+    void remove(cocos2d::Node* owner);
+
+    /**
+     * @brief 包围盒重叠查询
+     * @param box 世界空间查询包围盒
+     * @param layerMask 只返回这些层的条目
+     * @param out 输出：与 box 重叠的条目（先清空）
+     * @param ignore 排除的节点（通常为查询者自身）
+     * @return int 结果数量
+     */
+    int queryAABB(const cocos2d::AABB& box, unsigned int layerMask,
+                  std::vector<BroadPhaseProxy>& out, cocos2d::Node* ignore = nullptr);
+
+    /**
+     * @brief 半径查询（球体与条目 worldAABB 相交）
+     * @param center 世界空间球心
+     * @param radius 半径
+     * @param layerMask 只返回这些层的条目
+     * @param out 输出：结果条目（先清空）
+     * @param ignore 排除的节点
+     * @return int 结果数量
+     */
+    int queryRadius(const cocos2d::Vec3& center, float radius, unsigned int layerMask,
+                    std::vector<BroadPhaseProxy>& out, cocos2d::Node* ignore = nullptr);
+
+    /**
+     * @brief 每帧重建空间哈希
+     */
+    void update(float dt);
+
+private:
+    struct Entry {
+        BroadPhaseProxy proxy;
+        bool removed;
+        unsigned int queryStamp;  // 去重：同一次查询中已访问过
+    };
+
+    struct CellNode {
+        int entry;
+        int next;
+    };
+
+    float _cellSize = 200.0f;
+    float _invCellSize = 1.0f / 200.0f;
+    bool _dirty = true;
+    unsigned int _queryStamp = 0;
+
+    std::vector<Entry> _entries;
+    std::vector<int> _buckets;         // 哈希桶链表头，大小为 2 的幂
+    std::vector<CellNode> _cellNodes;  // 所有桶共用的链表节点
+    std::vector<int> _oversized;       // 覆盖网格过多、不插入网格的条目下标
+
+    void rebuild();
+
+    /**
+     * @brief 遍历与 [minX, maxX] x [minZ, maxZ] 相交网格中的条目（已去重、已过滤层与 ignore）
+     */
+    template <typename Visitor>
+    void forEachCandidate(float minX, float minZ, float maxX, float maxZ,
+                          unsigned int layerMask, cocos2d::Node* ignore, Visitor visit);
+
+    int cellCoord(float v) const;
+    unsigned int bucketOf(int cx, int cz) const;
+};
+
+#endif // __BROAD_PHASE_H__
@@ -1,12 +1,24 @@
 #include "Collider.h"
 #include "3d/CCSprite3D.h"
 #include "3d/CCMesh.h"
-#include <fstream>
-#include <sstream>
+#include <stdlib.h>
+#include <string.h>
 #include <algorithm>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
 
 USING_NS_CC;
 
+// 贴地批处理在所有角色 update（优先级 0）之后执行
+static const int kGroundSnapPriority = 1;
+// 贴地射线起点高于检测点的高度
+static const float kGroundSnapRayHeight = 500.0f;
+// 高度场采样数上限（约 4MB 高度数据）
+static const int kHeightFieldMaxSamples = 1024 * 1024;
+
 /**
  * 创建地形碰撞器实例
  * @param terrainModel 关联的 3D 地形模型
@@ -23,101 +35,294 @@ TerrainCollider* TerrainCollider::create(Sprite3D* terrainModel, const std::stri
     return nullptr;
 }
 
+TerrainCollider::TerrainCollider() {
+}
+
+TerrainCollider::~TerrainCollider() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& req : _snapRequests) {
+        req.owner->release();
+    }
+    CC_SAFE_RELEASE(_terrain);
+}
+
 /**
  * 初始化碰撞器
- * 逻辑：优先尝试从 .obj 文件加载精确三角形，如果失败则回退到基于 AABB 的简单碰撞
+ * 逻辑：优先映射烘焙好的二进制碰撞网格（随资源发布的 .wkcol，其次是可写目录中的缓存），
+ * 都不可用时首次运行烘焙到缓存再映射；缓存不可写时在内存中构建；仍失败则回退到基于 AABB 的简单碰撞
  */
 bool TerrainCollider::init(Sprite3D* terrainModel, const std::string& objFilePath) {
     if (!terrainModel) return false;
     _terrain = terrainModel;
     _terrain->retain(); // 增加引用计数，防止模型被提前释放
-    
+
     bool loaded = false;
     if (!objFilePath.empty()) {
-        // 尝试从磁盘加载 .obj 文件
-        loaded = loadFromObj(objFilePath);
+        auto fileUtils = FileUtils::getInstance();
+        // 获取当前模型的缩放和位置，烘焙数据与之匹配才可复用
+        float scale = _terrain->getScale();
+        Vec3 pos = _terrain->getPosition3D();
+        // 只查询源文件的大小与修改时间判断烘焙数据是否过期，不读取 .obj 内容
+        auto source = CookedCollisionMesh::stampSourceFile(fileUtils->fullPathForFilename(objFilePath));
+
+        std::string cookedPath = CookedCollisionMesh::cookedPathFor(objFilePath);
+        std::string cachePath = CookedCollisionMesh::cachePathFor(objFilePath);
+        if (fileUtils->isFileExist(cookedPath)) {
+            loaded = loadCooked(fileUtils->fullPathForFilename(cookedPath), source, false, scale, pos);
+        }
+        if (!loaded) {
+            loaded = loadCooked(cachePath, source, true, scale, pos);
+        }
+
+        // 没有可用的烘焙数据：首次运行烘焙到缓存，之后的启动直接映射
+        if (!loaded && cook(objFilePath, scale, pos, cachePath)) {
+            loaded = loadCooked(cachePath, source, true, scale, pos);
+        }
+
+        // 缓存不可写：在内存中构建
+        if (!loaded && loadFromObj(objFilePath, scale, pos)) {
+            buildBVH();
+            buildSoA();
+            buildHeightField();
+            loaded = true;
+        }
     }
 
     // 如果没有路径或加载失败，生成一个基于 AABB 范围的平面作为碰撞体（保底逻辑）
-    if (!loaded || _triangles.empty()) {
+    if (!loaded) {
         extractTriangles(_terrain);
+        buildBVH();
+        buildSoA();
+        buildHeightField();
     }
-    
-    // 构建空间网格索引
-    buildGrid();
+
+    // 每帧统一处理贴地请求
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, kGroundSnapPriority, false);
 
     return true;
 }
 
+bool TerrainCollider::cook(const std::string& objFilePath, float scale, const Vec3& position,
+                           const std::string& outPath) {
+    auto collider = new (std::nothrow) TerrainCollider();
+    bool ok = collider && collider->loadFromObj(objFilePath, scale, position);
+    if (ok) {
+        collider->buildBVH();
+        collider->buildSoA();
+        collider->buildHeightField();
+        auto source = CookedCollisionMesh::stampSourceFile(FileUtils::getInstance()->fullPathForFilename(objFilePath));
+        ok = collider->saveCooked(outPath, source);
+    }
+    CC_SAFE_RELEASE(collider);
+    return ok;
+}
+
+/**
+ * 映射烘焙文件，校验通过后所有网格数据直接指向映射内存，不做拷贝
+ */
+bool TerrainCollider::loadCooked(const std::string& fullPath, const CookedCollisionMesh::SourceStamp& source, bool checkMTime,
+                                 float scale, const Vec3& position) {
+    if (fullPath.empty() || !FileUtils::getInstance()->isFileExist(fullPath)) return false;
+    if (!_cookedFile.open(fullPath)) return false;
+
+    const unsigned char* data = _cookedFile.data();
+    if (!CookedCollisionMesh::validateHeader(data, _cookedFile.size(), sizeof(BVHNode))) {
+        CCLOG("TerrainCollider: invalid cooked mesh %s", fullPath.c_str());
+        _cookedFile.close();
+        return false;
+    }
+
+    // 源 .obj 或地形变换变化后，烘焙数据视为过期
+    const auto* header = reinterpret_cast<const CookedCollisionMesh::CookedMeshHeader*>(data);
+    bool stale = (source.size != 0 && header->sourceSize != 0 && header->sourceSize != source.size) ||
+                 (checkMTime && source.mtime != 0 && header->sourceMTime != 0 && header->sourceMTime != source.mtime) ||
+                 header->scale != scale || header->posX != position.x ||
+                 header->posY != position.y || header->posZ != position.z;
+
+    // 节点或三角形索引越界的文件直接拒绝，避免遍历时访问非法内存
+    const auto* nodes = reinterpret_cast<const BVHNode*>(data + header->nodesOffset);
+    const auto* indices = reinterpret_cast<const uint32_t*>(data + header->indicesOffset);
+    const int triCount = (int)header->triangleCount;
+    const int nodeCount = (int)header->nodeCount;
+    for (int i = 0; i < nodeCount && !stale; ++i) {
+        const BVHNode& n = nodes[i];
+        bool ok = n.count > 0 ? (n.leftFirst >= 0 && n.count <= triCount - n.leftFirst)
+                              : (n.count == 0 && n.leftFirst > i && n.leftFirst + 1 < nodeCount);
+        if (!ok) stale = true;
+    }
+    for (uint32_t i = 0; i < header->triangleCount * 3 && !stale; ++i) {
+        if (indices[i] >= header->vertexCount) stale = true;
+    }
+    if (stale) {
+        CCLOG("TerrainCollider: cooked mesh %s is out of date", fullPath.c_str());
+        _cookedFile.close();
+        return false;
+    }
+
+    _meshScale = scale;
+    _meshPosition = position;
+    _vertexCount = (int)header->vertexCount;
+    _triangleCount = triCount;
+    _vertices = reinterpret_cast<const float*>(data + header->verticesOffset);
+    _indices = indices;
+    _bvhNodes = nodes;
+    _bvhNodeCount = nodeCount;
+    computeBVHDepth();
+    bindSoA(reinterpret_cast<const float*>(data + header->soaOffset), (int)header->soaStride);
+
+    _heightField = HeightField();
+    if (header->hfCols > 1) {
+        _heightField.cols = (int)header->hfCols;
+        _heightField.rows = (int)header->hfRows;
+        _heightField.originX = header->hfOriginX;
+        _heightField.originZ = header->hfOriginZ;
+        _heightField.cellSize = header->hfCellSize;
+        _heightField.heights = reinterpret_cast<const float*>(data + header->heightsOffset);
+        _heightField.cellFlags = data + header->cellFlagsOffset;
+    }
+
+    CCLOG("TerrainCollider: mapped cooked mesh %s. %d triangles, %d nodes.",
+          fullPath.c_str(), _triangleCount, _bvhNodeCount);
+    return true;
+}
+
+bool TerrainCollider::saveCooked(const std::string& fullPath, const CookedCollisionMesh::SourceStamp& source) const {
+    using namespace CookedCollisionMesh;
+    if (fullPath.empty() || _triangleCount == 0 || _bvhNodeCount == 0) return false;
+
+    CookedMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(CookedMeshHeader);
+    header.sourceSize = source.size;
+    header.sourceMTime = source.mtime;
+    header.scale = _meshScale;
+    header.posX = _meshPosition.x;
+    header.posY = _meshPosition.y;
+    header.posZ = _meshPosition.z;
+    header.vertexCount = (uint32_t)_vertexCount;
+    header.triangleCount = (uint32_t)_triangleCount;
+    header.nodeCount = (uint32_t)_bvhNodeCount;
+    header.soaStride = (uint32_t)_soaStride;
+    header.hfCols = (uint32_t)_heightField.cols;
+    header.hfRows = (uint32_t)_heightField.rows;
+    header.hfOriginX = _heightField.originX;
+    header.hfOriginZ = _heightField.originZ;
+    header.hfCellSize = _heightField.cellSize;
+
+    const uint32_t vertexBytes = header.vertexCount * 3 * sizeof(float);
+    const uint32_t indexBytes = header.triangleCount * 3 * sizeof(uint32_t);
+    const uint32_t nodeBytes = header.nodeCount * sizeof(BVHNode);
+    const uint32_t soaBytes = header.soaStride * 9 * sizeof(float);
+    header.verticesOffset = alignSection(sizeof(CookedMeshHeader));
+    header.indicesOffset = alignSection(header.verticesOffset + vertexBytes);
+    header.nodesOffset = alignSection(header.indicesOffset + indexBytes);
+    header.soaOffset = alignSection(header.nodesOffset + nodeBytes);
+    header.fileSize = header.soaOffset + soaBytes;
+
+    uint32_t heightBytes = 0;
+    uint32_t flagBytes = 0;
+    if (_heightField.cols > 1) {
+        heightBytes = header.hfCols * header.hfRows * sizeof(float);
+        flagBytes = (header.hfCols - 1) * (header.hfRows - 1);
+        header.heightsOffset = alignSection(header.fileSize);
+        header.cellFlagsOffset = alignSection(header.heightsOffset + heightBytes);
+        header.fileSize = header.cellFlagsOffset + flagBytes;
+    }
+
+    std::vector<unsigned char> buffer(header.fileSize, 0);
+    memcpy(&buffer[0], &header, sizeof(header));
+    memcpy(&buffer[header.verticesOffset], _vertices, vertexBytes);
+    memcpy(&buffer[header.indicesOffset], _indices, indexBytes);
+    memcpy(&buffer[header.nodesOffset], _bvhNodes, nodeBytes);
+    memcpy(&buffer[header.soaOffset], _soa.v0x, soaBytes);
+    if (heightBytes > 0) {
+        memcpy(&buffer[header.heightsOffset], _heightField.heights, heightBytes);
+        memcpy(&buffer[header.cellFlagsOffset], _heightField.cellFlags, flagBytes);
+    }
+
+    Data data;
+    data.copy(buffer.data(), (ssize_t)buffer.size());
+    if (!FileUtils::getInstance()->writeDataToFile(data, fullPath)) {
+        CCLOG("TerrainCollider: failed to write cooked mesh %s", fullPath.c_str());
+        return false;
+    }
+    return true;
+}
+
 /**
  * 解析 .obj 文件以提取三角形面片
- * .obj 文件包含顶点 (v) 和面 (f) 信息
+ * .obj 文件包含顶点 (v) 和面 (f) 信息，直接在文件内容上逐行扫描，避免逐行构造字符串流
  */
-bool TerrainCollider::loadFromObj(const std::string& objFilePath) {
+bool TerrainCollider::loadFromObj(const std::string& objFilePath, float scale, const Vec3& position) {
     // 获取文件的完整路径（适配 Cocos2d-x 的资源管理）
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(objFilePath);
     std::string content = FileUtils::getInstance()->getStringFromFile(fullPath);
     if (content.empty()) return false;
 
-    std::vector<Vec3> vertices; // 临时存储原始顶点
-    std::stringstream ss(content);
-    std::string line;
-    
-    // 获取当前模型的缩放和位置，以便将局部坐标转换为世界坐标
-    float scale = _terrain->getScale();
-    Vec3 pos = _terrain->getPosition3D();
+    _meshScale = scale;
+    _meshPosition = position;
+    _ownedVertices.clear();
+    _ownedIndices.clear();
 
-    while (std::getline(ss, line)) {
-        if (line.size() < 2) continue;
+    const char* p = content.c_str();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
 
         // 解析顶点坐标：v x y z
-        if (line[0] == 'v' && line[1] == ' ') {
-            std::stringstream vss(line.substr(2));
-            float x, y, z;
-            if (vss >> x >> y >> z) {
+        if (lineEnd - p >= 2 && p[0] == 'v' && p[1] == ' ') {
+            char* q = const_cast<char*>(p + 2);
+            float xyz[3];
+            bool ok = true;
+            for (int k = 0; k < 3 && ok; ++k) {
+                const char* start = q;
+                xyz[k] = strtof(start, &q);
+                ok = q != start && q <= lineEnd;
+            }
+            if (ok) {
                 // 转换到世界空间坐标系
-                vertices.push_back(Vec3(x * scale + pos.x, y * scale + pos.y, z * scale + pos.z));
+                _ownedVertices.push_back(xyz[0] * scale + position.x);
+                _ownedVertices.push_back(xyz[1] * scale + position.y);
+                _ownedVertices.push_back(xyz[2] * scale + position.z);
             }
-        } 
+        }
         // 解析面索引：f v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3
-        else if (line[0] == 'f' && line[1] == ' ') {
-            std::stringstream fss(line.substr(2));
-            std::string v1_s, v2_s, v3_s;
-            if (fss >> v1_s >> v2_s >> v3_s) {
-                try {
-                    // 处理可能带斜杠的索引（如 1/1/1 或 1//1）
-                    auto parseIdx = [](const std::string& s) {
-                        size_t p = s.find('/');
-                        return (p == std::string::npos) ? std::stoi(s) : std::stoi(s.substr(0, p));
-                    };
-
-                    // .obj 索引从 1 开始，需减 1 匹配 vector 索引
-                    int i1 = parseIdx(v1_s) - 1;
-                    int i2 = parseIdx(v2_s) - 1;
-                    int i3 = parseIdx(v3_s) - 1;
-
-                    // 索引合法性检查，防止数组越界导致崩溃
-                    if (i1 >= 0 && i1 < (int)vertices.size() &&
-                        i2 >= 0 && i2 < (int)vertices.size() &&
-                        i3 >= 0 && i3 < (int)vertices.size()) {
-                        // 存储生成的三角形面片数据，并预计算边界
-                        Triangle tri;
-                        tri.v0 = vertices[i1];
-                        tri.v1 = vertices[i2];
-                        tri.v2 = vertices[i3];
-                        tri.minX = std::min({tri.v0.x, tri.v1.x, tri.v2.x});
-                        tri.maxX = std::max({tri.v0.x, tri.v1.x, tri.v2.x});
-                        tri.minZ = std::min({tri.v0.z, tri.v1.z, tri.v2.z});
-                        tri.maxZ = std::max({tri.v0.z, tri.v1.z, tri.v2.z});
-                        _triangles.push_back(tri);
-                    }
-                } catch (...) {
-                    // 忽略格式错误的行
-                }
+        else if (lineEnd - p >= 2 && p[0] == 'f' && p[1] == ' ') {
+            const int vertexCount = (int)(_ownedVertices.size() / 3);
+            const char* s = p + 2;
+            // 处理可能带斜杠的索引（如 1/1/1 或 1//1），只取顶点索引
+            auto parseIdx = [&](int& out) {
+                while (s < lineEnd && (*s == ' ' || *s == '\t')) ++s;
+                if (s >= lineEnd) return false;
+                char* q;
+                long v = strtol(s, &q, 10);
+                if (q == s) return false;
+                // .obj 索引从 1 开始，需减 1 匹配数组索引
+                out = (int)v - 1;
+                s = q;
+                while (s < lineEnd && *s != ' ' && *s != '\t' && *s != '\r') ++s;
+                return true;
+            };
+
+            int i1, i2, i3;
+            // 索引合法性检查，防止数组越界导致崩溃；格式错误的行直接忽略
+            if (parseIdx(i1) && parseIdx(i2) && parseIdx(i3) &&
+                i1 >= 0 && i1 < vertexCount &&
+                i2 >= 0 && i2 < vertexCount &&
+                i3 >= 0 && i3 < vertexCount) {
+                _ownedIndices.push_back((uint32_t)i1);
+                _ownedIndices.push_back((uint32_t)i2);
+                _ownedIndices.push_back((uint32_t)i3);
             }
         }
+        p = lineEnd + 1;
     }
-    return !_triangles.empty();
+
+    bindOwnedMesh();
+    return _triangleCount > 0;
 }
 
 /**
@@ -129,54 +334,467 @@ void TerrainCollider::extractTriangles(Sprite3D* model) {
     Vec3 min = aabb._min;
     Vec3 max = aabb._max;
     float groundY = min.y; // 取包围盒底部高度
-    
+
     // 创建两个三角形组成一个矩形平面
-    Triangle tri1 = {Vec3(min.x, groundY, min.z), Vec3(max.x, groundY, min.z), Vec3(max.x, groundY, max.z)};
-    tri1.minX = min.x; tri1.maxX = max.x; tri1.minZ = min.z; tri1.maxZ = max.z;
-    _triangles.push_back(tri1);
-
-    Triangle tri2 = {Vec3(min.x, groundY, min.z), Vec3(max.x, groundY, max.z), Vec3(min.x, groundY, max.z)};
-    tri2.minX = min.x; tri2.maxX = max.x; tri2.minZ = min.z; tri2.maxZ = max.z;
-    _triangles.push_back(tri2);
-}
-
-void TerrainCollider::buildGrid() {
-    if (_triangles.empty()) return;
-
-    // 1. 计算地形总边界
-    float minX = FLT_MAX, maxX = -FLT_MAX;
-    float minZ = FLT_MAX, maxZ = -FLT_MAX;
-    for (const auto& tri : _triangles) {
-        minX = std::min({minX, tri.minX});
-        maxX = std::max({maxX, tri.maxX});
-        minZ = std::min({minZ, tri.minZ});
-        maxZ = std::max({maxZ, tri.maxZ});
-    }
-
-    // 2. 初始化网格参数 (固定 32x32 网格)
-    _grid.minX = minX;
-    _grid.minZ = minZ;
-    _grid.cols = 32;
-    _grid.rows = 32;
-    _grid.cellSize = std::max((maxX - minX) / _grid.cols, (maxZ - minZ) / _grid.rows) + 0.1f;
-    _grid.cells.assign(_grid.cols * _grid.rows, std::vector<int>());
-
-    // 3. 将三角形分配到重叠的网格中
-    for (int i = 0; i < (int)_triangles.size(); ++i) {
-        const auto& tri = _triangles[i];
-        
-        int startCol = std::max(0, (int)((tri.minX - _grid.minX) / _grid.cellSize));
-        int endCol = std::min(_grid.cols - 1, (int)((tri.maxX - _grid.minX) / _grid.cellSize));
-        int startRow = std::max(0, (int)((tri.minZ - _grid.minZ) / _grid.cellSize));
-        int endRow = std::min(_grid.rows - 1, (int)((tri.maxZ - _grid.minZ) / _grid.cellSize));
-
-        for (int r = startRow; r <= endRow; ++r) {
-            for (int c = startCol; c <= endCol; ++c) {
-                _grid.cells[r * _grid.cols + c].push_back(i);
+    _ownedVertices = {
+        min.x, groundY, min.z,
+        max.x, groundY, min.z,
+        max.x, groundY, max.z,
+        min.x, groundY, max.z,
+    };
+    _ownedIndices = { 0, 1, 2, 0, 2, 3 };
+    bindOwnedMesh();
+}
+
+void TerrainCollider::bindOwnedMesh() {
+    _cookedFile.close();
+    _vertexCount = (int)(_ownedVertices.size() / 3);
+    _triangleCount = (int)(_ownedIndices.size() / 3);
+    _vertices = _ownedVertices.data();
+    _indices = _ownedIndices.data();
+}
+
+Vec3 TerrainCollider::triangleVertex(int triIdx, int corner) const {
+    const float* v = _vertices + _indices[triIdx * 3 + corner] * 3;
+    return Vec3(v[0], v[1], v[2]);
+}
+
+namespace {
+    const int kBVHBins = 12;        // SAH 分桶数量
+    const int kBVHMaxLeafSize = 4;  // 叶子最多容纳的三角形数
+    const int kBVHStackSize = 64;   // 栈上遍历栈的深度，更深的 BVH 改用堆上分配
+
+    struct Bounds {
+        Vec3 bmin = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 bmax = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+        void grow(const Vec3& p) {
+            bmin.set(std::min(bmin.x, p.x), std::min(bmin.y, p.y), std::min(bmin.z, p.z));
+            bmax.set(std::max(bmax.x, p.x), std::max(bmax.y, p.y), std::max(bmax.z, p.z));
+        }
+        void grow(const Bounds& b) {
+            if (b.bmin.x > b.bmax.x) return;
+            grow(b.bmin);
+            grow(b.bmax);
+        }
+        float area() const {
+            Vec3 e = bmax - bmin;
+            if (e.x < 0.0f) return 0.0f;
+            return e.x * e.y + e.y * e.z + e.z * e.x;
+        }
+    };
+
+    inline float axisOf(const Vec3& v, int axis) {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    // 射线包：每个 SIMD 通道一条射线
+#if defined(__AVX__)
+    const int kRayLanes = 8;
+    typedef __m256 RayLane;
+    inline RayLane laneSet(float v) { return _mm256_set1_ps(v); }
+    inline RayLane laneLoad(const float* p) { return _mm256_loadu_ps(p); }
+    inline void laneStore(float* p, RayLane v) { _mm256_storeu_ps(p, v); }
+    inline RayLane laneAdd(RayLane a, RayLane b) { return _mm256_add_ps(a, b); }
+    inline RayLane laneSub(RayLane a, RayLane b) { return _mm256_sub_ps(a, b); }
+    inline RayLane laneMul(RayLane a, RayLane b) { return _mm256_mul_ps(a, b); }
+    inline RayLane laneDiv(RayLane a, RayLane b) { return _mm256_div_ps(a, b); }
+    inline RayLane laneMin(RayLane a, RayLane b) { return _mm256_min_ps(a, b); }
+    inline RayLane laneMax(RayLane a, RayLane b) { return _mm256_max_ps(a, b); }
+    inline RayLane laneLess(RayLane a, RayLane b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    inline RayLane laneLessEq(RayLane a, RayLane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline RayLane laneAnd(RayLane a, RayLane b) { return _mm256_and_ps(a, b); }
+    inline RayLane laneSelect(RayLane mask, RayLane a, RayLane b) { return _mm256_blendv_ps(b, a, mask); }
+    inline int laneMask(RayLane v) { return _mm256_movemask_ps(v); }
+#elif defined(__SSE__)
+    const int kRayLanes = 4;
+    typedef __m128 RayLane;
+    inline RayLane laneSet(float v) { return _mm_set1_ps(v); }
+    inline RayLane laneLoad(const float* p) { return _mm_loadu_ps(p); }
+    inline void laneStore(float* p, RayLane v) { _mm_storeu_ps(p, v); }
+    inline RayLane laneAdd(RayLane a, RayLane b) { return _mm_add_ps(a, b); }
+    inline RayLane laneSub(RayLane a, RayLane b) { return _mm_sub_ps(a, b); }
+    inline RayLane laneMul(RayLane a, RayLane b) { return _mm_mul_ps(a, b); }
+    inline RayLane laneDiv(RayLane a, RayLane b) { return _mm_div_ps(a, b); }
+    inline RayLane laneMin(RayLane a, RayLane b) { return _mm_min_ps(a, b); }
+    inline RayLane laneMax(RayLane a, RayLane b) { return _mm_max_ps(a, b); }
+    inline RayLane laneLess(RayLane a, RayLane b) { return _mm_cmplt_ps(a, b); }
+    inline RayLane laneLessEq(RayLane a, RayLane b) { return _mm_cmple_ps(a, b); }
+    inline RayLane laneAnd(RayLane a, RayLane b) { return _mm_and_ps(a, b); }
+    inline RayLane laneSelect(RayLane mask, RayLane a, RayLane b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    inline int laneMask(RayLane v) { return _mm_movemask_ps(v); }
+#else
+    const int kRayLanes = 1;
+#endif
+}
+
+/**
+ * 构建 BVH
+ * 使用分桶 SAH（表面积启发式）自顶向下划分，节点扁平存储在连续数组中，
+ * 构建过程中直接重排索引缓冲（每 3 个一组），使每个叶子引用一段连续的三角形
+ */
+void TerrainCollider::buildBVH() {
+    _ownedNodes.clear();
+    _bvhNodes = nullptr;
+    _bvhNodeCount = 0;
+    _bvhDepth = 0;
+    if (_triangleCount == 0) return;
+
+    const int triCount = _triangleCount;
+    std::vector<Vec3> centroids(triCount);
+    for (int i = 0; i < triCount; ++i) {
+        centroids[i] = (triangleVertex(i, 0) + triangleVertex(i, 1) + triangleVertex(i, 2)) * (1.0f / 3.0f);
+    }
+
+    // N 个叶子的二叉树最多 2N-1 个节点，预留后递归中不会发生重新分配
+    _ownedNodes.reserve(triCount * 2);
+    BVHNode root;
+    root.leftFirst = 0;
+    root.count = triCount;
+    _ownedNodes.push_back(root);
+
+    updateNodeBounds(0);
+    subdivideNode(0, centroids);
+
+    _bvhNodes = _ownedNodes.data();
+    _bvhNodeCount = (int)_ownedNodes.size();
+    computeBVHDepth();
+    CCLOG("TerrainCollider: BVH built. %d triangles, %d nodes, depth %d.", triCount, _bvhNodeCount, _bvhDepth);
+}
+
+void TerrainCollider::computeBVHDepth() {
+    _bvhDepth = 0;
+    if (_bvhNodeCount == 0) return;
+
+    // 孩子总在父节点之后，顺序扫描一遍即可得到每个节点的深度
+    std::vector<int> depth(_bvhNodeCount, 0);
+    for (int i = 0; i < _bvhNodeCount; ++i) {
+        const BVHNode& n = _bvhNodes[i];
+        if (n.count > 0) {
+            _bvhDepth = std::max(_bvhDepth, depth[i]);
+        } else {
+            depth[n.leftFirst] = depth[n.leftFirst + 1] = depth[i] + 1;
+        }
+    }
+}
+
+void TerrainCollider::updateNodeBounds(int nodeIdx) {
+    BVHNode& node = _ownedNodes[nodeIdx];
+    Bounds b;
+    for (int i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+        b.grow(triangleVertex(i, 0));
+        b.grow(triangleVertex(i, 1));
+        b.grow(triangleVertex(i, 2));
+    }
+    node.minX = b.bmin.x; node.minY = b.bmin.y; node.minZ = b.bmin.z;
+    node.maxX = b.bmax.x; node.maxY = b.bmax.y; node.maxZ = b.bmax.z;
+}
+
+void TerrainCollider::subdivideNode(int nodeIdx, std::vector<Vec3>& centroids) {
+    const int first = _ownedNodes[nodeIdx].leftFirst;
+    const int count = _ownedNodes[nodeIdx].count;
+    if (count <= 1) return;
+
+    // 1. 计算质心包围盒，决定分桶范围
+    Bounds centroidBounds;
+    for (int i = first; i < first + count; ++i) {
+        centroidBounds.grow(centroids[i]);
+    }
+
+    // 2. 在三个轴上分桶并评估 SAH 代价
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        float lo = axisOf(centroidBounds.bmin, axis);
+        float hi = axisOf(centroidBounds.bmax, axis);
+        if (hi - lo < 1e-6f) continue;
+
+        Bounds binBounds[kBVHBins];
+        int binCount[kBVHBins] = {0};
+        float scale = kBVHBins / (hi - lo);
+        for (int i = first; i < first + count; ++i) {
+            int b = std::min(kBVHBins - 1, (int)((axisOf(centroids[i], axis) - lo) * scale));
+            binCount[b]++;
+            binBounds[b].grow(triangleVertex(i, 0));
+            binBounds[b].grow(triangleVertex(i, 1));
+            binBounds[b].grow(triangleVertex(i, 2));
+        }
+
+        // 前缀 / 后缀扫描得到每个分割面两侧的面积与数量
+        float leftArea[kBVHBins - 1], rightArea[kBVHBins - 1];
+        int leftCount[kBVHBins - 1], rightCount[kBVHBins - 1];
+        Bounds leftBox, rightBox;
+        int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < kBVHBins - 1; ++i) {
+            leftSum += binCount[i];
+            leftCount[i] = leftSum;
+            leftBox.grow(binBounds[i]);
+            leftArea[i] = leftBox.area();
+
+            rightSum += binCount[kBVHBins - 1 - i];
+            rightCount[kBVHBins - 2 - i] = rightSum;
+            rightBox.grow(binBounds[kBVHBins - 1 - i]);
+            rightArea[kBVHBins - 2 - i] = rightBox.area();
+        }
+
+        for (int i = 0; i < kBVHBins - 1; ++i) {
+            float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    // 3. 与不划分（叶子）的代价比较，小节点直接作为叶子
+    const BVHNode& node = _ownedNodes[nodeIdx];
+    Bounds nodeBox;
+    nodeBox.bmin.set(node.minX, node.minY, node.minZ);
+    nodeBox.bmax.set(node.maxX, node.maxY, node.maxZ);
+    float leafCost = count * nodeBox.area();
+    if (bestAxis < 0 || (count <= kBVHMaxLeafSize && bestCost >= leafCost)) return;
+
+    // 4. 按分割面原地划分三角形（质心同步交换）
+    float lo = axisOf(centroidBounds.bmin, bestAxis);
+    float scale = kBVHBins / (axisOf(centroidBounds.bmax, bestAxis) - lo);
+    int i = first;
+    int j = first + count - 1;
+    while (i <= j) {
+        int b = std::min(kBVHBins - 1, (int)((axisOf(centroids[i], bestAxis) - lo) * scale));
+        if (b <= bestSplit) {
+            ++i;
+        } else {
+            std::swap_ranges(&_ownedIndices[i * 3], &_ownedIndices[i * 3 + 3], &_ownedIndices[j * 3]);
+            std::swap(centroids[i], centroids[j]);
+            --j;
+        }
+    }
+
+    int leftCount = i - first;
+    if (leftCount == 0 || leftCount == count) return;
+
+    // 5. 创建左右孩子（相邻存放）并递归
+    int leftIdx = (int)_ownedNodes.size();
+    BVHNode left, right;
+    left.leftFirst = first;
+    left.count = leftCount;
+    right.leftFirst = i;
+    right.count = count - leftCount;
+    _ownedNodes.push_back(left);
+    _ownedNodes.push_back(right);
+
+    _ownedNodes[nodeIdx].leftFirst = leftIdx;
+    _ownedNodes[nodeIdx].count = 0;
+
+    updateNodeBounds(leftIdx);
+    updateNodeBounds(leftIdx + 1);
+    subdivideNode(leftIdx, centroids);
+    subdivideNode(leftIdx + 1, centroids);
+}
+
+/**
+ * 射线与 BVH 节点包围盒的 slab 检测
+ * @return 进入距离，未命中（或比 tMax 更远）返回 FLT_MAX
+ */
+static inline float intersectNodeAABB(const Vec3& origin, const Vec3& invDir, float tMax,
+                                      float minX, float minY, float minZ,
+                                      float maxX, float maxY, float maxZ) {
+    float tx1 = (minX - origin.x) * invDir.x, tx2 = (maxX - origin.x) * invDir.x;
+    float tmin = std::min(tx1, tx2), tmax = std::max(tx1, tx2);
+    float ty1 = (minY - origin.y) * invDir.y, ty2 = (maxY - origin.y) * invDir.y;
+    tmin = std::max(tmin, std::min(ty1, ty2)); tmax = std::min(tmax, std::max(ty1, ty2));
+    float tz1 = (minZ - origin.z) * invDir.z, tz2 = (maxZ - origin.z) * invDir.z;
+    tmin = std::max(tmin, std::min(tz1, tz2)); tmax = std::min(tmax, std::max(tz1, tz2));
+
+    if (tmax >= tmin && tmin < tMax && tmax > 0.0f) return tmin;
+    return FLT_MAX;
+}
+
+int TerrainCollider::traverseBVH(const CustomRay& ray, float tMax, float& tHit) const {
+    if (_bvhNodeCount == 0) return -1;
+
+    // 避免 0 分量产生 0 * inf = NaN
+    auto safeInv = [](float d) { return 1.0f / (std::abs(d) > 1e-12f ? d : (d < 0.0f ? -1e-12f : 1e-12f)); };
+    const Vec3 invDir(safeInv(ray.direction.x), safeInv(ray.direction.y), safeInv(ray.direction.z));
+
+    auto nodeDist = [&](int idx, float limit) {
+        const BVHNode& n = _bvhNodes[idx];
+        return intersectNodeAABB(ray.origin, invDir, limit, n.minX, n.minY, n.minZ, n.maxX, n.maxY, n.maxZ);
+    };
+
+    int hitIdx = -1;
+    tHit = tMax;
+    if (nodeDist(0, tHit) == FLT_MAX) return -1;
+
+    // 每个内部节点最多压入一个孩子，栈深度不超过 BVH 深度
+    int localStack[kBVHStackSize];
+    std::vector<int> heapStack;
+    int* stack = localStack;
+    if (_bvhDepth > kBVHStackSize) {
+        heapStack.resize(_bvhDepth);
+        stack = heapStack.data();
+    }
+    int stackPtr = 0;
+    int nodeIdx = 0;
+    while (true) {
+        const BVHNode& node = _bvhNodes[nodeIdx];
+        if (node.count > 0) {
+            // 叶子：批量求交，保留最近的命中
+            int leafHit = intersectLeaf(ray, node.leftFirst, node.count, tHit);
+            if (leafHit >= 0) hitIdx = leafHit;
+            if (stackPtr == 0) break;
+            nodeIdx = stack[--stackPtr];
+            continue;
+        }
+
+        // 内部节点：先访问更近的孩子，远的入栈
+        int near = node.leftFirst;
+        int far = node.leftFirst + 1;
+        float dNear = nodeDist(near, tHit);
+        float dFar = nodeDist(far, tHit);
+        if (dNear > dFar) {
+            std::swap(near, far);
+            std::swap(dNear, dFar);
+        }
+
+        if (dNear == FLT_MAX) {
+            if (stackPtr == 0) break;
+            nodeIdx = stack[--stackPtr];
+        } else {
+            nodeIdx = near;
+            if (dFar != FLT_MAX) {
+                CCASSERT(stackPtr < std::max(_bvhDepth, kBVHStackSize), "TerrainCollider: BVH traversal stack overflow");
+                stack[stackPtr++] = far;
             }
         }
     }
-    CCLOG("TerrainCollider: Grid built. %d triangles distributed into %dx%d cells.", (int)_triangles.size(), _grid.cols, _grid.rows);
+    return hitIdx;
+}
+
+/**
+ * 生成 SoA 数据：9 个分量存放在同一块连续内存中，布局与烘焙文件的 soa 段一致
+ * 每个分量长度补齐到 4 的倍数，保证各分量起点 16 字节对齐
+ */
+void TerrainCollider::buildSoA() {
+    const int n = _triangleCount;
+    const int stride = (n + 3 + 3) & ~3;
+    _ownedSoA.assign((size_t)stride * 9, 0.0f);
+
+    float* v0x = &_ownedSoA[0];
+    float* v0y = v0x + stride;
+    float* v0z = v0y + stride;
+    float* e1x = v0z + stride;
+    float* e1y = e1x + stride;
+    float* e1z = e1y + stride;
+    float* e2x = e1z + stride;
+    float* e2y = e2x + stride;
+    float* e2z = e2y + stride;
+    for (int i = 0; i < n; ++i) {
+        Vec3 v0 = triangleVertex(i, 0);
+        Vec3 e1 = triangleVertex(i, 1) - v0;
+        Vec3 e2 = triangleVertex(i, 2) - v0;
+        v0x[i] = v0.x; v0y[i] = v0.y; v0z[i] = v0.z;
+        e1x[i] = e1.x; e1y[i] = e1.y; e1z[i] = e1.z;
+        e2x[i] = e2.x; e2y[i] = e2.y; e2z[i] = e2.z;
+    }
+    bindSoA(_ownedSoA.data(), stride);
+}
+
+void TerrainCollider::bindSoA(const float* base, int stride) {
+    _soaStride = stride;
+    _soa.v0x = base;
+    _soa.v0y = base + stride;
+    _soa.v0z = base + stride * 2;
+    _soa.e1x = base + stride * 3;
+    _soa.e1y = base + stride * 4;
+    _soa.e1z = base + stride * 5;
+    _soa.e2x = base + stride * 6;
+    _soa.e2y = base + stride * 7;
+    _soa.e2z = base + stride * 8;
+}
+
+/**
+ * 叶子内三角形求交
+ * SSE 下同一条射线一次测试 4 个三角形（Möller-Trumbore 的 4 路展开），
+ * BVH 叶子最多 4 个三角形，通常一个叶子只需一轮
+ */
+int TerrainCollider::intersectLeaf(const CustomRay& ray, int first, int count, float& tHit) const {
+    int hitIdx = -1;
+#ifdef __SSE__
+    const __m128 dx = _mm_set1_ps(ray.direction.x);
+    const __m128 dy = _mm_set1_ps(ray.direction.y);
+    const __m128 dz = _mm_set1_ps(ray.direction.z);
+    const __m128 ox = _mm_set1_ps(ray.origin.x);
+    const __m128 oy = _mm_set1_ps(ray.origin.y);
+    const __m128 oz = _mm_set1_ps(ray.origin.z);
+    const __m128 eps = _mm_set1_ps(0.00001f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (int base = first; base < first + count; base += 4) {
+        const __m128 e1x = _mm_loadu_ps(&_soa.e1x[base]);
+        const __m128 e1y = _mm_loadu_ps(&_soa.e1y[base]);
+        const __m128 e1z = _mm_loadu_ps(&_soa.e1z[base]);
+        const __m128 e2x = _mm_loadu_ps(&_soa.e2x[base]);
+        const __m128 e2y = _mm_loadu_ps(&_soa.e2y[base]);
+        const __m128 e2z = _mm_loadu_ps(&_soa.e2z[base]);
+
+        // h = dir x e2, a = e1 . h
+        __m128 hx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 hy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 hz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, hx), _mm_mul_ps(e1y, hy)), _mm_mul_ps(e1z, hz));
+
+        // |a| < eps 视为平行（与标量版一致）
+        __m128 absA = _mm_max_ps(a, _mm_sub_ps(zero, a));
+        __m128 valid = _mm_cmpge_ps(absA, eps);
+        __m128 f = _mm_div_ps(one, _mm_or_ps(a, _mm_andnot_ps(valid, one)));
+
+        // s = o - v0, u = f * (s . h)
+        __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(&_soa.v0x[base]));
+        __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(&_soa.v0y[base]));
+        __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(&_soa.v0z[base]));
+        __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, hx), _mm_mul_ps(sy, hy)), _mm_mul_ps(sz, hz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+        // q = s x e1, v = f * (dir . q)
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+        // t = f * (e2 . q)，要求 eps < t < tHit
+        __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, eps), _mm_cmplt_ps(t, _mm_set1_ps(tHit))));
+
+        int mask = _mm_movemask_ps(valid);
+        if (!mask) continue;
+
+        float ts[4];
+        _mm_storeu_ps(ts, t);
+        const int lanes = std::min(4, first + count - base);
+        for (int k = 0; k < lanes; ++k) {
+            if ((mask & (1 << k)) && ts[k] < tHit) {
+                tHit = ts[k];
+                hitIdx = base + k;
+            }
+        }
+    }
+#else
+    for (int i = first; i < first + count; ++i) {
+        float t;
+        if (intersectTriangle(ray, i, t) && t < tHit) {
+            tHit = t;
+            hitIdx = i;
+        }
+    }
+#endif
+    return hitIdx;
 }
 
 /**
@@ -186,36 +804,428 @@ void TerrainCollider::buildGrid() {
  * @return 是否发生碰撞
  */
 bool TerrainCollider::rayIntersects(const CustomRay& ray, float& hitDist) {
-    if (_triangles.empty()) return false;
+    float t;
+    if (traverseBVH(ray, FLT_MAX, t) < 0) return false;
+
+    hitDist = t;
+    return true;
+}
 
-    // 1. 确定射线所在的网格单元
-    int c = (int)((ray.origin.x - _grid.minX) / _grid.cellSize);
-    int r = (int)((ray.origin.z - _grid.minZ) / _grid.cellSize);
+/**
+ * 任意方向射线检测
+ * 与 rayIntersects 共用 BVH，方向归一化后 hitDist 即为世界空间距离
+ */
+bool TerrainCollider::raycast(const Vec3& origin, const Vec3& dir, float maxDist,
+                              float* hitDist, Vec3* hitNormal) const {
+    if (maxDist <= 0.0f || dir.lengthSquared() < 1e-12f) return false;
 
-    // 如果射线在网格之外，不进行检测
-    if (c < 0 || c >= _grid.cols || r < 0 || r >= _grid.rows) return false;
+    Vec3 unitDir = dir.getNormalized();
+    CustomRay ray(origin, unitDir);
 
-    const auto& cellIndices = _grid.cells[r * _grid.cols + c];
-    float closestDist = FLT_MAX;
-    bool hit = false;
-    
-    for (int idx : cellIndices) {
-        const auto& tri = _triangles[idx];
-        
-        // 性能优化：快速 AABB 过滤 (2D 投影)
-        if (ray.origin.x < tri.minX || ray.origin.x > tri.maxX || ray.origin.z < tri.minZ || ray.origin.z > tri.maxZ) continue;
+    float t;
+    int triIdx = traverseBVH(ray, maxDist, t);
+    if (triIdx < 0) return false;
 
-        float t;
-        if (intersectTriangle(ray, tri, t)) {
-            if (t < closestDist && t > 0) {
-                closestDist = t;
-                hit = true;
+    if (hitDist) *hitDist = t;
+    if (hitNormal) *hitNormal = triangleNormal(triIdx, unitDir);
+    return true;
+}
+
+Vec3 TerrainCollider::triangleNormal(int triIdx, const Vec3& rayDir) const {
+    Vec3 e1(_soa.e1x[triIdx], _soa.e1y[triIdx], _soa.e1z[triIdx]);
+    Vec3 e2(_soa.e2x[triIdx], _soa.e2y[triIdx], _soa.e2z[triIdx]);
+    Vec3 n;
+    Vec3::cross(e1, e2, &n);
+    n.normalize();
+    // 法线朝向射线来的一侧
+    if (n.dot(rayDir) > 0.0f) n = -n;
+    return n;
+}
+
+/**
+ * 批量射线检测
+ * 按 kRayLanes 条一包处理，不支持 SIMD 的平台逐条遍历
+ */
+int TerrainCollider::rayIntersectsBatch(const CustomRay* rays, int count, float* hitDists, int* hitTriangles) const {
+    int hitCount = 0;
+    for (int base = 0; base < count; base += kRayLanes) {
+        const int n = std::min(kRayLanes, count - base);
+        float t[kRayLanes];
+        int tri[kRayLanes];
+        intersectPacket(rays + base, n, t, tri);
+        for (int k = 0; k < n; ++k) {
+            hitDists[base + k] = tri[k] >= 0 ? t[k] : -1.0f;
+            if (hitTriangles) hitTriangles[base + k] = tri[k];
+            if (tri[k] >= 0) ++hitCount;
+        }
+    }
+    return hitCount;
+}
+
+/**
+ * 射线包遍历
+ * 节点包围盒对整包射线做 slab 检测，任一有效射线命中即进入，先访问包内进入距离最近的孩子；
+ * 叶子中逐个三角形广播后与整包射线做 Möller-Trumbore 求交，每条射线各自保留最近命中
+ */
+void TerrainCollider::intersectPacket(const CustomRay* rays, int count, float* tHit, int* hitTri) const {
+    for (int k = 0; k < count; ++k) {
+        tHit[k] = FLT_MAX;
+        hitTri[k] = -1;
+    }
+    if (_bvhNodeCount == 0 || count <= 0) return;
+
+#if defined(__SSE__)
+    // 射线转置为 SoA，不足一包的空位复制最后一条射线，并从有效掩码中排除
+    float ox[kRayLanes], oy[kRayLanes], oz[kRayLanes];
+    float dx[kRayLanes], dy[kRayLanes], dz[kRayLanes];
+    float ix[kRayLanes], iy[kRayLanes], iz[kRayLanes];
+    auto safeInv = [](float d) { return 1.0f / (std::abs(d) > 1e-12f ? d : (d < 0.0f ? -1e-12f : 1e-12f)); };
+    for (int k = 0; k < kRayLanes; ++k) {
+        const CustomRay& r = rays[std::min(k, count - 1)];
+        ox[k] = r.origin.x; oy[k] = r.origin.y; oz[k] = r.origin.z;
+        dx[k] = r.direction.x; dy[k] = r.direction.y; dz[k] = r.direction.z;
+        ix[k] = safeInv(dx[k]); iy[k] = safeInv(dy[k]); iz[k] = safeInv(dz[k]);
+    }
+    const int activeMask = (1 << count) - 1;
+
+    const RayLane Ox = laneLoad(ox), Oy = laneLoad(oy), Oz = laneLoad(oz);
+    const RayLane Dx = laneLoad(dx), Dy = laneLoad(dy), Dz = laneLoad(dz);
+    const RayLane Ix = laneLoad(ix), Iy = laneLoad(iy), Iz = laneLoad(iz);
+    const RayLane zero = laneSet(0.0f);
+    const RayLane one = laneSet(1.0f);
+    const RayLane eps = laneSet(0.00001f);
+    RayLane best = laneSet(FLT_MAX);
+
+    // 返回命中该节点的射线掩码，entry 为其中最小的进入距离
+    auto nodeMask = [&](int idx, float& entry) {
+        const BVHNode& n = _bvhNodes[idx];
+        RayLane t1 = laneMul(laneSub(laneSet(n.minX), Ox), Ix);
+        RayLane t2 = laneMul(laneSub(laneSet(n.maxX), Ox), Ix);
+        RayLane tmin = laneMin(t1, t2), tmax = laneMax(t1, t2);
+        t1 = laneMul(laneSub(laneSet(n.minY), Oy), Iy);
+        t2 = laneMul(laneSub(laneSet(n.maxY), Oy), Iy);
+        tmin = laneMax(tmin, laneMin(t1, t2)); tmax = laneMin(tmax, laneMax(t1, t2));
+        t1 = laneMul(laneSub(laneSet(n.minZ), Oz), Iz);
+        t2 = laneMul(laneSub(laneSet(n.maxZ), Oz), Iz);
+        tmin = laneMax(tmin, laneMin(t1, t2)); tmax = laneMin(tmax, laneMax(t1, t2));
+
+        RayLane hit = laneAnd(laneLessEq(tmin, tmax), laneAnd(laneLess(tmin, best), laneLess(zero, tmax)));
+        int mask = laneMask(hit) & activeMask;
+        entry = FLT_MAX;
+        if (mask) {
+            float e[kRayLanes];
+            laneStore(e, tmin);
+            for (int k = 0; k < kRayLanes; ++k) {
+                if (mask & (1 << k)) entry = std::min(entry, e[k]);
             }
         }
+        return mask;
+    };
+
+    float rootEntry;
+    if (!nodeMask(0, rootEntry)) return;
+
+    int localStack[kBVHStackSize];
+    std::vector<int> heapStack;
+    int* stack = localStack;
+    if (_bvhDepth > kBVHStackSize) {
+        heapStack.resize(_bvhDepth);
+        stack = heapStack.data();
     }
-    
-    if (hit) hitDist = closestDist;
-    return hit;
+    int stackPtr = 0;
+    int nodeIdx = 0;
+    while (true) {
+        const BVHNode& node = _bvhNodes[nodeIdx];
+        if (node.count > 0) {
+            for (int i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+                const RayLane e1x = laneSet(_soa.e1x[i]), e1y = laneSet(_soa.e1y[i]), e1z = laneSet(_soa.e1z[i]);
+                const RayLane e2x = laneSet(_soa.e2x[i]), e2y = laneSet(_soa.e2y[i]), e2z = laneSet(_soa.e2z[i]);
+
+                // h = dir x e2, a = e1 . h
+                RayLane hx = laneSub(laneMul(Dy, e2z), laneMul(Dz, e2y));
+                RayLane hy = laneSub(laneMul(Dz, e2x), laneMul(Dx, e2z));
+                RayLane hz = laneSub(laneMul(Dx, e2y), laneMul(Dy, e2x));
+                RayLane a = laneAdd(laneAdd(laneMul(e1x, hx), laneMul(e1y, hy)), laneMul(e1z, hz));
+
+                // |a| < eps 视为平行
+                RayLane valid = laneLessEq(eps, laneMax(a, laneSub(zero, a)));
+                RayLane f = laneDiv(one, laneSelect(valid, a, one));
+
+                // s = o - v0, u = f * (s . h)
+                RayLane sx = laneSub(Ox, laneSet(_soa.v0x[i]));
+                RayLane sy = laneSub(Oy, laneSet(_soa.v0y[i]));
+                RayLane sz = laneSub(Oz, laneSet(_soa.v0z[i]));
+                RayLane u = laneMul(f, laneAdd(laneAdd(laneMul(sx, hx), laneMul(sy, hy)), laneMul(sz, hz)));
+                valid = laneAnd(valid, laneAnd(laneLessEq(zero, u), laneLessEq(u, one)));
+
+                // q = s x e1, v = f * (dir . q)
+                RayLane qx = laneSub(laneMul(sy, e1z), laneMul(sz, e1y));
+                RayLane qy = laneSub(laneMul(sz, e1x), laneMul(sx, e1z));
+                RayLane qz = laneSub(laneMul(sx, e1y), laneMul(sy, e1x));
+                RayLane v = laneMul(f, laneAdd(laneAdd(laneMul(Dx, qx), laneMul(Dy, qy)), laneMul(Dz, qz)));
+                valid = laneAnd(valid, laneAnd(laneLessEq(zero, v), laneLessEq(laneAdd(u, v), one)));
+
+                // t = f * (e2 . q)，要求 eps < t < best
+                RayLane t = laneMul(f, laneAdd(laneAdd(laneMul(e2x, qx), laneMul(e2y, qy)), laneMul(e2z, qz)));
+                valid = laneAnd(valid, laneAnd(laneLess(eps, t), laneLess(t, best)));
+
+                int mask = laneMask(valid) & activeMask;
+                if (!mask) continue;
+                best = laneSelect(valid, t, best);
+                for (int k = 0; k < count; ++k) {
+                    if (mask & (1 << k)) hitTri[k] = i;
+                }
+            }
+            if (stackPtr == 0) break;
+            nodeIdx = stack[--stackPtr];
+            continue;
+        }
+
+        int near = node.leftFirst;
+        int far = node.leftFirst + 1;
+        float dNear, dFar;
+        int mNear = nodeMask(near, dNear);
+        int mFar = nodeMask(far, dFar);
+        if (dNear > dFar) {
+            std::swap(near, far);
+            std::swap(mNear, mFar);
+        }
+
+        if (!mNear) {
+            if (stackPtr == 0) break;
+            nodeIdx = stack[--stackPtr];
+        } else {
+            nodeIdx = near;
+            if (mFar) {
+                CCASSERT(stackPtr < std::max(_bvhDepth, kBVHStackSize), "TerrainCollider: BVH traversal stack overflow");
+                stack[stackPtr++] = far;
+            }
+        }
+    }
+
+    float bestT[kRayLanes];
+    laneStore(bestT, best);
+    for (int k = 0; k < count; ++k) {
+        tHit[k] = bestT[k];
+    }
+#else
+    for (int k = 0; k < count; ++k) {
+        hitTri[k] = traverseBVH(rays[k], FLT_MAX, tHit[k]);
+    }
+#endif
+}
+
+void TerrainCollider::requestGroundSnap(Node* owner, GroundSnapListener* listener, const Vec3& pos) {
+    if (!owner || !listener) return;
+
+    owner->retain();
+    _snapRequests.push_back({owner, listener, pos});
+}
+
+/**
+ * 贴地批处理
+ * 本帧所有角色提交的请求先查高度场，多层 / 边界区域的请求汇总为向下射线一次批量求交，再逐个回调
+ */
+void TerrainCollider::update(float dt) {
+    if (_snapRequests.empty()) return;
+
+    // 回调中可能再次提交请求，先交换出来
+    std::vector<GroundSnapRequest> requests;
+    requests.swap(_snapRequests);
+
+    const int count = (int)requests.size();
+    const Vec3 down(0.0f, -1.0f, 0.0f);
+    _snapResults.resize(count);
+    _snapRays.clear();
+    _snapRayRequests.clear();
+    for (int i = 0; i < count; ++i) {
+        const Vec3& pos = requests[i].pos;
+        const float fromY = pos.y + kGroundSnapRayHeight;
+        GroundSnapResult& res = _snapResults[i];
+        res.normal.set(0.0f, 1.0f, 0.0f);
+        if (sampleHeightField(pos.x, pos.z, fromY, res.hit, res.groundY, &res.normal)) continue;
+
+        res.hit = false;
+        if (_bvhNodeCount == 0) continue;
+        // 起点不必高于整个网格的最高点（与 rayGroundHeight 一致）
+        const float startY = std::min(fromY, _bvhNodes[0].maxY + 1.0f);
+        _snapRays.push_back(CustomRay(Vec3(pos.x, startY, pos.z), down));
+        _snapRayRequests.push_back(i);
+    }
+
+    const int rayCount = (int)_snapRays.size();
+    if (rayCount > 0) {
+        _snapRayDists.resize(rayCount);
+        _snapRayTriangles.resize(rayCount);
+        rayIntersectsBatch(_snapRays.data(), rayCount, _snapRayDists.data(), _snapRayTriangles.data());
+        for (int j = 0; j < rayCount; ++j) {
+            if (_snapRayTriangles[j] < 0) continue;
+            GroundSnapResult& res = _snapResults[_snapRayRequests[j]];
+            res.hit = true;
+            res.groundY = _snapRays[j].origin.y - _snapRayDists[j];
+            res.normal = triangleNormal(_snapRayTriangles[j], down);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const GroundSnapResult& res = _snapResults[i];
+        requests[i].listener->onGroundSnap(res.hit, res.groundY, res.normal);
+        requests[i].owner->release();
+    }
+
+    // 换回以复用容量，避免每帧分配
+    requests.clear();
+    if (_snapRequests.empty()) {
+        _snapRequests.swap(requests);
+    }
+}
+
+/**
+ * 烘焙高度场
+ * 采样间距取三角形平均尺寸的一半，每个采样点向下发射射线取最高表面；
+ * 同一位置存在多层表面（桥、洞穴、悬崖下方）的采样点，以及单元中心插值误差超过容差的单元，
+ * 标记为回退，查询时改用射线检测
+ */
+void TerrainCollider::buildHeightField() {
+    _heightField = HeightField();
+    _ownedHeights.clear();
+    _ownedCellFlags.clear();
+    if (_bvhNodeCount == 0 || _triangleCount == 0) return;
+
+    const BVHNode& root = _bvhNodes[0];
+    const float extentX = root.maxX - root.minX;
+    const float extentZ = root.maxZ - root.minZ;
+    const float area = extentX * extentZ;
+    if (area <= 0.0f) return;
+
+    float cellSize = std::sqrt(2.0f * area / _triangleCount) * 0.5f;
+    cellSize = std::max(cellSize, std::sqrt(area / kHeightFieldMaxSamples));
+    const int cols = (int)std::ceil(extentX / cellSize) + 1;
+    const int rows = (int)std::ceil(extentZ / cellSize) + 1;
+    if (cols < 2 || rows < 2) return;
+
+    const float topY = root.maxY + 1.0f;
+    const float tolerance = std::max(1.0f, cellSize * 0.05f);
+    const float noGround = -FLT_MAX;
+
+    _ownedHeights.assign((size_t)cols * rows, noGround);
+    std::vector<uint8_t> multiLayer((size_t)cols * rows, 0);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const float x = root.minX + c * cellSize;
+            const float z = root.minZ + r * cellSize;
+            float h;
+            if (!rayGroundHeight(x, z, topY, h, nullptr)) continue;
+            _ownedHeights[r * cols + c] = h;
+
+            // 最高表面下方还有表面：多层结构
+            float below;
+            if (rayGroundHeight(x, z, h - tolerance, below, nullptr)) {
+                multiLayer[r * cols + c] = 1;
+            }
+        }
+    }
+
+    _ownedCellFlags.assign((size_t)(cols - 1) * (rows - 1), 0);
+    int fallbackCells = 0;
+    for (int r = 0; r < rows - 1; ++r) {
+        for (int c = 0; c < cols - 1; ++c) {
+            const int i00 = r * cols + c;
+            const int corners[4] = { i00, i00 + 1, i00 + cols, i00 + cols + 1 };
+            bool fallback = false;
+            float sum = 0.0f;
+            for (int k = 0; k < 4 && !fallback; ++k) {
+                fallback = _ownedHeights[corners[k]] == noGround || multiLayer[corners[k]];
+                sum += _ownedHeights[corners[k]];
+            }
+
+            // 单元中心的双线性值即四角平均，与真实表面比较
+            if (!fallback) {
+                float h;
+                const float x = root.minX + (c + 0.5f) * cellSize;
+                const float z = root.minZ + (r + 0.5f) * cellSize;
+                fallback = !rayGroundHeight(x, z, topY, h, nullptr) || std::abs(h - sum * 0.25f) > tolerance;
+            }
+
+            if (fallback) {
+                _ownedCellFlags[r * (cols - 1) + c] = 1;
+                ++fallbackCells;
+            }
+        }
+    }
+
+    _heightField.cols = cols;
+    _heightField.rows = rows;
+    _heightField.originX = root.minX;
+    _heightField.originZ = root.minZ;
+    _heightField.cellSize = cellSize;
+    _heightField.heights = _ownedHeights.data();
+    _heightField.cellFlags = _ownedCellFlags.data();
+
+    CCLOG("TerrainCollider: height field %dx%d (cell %.1f), %d/%d cells fall back to raycast.",
+          cols, rows, cellSize, fallbackCells, (cols - 1) * (rows - 1));
+}
+
+bool TerrainCollider::rayGroundHeight(float x, float z, float fromY, float& height, Vec3* normal) const {
+    if (_bvhNodeCount == 0) return false;
+
+    // 起点不必高于整个网格的最高点
+    const float startY = std::min(fromY, _bvhNodes[0].maxY + 1.0f);
+    const float maxDist = startY - _bvhNodes[0].minY + 1.0f;
+    if (maxDist <= 0.0f) return false;
+
+    float dist;
+    if (!raycast(Vec3(x, startY, z), Vec3(0.0f, -1.0f, 0.0f), maxDist, &dist, normal)) return false;
+    height = startY - dist;
+    return true;
+}
+
+/**
+ * 地面高度查询
+ * 高度场能回答时直接返回，否则回退向下射线检测
+ */
+bool TerrainCollider::getGroundHeight(float x, float z, float& height, Vec3* normal, float fromY) const {
+    bool hit;
+    if (sampleHeightField(x, z, fromY, hit, height, normal)) return hit;
+    return rayGroundHeight(x, z, fromY, height, normal);
+}
+
+/**
+ * 高度场查询
+ * 高度场单元内做双线性插值，法线由插值曲面的梯度得到
+ */
+bool TerrainCollider::sampleHeightField(float x, float z, float fromY, bool& hit, float& height, Vec3* normal) const {
+    const HeightField& hf = _heightField;
+    if (hf.cols < 2) return false;
+
+    const float fx = (x - hf.originX) / hf.cellSize;
+    const float fz = (z - hf.originZ) / hf.cellSize;
+    const int c = (int)std::floor(fx);
+    const int r = (int)std::floor(fz);
+    if (c < 0 || r < 0 || c >= hf.cols - 1 || r >= hf.rows - 1 || hf.cellFlags[r * (hf.cols - 1) + c]) return false;
+
+    const float tx = fx - c;
+    const float tz = fz - r;
+    const float* row0 = hf.heights + r * hf.cols + c;
+    const float* row1 = row0 + hf.cols;
+    const float h00 = row0[0], h10 = row0[1];
+    const float h01 = row1[0], h11 = row1[1];
+
+    const float h0 = h00 + (h10 - h00) * tx;
+    const float h1 = h01 + (h11 - h01) * tx;
+    const float h = h0 + (h1 - h0) * tz;
+    // 单层单元：地面高于查询起点即视为没有地面（与向下射线语义一致）
+    hit = h <= fromY;
+    if (!hit) return true;
+
+    height = h;
+    if (normal) {
+        const float dhdx = ((h10 - h00) * (1.0f - tz) + (h11 - h01) * tz) / hf.cellSize;
+        const float dhdz = (h1 - h0) / hf.cellSize;
+        *normal = Vec3(-dhdx, 1.0f, -dhdz);
+        normal->normalize();
+    }
+    return true;
 }
 
 /**
@@ -223,9 +1233,10 @@ bool TerrainCollider::rayIntersects(const CustomRay& ray, float& hitDist) {
  * 此算法不需要计算平面方程，效率极高。
  * @param t 返回相交点在射线方向上的参数值（距离 = t * |direction|）
  */
-bool TerrainCollider::intersectTriangle(const CustomRay& ray, const Triangle& tri, float& t) {
-    Vec3 edge1 = tri.v1 - tri.v0;
-    Vec3 edge2 = tri.v2 - tri.v0;
+bool TerrainCollider::intersectTriangle(const CustomRay& ray, int triIdx, float& t) const {
+    Vec3 v0(_soa.v0x[triIdx], _soa.v0y[triIdx], _soa.v0z[triIdx]);
+    Vec3 edge1(_soa.e1x[triIdx], _soa.e1y[triIdx], _soa.e1z[triIdx]);
+    Vec3 edge2(_soa.e2x[triIdx], _soa.e2y[triIdx], _soa.e2z[triIdx]);
     Vec3 h, s, q;
     float a, f, u, v;
     
@@ -236,7 +1247,7 @@ bool TerrainCollider::intersectTriangle(const CustomRay& ray, const Triangle& tr
     if (a > -0.00001f && a < 0.00001f) return false;
     
     f = 1.0f / a;
-    s = ray.origin - tri.v0;
+    s = ray.origin - v0;
     u = f * s.dot(h);
     
     // 检查重心坐标 u 是否在三角形内部
@@ -2,7 +2,9 @@
 #define __COLLIDER_H__
 
 #include "cocos2d.h"
+#include "CookedCollisionMesh.h"
 #include <vector>
+#include <float.h>
 
 /**
  * @class CustomRay
@@ -16,6 +18,23 @@ public:
     CustomRay(const cocos2d::Vec3& o, const cocos2d::Vec3& d) : origin(o), direction(d) {}
 };
 
+/**
+ * @class GroundSnapListener
+ * @brief 地面贴合请求的回调接口（Character / Enemy 实现）
+ */
+class GroundSnapListener {
+public:
+    virtual ~GroundSnapListener() = default;
+
+    /**
+     * @brief 批量射线检测完成后回调
+     * @param hit 是否检测到地面
+     * @param groundY 地面高度（hit 为 false 时无意义）
+     * @param groundNormal 地面单位法线（hit 为 false 时无意义）
+     */
+    virtual void onGroundSnap(bool hit, float groundY, const cocos2d::Vec3& groundNormal) = 0;
+};
+
 /**
  * @class TerrainCollider
  * @brief 处理 3D 地形碰撞的类
@@ -23,9 +42,41 @@ public:
 class TerrainCollider : public cocos2d::Ref {
 public:
     static TerrainCollider* create(cocos2d::Sprite3D* terrainModel, const std::string& objFilePath = "");
-    
+
+    TerrainCollider();
+    virtual ~TerrainCollider();
+
     bool init(cocos2d::Sprite3D* terrainModel, const std::string& objFilePath);
 
+    /**
+     * @brief 烘焙：解析 .obj、构建 BVH 并写出二进制碰撞网格（.wkcol）
+     * 离线使用时（见 CampScene::cookCollisionMeshes）输出到 .obj 同目录并随资源发布；
+     * 运行时缺少可用烘焙文件时，init 也会调用它写入可写目录的缓存
+     * @param objFilePath .obj 文件路径
+     * @param scale 地形模型缩放（与场景中一致）
+     * @param position 地形模型位置（与场景中一致）
+     * @param outPath 输出文件完整路径
+     * @return bool 是否成功
+     */
+    static bool cook(const std::string& objFilePath, float scale, const cocos2d::Vec3& position,
+                     const std::string& outPath);
+
+    /**
+     * @brief 将当前碰撞网格写为烘焙文件
+     * @param fullPath 输出文件完整路径
+     * @param source 源 .obj 的大小与修改时间
+     */
+    bool saveCooked(const std::string& fullPath, const CookedCollisionMesh::SourceStamp& source) const;
+
+    /**
+     * @brief 碰撞网格只读视图（世界空间顶点 xyz 连续存放，三角形索引每 3 个一组）
+     * init 之后网格不再修改，持有本对象期间可在工作线程读取（如导航网格烘焙）
+     */
+    int getVertexCount() const { return _vertexCount; }
+    int getTriangleCount() const { return _triangleCount; }
+    const float* getVertices() const { return _vertices; }
+    const uint32_t* getIndices() const { return _indices; }
+
     /**
      * @brief 射线检测
      * @param ray 射线
@@ -34,27 +85,195 @@ public:
      */
     bool rayIntersects(const CustomRay& ray, float& hitDist);
 
+    /**
+     * @brief 任意方向的射线检测（相机遮挡、投射物、视线判定等共用）
+     * @param origin 射线起点（世界坐标）
+     * @param dir 射线方向（内部会归一化）
+     * @param maxDist 最大检测距离
+     * @param hitDist 输出（可选）：起点到最近碰撞点的距离
+     * @param hitNormal 输出（可选）：碰撞三角形的单位法线
+     * @return bool 在 maxDist 内是否碰撞
+     */
+    bool raycast(const cocos2d::Vec3& origin, const cocos2d::Vec3& dir, float maxDist,
+                 float* hitDist = nullptr, cocos2d::Vec3* hitNormal = nullptr) const;
+
+    /**
+     * @brief 查询 (x, z) 处的地面高度
+     * 单层地形区域直接对预烘焙的高度场做双线性插值（O(1)）；
+     * 高度场之外、悬垂/多层结构或插值误差过大的单元回退为向下射线检测
+     * @param x 世界坐标 X
+     * @param z 世界坐标 Z
+     * @param height 输出：地面高度
+     * @param normal 输出（可选）：地面单位法线
+     * @param fromY 只查找不高于该高度的地面（相当于射线起点），默认不限制
+     * @return bool 是否存在地面
+     */
+    bool getGroundHeight(float x, float z, float& height, cocos2d::Vec3* normal = nullptr,
+                         float fromY = FLT_MAX) const;
+
+    /**
+     * @brief 批量射线检测：射线按 SIMD 宽度打包（AVX 8 条 / SSE 4 条），整包共同遍历 BVH，
+     * 叶子中每个三角形一次与整包射线求交
+     * @param rays 射线数组
+     * @param count 射线数量
+     * @param hitDists 输出：每条射线的碰撞距离（以方向长度为单位），未命中写入 -1
+     * @param hitTriangles 输出（可选）：每条射线命中的三角形下标，未命中写入 -1
+     * @return int 命中的射线数量
+     */
+    int rayIntersectsBatch(const CustomRay* rays, int count, float* hitDists, int* hitTriangles = nullptr) const;
+
+    /**
+     * @brief 提交一次向下的贴地检测，本帧所有请求在 update 中统一处理
+     * @param owner 请求者节点（排队期间会被 retain）
+     * @param listener 结果回调
+     * @param pos 待检测的世界坐标（射线从其上方 500 单位向下发射）
+     */
+    void requestGroundSnap(cocos2d::Node* owner, GroundSnapListener* listener, const cocos2d::Vec3& pos);
+
+    /**
+     * @brief 每帧在所有角色 update 之后执行，批量处理贴地请求
+     * 高度场能直接回答的请求就地求值，其余请求的向下射线交给 rayIntersectsBatch 一次处理
+     */
+    void update(float dt);
+
 private:
-    cocos2d::Sprite3D* _terrain;
-    // 这里可以存储简化的物理网格数据
-    struct Triangle {
-        cocos2d::Vec3 v0, v1, v2;
-        float minX, maxX, minZ, maxZ; // 预计算的 XZ 边界，用于快速过滤
-    };
-    std::vector<Triangle> _triangles;
+    cocos2d::Sprite3D* _terrain = nullptr;
+
+    // 碰撞网格以只读视图访问：指向下方 _owned* 容器（由 .obj 构建）或映射的烘焙文件
+    int _vertexCount = 0;
+    int _triangleCount = 0;
+    const float* _vertices = nullptr;       // 世界空间顶点，xyz 连续存放
+    const uint32_t* _indices = nullptr;     // 三角形索引，每 3 个一组，BVH 叶子顺序
+
+    std::vector<float> _ownedVertices;
+    std::vector<uint32_t> _ownedIndices;
+    MappedFile _cookedFile;
+
+    // 顶点烘焙时使用的地形变换（写入烘焙文件头用于校验）
+    float _meshScale = 1.0f;
+    cocos2d::Vec3 _meshPosition;
+
+    void bindOwnedMesh();
 
     void extractTriangles(cocos2d::Sprite3D* model);
-    bool loadFromObj(const std::string& objFilePath);
-    bool intersectTriangle(const CustomRay& ray, const Triangle& tri, float& t);
+    bool loadFromObj(const std::string& objFilePath, float scale, const cocos2d::Vec3& position);
+    /**
+     * @brief 映射烘焙文件
+     * @param checkMTime 是否校验源文件修改时间（随资源发布的文件经打包 / 安装后修改时间不可靠，只校验大小）
+     */
+    bool loadCooked(const std::string& fullPath, const CookedCollisionMesh::SourceStamp& source, bool checkMTime,
+                    float scale, const cocos2d::Vec3& position);
+    bool intersectTriangle(const CustomRay& ray, int triIdx, float& t) const;
+    cocos2d::Vec3 triangleVertex(int triIdx, int corner) const;
+
+    /**
+     * @brief BVH 节点（扁平存储，32 字节）
+     * count > 0 为叶子：三角形区间 [leftFirst, leftFirst + count)
+     * count == 0 为内部节点：左孩子为 leftFirst，右孩子为 leftFirst + 1
+     */
+    struct BVHNode {
+        float minX, minY, minZ;
+        int leftFirst;
+        float maxX, maxY, maxZ;
+        int count;
+    };
+    const BVHNode* _bvhNodes = nullptr;
+    int _bvhNodeCount = 0;
+    int _bvhDepth = 0;      // 根到最深叶子的边数，即遍历栈所需的最大深度
+    std::vector<BVHNode> _ownedNodes;
+
+    /**
+     * @brief 三角形的 SoA 数据（BVH 顺序），供 SIMD 一次测试 4 个三角形
+     * 每个分量末尾补齐至少 3 个退化三角形，叶子起点处可直接读取 4 个连续元素
+     */
+    struct TriangleSoA {
+        const float *v0x, *v0y, *v0z;
+        const float *e1x, *e1y, *e1z;
+        const float *e2x, *e2y, *e2z;
+    } _soa = {};
+    int _soaStride = 0;
+    std::vector<float> _ownedSoA;
+
+    void buildSoA();
+    void bindSoA(const float* base, int stride);
+
+    /**
+     * @brief 2.5D 高度场：覆盖网格 XZ 范围的规则采样，每个单元带回退标记
+     */
+    struct HeightField {
+        int cols = 0;               // X 方向采样数
+        int rows = 0;               // Z 方向采样数
+        float originX = 0.0f;       // 第 0 个采样点的世界坐标
+        float originZ = 0.0f;
+        float cellSize = 0.0f;      // 采样间距
+        const float* heights = nullptr;     // cols * rows，行优先（Z 为行）
+        const uint8_t* cellFlags = nullptr; // (cols - 1) * (rows - 1)，非 0 表示该单元需回退射线检测
+    } _heightField;
+    std::vector<float> _ownedHeights;
+    std::vector<uint8_t> _ownedCellFlags;
+
+    void buildHeightField();
+
+    /**
+     * @brief 高度场查询（单层单元内双线性插值）
+     * @return bool 高度场能否回答该查询；返回 false 时需回退射线检测
+     */
+    bool sampleHeightField(float x, float z, float fromY, bool& hit, float& height, cocos2d::Vec3* normal) const;
+
+    /**
+     * @brief 向下射线检测，返回 fromY 以下最高的地面
+     */
+    bool rayGroundHeight(float x, float z, float fromY, float& height, cocos2d::Vec3* normal) const;
+
+    /**
+     * @brief 叶子内三角形求交（SSE 下 4 个一组），返回 (0, tHit) 内最近的三角形下标
+     */
+    int intersectLeaf(const CustomRay& ray, int first, int count, float& tHit) const;
+
+    /**
+     * @brief 一包射线（不超过 SIMD 宽度）共同遍历 BVH，任一射线命中节点即进入
+     * @param tHit 输出：每条射线最近命中的参数 t
+     * @param hitTri 输出：每条射线命中的三角形下标，未命中为 -1
+     */
+    void intersectPacket(const CustomRay* rays, int count, float* tHit, int* hitTri) const;
 
-    // 空间网格优化
-    struct Grid {
-        float minX, minZ, cellSize;
-        int cols, rows;
-        std::vector<std::vector<int>> cells; // 每个格子存储三角形索引
-    } _grid;
+    /**
+     * @brief 三角形单位法线，朝向射线来的一侧
+     */
+    cocos2d::Vec3 triangleNormal(int triIdx, const cocos2d::Vec3& rayDir) const;
 
-    void buildGrid();
+    struct GroundSnapRequest {
+        cocos2d::Node* owner;
+        GroundSnapListener* listener;
+        cocos2d::Vec3 pos;
+    };
+    std::vector<GroundSnapRequest> _snapRequests;
+
+    // 贴地批处理的临时数据，成员持有以复用容量
+    struct GroundSnapResult {
+        bool hit;
+        float groundY;
+        cocos2d::Vec3 normal;
+    };
+    std::vector<GroundSnapResult> _snapResults;
+    std::vector<CustomRay> _snapRays;
+    std::vector<int> _snapRayRequests;      // 每条回退射线对应的请求下标
+    std::vector<float> _snapRayDists;
+    std::vector<int> _snapRayTriangles;
+
+    void buildBVH();
+    void updateNodeBounds(int nodeIdx);
+    void subdivideNode(int nodeIdx, std::vector<cocos2d::Vec3>& centroids);
+
+    /**
+     * @brief 计算 _bvhDepth（要求孩子下标大于父节点，构建与烘焙文件校验均保证这一点）
+     */
+    void computeBVHDepth();
+
+    /**
+     * @brief BVH 遍历，返回 (0, tMax) 内最近命中的三角形下标，未命中返回 -1
+     */
+    int traverseBVH(const CustomRay& ray, float tMax, float& tHit) const;
 };
 
 #endif // __COLLIDER_H__
@@ -1,7 +1,8 @@
 #include "CombatComponent.h"
 #include "HealthComponent.h"
-#include "../player/Character.h"
-#include "../enemy/Enemy.h"
+
+// 近战攻击在攻击者 AABB 基础上向 XZ 四周外扩的距离
+static const float kMeleeReach = 30.0f;
 
 /**
  * @brief CombatComponent构造函数
@@ -145,8 +146,21 @@ bool CombatComponent::attack(Node* target) {
     }
 
     // 默认攻击逻辑
-    // 1. 获取目标的健康组件
+    // 1. 获取目标的健康组件与战斗组件
     HealthComponent* targetHealth = dynamic_cast<HealthComponent*>(target->getComponent("HealthComponent"));
+    CombatComponent* targetCombat = dynamic_cast<CombatComponent*>(target->getComponent("CombatComponent"));
+    return applyAttack(target, targetHealth, targetCombat);
+}
+
+/**
+ * @brief 攻击结算
+ * @details 目标组件由调用方提供（attack 内部查找，或宽相位登记时缓存）
+ * @param target 攻击目标节点
+ * @param targetHealth 目标健康组件
+ * @param targetCombat 目标战斗组件（可为空，视为无防御）
+ * @return bool 是否成功造成伤害
+ */
+bool CombatComponent::applyAttack(Node* target, HealthComponent* targetHealth, CombatComponent* targetCombat) {
     if (!targetHealth || targetHealth->isDead()) {
         return false;  // 目标没有健康组件或已死亡
     }
@@ -155,14 +169,12 @@ bool CombatComponent::attack(Node* target) {
     float totalDamage = _attackPower + _weaponDamage;
 
     // 3. 检查是否触发暴击
-    if (rand() % 100 < _critRate * 100) {
+    if (CombatSystem::randomUnit() < _critRate) {
         totalDamage *= _critDamage;
-        CCLOG("Critical hit! Damage: %f", totalDamage);
     }
 
     // 4. 获取目标的防御值（从目标的CombatComponent获取）
     float targetDefense = 0.0f;
-    CombatComponent* targetCombat = dynamic_cast<CombatComponent*>(target->getComponent("CombatComponent"));
     if (targetCombat) {
         targetDefense = targetCombat->getDefense();
     }
@@ -177,68 +189,71 @@ bool CombatComponent::attack(Node* target) {
 }
 
 /**
- * @brief 执行近战范围攻击
+ * @brief 提交近战范围攻击
+ * @details 攻击判定包围盒与当前属性在提交时确定，命中检测、暴击与防御减免
+ *          由 CombatSystem 在本帧末尾批量完成（自定义攻击回调只作用于 attack）
  * @param attackerCollider 攻击者的碰撞器
- * @param potentialTargets 潜在的目标列表
- * @return int 命中的目标数量
+ * @param targetLayers 可命中的层
+ * @return bool 是否已提交
  */
-int CombatComponent::executeMeleeAttack(const CharacterCollider& attackerCollider, const std::vector<Node*>& potentialTargets) {
-    int hitCount = 0;
-    const AABB& attackerAABB = attackerCollider.worldAABB;
-
-    for (Node* target : potentialTargets) {
-        if (!target || target == this->getOwner()) continue;
-
-        // 1. 检查目标是否具有健康组件且存活
-        HealthComponent* health = dynamic_cast<HealthComponent*>(target->getComponent("HealthComponent"));
-        if (!health || health->isDead()) {
-            CCLOG("MeleeAttack: Target has no HealthComponent or is dead");
-            continue;
-        }
-
-        // 2. 获取目标的 AABB 碰撞体
-        AABB targetAABB;
-        bool hasCollider = false;
-
-        auto character = dynamic_cast<Character*>(target);
-        if (character) {
-            targetAABB = character->getCollider().worldAABB;
-            hasCollider = true;
-        } else {
-            auto enemy = dynamic_cast<Enemy*>(target);
-            if (enemy) {
-                targetAABB = enemy->getCollider().worldAABB;
-                hasCollider = true;
-            }
-        }
-
-        if (!hasCollider) {
-            CCLOG("MeleeAttack: Target has no collider");
-            continue;
-        }
-
-        // 3. 碰撞检测：增加一定的攻击范围（膨胀 AABB）
-        // 我们给攻击者 AABB 在 XZ 轴上各增加 30 像素的“触手”范围
-        AABB attackAABB = attackerAABB;
-        attackAABB._min.x -= 30.0f;
-        attackAABB._max.x += 30.0f;
-        attackAABB._min.z -= 30.0f;
-        attackAABB._max.z += 30.0f;
-
-        if (attackAABB.intersects(targetAABB)) {
-            CCLOG("MeleeAttack: Hit detected! Dealing damage.");
-            // 4. 执行攻击结算
-            if (this->attack(target)) {
-                hitCount++;
-            }
-        } else {
-            // 调试日志，帮助判断距离
-            float dist = this->getOwner()->getPosition3D().distance(target->getPosition3D());
-            CCLOG("MeleeAttack: No intersection. Distance: %.2f", dist);
-        }
-    }
+bool CombatComponent::queueMeleeAttack(const CharacterCollider& attackerCollider, unsigned int targetLayers) {
+    if (!_combatSystem || !this->getOwner()) return false;
+
+    HitRequest request = makeHitRequest(targetLayers);
+    request.attacker = this->getOwner();
+    request.shape = HitRequest::SHAPE_AABB;
+    request.box = meleeAABB(attackerCollider.worldAABB);
+    _combatSystem->submit(request);
+    return true;
+}
 
-    return hitCount;
+/**
+ * @brief 提交球形范围攻击
+ * @param center 世界空间球心
+ * @param radius 半径
+ * @param targetLayers 可命中的层
+ * @param damageScale 伤害倍率
+ * @return bool 是否已提交
+ */
+bool CombatComponent::queueAreaAttack(const Vec3& center, float radius, unsigned int targetLayers, float damageScale) {
+    if (!_combatSystem || !this->getOwner()) return false;
+
+    HitRequest request = makeHitRequest(targetLayers, damageScale);
+    request.attacker = this->getOwner();
+    request.shape = HitRequest::SHAPE_SPHERE;
+    request.center = center;
+    request.radius = radius;
+    _combatSystem->submit(request);
+    return true;
+}
+
+/**
+ * @brief 以当前属性生成请求模板
+ * @param targetLayers 可命中的层
+ * @param damageScale 伤害倍率
+ * @return HitRequest 已填好伤害、暴击、防御与目标层的请求
+ */
+HitRequest CombatComponent::makeHitRequest(unsigned int targetLayers, float damageScale) const {
+    HitRequest request;
+    request.targetLayers = targetLayers;
+    request.damage = (_attackPower + _weaponDamage) * damageScale;
+    request.critRate = _critRate;
+    request.critDamage = _critDamage;
+    request.applyDefense = true;
+    return request;
+}
+
+/**
+ * @brief 攻击判定包围盒
+ * @details 给攻击者 AABB 在 XZ 轴上各增加 30 像素的“触手”范围
+ */
+AABB CombatComponent::meleeAABB(const AABB& attackerAABB) {
+    AABB attackAABB = attackerAABB;
+    attackAABB._min.x -= kMeleeReach;
+    attackAABB._max.x += kMeleeReach;
+    attackAABB._min.z -= kMeleeReach;
+    attackAABB._max.z += kMeleeReach;
+    return attackAABB;
 }
 
 /**
@@ -262,6 +277,16 @@ void CombatComponent::setAttackCallback(const AttackCallback& callback) {
  *       这种公式确保防御越高，收益递减，避免出现防御无敌的情况
  */
 float CombatComponent::calculateDamage(float baseDamage, float targetDefense) const {
+    return applyDefense(baseDamage, targetDefense);
+}
+
+/**
+ * @brief 防御减免公式
+ * @param baseDamage 基础伤害值
+ * @param targetDefense 目标防御值
+ * @return float 最终伤害值
+ */
+float CombatComponent::applyDefense(float baseDamage, float targetDefense) {
     // 伤害减免比例 = 防御 / (防御 + 100)
     // 当防御为0时，减免0%；当防御为100时，减免50%；当防御为200时，减免66.7%...
     float damageReduction = targetDefense / (targetDefense + 100.0f);
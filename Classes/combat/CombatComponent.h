@@ -2,6 +2,8 @@
 
 #include "cocos2d.h"
 #include "CharacterCollider.h"
+#include "BroadPhase.h"
+#include "CombatSystem.h"
 #include <vector>
 #include <functional>
 #include <unordered_map>
@@ -44,16 +46,44 @@ public:
     bool attack(Node* target);
 
     /**
-     * @brief 执行近战范围攻击
+     * @brief 设置战斗结算管线（由场景持有，组件只保存引用）
+     */
+    void setCombatSystem(CombatSystem* combatSystem) { _combatSystem = combatSystem; }
+    CombatSystem* getCombatSystem() const { return _combatSystem; }
+
+    /**
+     * @brief 提交近战范围攻击，命中与伤害在本帧末尾由 CombatSystem 批量结算
      * @param attackerCollider 攻击者的碰撞器（提供当前 AABB）
-     * @param potentialTargets 潜在的目标列表
-     * @return int 命中的目标数量
+     * @param targetLayers 可命中的层（BroadPhase::Layer 组合）
+     * @return bool 是否已提交（未设置 CombatSystem 时为 false）
+     */
+    bool queueMeleeAttack(const CharacterCollider& attackerCollider, unsigned int targetLayers);
+
+    /**
+     * @brief 提交球形范围攻击（范围技能），结算方式同 queueMeleeAttack
+     * @param center 世界空间球心
+     * @param radius 半径
+     * @param targetLayers 可命中的层
+     * @param damageScale 伤害倍率（乘在攻击强度 + 武器伤害上）
+     * @return bool 是否已提交
      */
-    int executeMeleeAttack(const CharacterCollider& attackerCollider, const std::vector<Node*>& potentialTargets);
+    bool queueAreaAttack(const Vec3& center, float radius, unsigned int targetLayers, float damageScale = 1.0f);
+
+    /**
+     * @brief 以当前属性生成请求模板（伤害、暴击与防御字段），供 WeaponSweep 等自行提交
+     * @param targetLayers 可命中的层
+     * @param damageScale 伤害倍率
+     */
+    HitRequest makeHitRequest(unsigned int targetLayers, float damageScale = 1.0f) const;
 
     void setAttackCallback(const AttackCallback& callback);
     bool castSkill(const std::string& skillName, Node* target = nullptr);
     float calculateDamage(float baseDamage, float targetDefense) const;
+
+    /**
+     * @brief 防御减免公式（批量结算与单体攻击共用）
+     */
+    static float applyDefense(float baseDamage, float targetDefense);
     float getWeaponDamage() const;
     void setWeaponDamage(float damage);
 
@@ -65,6 +95,18 @@ protected:
     float _weaponDamage;
 
     AttackCallback _attackCallback;
+
+    CombatSystem* _combatSystem = nullptr;  ///< 战斗结算管线（只是引用）
+
+    /**
+     * @brief 攻击结算（目标组件已知）
+     */
+    bool applyAttack(Node* target, HealthComponent* targetHealth, CombatComponent* targetCombat);
+
+    /**
+     * @brief 攻击判定包围盒：攻击者 AABB 在 XZ 轴上外扩攻击距离
+     */
+    static AABB meleeAABB(const AABB& attackerAABB);
 };
 
 
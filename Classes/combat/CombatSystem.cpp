@@ -0,0 +1,275 @@
+#include "CombatSystem.h"
+#include "CombatComponent.h"
+#include "HealthComponent.h"
+#include "base/CCJobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+USING_NS_CC;
+
+// 在宽相位重建（优先级 2）之后执行，查询使用本帧最终位置
+static const int kCombatPriority = 3;
+// 少于该数量的目标对直接在主线程计算，分发开销不划算
+static const int kParallelMinPairs = 64;
+static const int kComputeGrainSize = 32;
+// 扫掠胶囊沿轴向的最多分段数（采样数为分段数 + 1）
+static const int kMaxSweepSegments = 16;
+
+namespace {
+    // xorshift32，每个线程一份状态，首次使用时按线程 id 与时间播种
+    thread_local uint32_t t_rngState = 0;
+
+    uint32_t nextRandom() {
+        uint32_t x = t_rngState;
+        if (x == 0) {
+            x = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                (uint32_t)std::chrono::steady_clock::now().time_since_epoch().count();
+            if (x == 0) x = 0x9E3779B9u;
+        }
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        t_rngState = x;
+        return x;
+    }
+}
+
+float CombatSystem::randomUnit() {
+    // 取高 24 位，保证结果严格小于 1
+    return (float)(nextRandom() >> 8) * (1.0f / 16777216.0f);
+}
+
+CombatSystem* CombatSystem::create(BroadPhase* broadPhase) {
+    auto pRet = new (std::nothrow) CombatSystem();
+    if (pRet && pRet->init(broadPhase)) {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return nullptr;
+}
+
+CombatSystem::CombatSystem() {
+}
+
+CombatSystem::~CombatSystem() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& r : _requests) {
+        r.attacker->release();
+    }
+    CC_SAFE_RELEASE(_broadPhase);
+}
+
+bool CombatSystem::init(BroadPhase* broadPhase) {
+    if (!broadPhase) return false;
+    _broadPhase = broadPhase;
+    _broadPhase->retain();
+
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, kCombatPriority, false);
+    return true;
+}
+
+void CombatSystem::submit(const HitRequest& request) {
+    if (!request.attacker) return;
+    request.attacker->retain();
+    _requests.push_back(request);
+}
+
+unsigned int CombatSystem::beginSwing() {
+    unsigned int id = _nextSwingId++;
+    if (_nextSwingId == 0) _nextSwingId = 1;
+    return id;
+}
+
+void CombatSystem::endSwing(unsigned int swingId) {
+    if (swingId != 0) {
+        _endedSwings.push_back(swingId);
+    }
+}
+
+bool CombatSystem::consumeSwingHit(unsigned int swingId, Node* target) {
+    if (swingId == 0) return true;
+    for (const auto& h : _swingHits) {
+        if (h.swingId == swingId && h.target == target) return false;
+    }
+    _swingHits.push_back(SwingHit{ swingId, target });
+    return true;
+}
+
+AABB CombatSystem::sweptBounds(const HitRequest& r) {
+    AABB box;
+    box._min = box._max = r.prevA;
+    const Vec3* pts[] = { &r.prevB, &r.currA, &r.currB };
+    for (const Vec3* p : pts) {
+        box._min.x = std::min(box._min.x, p->x); box._max.x = std::max(box._max.x, p->x);
+        box._min.y = std::min(box._min.y, p->y); box._max.y = std::max(box._max.y, p->y);
+        box._min.z = std::min(box._min.z, p->z); box._max.z = std::max(box._max.z, p->z);
+    }
+    int samples;
+    const float radius = sweepRadius(r, samples);
+    box._min -= Vec3(radius, radius, radius);
+    box._max += Vec3(radius, radius, radius);
+    return box;
+}
+
+/**
+ * 轴向采样数与检测半径：采样间距不超过检测半径。
+ * 长武器配小半径时分段数按上限截断，此时把检测半径放大到采样间距（命中略偏宽松）。
+ */
+float CombatSystem::sweepRadius(const HitRequest& r, int& samples) {
+    const float axisLen = std::max(r.prevA.distance(r.prevB), r.currA.distance(r.currB));
+    samples = 1;
+    if (axisLen <= 0.0f) return r.radius;
+
+    int segments = r.radius > 0.0f ? (int)std::ceil(axisLen / r.radius) : kMaxSweepSegments;
+    segments = std::max(1, std::min(kMaxSweepSegments, segments));
+    samples = segments + 1;
+    return std::max(r.radius, axisLen / segments);
+}
+
+/**
+ * 连续检测：胶囊轴上的采样点从上一帧位置移动到本帧位置，各自扫出一条线段，
+ * 与按检测半径外扩后的目标包围盒做线段-包围盒（slab）检测。
+ * 采样间距不超过检测半径（见 sweepRadius），轴上任一点都被某个采样点的球覆盖，
+ * 不会因帧间位移过大而穿过目标。
+ */
+bool CombatSystem::sweptCapsuleHits(const HitRequest& r, const AABB& target) {
+    int samples;
+    const float radius = sweepRadius(r, samples);
+
+    const Vec3 lo = target._min - Vec3(radius, radius, radius);
+    const Vec3 hi = target._max + Vec3(radius, radius, radius);
+
+    for (int s = 0; s < samples; ++s) {
+        const float u = samples > 1 ? (float)s / (float)(samples - 1) : 0.0f;
+        const Vec3 p0 = r.prevA + (r.prevB - r.prevA) * u;
+        const Vec3 p1 = r.currA + (r.currB - r.currA) * u;
+        const Vec3 d = p1 - p0;
+
+        float tMin = 0.0f;
+        float tMax = 1.0f;
+        bool hit = true;
+        const float o[3] = { p0.x, p0.y, p0.z };
+        const float v[3] = { d.x, d.y, d.z };
+        const float bmin[3] = { lo.x, lo.y, lo.z };
+        const float bmax[3] = { hi.x, hi.y, hi.z };
+        for (int a = 0; a < 3 && hit; ++a) {
+            if (std::fabs(v[a]) < 1e-6f) {
+                hit = o[a] >= bmin[a] && o[a] <= bmax[a];
+            } else {
+                float t0 = (bmin[a] - o[a]) / v[a];
+                float t1 = (bmax[a] - o[a]) / v[a];
+                if (t0 > t1) std::swap(t0, t1);
+                tMin = std::max(tMin, t0);
+                tMax = std::min(tMax, t1);
+                hit = tMin <= tMax;
+            }
+        }
+        if (hit) return true;
+    }
+    return false;
+}
+
+void CombatSystem::gather() {
+    _pairRequest.clear();
+    _pairTarget.clear();
+    _pairHealth.clear();
+    _pairDefense.clear();
+
+    for (size_t i = 0; i < _resolving.size(); ++i) {
+        const HitRequest& r = _resolving[i];
+        // 宽相位查询已去重，并用目标当前的 worldAABB 做了精确检测
+        if (r.shape == HitRequest::SHAPE_SPHERE) {
+            _broadPhase->queryRadius(r.center, r.radius, r.targetLayers, _candidates, r.attacker);
+        } else if (r.shape == HitRequest::SHAPE_SWEPT_CAPSULE) {
+            _broadPhase->queryAABB(sweptBounds(r), r.targetLayers, _candidates, r.attacker);
+        } else {
+            _broadPhase->queryAABB(r.box, r.targetLayers, _candidates, r.attacker);
+        }
+
+        for (const auto& p : _candidates) {
+            if (!p.health || p.health->isDead()) continue;
+            if (r.shape == HitRequest::SHAPE_SWEPT_CAPSULE && !sweptCapsuleHits(r, p.collider->worldAABB)) {
+                continue;
+            }
+            _pairRequest.push_back((int)i);
+            _pairTarget.push_back(p.owner);
+            _pairHealth.push_back(p.health);
+            _pairDefense.push_back(p.combat ? p.combat->getDefense() : 0.0f);
+        }
+    }
+}
+
+void CombatSystem::compute() {
+    const int count = (int)_pairRequest.size();
+    _pairDamage.resize(count);
+
+    const HitRequest* requests = _resolving.data();
+    const int* pairRequest = _pairRequest.data();
+    const float* defense = _pairDefense.data();
+    float* damage = _pairDamage.data();
+
+    auto resolve = [requests, pairRequest, defense, damage](int k) {
+        const HitRequest& r = requests[pairRequest[k]];
+        float d = r.damage;
+        if (r.critRate > 0.0f && randomUnit() < r.critRate) {
+            d *= r.critDamage;
+        }
+        damage[k] = r.applyDefense ? CombatComponent::applyDefense(d, defense[k]) : d;
+    };
+
+    if (count >= kParallelMinPairs) {
+        JobSystem::getInstance()->parallelFor(count, resolve, kComputeGrainSize);
+    } else {
+        for (int k = 0; k < count; ++k) {
+            resolve(k);
+        }
+    }
+}
+
+int CombatSystem::commit() {
+    int hits = 0;
+    for (size_t k = 0; k < _pairRequest.size(); ++k) {
+        // 同批次中先结算的伤害可能已击杀目标
+        HealthComponent* health = _pairHealth[k];
+        if (health->isDead()) continue;
+        const HitRequest& r = _resolving[_pairRequest[k]];
+        if (!consumeSwingHit(r.swingId, _pairTarget[k])) continue;
+        health->takeDamage(_pairDamage[k], r.attacker);
+        ++hits;
+    }
+    return hits;
+}
+
+void CombatSystem::update(float dt) {
+    _resolving.swap(_requests);
+    _requests.clear();
+
+    int hits = 0;
+    if (!_resolving.empty()) {
+        gather();
+        compute();
+        hits = commit();
+    }
+
+    for (auto& r : _resolving) {
+        r.attacker->release();
+    }
+    _lastFrameRequests = (int)_resolving.size();
+    _lastFrameHits = hits;
+    _resolving.clear();
+
+    // 清除已结束挥击的命中记录
+    if (!_endedSwings.empty()) {
+        const auto& ended = _endedSwings;
+        _swingHits.erase(std::remove_if(_swingHits.begin(), _swingHits.end(),
+                                        [&ended](const SwingHit& h) {
+                                            return std::find(ended.begin(), ended.end(), h.swingId) != ended.end();
+                                        }),
+                         _swingHits.end());
+        _endedSwings.clear();
+    }
+}
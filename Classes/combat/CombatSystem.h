@@ -0,0 +1,128 @@
+#ifndef __COMBAT_SYSTEM_H__
+#define __COMBAT_SYSTEM_H__
+
+#include "cocos2d.h"
+#include "BroadPhase.h"
+#include <stdint.h>
+#include <vector>
+
+class HealthComponent;
+
+/**
+ * @struct HitRequest
+ * @brief 一次攻击判定请求：攻击者在本帧提交，由 CombatSystem 统一结算
+ *
+ * 伤害属性在提交时从攻击者拷贝，结算时不再访问攻击者的组件。
+ */
+struct HitRequest {
+    enum Shape {
+        SHAPE_AABB,             ///< 包围盒判定（近战）
+        SHAPE_SPHERE,           ///< 球形判定（范围技能）
+        SHAPE_SWEPT_CAPSULE     ///< 胶囊从上一帧位置扫掠到本帧位置（武器挥击，见 WeaponSweep）
+    };
+
+    cocos2d::Node* attacker = nullptr;  ///< 攻击者（排队期间被 retain，且不会命中自身）
+    Shape shape = SHAPE_AABB;
+    cocos2d::AABB box;                  ///< SHAPE_AABB 的世界空间包围盒
+    cocos2d::Vec3 center;               ///< SHAPE_SPHERE 的世界空间球心
+    cocos2d::Vec3 prevA, prevB;         ///< SHAPE_SWEPT_CAPSULE 上一帧的胶囊端点
+    cocos2d::Vec3 currA, currB;         ///< SHAPE_SWEPT_CAPSULE 本帧的胶囊端点
+    float radius = 0.0f;                ///< SHAPE_SPHERE / SHAPE_SWEPT_CAPSULE 的半径
+    unsigned int targetLayers = BroadPhase::LAYER_ALL;  ///< 可命中的层
+    unsigned int swingId = 0;           ///< 所属挥击（非 0 时同一挥击对同一目标只命中一次）
+    float damage = 0.0f;                ///< 基础伤害
+    float critRate = 0.0f;              ///< 暴击率（0~1）
+    float critDamage = 1.0f;            ///< 暴击倍率
+    bool applyDefense = true;           ///< 是否按目标防御减免
+};
+
+/**
+ * @class CombatSystem
+ * @brief 战斗结算管线：攻击只提交请求，每帧批量结算
+ *
+ * 每帧在宽相位重建之后执行，分三个阶段：
+ * 1. 收集：逐个请求查询宽相位，得到（请求, 目标）对，并拷贝目标防御与生命组件；
+ * 2. 计算：在连续数组上掷暴击、计算防御减免，数量多时分给 JobSystem 并行，
+ *    每个线程使用自己的随机数状态；
+ * 3. 提交：在主线程按顺序调用 HealthComponent::takeDamage，受伤 / 死亡回调只在这里触发。
+ * 同一请求对同一目标只命中一次；跨多帧的挥击用 beginSwing / endSwing 标识，整次挥击内去重。
+ */
+class CombatSystem : public cocos2d::Ref {
+public:
+    /**
+     * @brief 创建战斗结算管线
+     * @param broadPhase 场景宽相位（被 retain）
+     */
+    static CombatSystem* create(BroadPhase* broadPhase);
+
+    CombatSystem();
+    virtual ~CombatSystem();
+
+    bool init(BroadPhase* broadPhase);
+
+    /**
+     * @brief 提交攻击判定请求，在本帧末尾结算
+     */
+    void submit(const HitRequest& request);
+
+    /**
+     * @brief 开始一次挥击，返回的 ID 填入该挥击各帧请求的 swingId
+     */
+    unsigned int beginSwing();
+
+    /**
+     * @brief 结束挥击，其命中记录在本帧结算之后清除（本帧已提交的请求仍按该挥击去重）
+     */
+    void endSwing(unsigned int swingId);
+
+    /**
+     * @brief 上一帧结算的请求数与造成伤害的次数，用于调试显示
+     */
+    int getLastFrameRequests() const { return _lastFrameRequests; }
+    int getLastFrameHits() const { return _lastFrameHits; }
+
+    /**
+     * @brief 每帧在宽相位重建之后执行
+     */
+    void update(float dt);
+
+    /**
+     * @brief 快速随机数：[0, 1) 均匀分布，每个线程独立状态
+     */
+    static float randomUnit();
+
+private:
+    BroadPhase* _broadPhase = nullptr;
+    std::vector<HitRequest> _requests;   // 本帧已提交
+    std::vector<HitRequest> _resolving;  // 正在结算（提交阶段的回调中再提交的请求留到下一帧）
+    std::vector<BroadPhaseProxy> _candidates;
+
+    // 进行中挥击的命中记录（只用于比较，不持有目标）
+    struct SwingHit {
+        unsigned int swingId;
+        cocos2d::Node* target;
+    };
+    std::vector<SwingHit> _swingHits;
+    std::vector<unsigned int> _endedSwings;
+    unsigned int _nextSwingId = 1;
+
+    // （请求, 目标）对，结构数组布局
+    std::vector<int> _pairRequest;
+    std::vector<cocos2d::Node*> _pairTarget;
+    std::vector<HealthComponent*> _pairHealth;
+    std::vector<float> _pairDefense;
+    std::vector<float> _pairDamage;
+
+    int _lastFrameRequests = 0;
+    int _lastFrameHits = 0;
+
+    bool consumeSwingHit(unsigned int swingId, cocos2d::Node* target);
+    static cocos2d::AABB sweptBounds(const HitRequest& request);
+    static float sweepRadius(const HitRequest& request, int& samples);
+    static bool sweptCapsuleHits(const HitRequest& request, const cocos2d::AABB& target);
+    void gather();
+    void compute();
+    int commit();
+};
+
+#endif // __COMBAT_SYSTEM_H__
@@ -0,0 +1,164 @@
+#include "CookedCollisionMesh.h"
+#include <string.h>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+USING_NS_CC;
+
+namespace CookedCollisionMesh {
+
+    bool validateHeader(const unsigned char* data, size_t size, size_t nodeSize) {
+        if (!data || size < sizeof(CookedMeshHeader)) return false;
+
+        const auto* h = reinterpret_cast<const CookedMeshHeader*>(data);
+        if (memcmp(h->magic, kMagic, sizeof(kMagic)) != 0) return false;
+        if (h->version != kVersion || h->headerSize != sizeof(CookedMeshHeader)) return false;
+        if (h->fileSize != size) return false;
+
+        // 各段必须对齐且完整落在文件内
+        auto sectionOk = [&](uint32_t offset, uint64_t bytes) {
+            return offset % kSectionAlign == 0 && offset >= sizeof(CookedMeshHeader) &&
+                   (uint64_t)offset + bytes <= size;
+        };
+        const uint64_t cells = (h->hfCols > 1 && h->hfRows > 1)
+                             ? (uint64_t)(h->hfCols - 1) * (h->hfRows - 1) : 0;
+        const bool heightFieldOk = (h->hfCols == 0 && h->hfRows == 0) ||
+            (cells > 0 && h->hfCellSize > 0.0f &&
+             sectionOk(h->heightsOffset, (uint64_t)h->hfCols * h->hfRows * sizeof(float)) &&
+             sectionOk(h->cellFlagsOffset, cells));
+        return h->triangleCount > 0 && h->nodeCount > 0 && heightFieldOk &&
+               h->soaStride >= h->triangleCount + 3 &&
+               sectionOk(h->verticesOffset, (uint64_t)h->vertexCount * 3 * sizeof(float)) &&
+               sectionOk(h->indicesOffset, (uint64_t)h->triangleCount * 3 * sizeof(uint32_t)) &&
+               sectionOk(h->nodesOffset, (uint64_t)h->nodeCount * nodeSize) &&
+               sectionOk(h->soaOffset, (uint64_t)h->soaStride * 9 * sizeof(float));
+    }
+
+    SourceStamp stampSourceFile(const std::string& fullPath) {
+        SourceStamp stamp;
+        if (fullPath.empty()) return stamp;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        int wlen = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+        std::wstring wpath(wlen > 0 ? wlen : 0, L'\0');
+        if (wlen > 0) MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &wpath[0], wlen);
+
+        WIN32_FILE_ATTRIBUTE_DATA attr;
+        if (GetFileAttributesExW(wpath.c_str(), GetFileExInfoStandard, &attr)) {
+            // FILETIME 为 1601 年起的 100ns 计数，换算为 Unix 秒
+            uint64_t ticks = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+            stamp.size = attr.nFileSizeLow;
+            stamp.mtime = (uint32_t)(ticks / 10000000ULL - 11644473600ULL);
+            return stamp;
+        }
+#else
+        struct stat st;
+        if (::stat(fullPath.c_str(), &st) == 0) {
+            stamp.size = (uint32_t)st.st_size;
+            stamp.mtime = (uint32_t)st.st_mtime;
+            return stamp;
+        }
+#endif
+
+        // 无法 stat 的路径（APK 内资源）只能拿到大小
+        long size = FileUtils::getInstance()->getFileSize(fullPath);
+        if (size > 0) stamp.size = (uint32_t)size;
+        return stamp;
+    }
+
+    std::string cookedPathFor(const std::string& objFilePath) {
+        size_t dot = objFilePath.find_last_of('.');
+        size_t slash = objFilePath.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return objFilePath + kFileExtension;
+        }
+        return objFilePath.substr(0, dot) + kFileExtension;
+    }
+
+    std::string cachePathFor(const std::string& objFilePath) {
+        std::string name = cookedPathFor(objFilePath);
+        for (auto& c : name) {
+            if (c == '/' || c == '\\' || c == ':') c = '_';
+        }
+        return FileUtils::getInstance()->getWritablePath() + name;
+    }
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& fullPath) {
+    close();
+    if (fullPath.empty()) return false;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    std::wstring wpath(wlen > 0 ? wlen : 0, L'\0');
+    if (wlen > 0) MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &wpath[0], wlen);
+
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                // 映射视图持有对文件的引用，句柄可以立即关闭
+                CloseHandle(mapping);
+                if (view) {
+                    _data = static_cast<const unsigned char*>(view);
+                    _size = (size_t)fileSize.QuadPart;
+                    _mapped = true;
+                }
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                _data = static_cast<const unsigned char*>(addr);
+                _size = (size_t)st.st_size;
+                _mapped = true;
+            }
+        }
+        // 映射建立后即可关闭文件描述符
+        ::close(fd);
+    }
+#endif
+
+    if (_mapped) return true;
+
+    // 回退：整体读入内存（APK 内资源等无法直接映射的情况）
+    _buffer = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (_buffer.isNull()) return false;
+    _data = _buffer.getBytes();
+    _size = (size_t)_buffer.getSize();
+    return true;
+}
+
+void MappedFile::close() {
+    if (_mapped && _data) {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        UnmapViewOfFile(_data);
+#else
+        munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+    }
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+}
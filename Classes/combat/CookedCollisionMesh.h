@@ -0,0 +1,126 @@
+#ifndef __COOKED_COLLISION_MESH_H__
+#define __COOKED_COLLISION_MESH_H__
+
+#include "cocos2d.h"
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief 烘焙碰撞网格文件（.wkcol）格式
+ *
+ * 文件布局（小端序，各数据段按 16 字节对齐，可直接映射后原地使用）：
+ *   CookedMeshHeader
+ *   vertices  : float[vertexCount * 3]         世界空间顶点
+ *   indices   : uint32_t[triangleCount * 3]    三角形索引（BVH 叶子顺序）
+ *   nodes     : BVH 节点[nodeCount]            每个 32 字节，与 TerrainCollider::BVHNode 一致
+ *   soa       : float[9 * soaStride]           v0 / e1 / e2 的 SoA 分量，依次存放
+ *   heights   : float[hfCols * hfRows]         高度场采样（可选，hfCols 为 0 时不存在）
+ *   cellFlags : uint8_t[(hfCols-1)*(hfRows-1)] 高度场单元标记，非 0 表示需回退射线检测
+ */
+namespace CookedCollisionMesh {
+
+    const char kMagic[4] = { 'W', 'K', 'C', 'M' };
+    const uint32_t kVersion = 4;
+    const uint32_t kSectionAlign = 16;
+    const char* const kFileExtension = ".wkcol";
+
+    struct CookedMeshHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t sourceSize;      ///< 烘焙时源 .obj 的字节数，用于判断烘焙数据是否过期
+        uint32_t sourceMTime;     ///< 烘焙时源 .obj 的修改时间（Unix 秒），只对可写目录中的缓存校验
+        float scale;              ///< 烘焙时使用的地形缩放
+        float posX, posY, posZ;   ///< 烘焙时使用的地形位置
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        uint32_t nodeCount;
+        uint32_t soaStride;       ///< 每个 SoA 分量的元素数（含补齐）
+        uint32_t verticesOffset;
+        uint32_t indicesOffset;
+        uint32_t nodesOffset;
+        uint32_t soaOffset;
+        uint32_t hfCols;          ///< 高度场 X 方向采样数
+        uint32_t hfRows;          ///< 高度场 Z 方向采样数
+        float hfOriginX;          ///< 高度场第一个采样点的世界坐标
+        float hfOriginZ;
+        float hfCellSize;         ///< 采样间距
+        uint32_t heightsOffset;
+        uint32_t cellFlagsOffset;
+        uint32_t fileSize;
+    };
+
+    /** @brief 向上对齐到数据段边界 */
+    inline uint32_t alignSection(uint32_t offset) {
+        return (offset + kSectionAlign - 1) & ~(kSectionAlign - 1);
+    }
+
+    /**
+     * @brief 校验头部与文件长度，通过后各段偏移均可安全访问
+     * @param data 文件起始地址
+     * @param size 文件字节数
+     * @param nodeSize BVH 节点结构大小（防止布局变化后误读旧文件）
+     */
+    bool validateHeader(const unsigned char* data, size_t size, size_t nodeSize);
+
+    /**
+     * @brief 源文件的元数据戳：只查询文件属性，不读取内容
+     * 为 0 的字段表示无法获取（如 APK 内资源没有修改时间），校验时跳过
+     */
+    struct SourceStamp {
+        uint32_t size = 0;
+        uint32_t mtime = 0;
+    };
+
+    /**
+     * @brief 读取源文件的大小与修改时间
+     * @param fullPath 文件完整路径
+     */
+    SourceStamp stampSourceFile(const std::string& fullPath);
+
+    /**
+     * @brief 由 .obj 路径得到同目录下的烘焙文件路径（替换扩展名）
+     */
+    std::string cookedPathFor(const std::string& objFilePath);
+
+    /**
+     * @brief 由 .obj 路径得到可写目录下的缓存文件路径（目录分隔符替换为下划线）
+     */
+    std::string cachePathFor(const std::string& objFilePath);
+}
+
+/**
+ * @class MappedFile
+ * @brief 只读文件映射（POSIX mmap / Win32 MapViewOfFile）
+ *
+ * 无法直接映射的路径（如 Android APK 内的资源）回退为 FileUtils 整体读入，
+ * 调用方只通过 data()/size() 访问，不关心具体来源。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 打开并映射文件
+     * @param fullPath 文件完整路径
+     * @return bool 是否成功
+     */
+    bool open(const std::string& fullPath);
+    void close();
+
+    const unsigned char* data() const { return _data; }
+    size_t size() const { return _size; }
+    bool isOpen() const { return _data != nullptr; }
+
+private:
+    const unsigned char* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;          ///< true: 系统映射；false: 读入 _buffer
+    cocos2d::Data _buffer;
+};
+
+#endif // __COOKED_COLLISION_MESH_H__
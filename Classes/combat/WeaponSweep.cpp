@@ -0,0 +1,81 @@
+#include "WeaponSweep.h"
+#include "3d/CCSkeleton3D.h"
+
+USING_NS_CC;
+
+namespace {
+    Vec3 boneWorldPosition(Sprite3D* model, Bone3D* bone) {
+        // 骨骼矩阵位于模型空间，取最近一次求值的姿势
+        Mat4 world = model->getNodeToWorldTransform() * bone->getWorldMat();
+        return Vec3(world.m[12], world.m[13], world.m[14]);
+    }
+}
+
+void WeaponSweep::begin(CombatSystem* combatSystem, Node* owner, Sprite3D* model,
+                        const char* boneFrom, const char* boneTo, float radius, float reach) {
+    end();
+    if (!combatSystem || !owner) return;
+
+    _combatSystem = combatSystem;
+    _owner = owner;
+    _model = model;
+    _radius = radius;
+    _reach = reach;
+    _boneFrom = nullptr;
+    _boneTo = nullptr;
+    if (model && model->getSkeleton()) {
+        _boneFrom = model->getSkeleton()->getBoneByName(boneFrom);
+        _boneTo = model->getSkeleton()->getBoneByName(boneTo);
+    }
+    if (model && (!_boneFrom || !_boneTo)) {
+        CCLOG("WeaponSweep: bones %s/%s not found, falling back to body sphere", boneFrom, boneTo);
+    }
+
+    _swingId = _combatSystem->beginSwing();
+    sample(_prevA, _prevB);
+}
+
+void WeaponSweep::sample(Vec3& a, Vec3& b) const {
+    if (_boneFrom && _boneTo) {
+        a = boneWorldPosition(_model, _boneFrom);
+        b = boneWorldPosition(_model, _boneTo);
+        Vec3 axis = b - a;
+        if (axis.lengthSquared() > 1e-6f) {
+            axis.normalize();
+            b += axis * _reach;
+        }
+        return;
+    }
+
+    _owner->getNodeToWorldTransform().transformPoint(Vec3::ZERO, &a);
+    b = a;
+}
+
+void WeaponSweep::update(const HitRequest& damage) {
+    if (!isActive()) return;
+
+    HitRequest request = damage;
+    request.attacker = _owner;
+    request.shape = HitRequest::SHAPE_SWEPT_CAPSULE;
+    request.prevA = _prevA;
+    request.prevB = _prevB;
+    sample(request.currA, request.currB);
+    request.radius = (_boneFrom && _boneTo) ? _radius : _radius + _reach;
+    request.swingId = _swingId;
+    _combatSystem->submit(request);
+
+    _prevA = request.currA;
+    _prevB = request.currB;
+}
+
+void WeaponSweep::end() {
+    if (_swingId != 0 && _combatSystem) {
+        _combatSystem->endSwing(_swingId);
+    }
+    _swingId = 0;
+    _combatSystem = nullptr;
+    _owner = nullptr;
+    _model = nullptr;
+    _boneFrom = nullptr;
+    _boneTo = nullptr;
+}
@@ -0,0 +1,59 @@
+#ifndef __WEAPON_SWEEP_H__
+#define __WEAPON_SWEEP_H__
+
+#include "cocos2d.h"
+#include "CombatSystem.h"
+
+/**
+ * @class WeaponSweep
+ * @brief 跟随骨骼的扫掠攻击判定（由攻击状态按值持有）
+ *
+ * 活动窗口开始时 begin，窗口内每帧 update：取两根骨骼（如前臂到手）在世界空间的位置，
+ * 沿轴向外延 reach 得到武器胶囊，把上一帧到本帧的扫掠体作为一个请求提交给 CombatSystem。
+ * 窗口内的所有请求属于同一次挥击，同一目标只受伤一次；窗口结束时 end。
+ * 模型缺少指定骨骼时退化为以角色位置为中心、随角色移动扫掠的球体。
+ */
+class WeaponSweep {
+public:
+    /**
+     * @brief 开始一次挥击
+     * @param combatSystem 结算管线（为空时本次挥击不做判定）
+     * @param owner 攻击者节点
+     * @param model 带骨骼的模型（可为空）
+     * @param boneFrom 胶囊起点骨骼
+     * @param boneTo 胶囊终点骨骼
+     * @param radius 胶囊半径
+     * @param reach 从终点骨骼沿轴向外延的长度（武器 / 拳锋）
+     */
+    void begin(CombatSystem* combatSystem, cocos2d::Node* owner, cocos2d::Sprite3D* model,
+               const char* boneFrom, const char* boneTo, float radius, float reach);
+
+    /**
+     * @brief 提交本帧的扫掠判定
+     * @param damage 请求模板：只使用其中的伤害、暴击、防御与目标层字段
+     */
+    void update(const HitRequest& damage);
+
+    /**
+     * @brief 结束挥击（可重复调用）
+     */
+    void end();
+
+    bool isActive() const { return _swingId != 0; }
+
+private:
+    CombatSystem* _combatSystem = nullptr;  // 只是引用，挥击期间场景持有
+    cocos2d::Node* _owner = nullptr;
+    cocos2d::Sprite3D* _model = nullptr;
+    cocos2d::Bone3D* _boneFrom = nullptr;
+    cocos2d::Bone3D* _boneTo = nullptr;
+    float _radius = 0.0f;
+    float _reach = 0.0f;
+    unsigned int _swingId = 0;
+
+    cocos2d::Vec3 _prevA, _prevB;   // 上一帧的胶囊端点
+
+    void sample(cocos2d::Vec3& a, cocos2d::Vec3& b) const;
+};
+
+#endif // __WEAPON_SWEEP_H__
@@ -0,0 +1,294 @@
+#include "AssetLoader.h"
+#include "3d/CCAnimation3D.h"
+#include "3d/CCBundle3D.h"
+#include "3d/CCSprite3D.h"
+#include "base/CCAsyncTaskPool.h"
+#include <algorithm>
+#include <chrono>
+
+USING_NS_CC;
+
+// 模型初始化（顶点缓冲、材质）在引擎回调中完成，同一时间只有一个在途，每帧最多上传一个
+static const int kMaxModelsInFlight = 1;
+// TextureCache 在一次回调中上传所有已解码的贴图，限制在途数量即限制每帧上传数
+static const int kMaxTexturesInFlight = 2;
+static const int kMaxAnimationsInFlight = 4;
+static const int kMaxTasksInFlight = 4;
+
+// 进度权重：模型的解析与上传明显重于单张贴图或单个动画
+static const float kModelWeight = 4.0f;
+
+AssetLoader* AssetLoader::create() {
+    auto pRet = new (std::nothrow) AssetLoader();
+    if (pRet) {
+        pRet->autorelease();
+    }
+    return pRet;
+}
+
+AssetLoader::AssetLoader() {
+}
+
+AssetLoader::~AssetLoader() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    // 在途的任务都持有引用，析构时只剩已解码未收尾的动画数据
+    for (auto& asset : _assets) {
+        CC_SAFE_DELETE(asset.animation);
+    }
+}
+
+AssetLoader::AssetId AssetLoader::addAsset(AssetType type, const std::string& path,
+                                           const std::vector<AssetId>& deps) {
+    CCASSERT(!_started, "AssetLoader: assets must be added before start()");
+
+    if (!path.empty()) {
+        const std::string key = std::to_string((int)type) + ":" + path;
+        auto it = _lookup.find(key);
+        if (it != _lookup.end()) {
+            auto& existing = _assets[it->second].deps;
+            for (AssetId dep : deps) {
+                if (std::find(existing.begin(), existing.end(), dep) == existing.end()) {
+                    existing.push_back(dep);
+                }
+            }
+            return it->second;
+        }
+        _lookup[key] = (AssetId)_assets.size();
+    }
+
+    Asset asset;
+    asset.type = type;
+    asset.path = path;
+    // 只接受已登记的依赖，因此依赖图不会成环
+    for (AssetId dep : deps) {
+        if (dep >= 0 && dep < (AssetId)_assets.size()) {
+            asset.deps.push_back(dep);
+        }
+    }
+    asset.weight = (type == AssetType::MODEL) ? kModelWeight : 1.0f;
+    _totalWeight += asset.weight;
+    _assets.push_back(std::move(asset));
+    return (AssetId)_assets.size() - 1;
+}
+
+AssetLoader::AssetId AssetLoader::addTexture(const std::string& path, const std::vector<AssetId>& deps) {
+    return addAsset(AssetType::TEXTURE, path, deps);
+}
+
+AssetLoader::AssetId AssetLoader::addModel(const std::string& path, const std::vector<AssetId>& deps) {
+    return addAsset(AssetType::MODEL, path, deps);
+}
+
+AssetLoader::AssetId AssetLoader::addAnimation(const std::string& path, const std::vector<AssetId>& deps) {
+    return addAsset(AssetType::ANIMATION, path, deps);
+}
+
+AssetLoader::AssetId AssetLoader::addTask(const std::function<void()>& work, const std::function<void()>& finish,
+                                          const std::vector<AssetId>& deps) {
+    AssetId id = addAsset(AssetType::TASK, "", deps);
+    _assets[id].work = work;
+    _assets[id].finish = finish;
+    return id;
+}
+
+void AssetLoader::start(const ProgressCallback& onProgress, const CompleteCallback& onComplete) {
+    if (_started) return;
+    _started = true;
+    _onProgress = onProgress;
+    _onComplete = onComplete;
+
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
+    // 第一批（无依赖的资源）立即发起，不等下一帧
+    update(0.0f);
+}
+
+void AssetLoader::cancel() {
+    _cancelled = true;
+    _onProgress = nullptr;
+    _onComplete = nullptr;
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+}
+
+float AssetLoader::getProgress() const {
+    if (_totalWeight <= 0.0f) return 1.0f;
+    return std::min(1.0f, _resolvedWeight / _totalWeight);
+}
+
+bool AssetLoader::depsResolved(const Asset& asset) const {
+    for (AssetId dep : asset.deps) {
+        State s = _assets[dep].state;
+        if (s != State::DONE && s != State::FAILED) return false;
+    }
+    return true;
+}
+
+bool AssetLoader::canIssue(AssetType type) const {
+    switch (type) {
+    case AssetType::TEXTURE:   return _inFlight[(int)type] < kMaxTexturesInFlight;
+    case AssetType::MODEL:     return _inFlight[(int)type] < kMaxModelsInFlight;
+    case AssetType::ANIMATION: return _inFlight[(int)type] < kMaxAnimationsInFlight;
+    case AssetType::TASK:      return _inFlight[(int)type] < kMaxTasksInFlight;
+    }
+    return false;
+}
+
+void AssetLoader::issue(AssetId id) {
+    Asset& asset = _assets[id];
+    asset.state = State::LOADING;
+    ++_inFlight[(int)asset.type];
+    // 在途期间持有自身，加载界面提前退出时回调仍然安全
+    retain();
+
+    switch (asset.type) {
+    case AssetType::TEXTURE:   issueTexture(id); break;
+    case AssetType::MODEL:     issueModel(id); break;
+    case AssetType::ANIMATION: issueAnimation(id); break;
+    case AssetType::TASK:      issueTask(id); break;
+    }
+}
+
+void AssetLoader::issueTexture(AssetId id) {
+    // 已在缓存中时回调会被同步调用
+    Director::getInstance()->getTextureCache()->addImageAsync(_assets[id].path, [this, id](Texture2D* texture) {
+        onLoaded(id, texture != nullptr, false);
+    });
+}
+
+void AssetLoader::issueModel(AssetId id) {
+    const std::string path = _assets[id].path;
+    Sprite3D::createAsync(path, [this, id, path](Sprite3D*, void*) {
+        // 回调总会给出精灵，只有成功初始化的模型会进入缓存
+        onLoaded(id, Sprite3DCache::getInstance()->getSpriteData(path) != nullptr, false);
+    }, nullptr);
+}
+
+void AssetLoader::issueAnimation(AssetId id) {
+    Asset& asset = _assets[id];
+    AnimationJob* job = new (std::nothrow) AnimationJob();
+    if (!job) {
+        onLoaded(id, false, false);
+        return;
+    }
+    job->fullPath = FileUtils::getInstance()->fullPathForFilename(asset.path);
+    asset.animation = job;
+
+    // 缓存键与 Animation3D::create(path) 一致
+    if (job->fullPath.empty() || Animation3DCache::getInstance()->getAnimation(job->fullPath + "#")) {
+        onLoaded(id, !job->fullPath.empty(), false);
+        return;
+    }
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER,
+        [this, id](void*) {
+            onLoaded(id, _assets[id].animation->ok, true);
+        },
+        nullptr,
+        [job]() {
+            auto bundle = Bundle3D::createBundle();
+            job->ok = bundle->load(job->fullPath) && bundle->loadAnimationData("", &job->data);
+            Bundle3D::destroyBundle(bundle);
+        });
+}
+
+void AssetLoader::issueTask(AssetId id) {
+    std::function<void()> work = _assets[id].work;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER,
+        [this, id](void*) {
+            onLoaded(id, true, (bool)_assets[id].finish);
+        },
+        nullptr,
+        [work]() {
+            if (work) work();
+        });
+}
+
+void AssetLoader::onLoaded(AssetId id, bool ok, bool needsFinalize) {
+    --_inFlight[(int)_assets[id].type];
+
+    if (ok && needsFinalize) {
+        _assets[id].state = State::DECODED;
+        _decoded.push_back(id);
+    } else {
+        resolve(id, ok);
+    }
+    release();
+}
+
+void AssetLoader::finalize(AssetId id) {
+    Asset& asset = _assets[id];
+    bool ok = true;
+
+    if (asset.type == AssetType::ANIMATION) {
+        AnimationJob* job = asset.animation;
+        const std::string key = job->fullPath + "#";
+        // 同步路径可能已在此期间加载了同一动画
+        if (!Animation3DCache::getInstance()->getAnimation(key)) {
+            auto animation = new (std::nothrow) Animation3D();
+            ok = animation && animation->init(job->data);
+            if (ok) {
+                Animation3DCache::getInstance()->addAnimation(key, animation);
+            }
+            CC_SAFE_RELEASE(animation);
+        }
+    } else if (asset.type == AssetType::TASK && asset.finish) {
+        asset.finish();
+    }
+
+    resolve(id, ok);
+}
+
+void AssetLoader::resolve(AssetId id, bool ok) {
+    Asset& asset = _assets[id];
+    asset.state = ok ? State::DONE : State::FAILED;
+    CC_SAFE_DELETE(asset.animation);
+    asset.work = nullptr;
+    asset.finish = nullptr;
+
+    ++_resolvedCount;
+    _resolvedWeight += asset.weight;
+    if (!ok) {
+        ++_failedCount;
+        CCLOG("AssetLoader: failed to load %s", asset.path.c_str());
+    }
+}
+
+void AssetLoader::update(float dt) {
+    if (!_started || _finished || _cancelled) return;
+
+    // 1) 主线程收尾，在预算内尽量多处理，每帧至少处理一个保证推进
+    const auto begin = std::chrono::steady_clock::now();
+    while (_decodedHead < _decoded.size()) {
+        finalize(_decoded[_decodedHead++]);
+        const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin);
+        if (elapsed.count() >= _frameBudget) break;
+    }
+    if (_decodedHead == _decoded.size()) {
+        _decoded.clear();
+        _decodedHead = 0;
+    }
+
+    // 2) 按登记顺序发起依赖已满足的资源（回调可能同步返回，随时重新检查在途上限）
+    for (AssetId id = 0; id < (AssetId)_assets.size(); ++id) {
+        const Asset& asset = _assets[id];
+        if (asset.state == State::WAITING && canIssue(asset.type) && depsResolved(asset)) {
+            issue(id);
+        }
+    }
+
+    // 3) 报告进度与完成
+    const float progress = getProgress();
+    if (progress != _reportedProgress) {
+        _reportedProgress = progress;
+        if (_onProgress) _onProgress(progress);
+    }
+
+    if (_resolvedCount == (int)_assets.size()) {
+        _finished = true;
+        Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+        // 回调中通常会切换场景并释放加载器，先取出再调用
+        CompleteCallback onComplete = _onComplete;
+        _onComplete = nullptr;
+        _onProgress = nullptr;
+        if (onComplete) onComplete(_failedCount);
+    }
+}
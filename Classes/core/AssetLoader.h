@@ -0,0 +1,167 @@
+#ifndef __ASSET_LOADER_H__
+#define __ASSET_LOADER_H__
+
+#include "cocos2d.h"
+#include "3d/CCBundle3DData.h"
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class AssetLoader
+ * @brief 异步资源加载器：按依赖关系在后台线程解码资源，主线程分帧完成上传
+ *
+ * 资源先登记、再统一开始加载，每个资源可以声明依赖（依赖加载结束后才开始加载自身），
+ * 例如模型依赖其材质贴图，保证模型在主线程初始化时贴图已在 TextureCache 中。
+ * - 贴图：TextureCache::addImageAsync，结果进入 TextureCache
+ * - 模型：Sprite3D::createAsync，结果进入 Sprite3DCache
+ * - 动画：在 AsyncTaskPool 工作线程解析 Bundle3D，主线程创建 Animation3D 并放入 Animation3DCache
+ * - 任务：任意工作线程函数，加上可选的主线程收尾函数
+ * 加载完成后，场景中同路径的同步 create 调用直接命中缓存。
+ *
+ * 主线程开销的控制：
+ * - 动画与任务的主线程收尾放入队列，每帧只在时间预算内处理（至少处理一个）；
+ * - 模型与贴图的上传发生在引擎回调中，通过限制同时在途的数量，限制每帧上传的个数。
+ *
+ * 加载失败的资源同样视为结束（不阻塞依赖它的资源），最终以失败数量报告。
+ * 只应在主线程调用。
+ */
+class AssetLoader : public cocos2d::Ref {
+public:
+    /**
+     * @brief 资源类型
+     */
+    enum class AssetType {
+        TEXTURE,    ///< 贴图
+        MODEL,      ///< 3D 模型（.c3b / .c3t / .obj）
+        ANIMATION,  ///< 骨骼动画（.c3b / .c3t 中的第一个动画）
+        TASK        ///< 自定义任务
+    };
+
+    typedef int AssetId;
+    static const AssetId INVALID_ASSET = -1;
+
+    typedef std::function<void(float)> ProgressCallback;   ///< 参数为 0~1 的进度
+    typedef std::function<void(int)> CompleteCallback;     ///< 参数为失败的资源数
+
+    static AssetLoader* create();
+
+    AssetLoader();
+    virtual ~AssetLoader();
+
+    /**
+     * @brief 登记资源，同类型同路径的资源只登记一次（返回已有 ID，依赖合并）
+     * @param path 资源路径，应与场景中同步创建时使用的路径一致，才能命中缓存
+     * @param deps 依赖的资源
+     * @return AssetId 资源 ID，开始加载后不能再登记
+     */
+    AssetId addTexture(const std::string& path, const std::vector<AssetId>& deps = {});
+    AssetId addModel(const std::string& path, const std::vector<AssetId>& deps = {});
+    AssetId addAnimation(const std::string& path, const std::vector<AssetId>& deps = {});
+
+    /**
+     * @brief 登记自定义任务
+     * @param work 在工作线程执行，不能访问场景图与渲染资源
+     * @param finish 在主线程执行的收尾（可为空），计入帧预算
+     * @param deps 依赖的资源
+     */
+    AssetId addTask(const std::function<void()>& work, const std::function<void()>& finish = nullptr,
+                    const std::vector<AssetId>& deps = {});
+
+    /**
+     * @brief 设置每帧主线程收尾的时间预算（毫秒）
+     */
+    void setFrameBudget(float milliseconds) { _frameBudget = milliseconds; }
+
+    /**
+     * @brief 开始加载，之后每帧自动推进
+     * @param onProgress 进度变化时回调
+     * @param onComplete 全部资源结束后回调一次
+     */
+    void start(const ProgressCallback& onProgress, const CompleteCallback& onComplete);
+
+    /**
+     * @brief 停止发起新的加载并清除回调（已在途的加载会正常结束）
+     */
+    void cancel();
+
+    /**
+     * @brief 当前进度（0~1，按资源权重）
+     */
+    float getProgress() const;
+
+    bool isFinished() const { return _finished; }
+    int getAssetCount() const { return (int)_assets.size(); }
+    int getFailedCount() const { return _failedCount; }
+
+    /**
+     * @brief 每帧推进：处理主线程收尾、发起依赖已满足的加载、报告进度
+     */
+    void update(float dt);
+
+private:
+    enum class State {
+        WAITING,    // 等待依赖
+        LOADING,    // 已发起，后台解码中
+        DECODED,    // 已解码，等待主线程收尾
+        DONE,
+        FAILED
+    };
+
+    // 动画的后台解码结果，解码期间由工作线程独占
+    struct AnimationJob {
+        std::string fullPath;
+        cocos2d::Animation3DData data;
+        bool ok = false;
+    };
+
+    struct Asset {
+        AssetType type;
+        std::string path;
+        std::vector<AssetId> deps;
+        State state = State::WAITING;
+        float weight = 1.0f;
+        std::function<void()> work;
+        std::function<void()> finish;
+        AnimationJob* animation = nullptr;
+    };
+
+    AssetId addAsset(AssetType type, const std::string& path, const std::vector<AssetId>& deps);
+    bool depsResolved(const Asset& asset) const;
+    bool canIssue(AssetType type) const;
+    void issue(AssetId id);
+    void issueTexture(AssetId id);
+    void issueModel(AssetId id);
+    void issueAnimation(AssetId id);
+    void issueTask(AssetId id);
+    void finalize(AssetId id);
+
+    /**
+     * @brief 后台加载返回（主线程）：需要主线程收尾的放入队列，否则直接结束
+     */
+    void onLoaded(AssetId id, bool ok, bool needsFinalize);
+    void resolve(AssetId id, bool ok);
+
+    std::vector<Asset> _assets;
+    std::unordered_map<std::string, AssetId> _lookup;  // "类型:路径" -> ID
+    std::vector<AssetId> _decoded;                     // 等待主线程收尾，按到达顺序
+    size_t _decodedHead = 0;
+
+    int _inFlight[4] = { 0, 0, 0, 0 };  // 按 AssetType 统计在途数量
+    int _resolvedCount = 0;
+    int _failedCount = 0;
+    float _resolvedWeight = 0.0f;
+    float _totalWeight = 0.0f;
+    float _frameBudget = 4.0f;
+    float _reportedProgress = -1.0f;
+
+    bool _started = false;
+    bool _finished = false;
+    bool _cancelled = false;
+
+    ProgressCallback _onProgress;
+    CompleteCallback _onComplete;
+};
+
+#endif // __ASSET_LOADER_H__
@@ -1,6 +1,5 @@
 #ifndef BASESTATE_H
 #define BASESTATE_H
-#include <string>
 
 /**
  * @class BaseState
@@ -40,10 +39,16 @@ public:
     virtual void onExit(T* entity) = 0;
 
     /**
-     * @brief 获取状态名称
-     * @return std::string 状态名称
+     * @brief 获取状态 ID（状态机表下标，由实体类的状态枚举定义）
+     * @return int 状态 ID
      */
-    virtual std::string getStateName() const = 0;
+    virtual int getStateId() const = 0;
+
+    /**
+     * @brief 获取状态名称（仅用于调试输出）
+     * @return const char* 状态名称（静态字符串）
+     */
+    virtual const char* getStateName() const = 0;
 };
 
 #endif // BASESTATE_H
\ No newline at end of file
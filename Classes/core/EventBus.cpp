@@ -0,0 +1,194 @@
+#include "EventBus.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+const float EventBus::WHEEL_TICK = 1.0f / 60.0f;
+
+EventBus::EventBus() {
+    for (int i = 0; i < WHEEL_SLOTS; ++i) {
+        _wheel[i] = -1;
+    }
+}
+
+EventBus::~EventBus() {
+}
+
+EventHandle EventBus::addListener(EventChannel channel, Listener listener) {
+    Channel& ch = _channels[channel];
+
+    // 优先复用已回收的槽位；分发中只在尾部追加，
+    // 否则复用的低位槽位会落在本次分发的范围内，收到正在分发的事件
+    uint16_t slot;
+    if (!ch.freeSlots.empty() && ch.dispatchDepth == 0) {
+        slot = ch.freeSlots.back();
+        ch.freeSlots.pop_back();
+    } else {
+        slot = (uint16_t)ch.slots.size();
+        ch.slots.push_back(Slot());
+    }
+
+    Slot& s = ch.slots[slot];
+    s.listener = std::move(listener);
+    s.generation = _nextGeneration++;
+    if (_nextGeneration == 0) {
+        _nextGeneration = 1;    // 0 留给空句柄
+    }
+    s.active = true;
+
+    EventHandle handle;
+    handle.channel = channel;
+    handle.slot = slot;
+    handle.generation = s.generation;
+    return handle;
+}
+
+void EventBus::unsubscribe(EventHandle& handle) {
+    if (!handle.isValid() || handle.channel >= MAX_CHANNELS) {
+        return;
+    }
+
+    Channel& ch = _channels[handle.channel];
+    if (handle.slot < ch.slots.size()) {
+        Slot& s = ch.slots[handle.slot];
+        if (s.active && s.generation == handle.generation) {
+            s.active = false;
+            if (ch.dispatchDepth > 0) {
+                // 分发中不能释放回调（可能正是当前回调），结束后统一回收
+                ch.hasDead = true;
+            } else {
+                s.listener = nullptr;
+                ch.freeSlots.push_back(handle.slot);
+            }
+        }
+    }
+    handle = EventHandle();
+}
+
+void EventBus::dispatch(EventChannel channel, const void* payload) {
+    Channel& ch = _channels[channel];
+    if (ch.slots.empty()) {
+        return;
+    }
+
+    // 只分发到分发开始时已有的槽位；槽位数组可能因回调中的订阅而扩容，按下标访问
+    const size_t count = ch.slots.size();
+    ++ch.dispatchDepth;
+    for (size_t i = 0; i < count; ++i) {
+        if (ch.slots[i].active) {
+            ch.slots[i].listener(payload);
+        }
+    }
+    --ch.dispatchDepth;
+
+    if (ch.dispatchDepth == 0 && ch.hasDead) {
+        ch.hasDead = false;
+        for (size_t i = 0; i < ch.slots.size(); ++i) {
+            Slot& s = ch.slots[i];
+            if (!s.active && s.listener) {
+                s.listener = nullptr;
+                ch.freeSlots.push_back((uint16_t)i);
+            }
+        }
+    }
+}
+
+void EventBus::enqueue(EventChannel channel, const void* payload, size_t size) {
+    if (_queueCount >= QUEUE_CAPACITY) {
+        // 队列已满：退化为立即分发，不丢事件
+        dispatch(channel, payload);
+        return;
+    }
+
+    Record& r = _queue[(_queueHead + _queueCount) % QUEUE_CAPACITY];
+    r.channel = channel;
+    memcpy(r.payload, payload, size);
+    ++_queueCount;
+}
+
+void EventBus::schedule(EventChannel channel, const void* payload, size_t size, float delay) {
+    // 距离当前刻度的刻数，至少 1 刻（下一次推进时到期）
+    const float ticks = std::ceil((std::max(delay, 0.0f) + _wheelTime) / WHEEL_TICK);
+    const uint32_t total = std::max(1u, (uint32_t)ticks);
+
+    int index;
+    if (_freeTimer >= 0) {
+        index = _freeTimer;
+        _freeTimer = _timers[index].next;
+    } else {
+        index = (int)_timers.size();
+        _timers.push_back(Timer());
+    }
+
+    Timer& t = _timers[index];
+    t.record.channel = channel;
+    memcpy(t.record.payload, payload, size);
+    t.rounds = (total - 1) / WHEEL_SLOTS;
+
+    const int slot = (_wheelCursor + (int)((total - 1) % WHEEL_SLOTS) + 1) % WHEEL_SLOTS;
+    t.next = _wheel[slot];
+    _wheel[slot] = index;
+}
+
+void EventBus::advanceWheel() {
+    _wheelCursor = (_wheelCursor + 1) % WHEEL_SLOTS;
+
+    // 先把整条链摘下，回调中新排的定时器挂到新链上，不影响本次遍历
+    int index = _wheel[_wheelCursor];
+    _wheel[_wheelCursor] = -1;
+
+    while (index >= 0) {
+        const int next = _timers[index].next;
+        if (_timers[index].rounds > 0) {
+            --_timers[index].rounds;
+            _timers[index].next = _wheel[_wheelCursor];
+            _wheel[_wheelCursor] = index;
+        } else {
+            // 拷出后先归还节点，回调中可以立即复用
+            const Record record = _timers[index].record;
+            _timers[index].next = _freeTimer;
+            _freeTimer = index;
+            dispatch(record.channel, record.payload);
+        }
+        index = next;
+    }
+}
+
+void EventBus::update(float deltaTime) {
+    // 1) 推进时间轮
+    _wheelTime += deltaTime;
+    while (_wheelTime >= WHEEL_TICK) {
+        _wheelTime -= WHEEL_TICK;
+        advanceWheel();
+    }
+
+    // 2) 分发本帧开始时已在队列中的事件，回调中新排入的留到下一帧
+    int pending = _queueCount;
+    while (pending-- > 0 && _queueCount > 0) {
+        const Record record = _queue[_queueHead];
+        _queueHead = (_queueHead + 1) % QUEUE_CAPACITY;
+        --_queueCount;
+        dispatch(record.channel, record.payload);
+    }
+}
+
+void EventBus::clear() {
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        Channel& ch = _channels[i];
+        assert(ch.dispatchDepth == 0 && "EventBus::clear during dispatch");
+        ch.slots.clear();
+        ch.freeSlots.clear();
+        ch.hasDead = false;
+    }
+
+    _queueHead = 0;
+    _queueCount = 0;
+
+    for (int i = 0; i < WHEEL_SLOTS; ++i) {
+        _wheel[i] = -1;
+    }
+    _wheelCursor = 0;
+    _wheelTime = 0.0f;
+    _timers.clear();
+    _freeTimer = -1;
+}
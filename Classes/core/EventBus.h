@@ -0,0 +1,168 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief 事件通道 ID（事件结构体以静态成员 CHANNEL 声明，见 GameEvents.h）
+ */
+typedef uint16_t EventChannel;
+
+/**
+ * @struct EventHandle
+ * @brief 订阅句柄，用于取消订阅（槽位复用后旧句柄因代数不同而失效）
+ */
+struct EventHandle {
+    EventChannel channel = 0;
+    uint16_t slot = 0;
+    uint32_t generation = 0;    ///< 0 表示空句柄
+
+    bool isValid() const { return generation != 0; }
+};
+
+/**
+ * @class EventBus
+ * @brief 类型安全的事件总线
+ *
+ * - 事件为带 CHANNEL 静态成员的结构体，按整数通道索引监听者表，不做字符串查找
+ * - publish 立即同步分发；post 放入环形队列，在 update 中统一分发
+ * - publishDelayed 放入时间轮，到期后在 update 中分发
+ * - 订阅时分配一次，之后发布、排队与取消订阅均不分配内存
+ * - 分发过程中订阅 / 取消订阅是安全的（取消只做标记，新订阅本次不会收到）
+ *
+ * 排队与延迟的事件按值拷贝，需为可平凡拷贝类型且不超过 MAX_PAYLOAD 字节。
+ * 只应在主线程使用。
+ */
+class EventBus {
+public:
+    static const int MAX_CHANNELS = 64;         ///< 通道数上限
+    static const size_t MAX_PAYLOAD = 48;       ///< 排队 / 延迟事件的最大字节数
+    static const int QUEUE_CAPACITY = 256;      ///< 环形队列容量（满时立即分发）
+    static const int WHEEL_SLOTS = 256;         ///< 时间轮槽数
+    static const float WHEEL_TICK;              ///< 时间轮刻度（秒）
+
+    EventBus();
+    ~EventBus();
+
+    /**
+     * @brief 订阅事件
+     * @tparam E 事件类型
+     * @param handler 回调
+     * @return EventHandle 取消订阅用的句柄
+     */
+    template <typename E>
+    EventHandle subscribe(std::function<void(const E&)> handler) {
+        static_assert(E::CHANNEL < MAX_CHANNELS, "event channel out of range");
+        return addListener(E::CHANNEL, [handler](const void* payload) {
+            handler(*static_cast<const E*>(payload));
+        });
+    }
+
+    /**
+     * @brief 取消订阅（句柄随后被清空，重复调用无副作用）
+     */
+    void unsubscribe(EventHandle& handle);
+
+    /**
+     * @brief 立即分发事件
+     */
+    template <typename E>
+    void publish(const E& event) {
+        static_assert(E::CHANNEL < MAX_CHANNELS, "event channel out of range");
+        dispatch(E::CHANNEL, &event);
+    }
+
+    /**
+     * @brief 事件入队，在下一次 update 中分发
+     */
+    template <typename E>
+    void post(const E& event) {
+        checkPayload<E>();
+        enqueue(E::CHANNEL, &event, sizeof(E));
+    }
+
+    /**
+     * @brief 延迟分发事件
+     * @param event 事件
+     * @param delay 延迟（秒），按时间轮刻度向上取整
+     */
+    template <typename E>
+    void publishDelayed(const E& event, float delay) {
+        checkPayload<E>();
+        schedule(E::CHANNEL, &event, sizeof(E), delay);
+    }
+
+    /**
+     * @brief 推进时间轮并分发到期的延迟事件与队列中的事件
+     * @param deltaTime 帧间隔时间
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief 清空队列、时间轮与所有监听者
+     */
+    void clear();
+
+private:
+    typedef std::function<void(const void*)> Listener;
+
+    struct Slot {
+        Listener listener;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    struct Channel {
+        std::deque<Slot> slots;     // 尾部追加不移动已有元素，回调中订阅不影响正在执行的回调
+        std::vector<uint16_t> freeSlots;
+        int dispatchDepth = 0;      // 正在分发的层数（嵌套发布）
+        bool hasDead = false;       // 分发期间有取消的槽位，结束后回收
+    };
+
+    struct Record {
+        EventChannel channel;
+        alignas(8) uint8_t payload[MAX_PAYLOAD];
+    };
+
+    struct Timer {
+        Record record;
+        uint32_t rounds;    // 还需转过的整圈数
+        int next;           // 同槽链表 / 空闲链表的下一个下标
+    };
+
+    template <typename E>
+    static void checkPayload() {
+        static_assert(E::CHANNEL < MAX_CHANNELS, "event channel out of range");
+        static_assert(std::is_trivially_copyable<E>::value, "queued events must be trivially copyable");
+        static_assert(sizeof(E) <= MAX_PAYLOAD, "event too large for the queue");
+        static_assert(alignof(E) <= 8, "event alignment too large for the queue");
+    }
+
+    EventHandle addListener(EventChannel channel, Listener listener);
+    void dispatch(EventChannel channel, const void* payload);
+    void enqueue(EventChannel channel, const void* payload, size_t size);
+    void schedule(EventChannel channel, const void* payload, size_t size, float delay);
+    void advanceWheel();
+
+    Channel _channels[MAX_CHANNELS];
+    uint32_t _nextGeneration = 1;
+
+    // 环形队列
+    Record _queue[QUEUE_CAPACITY];
+    int _queueHead = 0;
+    int _queueCount = 0;
+
+    // 时间轮：每槽一条单链表，节点取自 _timers 池
+    int _wheel[WHEEL_SLOTS];
+    int _wheelCursor = 0;
+    float _wheelTime = 0.0f;
+    std::vector<Timer> _timers;
+    int _freeTimer = -1;
+};
+
+#endif // EVENTBUS_H
@@ -1,6 +1,7 @@
 #include "GameApp.h"                                   // 游戏应用主类
 #include "scene_ui/UIManager.h"                        // UI 管理器（用于注册标题场景）
 #include "scene_ui/BaseScene.h"                        // 第一个游戏场景
+#include "scene_ui/LoadingScene.h"                     // 进入游戏场景前的资源加载界面
 
 // 初始化单例指针
 GameApp* GameApp::_instance = nullptr;
@@ -22,7 +23,7 @@ GameApp* GameApp::getInstance() {
 GameApp::GameApp() :
     _director(nullptr),
     _sceneManager(nullptr),
-    _eventManager(nullptr),
+    _eventBus(nullptr),
     _isPaused(false) {
     // 构造函数初始化
 }
@@ -37,9 +38,13 @@ GameApp::~GameApp() {
         _sceneManager = nullptr;
     }
 
-    if (_eventManager) {
-        delete _eventManager;
-        _eventManager = nullptr;
+    if (_director) {
+        _director->getScheduler()->unschedule("GameApp::update", this);
+    }
+
+    if (_eventBus) {
+        delete _eventBus;
+        _eventBus = nullptr;
     }
 }
 
@@ -67,17 +72,18 @@ bool GameApp::init(Director* director) {
     _sceneManager->registerScene(SceneManager::SceneType::TITLE, []() {
         return UIManager::getInstance()->createStartMenuScene();
         });
+    // 游戏场景先进入加载界面，后台加载资源后再创建营地场景
     _sceneManager->registerScene(SceneManager::SceneType::GAMEPLAY, []() {
-        return CampScene::createScene();
+        return LoadingScene::create(&CampScene::preloadAssets, &CampScene::createScene);
         });
 
-    // 创建事件管理器
-    _eventManager = new EventManager();
-    if (!_eventManager->init()) {
-        delete _eventManager;
-        _eventManager = nullptr;
-        return false;
-    }
+    // 创建事件总线
+    _eventBus = new EventBus();
+
+    // 每帧推进事件总线（排队与延迟事件），导演暂停时一并暂停
+    _director->getScheduler()->schedule([this](float dt) {
+        this->update(dt);
+        }, this, 0.0f, false, "GameApp::update");
 
     // 初始化成功
     return true;
@@ -97,9 +103,9 @@ void GameApp::update(float deltaTime) {
         _sceneManager->update(deltaTime);
     }
 
-    // 更新事件管理器
-    if (_eventManager) {
-        _eventManager->update(deltaTime);
+    // 分发排队与到期的延迟事件
+    if (_eventBus) {
+        _eventBus->update(deltaTime);
     }
 }
 
@@ -135,9 +141,9 @@ SceneManager* GameApp::getSceneManager() const {
 }
 
 /**
- * @brief 获取事件管理器
- * @return EventManager* 事件管理器指针
+ * @brief 获取事件总线
+ * @return EventBus* 事件总线指针
  */
-EventManager* GameApp::getEventManager() const {
-    return _eventManager;
+EventBus* GameApp::getEventBus() const {
+    return _eventBus;
 }
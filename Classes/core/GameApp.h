@@ -3,7 +3,8 @@
 
 #include "cocos2d.h"
 #include "SceneManager.h"
-#include "EventManager.h"
+#include "EventBus.h"
+#include "GameEvents.h"
 
 USING_NS_CC;
 
@@ -55,10 +56,10 @@ public:
     SceneManager* getSceneManager() const;
 
     /**
-     * @brief 获取事件管理器
-     * @return EventManager* 事件管理器指针
+     * @brief 获取事件总线
+     * @return EventBus* 事件总线指针
      */
-    EventManager* getEventManager() const;
+    EventBus* getEventBus() const;
 
 private:
     /**
@@ -74,7 +75,7 @@ private:
     static GameApp* _instance; ///< 单例实例
     Director* _director; ///< 导演实例
     SceneManager* _sceneManager; ///< 场景管理器
-    EventManager* _eventManager; ///< 事件管理器
+    EventBus* _eventBus; ///< 事件总线
     bool _isPaused; ///< 游戏是否暂停
 };
 
@@ -0,0 +1,81 @@
+#ifndef GAMEEVENTS_H
+#define GAMEEVENTS_H
+
+#include "EventBus.h"
+
+namespace cocos2d {
+    class Node;
+}
+class Character;
+class Enemy;
+class Boss;
+
+/**
+ * @enum GameEventChannel
+ * @brief 游戏事件通道 ID（需小于 EventBus::MAX_CHANNELS）
+ */
+enum GameEventChannel : EventChannel {
+    EVENT_PLAYER_HURT,          ///< 玩家受伤
+    EVENT_PLAYER_DEAD,          ///< 玩家死亡
+    EVENT_ENEMY_HURT,           ///< 敌人受伤
+    EVENT_ENEMY_DEAD,           ///< 敌人死亡（进入死亡状态）
+    EVENT_ENEMY_REMOVED,        ///< 敌人死亡动画结束，即将从场景移除
+    EVENT_BOSS_PHASE_CHANGE,    ///< Boss 阶段变化
+    EVENT_CHANNEL_COUNT
+};
+
+/**
+ * @brief 玩家受伤事件
+ */
+struct PlayerHurtEvent {
+    static const EventChannel CHANNEL = EVENT_PLAYER_HURT;
+    Character* player;
+    int damage;
+    int hp;                     ///< 受伤后剩余血量
+};
+
+/**
+ * @brief 玩家死亡事件
+ */
+struct PlayerDeadEvent {
+    static const EventChannel CHANNEL = EVENT_PLAYER_DEAD;
+    Character* player;
+};
+
+/**
+ * @brief 敌人受伤事件（Boss 也会触发）
+ */
+struct EnemyHurtEvent {
+    static const EventChannel CHANNEL = EVENT_ENEMY_HURT;
+    Enemy* enemy;
+    cocos2d::Node* attacker;
+    float damage;
+};
+
+/**
+ * @brief 敌人死亡事件（Boss 也会触发）
+ */
+struct EnemyDeadEvent {
+    static const EventChannel CHANNEL = EVENT_ENEMY_DEAD;
+    Enemy* enemy;
+    cocos2d::Node* attacker;
+};
+
+/**
+ * @brief 敌人移除事件：死亡动画播放完毕，监听者应在此释放对该敌人的引用
+ */
+struct EnemyRemovedEvent {
+    static const EventChannel CHANNEL = EVENT_ENEMY_REMOVED;
+    Enemy* enemy;
+};
+
+/**
+ * @brief Boss 阶段变化事件
+ */
+struct BossPhaseChangeEvent {
+    static const EventChannel CHANNEL = EVENT_BOSS_PHASE_CHANGE;
+    Boss* boss;
+    int phase;                  ///< 新阶段
+};
+
+#endif // GAMEEVENTS_H
@@ -2,29 +2,33 @@
 #define STATEMACHINE_H
 
 #include "BaseState.h"
-#include <unordered_map>
-#include <string>
-#include <memory>
+#include <cassert>
 
 /**
  * @class StateMachine
  * @brief 状态机类，负责管理实体的状态切换和更新
+ *
+ * 状态按整数 ID 存放在定长表中，切换与查询都是数组下标访问，不做字符串比较或分配；
+ * 状态名称只用于调试输出。状态对象由实体持有，状态机只保存裸指针。
  * @tparam T 状态所属的实体类型
+ * @tparam MaxStates 状态表容量（状态 ID 需小于该值）
  */
-template <typename T>
+template <typename T, int MaxStates = 16>
 class StateMachine {
 public:
     /**
-     * @brief 构造函数
-     * @param owner 状态机所属的实体
+     * @brief 无效状态 ID
      */
-    explicit StateMachine(T* owner) : _owner(owner), _currentState(nullptr), _previousState(nullptr) {}
+    static const int INVALID_STATE = -1;
 
     /**
-     * @brief 析构函数
+     * @brief 构造函数
+     * @param owner 状态机所属的实体
      */
-    ~StateMachine() {
-        _states.clear();
+    explicit StateMachine(T* owner) : _owner(owner), _currentState(nullptr), _previousState(nullptr) {
+        for (int i = 0; i < MaxStates; ++i) {
+            _states[i] = nullptr;
+        }
     }
 
     /**
@@ -49,26 +53,30 @@ public:
     }
 
     /**
-     * @brief 注册状态
+     * @brief 注册状态（放入 getStateId() 对应的表项，同 ID 后注册的覆盖先注册的）
      * @param state 要注册的状态
      */
     void registerState(BaseState<T>* state) {
-        if (state) {
-            _states[state->getStateName()] = state;
+        if (!state) {
+            return;
+        }
+        const int id = state->getStateId();
+        assert(id >= 0 && id < MaxStates && "state id out of range");
+        if (id >= 0 && id < MaxStates) {
+            _states[id] = state;
         }
     }
 
     /**
      * @brief 切换到指定状态
-     * @param stateName 目标状态名称
+     * @param stateId 目标状态 ID
      */
-    void changeState(const std::string& stateName) {
-        auto it = _states.find(stateName);
-        if (it == _states.end()) {
+    void changeState(int stateId) {
+        if (stateId < 0 || stateId >= MaxStates || !_states[stateId]) {
             return; // 状态不存在
         }
 
-        changeState(it->second);
+        changeState(_states[stateId]);
     }
 
     /**
@@ -116,20 +124,36 @@ public:
         return _previousState;
     }
 
+    /**
+     * @brief 获取当前状态 ID
+     * @return int 当前状态 ID，未初始化时为 INVALID_STATE
+     */
+    int getCurrentStateId() const {
+        return _currentState ? _currentState->getStateId() : INVALID_STATE;
+    }
+
+    /**
+     * @brief 获取当前状态名称（仅用于调试输出）
+     * @return const char* 状态名称，未初始化时为空串
+     */
+    const char* getCurrentStateName() const {
+        return _currentState ? _currentState->getStateName() : "";
+    }
+
     /**
      * @brief 检查是否处于指定状态
-     * @param stateName 状态名称
+     * @param stateId 状态 ID
      * @return bool 是否处于该状态
      */
-    bool isInState(const std::string& stateName) const {
-        return _currentState && _currentState->getStateName() == stateName;
+    bool isInState(int stateId) const {
+        return getCurrentStateId() == stateId;
     }
 
 private:
     T* _owner; ///< 状态机所属的实体
     BaseState<T>* _currentState; ///< 当前状态
     BaseState<T>* _previousState; ///< 上一个状态
-    std::unordered_map<std::string, BaseState<T>*> _states; ///< 已注册的状态映射
+    BaseState<T>* _states[MaxStates]; ///< 已注册的状态表（按状态 ID 索引）
 };
 
-#endif // STATEMACHINE_H
\ No newline at end of file
+#endif // STATEMACHINE_H
@@ -0,0 +1,69 @@
+#include "AIPerception.h"
+#include "combat/Collider.h"
+#include "base/CCJobSystem.h"
+#include <cmath>
+
+USING_NS_CC;
+
+// 视锥半角余弦（半角 60°）
+static const float kViewConeCos = 0.5f;
+// 贴近到视野距离的该比例以内时，不要求在视锥内
+static const float kAwarenessRatio = 0.5f;
+// 视线检测的眼睛高度（敌人与目标都从脚底抬高）
+static const float kEyeHeight = 100.0f;
+// 视线终点前留出的余量，避免目标脚下地形误判为遮挡
+static const float kSightSlack = 20.0f;
+// 每个工作线程一次领取的敌人数量
+static const int kSenseGrainSize = 4;
+
+bool PerceptionResult::canSeeTarget() const {
+    return hasTarget && inViewRange && inViewCone && hasLineOfSight;
+}
+
+void AIPerception::sense(const PerceptionInput& in, PerceptionResult& out) {
+    out.selfPos = in.selfPos;
+    out.birthPos = in.birthPos;
+    out.targetPos = in.targetPos;
+    out.distanceFromBirth = in.selfPos.distance(in.birthPos);
+    out.hasTarget = in.hasTarget;
+
+    if (!in.hasTarget) {
+        out.distanceToTarget = FLT_MAX;
+        out.inViewRange = false;
+        out.inViewCone = false;
+        out.hasLineOfSight = false;
+        return;
+    }
+
+    Vec3 toTarget = in.targetPos - in.selfPos;
+    out.distanceToTarget = toTarget.length();
+    out.inViewRange = out.distanceToTarget <= in.viewRange;
+
+    // 视锥只看水平方向；贴近时视为已察觉
+    Vec3 flat(toTarget.x, 0.0f, toTarget.z);
+    float flatLen = flat.length();
+    out.inViewCone = out.distanceToTarget <= in.viewRange * kAwarenessRatio ||
+                     flatLen < 1e-3f ||
+                     flat.dot(in.forward) >= kViewConeCos * flatLen;
+
+    // 视野外不做射线检测
+    out.hasLineOfSight = false;
+    if (out.inViewRange) {
+        if (!in.terrain) {
+            out.hasLineOfSight = true;
+        } else {
+            Vec3 eye = in.selfPos + Vec3(0.0f, kEyeHeight, 0.0f);
+            Vec3 dir = in.targetPos + Vec3(0.0f, kEyeHeight, 0.0f) - eye;
+            float len = dir.length();
+            out.hasLineOfSight = len <= kSightSlack ||
+                                 !in.terrain->raycast(eye, dir, len - kSightSlack);
+        }
+    }
+}
+
+void AIPerception::senseBatch(const PerceptionInput* in, PerceptionResult* out, int count) {
+    // 每个下标只写自己的结果，地形射线检测为只读访问
+    JobSystem::getInstance()->parallelFor(count, [in, out](int i) {
+        sense(in[i], out[i]);
+    }, kSenseGrainSize);
+}
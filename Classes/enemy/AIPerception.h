@@ -0,0 +1,60 @@
+#ifndef __AI_PERCEPTION_H__
+#define __AI_PERCEPTION_H__
+
+#include "cocos2d.h"
+#include <float.h>
+
+class TerrainCollider;
+
+/**
+ * @struct PerceptionInput
+ * @brief 感知输入快照（主线程采集，工作线程只读）
+ */
+struct PerceptionInput {
+    const TerrainCollider* terrain = nullptr;  ///< 视线检测用，为空时视线总是通畅
+    cocos2d::Vec3 selfPos;      ///< 敌人世界坐标
+    cocos2d::Vec3 birthPos;     ///< 出生点世界坐标
+    cocos2d::Vec3 forward;      ///< 模型水平朝向（世界坐标，单位向量）
+    cocos2d::Vec3 targetPos;    ///< 目标世界坐标
+    float viewRange = 0.0f;     ///< 视野距离
+    bool hasTarget = false;     ///< 目标存在且存活
+};
+
+/**
+ * @struct PerceptionResult
+ * @brief 感知结果：每次 AI 运行前发布，状态机只读
+ */
+struct PerceptionResult {
+    cocos2d::Vec3 selfPos;
+    cocos2d::Vec3 birthPos;
+    cocos2d::Vec3 targetPos;
+    float distanceToTarget = FLT_MAX;   ///< 无目标时为 FLT_MAX
+    float distanceFromBirth = 0.0f;
+    bool hasTarget = false;
+    bool inViewRange = false;           ///< 目标在视野距离内
+    bool inViewCone = false;            ///< 目标在前方视锥内，或已贴近（身后也能察觉）
+    bool hasLineOfSight = false;        ///< 眼睛高度处到目标之间没有地形遮挡
+
+    /**
+     * @brief 是否发现目标：视野距离内、在视锥内且视线通畅
+     */
+    bool canSeeTarget() const;
+};
+
+/**
+ * @namespace AIPerception
+ * @brief 感知计算：纯函数，不访问场景图
+ */
+namespace AIPerception {
+    /**
+     * @brief 计算单个敌人的感知结果
+     */
+    void sense(const PerceptionInput& in, PerceptionResult& out);
+
+    /**
+     * @brief 在 JobSystem 上并行计算一批感知结果（out[i] 对应 in[i]）
+     */
+    void senseBatch(const PerceptionInput* in, PerceptionResult* out, int count);
+}
+
+#endif // __AI_PERCEPTION_H__
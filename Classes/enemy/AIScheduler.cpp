@@ -0,0 +1,207 @@
+#include "AIScheduler.h"
+#include "Enemy.h"
+#include <algorithm>
+#include <chrono>
+
+USING_NS_CC;
+
+// 在人群更新（-1）之前运行，本帧提交的移动目标当帧生效
+static const int kAIPriority = -2;
+// 中档每 4 帧运行一次
+static const unsigned int kMidTierFrames = 4;
+// 远档每 500 毫秒运行一次
+static const float kFarTierInterval = 0.5f;
+// 单次传给状态机的时间上限，避免长时间顺延后一步跨得过远
+static const float kMaxStepTime = 1.0f;
+
+namespace {
+    typedef std::chrono::steady_clock AIClock;
+
+    int elapsedMicros(const AIClock::time_point& start) {
+        return (int)std::chrono::duration_cast<std::chrono::microseconds>(AIClock::now() - start).count();
+    }
+}
+
+AIScheduler* AIScheduler::create(int frameBudgetMicros) {
+    auto pRet = new (std::nothrow) AIScheduler();
+    if (pRet && pRet->init(frameBudgetMicros)) {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return nullptr;
+}
+
+AIScheduler::AIScheduler() {
+}
+
+AIScheduler::~AIScheduler() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& b : _brains) {
+        if (b.enemy) {
+            b.enemy->setAIScheduler(nullptr);
+            b.enemy->release();
+        }
+    }
+}
+
+bool AIScheduler::init(int frameBudgetMicros) {
+    _frameBudgetMicros = frameBudgetMicros;
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, kAIPriority, false);
+    return true;
+}
+
+void AIScheduler::setTierRanges(float nearRange, float midRange) {
+    _nearRange = nearRange;
+    _midRange = std::max(nearRange, midRange);
+}
+
+void AIScheduler::add(Enemy* enemy) {
+    if (!enemy) return;
+    for (auto& b : _brains) {
+        if (b.enemy == enemy) return;
+    }
+
+    Brain b;
+    b.enemy = enemy;
+    b.tier = TIER_NEAR;
+    b.pendingTime = 0.0f;
+    b.frames = 0;
+    enemy->retain();
+    enemy->setAIScheduler(this);
+    _brains.push_back(b);
+}
+
+void AIScheduler::remove(Enemy* enemy) {
+    for (auto& b : _brains) {
+        if (b.enemy == enemy) {
+            enemy->setAIScheduler(nullptr);
+            enemy->release();
+            // 置空后在 update 末尾压缩，update 过程中注销也安全
+            b.enemy = nullptr;
+            return;
+        }
+    }
+}
+
+AIScheduler::Tier AIScheduler::classify(const Vec3& focusPos, const Vec3& enemyPos) const {
+    const float distSq = enemyPos.distanceSquared(focusPos);
+    if (distSq < _nearRange * _nearRange) return TIER_NEAR;
+    if (distSq < _midRange * _midRange) return TIER_MID;
+    return TIER_FAR;
+}
+
+void AIScheduler::sense() {
+    // 主线程采集快照：同一目标只计算一次世界坐标
+    const size_t count = _near.size() + _due.size();
+    _senseInputs.resize(count);
+    _senseResults.resize(count);
+
+    const Wukong* cachedTarget = nullptr;
+    Vec3 cachedTargetPos;
+    for (size_t k = 0; k < count; ++k) {
+        const int i = k < _near.size() ? _near[k] : _due[k - _near.size()];
+        Enemy* enemy = _brains[i].enemy;
+        const Wukong* target = enemy->getTarget();
+        if (target && target != cachedTarget) {
+            cachedTarget = target;
+            cachedTargetPos = enemy->getTargetWorldPos();
+        }
+        enemy->gatherPerception(_senseInputs[k], _selfPositions[i], target ? cachedTargetPos : Vec3::ZERO);
+    }
+
+    // 工作线程并行计算，完成后发布
+    AIPerception::senseBatch(_senseInputs.data(), _senseResults.data(), (int)count);
+    for (size_t k = 0; k < count; ++k) {
+        const int i = k < _near.size() ? _near[k] : _due[k - _near.size()];
+        _brains[i].enemy->setPerception(_senseResults[k]);
+    }
+}
+
+void AIScheduler::run(Brain& brain) {
+    brain.enemy->updateAI(std::min(brain.pendingTime, kMaxStepTime));
+    brain.pendingTime = 0.0f;
+    brain.frames = 0;
+}
+
+void AIScheduler::update(float dt) {
+    const AIClock::time_point start = AIClock::now();
+
+    Vec3 focusPos;
+    if (_focus) {
+        _focus->getNodeToWorldTransform().transformPoint(Vec3::ZERO, &focusPos);
+    } else if (auto scene = Director::getInstance()->getRunningScene()) {
+        if (auto camera = scene->getDefaultCamera()) {
+            focusPos = camera->getPosition3D();
+        }
+    }
+
+    // 1) 累计时间、重新分档，收集本帧运行的近档与到期的中、远档
+    _near.clear();
+    _due.clear();
+    _selfPositions.resize(_brains.size());
+    for (size_t i = 0; i < _brains.size(); ++i) {
+        Brain& b = _brains[i];
+        if (!b.enemy) continue;
+
+        b.pendingTime += dt;
+        b.frames += 1;
+        _selfPositions[i] = b.enemy->getWorldPosition3D();
+        b.tier = classify(focusPos, _selfPositions[i]);
+
+        if (b.tier == TIER_NEAR) {
+            _near.push_back((int)i);
+        } else if ((b.tier == TIER_MID && b.frames >= kMidTierFrames) ||
+                   (b.tier == TIER_FAR && b.pendingTime >= kFarTierInterval)) {
+            _due.push_back((int)i);
+        }
+    }
+
+    // 2) 并行感知
+    sense();
+
+    // 3) 近档全部运行
+    int updates = 0;
+    for (int i : _near) {
+        if (!_brains[i].enemy) continue;
+        run(_brains[i]);
+        ++updates;
+    }
+
+    // 4) 中、远档从轮转起点开始在预算内运行，剩余的保持到期状态顺延到下一帧
+    //    预算只计本步耗时；每帧至少运行一个，近档再多也不会让中、远档停滞
+    if (!_due.empty()) {
+        auto first = std::lower_bound(_due.begin(), _due.end(), (int)_cursor);
+        std::rotate(_due.begin(), first, _due.end());
+
+        const AIClock::time_point budgetStart = AIClock::now();
+        int dueUpdates = 0;
+        for (size_t k = 0; k < _due.size(); ++k) {
+            if (dueUpdates > 0 && elapsedMicros(budgetStart) >= _frameBudgetMicros) {
+                _cursor = (size_t)_due[k];
+                break;
+            }
+            Brain& b = _brains[_due[k]];
+            if (!b.enemy) continue;
+            run(b);
+            ++dueUpdates;
+        }
+        updates += dueUpdates;
+    }
+
+    // 5) 压缩本帧注销的条目，轮转起点前移被删除的条目数，仍指向同一个敌人
+    size_t removedBeforeCursor = 0;
+    for (size_t i = 0; i < _cursor && i < _brains.size(); ++i) {
+        if (!_brains[i].enemy) ++removedBeforeCursor;
+    }
+    _cursor -= removedBeforeCursor;
+    _brains.erase(std::remove_if(_brains.begin(), _brains.end(),
+                                 [](const Brain& b) { return b.enemy == nullptr; }),
+                  _brains.end());
+    if (_cursor >= _brains.size()) {
+        _cursor = 0;
+    }
+
+    _lastFrameMicros = elapsedMicros(start);
+    _lastFrameUpdates = updates;
+}
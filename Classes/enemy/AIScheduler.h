@@ -0,0 +1,108 @@
+#ifndef __AI_SCHEDULER_H__
+#define __AI_SCHEDULER_H__
+
+#include "cocos2d.h"
+#include "AIPerception.h"
+#include <vector>
+
+class Enemy;
+
+/**
+ * @class AIScheduler
+ * @brief 敌人 AI 的集中调度：按与焦点（玩家）的距离分档降频，并限制每帧 AI 总耗时
+ *
+ * 登记的敌人不再在自身 update 中运行状态机，改由本调度器调用 Enemy::updateAI，
+ * 传入距上次运行累计的时间。重力、位移与贴地仍由敌人每帧自行处理。
+ * 近档每帧运行且不受预算限制；中、远档到期后在预算内轮流运行，超出预算的顺延到下一帧，
+ * 预算只计中、远档自身的耗时，且每帧至少运行一个到期的敌人。
+ * 运行前先为本帧到期的敌人采集位置快照，在工作线程上并行计算感知（距离、视锥、视线），
+ * 结果发布到各敌人后状态机只读取，不再各自遍历场景图。
+ */
+class AIScheduler : public cocos2d::Ref {
+public:
+    /**
+     * @enum Tier
+     * @brief 更新档位
+     */
+    enum Tier {
+        TIER_NEAR,   ///< 每帧
+        TIER_MID,    ///< 每 4 帧
+        TIER_FAR,    ///< 每 500 毫秒
+        TIER_COUNT
+    };
+
+    /**
+     * @brief 创建调度器
+     * @param frameBudgetMicros 每帧中、远档 AI 的耗时预算（微秒）
+     */
+    static AIScheduler* create(int frameBudgetMicros = 1000);
+
+    AIScheduler();
+    virtual ~AIScheduler();
+
+    bool init(int frameBudgetMicros);
+
+    /**
+     * @brief 设置距离焦点（通常为玩家；为空时使用默认相机）
+     */
+    void setFocus(cocos2d::Node* focus) { _focus = focus; }
+
+    /**
+     * @brief 设置分档距离：小于 nearRange 为近档，小于 midRange 为中档，其余为远档
+     */
+    void setTierRanges(float nearRange, float midRange);
+
+    void setFrameBudget(int micros) { _frameBudgetMicros = micros; }
+    int getFrameBudget() const { return _frameBudgetMicros; }
+
+    /**
+     * @brief 登记敌人（登记期间被 retain），之后其状态机由调度器驱动
+     */
+    void add(Enemy* enemy);
+
+    /**
+     * @brief 注销敌人，状态机恢复由敌人自身每帧更新
+     */
+    void remove(Enemy* enemy);
+
+    /**
+     * @brief 上一帧 AI 耗时（微秒）与运行的敌人数量，用于调试显示
+     */
+    int getLastFrameMicros() const { return _lastFrameMicros; }
+    int getLastFrameUpdates() const { return _lastFrameUpdates; }
+
+    /**
+     * @brief 每帧在人群更新与角色 update 之前执行
+     */
+    void update(float dt);
+
+private:
+    struct Brain {
+        Enemy* enemy;
+        Tier tier;
+        float pendingTime;      // 距上次运行累计的时间
+        unsigned int frames;    // 距上次运行经过的帧数
+    };
+
+    std::vector<Brain> _brains;
+    std::vector<int> _near;     // 本帧运行的近档下标（以下均为复用缓冲）
+    std::vector<int> _due;      // 本帧到期的中、远档下标
+    std::vector<cocos2d::Vec3> _selfPositions;  // 与 _brains 对齐的本帧世界坐标
+    std::vector<PerceptionInput> _senseInputs;
+    std::vector<PerceptionResult> _senseResults;
+    size_t _cursor = 0;         // 预算不足时的轮转起点，保证各敌人轮流获得时间片
+
+    cocos2d::Node* _focus = nullptr;    // 只是引用
+    float _nearRange = 800.0f;
+    float _midRange = 2000.0f;
+    int _frameBudgetMicros = 1000;
+
+    int _lastFrameMicros = 0;
+    int _lastFrameUpdates = 0;
+
+    Tier classify(const cocos2d::Vec3& focusPos, const cocos2d::Vec3& enemyPos) const;
+    void sense();
+    void run(Brain& brain);
+};
+
+#endif // __AI_SCHEDULER_H__
@@ -4,6 +4,7 @@
 #include "cocos2d.h"
 #include "scene_ui/UIManager.h"
 #include "combat/HealthComponent.h"
+#include "core/GameApp.h"
 
 USING_NS_CC;
 
@@ -53,9 +54,14 @@ bool Boss::initBoss(const std::string& resRoot, const std::string& modelFile) {
                 _phase = 2; // 设置为第二阶段
                 _health->fullHeal();
                 CCLOG("Boss: Phase 2 triggered! HP restored to 100%%");
+
+                BossPhaseChangeEvent event;
+                event.boss = this;
+                event.phase = _phase;
+                GameApp::getInstance()->getEventBus()->publish(event);
                 
                 if (_stateMachine) {
-                    _stateMachine->changeState("PhaseChange");
+                    _stateMachine->changeState(STATE_PHASE_CHANGE);
                 }
             }
         });
@@ -78,8 +84,8 @@ void Boss::resetEnemy() {
     CCLOG("Boss: Reset to initial state");
 }
 
-void Boss::update(float dt) {
-    Enemy::update(dt);
+void Boss::updateAI(float dt) {
+    Enemy::updateAI(dt);
 
     if (_ai) {
         _ai->update(dt);
@@ -87,7 +93,7 @@ void Boss::update(float dt) {
 }
 
 void Boss::initStateMachine() {
-    _stateMachine = new StateMachine<Enemy>(this);
+    _stateMachine = new FSM(this);
 
     _stateMachine->registerState(new BossIdleState());
     _stateMachine->registerState(new BossChaseState());
@@ -96,12 +102,13 @@ void Boss::initStateMachine() {
     _stateMachine->registerState(new BossHitState());
     _stateMachine->registerState(new BossDeadState());
 
-    _stateMachine->changeState("Chase");
+    _stateMachine->changeState(STATE_CHASE);
 }
 
 float Boss::distanceToPlayer() const {
     if (!getTarget()) return 1e9f;
-    return (getTargetWorldPos() - getWorldPosition3D()).length();
+    // 读取本次 AI 运行前发布的感知结果
+    return getPerception().distanceToTarget;
 }
 
 void Boss::setAI(BossAI* ai) {
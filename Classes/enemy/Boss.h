@@ -30,9 +30,9 @@ public:
     bool initBoss(const std::string& resRoot, const std::string& modelFile);
 
     /**
-     * @brief 每帧更新：先 Enemy::update，再 AI 决策（AI可后续接入）
+     * @brief AI 一步：状态机 + BossAI 决策（由 update 或 AIScheduler 调用）
      */
-    void update(float dt) override;
+    void updateAI(float dt) override;
 
     /**
      * @brief Boss 注册自己的状态（后续你写 BossStates 后在 cpp 里改这里）
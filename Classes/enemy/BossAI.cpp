@@ -72,7 +72,7 @@ void BossAI::update(float dt) {
     // 4) 阶段切换：HP <= 50%
     if (_boss->getPhase() == 1 && _boss->getHealthRatio() <= 0.5f) {
         _boss->setPhase(2);
-        _boss->getStateMachine()->changeState("PhaseChange"); // Roar 1s + buff 在 PhaseChangeState 里做
+        _boss->getStateMachine()->changeState(Enemy::STATE_PHASE_CHANGE); // Roar 1s + buff 在 PhaseChangeState 里做
         return;
     }
 
@@ -97,7 +97,7 @@ void BossAI::update(float dt) {
         for (auto* s : cands) {
             if (s->name == "LeapSlam") {
                 _boss->setPendingSkill("LeapSlam");
-                _boss->getStateMachine()->changeState("Attack");
+                _boss->getStateMachine()->changeState(Enemy::STATE_ATTACK);
                 _cdLeft["LeapSlam"] = s->cd;
                 return;
             }
@@ -109,11 +109,11 @@ void BossAI::update(float dt) {
         const BossAISkill* pick = pickByWeight(cands);
 
         _boss->setPendingSkill(pick->name);
-        _boss->getStateMachine()->changeState("Attack");
+        _boss->getStateMachine()->changeState(Enemy::STATE_ATTACK);
         _cdLeft[pick->name] = pick->cd;
         return;
     }
 
     // 9) 没技能：追击（你想加 strafe 也可以在这里切别的状态）
-    _boss->getStateMachine()->changeState("Chase");
+    _boss->getStateMachine()->changeState(Enemy::STATE_CHASE);
 }
@@ -2,6 +2,8 @@
 #include "BossStates.h"
 #include "Boss.h"
 #include "Wukong.h"
+#include "core/GameApp.h"
+#include "combat/CombatComponent.h"
 #include "cocos2d.h"
 #include <algorithm>
 #include <cmath>
@@ -34,35 +36,37 @@ static void faceToWorldDir(Enemy* e, Vec3 dirW, float yOffsetDeg = 45.0f) {
 static BossSkillConfig getCfg(const std::string& skill) {
     if (skill == "Combo3") {
         return BossSkillConfig{
-            "Combo3", "combo3",
+            "Combo3", Enemy::ANIM_COMBO3,
             0.35f, 0.0f, 0.50f, 0.65f,  // 增加所有时间参数以延长动画播放时间
-            0.f, M(1.2f), 12.f, false
+            0.f, M(1.2f), 12.f, false,
+            M(0.5f), M(0.6f)
         };
     }
     if (skill == "DashSlash") {
         return BossSkillConfig{
-            "DashSlash", "rush",
+            "DashSlash", Enemy::ANIM_RUSH,
             0.30f, 0.25f, 0.15f, 0.50f,
-            M(2.0f), M(1.4f), 16.f, true
+            M(2.0f), M(1.4f), 16.f, true,
+            M(0.6f), M(0.8f)
         };
     }
     if (skill == "GroundSlam") {
         return BossSkillConfig{
-            "GroundSlam", "groundslam",
+            "GroundSlam", Enemy::ANIM_GROUNDSLAM,
             0.60f, 0.0f, 0.20f, 0.80f,
             0.f, M(1.7f), 20.f, false
         };
     }
     if (skill == "Roar") {
         return BossSkillConfig{
-            "Roar", "roar",
+            "Roar", Enemy::ANIM_ROAR,
             1.00f, 0.0f, 0.0f, 0.0f,
             0.f, 0.f, 0.f, false
         };
     }
     if (skill == "LeapSlam") {
         return BossSkillConfig{
-            "LeapSlam", "rush",  // 首先播放rush动画
+            "LeapSlam", Enemy::ANIM_RUSH,  // 首先播放rush动画
             0.35f, 0.35f, 0.15f, 1.30f,  // 延长recovery时间以容纳第二个动画
             M(2.0f), M(3.0f), 26.f, true
         };
@@ -71,33 +75,33 @@ static BossSkillConfig getCfg(const std::string& skill) {
     return getCfg("Combo3");
 }
 
-static void applyHitOnce(Enemy* enemy, const BossSkillConfig& cfg, float dmgMul) {
-    if (!enemy) return;
-
-    Vec3 pW = enemy->getTargetWorldPos();
-    Vec3 eW = enemy->getWorldPosition3D();
-    float dist = (pW - eW).length();
-
-    if (dist <= cfg.hitRadius) {
-        float dmg = cfg.damage * dmgMul;
-        CCLOG("[BossAttack] %s HIT dmg=%.2f dist=%.1f", cfg.skill.c_str(), dmg, dist);
-
-        // 使用与普通敌人相同的减血逻辑
-        auto target = enemy->getTarget();
-        if (target && target->getHealth()) {
-            target->getHealth()->takeDamage(dmg, enemy);
-            CCLOG("Boss dealt %.2f damage to player", dmg);
-        }
-    }
-    else {
-        CCLOG("[BossAttack] %s miss dist=%.1f", cfg.skill.c_str(), dist);
+// 开始技能的扫掠判定：带武器胶囊的技能跟随右臂骨骼，其余以 Boss 为中心随其移动扫掠
+static void beginSkillSweep(Enemy* enemy, const BossSkillConfig& cfg, WeaponSweep& sweep) {
+    if (!enemy || !enemy->getCombat()) return;
+    if (cfg.hitRadius <= 0.f || cfg.damage <= 0.f) return;  // Roar 等无伤害技能
+
+    auto combatSystem = enemy->getCombat()->getCombatSystem();
+    if (cfg.weaponRadius > 0.f) {
+        sweep.begin(combatSystem, enemy, enemy->getSprite(), "lowerarm_r", "hand_r",
+                    cfg.weaponRadius, cfg.weaponReach);
+    } else {
+        sweep.begin(combatSystem, enemy, nullptr, "", "", cfg.hitRadius, 0.f);
     }
 }
 
+// 技能伤害为固定值：不暴击、不计防御
+static HitRequest skillDamage(const BossSkillConfig& cfg, float dmgMul) {
+    HitRequest request;
+    request.targetLayers = BroadPhase::LAYER_PLAYER;
+    request.damage = cfg.damage * dmgMul;
+    request.applyDefense = false;
+    return request;
+}
+
 // ================= Idle =================
 void BossIdleState::onEnter(Enemy* enemy) {
     if (!enemy) return;
-    enemy->playAnim("idle", true);
+    enemy->playAnim(Enemy::ANIM_IDLE, true);
 
     auto boss = static_cast<Boss*>(enemy);
     boss->setBusy(false);
@@ -106,7 +110,7 @@ void BossIdleState::onEnter(Enemy* enemy) {
 void BossIdleState::onUpdate(Enemy* enemy, float) {
     if (!enemy) return;
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 }
@@ -116,7 +120,7 @@ void BossIdleState::onExit(Enemy*) {}
 // ================= Chase =================
 void BossChaseState::onEnter(Enemy* enemy) {
     if (!enemy) return;
-    enemy->playAnim("chase", true);
+    enemy->playAnim(Enemy::ANIM_CHASE, true);
 
     auto boss = static_cast<Boss*>(enemy);
     boss->setBusy(false);
@@ -126,34 +130,33 @@ void BossChaseState::onUpdate(Enemy* enemy, float dt) {
     if (!enemy) return;
 
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
-    Vec3 pW = enemy->getTargetWorldPos();
-    if (pW == Vec3::ZERO) {
-        enemy->getStateMachine()->changeState("Idle");
+    const PerceptionResult& sense = enemy->getPerception();
+    if (!sense.hasTarget) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_IDLE);
         return;
     }
 
     auto boss = static_cast<Boss*>(enemy);
-    Vec3 eW = enemy->getWorldPosition3D();
+    const Vec3& pW = sense.targetPos;
+    const Vec3& eW = sense.selfPos;
 
     Vec3 dir = pW - eW;
     dir.y = 0;
     if (dir.lengthSquared() < 1e-6f) return;
-    dir.normalize();
-
-    faceToWorldDir(enemy, dir);
 
+    // 有导航时绕开障碍，朝向跟随实际移动方向
     float speed = enemy->getMoveSpeed() * boss->getMoveMul();
-    Vec3 newW = eW + dir * speed * dt;
-    newW.y = eW.y;
-
-    enemy->setPosition3D(worldToParentSpace(enemy, newW));
+    Vec3 moveDir = enemy->moveToward(pW, speed, dt);
+    faceToWorldDir(enemy, moveDir);
 }
 
-void BossChaseState::onExit(Enemy*) {}
+void BossChaseState::onExit(Enemy* enemy) {
+    if (enemy) enemy->stopMoving();
+}
 
 // ================= PhaseChange =================
 void BossPhaseChangeState::onEnter(Enemy* enemy) {
@@ -163,7 +166,7 @@ void BossPhaseChangeState::onEnter(Enemy* enemy) {
     CCLOG("Boss phase change triggered, playing roar animation");
 
     // 播放roar.c3b动画，这是BOSS血量降到50%以下时的特殊动画
-    enemy->playAnim("roar", false);
+    enemy->playAnim(Enemy::ANIM_ROAR, false);
 
     auto boss = static_cast<Boss*>(enemy);
     boss->setBusy(true);
@@ -173,7 +176,7 @@ void BossPhaseChangeState::onUpdate(Enemy* enemy, float dt) {
     if (!enemy) return;
 
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -184,7 +187,7 @@ void BossPhaseChangeState::onUpdate(Enemy* enemy, float dt) {
         boss->applyPhase2Buff(1.2f, 1.15f); 
         boss->setBusy(false);
 
-        enemy->getStateMachine()->changeState("Chase");
+        enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
     }
 }
 
@@ -225,7 +228,7 @@ void BossAttackState::onUpdate(Enemy* enemy, float dt) {
     if (!enemy) return;
 
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -268,16 +271,18 @@ void BossAttackState::onUpdate(Enemy* enemy, float dt) {
     // 3) Active
     if (_stage == Stage::Active) {
         if (!_didHit) {
-            applyHitOnce(enemy, _cfg, boss->getDmgMul());
+            beginSkillSweep(enemy, _cfg, _sweep);
             _didHit = true;
         }
+        _sweep.update(skillDamage(_cfg, boss->getDmgMul()));
 
         if (_timer >= _cfg.active) {
+            _sweep.end();
             gotoStage(Stage::Recovery);
 
             // 如果是LeapSlam技能，播放groundslam动画作为第二个动画
             if (_cfg.skill == "LeapSlam") {
-                enemy->playAnim("groundslam", false);
+                enemy->playAnim(Enemy::ANIM_GROUNDSLAM, false);
             }
         }
         return;
@@ -287,13 +292,14 @@ void BossAttackState::onUpdate(Enemy* enemy, float dt) {
     if (_stage == Stage::Recovery) {
         if (_timer >= _cfg.recovery) {
             boss->setBusy(false);
-            enemy->getStateMachine()->changeState("Chase");
+            enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
         }
         return;
     }
 }
 
 void BossAttackState::onExit(Enemy* enemy) {
+    _sweep.end();
     if (!enemy) return;
     auto boss = static_cast<Boss*>(enemy);
     boss->setBusy(false);
@@ -308,7 +314,7 @@ void BossHitState::onEnter(Enemy* enemy) {
     boss->setBusy(true);
 
     // 播放受击动画，确保使用正确的文件名
-    enemy->playAnim("hited", false);
+    enemy->playAnim(Enemy::ANIM_HITED, false);
     CCLOG("Boss hit state triggered, playing hited animation");
 }
 
@@ -316,7 +322,7 @@ void BossHitState::onUpdate(Enemy* enemy, float dt) {
     if (!enemy) return;
 
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -325,7 +331,7 @@ void BossHitState::onUpdate(Enemy* enemy, float dt) {
     if (_timer >= 0.8f) {
         auto boss = static_cast<Boss*>(enemy);
         boss->setBusy(false);
-        enemy->getStateMachine()->changeState("Chase");
+        enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
     }
 }
 
@@ -345,7 +351,7 @@ void BossDeadState::onEnter(Enemy* enemy) {
     CCLOG("Boss entering death state, playing dying animation");
 
     // 播放死亡动画 dying.c3b
-    enemy->playAnim("dying", false);
+    enemy->playAnim(Enemy::ANIM_DYING, false);
 
     // 与普通敌人一样的死亡处理流程：发送事件 + 延迟移除
     // 延长延迟时间至3秒以确保死亡动画完整播放
@@ -354,11 +360,10 @@ void BossDeadState::onEnter(Enemy* enemy) {
         CallFunc::create([enemy]() {
             CCLOG("Boss is being removed after death animation");
 
-            // 通知游戏管理器从敌人列表中移除此敌人
-            // 通过一个全局事件通知系统
-            cocos2d::EventCustom event("enemy_died");
-            event.setUserData(enemy);
-            cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&event);
+            // 通知场景从敌人列表中移除此敌人
+            EnemyRemovedEvent event;
+            event.enemy = enemy;
+            GameApp::getInstance()->getEventBus()->publish(event);
 
             // 执行实际的移除操作
             enemy->removeFromParent();
@@ -6,11 +6,12 @@
 #include <string>
 #include "combat/HealthComponent.h"
 #include "combat/CombatComponent.h"
+#include "combat/WeaponSweep.h"
 
 // ========== 技能配置（AttackState 用）==========
 struct BossSkillConfig {
     std::string skill;   // "Combo3" / "DashSlash" / "GroundSlam" / "Roar" / "LeapSlam"
-    std::string anim;    // 对应动画文件名（不带 .c3b）
+    Enemy::AnimClip anim = Enemy::ANIM_COMBO3;  // 对应动画片段
 
     float windup = 0.f;    // 前摇
     float moveTime = 0.f;  // 位移时间（Dash/Leap 用）
@@ -21,6 +22,9 @@ struct BossSkillConfig {
     float hitRadius = 0.f;    // 命中球半径（世界单位）
     float damage = 0.f;       // 伤害（先打印，后面再接你的扣血）
     bool  lockTarget = true;  // 是否锁定落点
+
+    float weaponRadius = 0.f; // 右臂武器胶囊半径（0 表示以 Boss 为中心、半径 hitRadius 的范围判定）
+    float weaponReach = 0.f;  // 胶囊从手部沿前臂方向外延的长度
 };
 
 // ========== Boss Idle ==========
@@ -29,7 +33,8 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "Idle"; }
+    int getStateId() const override { return Enemy::STATE_IDLE; }
+    const char* getStateName() const override { return "Idle"; }
 };
 
 // ========== Boss Chase ==========
@@ -38,7 +43,8 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "Chase"; }
+    int getStateId() const override { return Enemy::STATE_CHASE; }
+    const char* getStateName() const override { return "Chase"; }
 };
 
 // ========== Phase Change (Roar 1s) ==========
@@ -47,7 +53,8 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "PhaseChange"; }
+    int getStateId() const override { return Enemy::STATE_PHASE_CHANGE; }
+    const char* getStateName() const override { return "PhaseChange"; }
 private:
     float _timer = 0.f;
 };
@@ -58,16 +65,18 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "Attack"; }
+    int getStateId() const override { return Enemy::STATE_ATTACK; }
+    const char* getStateName() const override { return "Attack"; }
 
 private:
     enum class Stage { Windup, Move, Active, Recovery };
     Stage _stage = Stage::Windup;
 
     float _timer = 0.f;
-    bool  _didHit = false;
+    bool  _didHit = false;   // 本次生效窗口是否已开始判定
 
     BossSkillConfig _cfg;
+    WeaponSweep _sweep;      // 生效窗口内逐帧扫掠判定，整个窗口对同一目标只命中一次
 
     cocos2d::Vec3 _startW = cocos2d::Vec3::ZERO;
     cocos2d::Vec3 _targetW = cocos2d::Vec3::ZERO;  // 位移目标（锁定）
@@ -79,7 +88,8 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "Hit"; }
+    int getStateId() const override { return Enemy::STATE_HIT; }
+    const char* getStateName() const override { return "Hit"; }
 private:
     float _timer = 0.f;
 };
@@ -90,5 +100,6 @@ public:
     void onEnter(Enemy* enemy) override;
     void onUpdate(Enemy* enemy, float dt) override;
     void onExit(Enemy* enemy) override;
-    std::string getStateName() const override { return "Dead"; }
+    int getStateId() const override { return Enemy::STATE_DEAD; }
+    const char* getStateName() const override { return "Dead"; }
 };
@@ -3,7 +3,64 @@
 #include "combat/HealthComponent.h"
 #include "combat/CombatComponent.h"
 #include "combat/Collider.h"
+#include "EnemyNavigation.h"
 #include "player/Wukong.h"
+#include "core/GameApp.h"
+#include <unordered_map>
+
+// 状态切换时的动画交叉淡化时长（秒）
+static const float kAnimFadeTime = 0.15f;
+
+// 模型朝向与移动方向之间的偏航偏移（度），faceDirection 加上、gatherPerception 减去
+static const float kModelYawOffset = 45.0f;
+
+// AnimClip 对应的文件名（不带 .c3b）
+static const char* const kAnimClipFiles[Enemy::ANIM_COUNT] = {
+    "idle", "patrol", "chase", "attack", "hited", "dying",
+    "roar", "combo3", "rush", "groundslam", "dodge"
+};
+
+/**
+ * @brief 每个原型（resRoot）一张动画片段表，首次创建该原型的敌人时加载，之后共享
+ * 表中的 Animation3D 被 retain，生命周期与程序相同
+ */
+struct AnimClipTable {
+    cocos2d::Animation3D* clips[Enemy::ANIM_COUNT];
+};
+
+static const AnimClipTable& getAnimClipTable(const std::string& resRoot) {
+    static std::unordered_map<std::string, AnimClipTable> s_tables;
+
+    auto it = s_tables.find(resRoot);
+    if (it != s_tables.end()) return it->second;
+
+    AnimClipTable& table = s_tables[resRoot];
+    auto fileUtils = FileUtils::getInstance();
+    for (int i = 0; i < Enemy::ANIM_COUNT; ++i) {
+        std::string file = resRoot + "/" + kAnimClipFiles[i] + ".c3b";
+        table.clips[i] = fileUtils->isFileExist(file) ? cocos2d::Animation3D::create(file) : nullptr;
+        if (table.clips[i]) {
+            table.clips[i]->retain();
+        }
+    }
+    return table;
+}
+
+void Enemy::preloadAssets(AssetLoader* loader, const std::string& resRoot,
+                          const std::string& modelFile,
+                          const std::vector<AssetLoader::AssetId>& modelDeps) {
+    if (!loader) return;
+    loader->addModel(resRoot + "/" + modelFile, modelDeps);
+
+    // 与 getAnimClipTable 相同的路径与存在性判断，保证加载结果命中 Animation3DCache
+    auto fileUtils = FileUtils::getInstance();
+    for (int i = 0; i < Enemy::ANIM_COUNT; ++i) {
+        std::string file = resRoot + "/" + kAnimClipFiles[i] + ".c3b";
+        if (fileUtils->isFileExist(file)) {
+            loader->addAnimation(file);
+        }
+    }
+}
 
 Enemy* Enemy::create() {
     auto enemy = new (std::nothrow) Enemy();
@@ -29,10 +86,17 @@ Enemy::Enemy()
     , _targetPosition(Vec3::ZERO)
     , _birthPosition(0, 100, 0)
     , _maxChaseRange(1000.0f)
+    , _animator(nullptr)
     , _terrainCollider(nullptr)
+    , _navigation(nullptr)
+    , _aiScheduler(nullptr)
+    , _navMoving(false)
     , _velocity(Vec3::ZERO)
     , _onGround(true)
 {
+    for (int i = 0; i < ANIM_COUNT; ++i) {
+        _clips[i] = nullptr;
+    }
 }
 
 Enemy::~Enemy() {
@@ -71,9 +135,13 @@ bool Enemy::init() {
 void Enemy::update(float deltaTime) {
     Node::update(deltaTime);
     
-    // 更新状态机
-    if (_stateMachine) {
-        _stateMachine->update(deltaTime);
+    // 未登记到 AI 调度器时每帧自行感知并更新状态机
+    if (!_aiScheduler) {
+        const Vec3 selfWorld = getWorldPosition3D();
+        PerceptionInput in;
+        gatherPerception(in, selfWorld, getTargetWorldPos());
+        AIPerception::sense(in, _perception);
+        updateAI(deltaTime);
     }
 
     applyGravity(deltaTime);
@@ -83,6 +151,27 @@ void Enemy::update(float deltaTime) {
     _collider.update(this);
 }
 
+void Enemy::gatherPerception(PerceptionInput& in, const Vec3& selfWorld, const Vec3& targetWorld) const {
+    in.terrain = _terrainCollider;
+    in.selfPos = selfWorld;
+    in.birthPos = _birthPosition;
+    if (auto p = getParent()) {
+        p->getNodeToWorldTransform().transformPoint(_birthPosition, &in.birthPos);
+    }
+    in.targetPos = targetWorld;
+    in.viewRange = _viewRange;
+    in.hasTarget = _target && !_target->isDead();
+
+    float yaw = _sprite ? CC_DEGREES_TO_RADIANS(_sprite->getRotation3D().y - kModelYawOffset) : 0.0f;
+    in.forward.set(sinf(yaw), 0.0f, cosf(yaw));
+}
+
+void Enemy::updateAI(float deltaTime) {
+    if (_stateMachine) {
+        _stateMachine->update(deltaTime);
+    }
+}
+
 void Enemy::applyGravity(float dt) {
     if (_onGround && _terrainCollider) {
         return;
@@ -90,44 +179,67 @@ void Enemy::applyGravity(float dt) {
     _velocity.y -= _gravity * dt;
 }
 
+Vec3 Enemy::moveToward(const Vec3& worldTarget, float speed, float dt) {
+    if (_navigation && _navigation->requestMove(this, worldTarget, speed)) {
+        _navMoving = true;
+        Vec3 agentPos, agentVel;
+        _navigation->getAgentState(this, agentPos, agentVel);
+        agentVel.y = 0.0f;
+        if (agentVel.lengthSquared() > 1e-6f) {
+            agentVel.normalize();
+            return agentVel;
+        }
+        return Vec3::ZERO;
+    }
+
+    const Vec3 worldPos = getWorldPosition3D();
+    Vec3 dir = worldTarget - worldPos;
+    dir.y = 0.0f;
+    float dist = dir.length();
+    if (dist < 1e-3f) return Vec3::ZERO;
+    dir.normalize();
+
+    float step = speed * dt;
+    if (step > dist) step = dist;
+    Vec3 newWorld = worldPos + dir * step;
+
+    // 世界坐标转回父节点坐标再设置位置
+    Vec3 newPos = newWorld;
+    if (auto p = getParent()) {
+        p->getWorldToNodeTransform().transformPoint(newWorld, &newPos);
+    }
+    this->setPosition3D(newPos);
+    return dir;
+}
+
+void Enemy::stopMoving() {
+    if (_navMoving && _navigation) {
+        _navigation->stopMove(this);
+    }
+    _navMoving = false;
+}
+
 void Enemy::applyMovement(float dt) {
     Vec3 oldPos = this->getPosition3D();
     Vec3 newPos = oldPos + _velocity * dt;
 
-    if (_terrainCollider) {
-        // 射线检测新位置地面
-        CustomRay ray(newPos + Vec3(0, 500, 0), Vec3(0, -1, 0));
-        float hitDist;
-
-        if (_terrainCollider->rayIntersects(ray, hitDist)) {
-            float groundY = ray.origin.y - hitDist;
-            const float MAX_STEP_HEIGHT = 40.0f;
-
-            if (groundY - oldPos.y < MAX_STEP_HEIGHT) {
-                newPos.y = groundY;
-                this->setPosition3D(newPos);
-                
-                if (!_onGround && _velocity.y <= 0) {
-                    _onGround = true;
-                    _velocity.y = 0;
-                }
-            } else {
-                // 坡度太陡
-                Vec3 finalPos = oldPos;
-                finalPos.y += _velocity.y * dt; 
-                
-                if (finalPos.y <= groundY) {
-                    finalPos.y = groundY;
-                    _onGround = true;
-                    _velocity.y = 0;
-                }
-                this->setPosition3D(finalPos);
-            }
-        } else {
-            // 没检测到地面
-            this->setPosition3D(newPos);
-            _onGround = false;
+    // 由人群驱动时 XZ 取自代理（已做寻路与避让），高度仍由下方贴地决定
+    Vec3 agentPos, agentVel;
+    if (_navMoving && _navigation && _navigation->getAgentState(this, agentPos, agentVel)) {
+        Vec3 local = agentPos;
+        if (auto p = getParent()) {
+            p->getWorldToNodeTransform().transformPoint(agentPos, &local);
         }
+        newPos.x = local.x;
+        newPos.z = local.z;
+    }
+
+    if (_terrainCollider) {
+        // 射线检测新位置地面：与其他角色合并为一次批量检测
+        _snapOldPos = oldPos;
+        _snapNewPos = newPos;
+        _snapDt = dt;
+        _terrainCollider->requestGroundSnap(this, this, newPos);
     } else {
         this->setPosition3D(newPos);
         if (newPos.y <= 0.0f) {
@@ -140,6 +252,46 @@ void Enemy::applyMovement(float dt) {
     }
 }
 
+void Enemy::onGroundSnap(bool hit, float groundY, const Vec3& groundNormal) {
+    const Vec3& oldPos = _snapOldPos;
+    Vec3 newPos = _snapNewPos;
+    const float dt = _snapDt;
+
+    if (hit) {
+        const float MAX_STEP_HEIGHT = 40.0f;
+        const float MIN_GROUND_NORMAL_Y = 0.5f; // 可行走的最大坡度约 60°
+
+        bool tooSteep = groundY > oldPos.y && groundNormal.y < MIN_GROUND_NORMAL_Y;
+        if (groundY - oldPos.y < MAX_STEP_HEIGHT && !tooSteep) {
+            newPos.y = groundY;
+            this->setPosition3D(newPos);
+            
+            if (!_onGround && _velocity.y <= 0) {
+                _onGround = true;
+                _velocity.y = 0;
+            }
+        } else {
+            // 坡度太陡
+            Vec3 finalPos = oldPos;
+            finalPos.y += _velocity.y * dt; 
+            
+            if (finalPos.y <= groundY) {
+                finalPos.y = groundY;
+                _onGround = true;
+                _velocity.y = 0;
+            }
+            this->setPosition3D(finalPos);
+        }
+    } else {
+        // 没检测到地面
+        this->setPosition3D(newPos);
+        _onGround = false;
+    }
+
+    // 位置已确定，刷新世界空间 AABB
+    _collider.update(this);
+}
+
 float Enemy::getMoveSpeed() const {
     return _moveSpeed;
 }
@@ -196,7 +348,7 @@ Vec3 Enemy::getPosition3D() const {
     return Node::getPosition3D();
 }
 
-StateMachine<Enemy>* Enemy::getStateMachine() const {
+Enemy::FSM* Enemy::getStateMachine() const {
     return _stateMachine;
 }
 
@@ -204,6 +356,12 @@ Sprite3D* Enemy::getSprite() const {
     return _sprite;
 }
 
+void Enemy::faceDirection(const Vec3& dir) {
+    if (!_sprite || (dir.x == 0.0f && dir.z == 0.0f)) return;
+    float angle = CC_RADIANS_TO_DEGREES(atan2f(dir.x, dir.z)) + kModelYawOffset;
+    _sprite->setRotation3D(Vec3(0, angle, 0));
+}
+
 // 设置出生点
 void Enemy::setBirthPosition(const Vec3& pos) {
     _birthPosition = pos;
@@ -220,7 +378,7 @@ float Enemy::getMaxChaseRange() const {
 }
 void Enemy::initStateMachine() {
     // 创建状态机实例
-    _stateMachine = new StateMachine<Enemy>(this);
+    _stateMachine = new FSM(this);
     
     // 注册所有状态
     _stateMachine->registerState(new EnemyIdleState());
@@ -232,7 +390,7 @@ void Enemy::initStateMachine() {
     _stateMachine->registerState(new ReturnState());
 
     // 初始化为待机状态（使用已注册的状态）
-    _stateMachine->changeState("Idle");
+    _stateMachine->changeState(STATE_IDLE);
 }
 
 void Enemy::initHealthComponent() {
@@ -261,9 +419,15 @@ void Enemy::initCombatComponent() {
 }
 
 void Enemy::onHurtCallback(float damage, Node* attacker) {
+    EnemyHurtEvent event;
+    event.enemy = this;
+    event.attacker = attacker;
+    event.damage = damage;
+    GameApp::getInstance()->getEventBus()->publish(event);
+
     // 对于Boss类型的敌人，直接切换到Hit状态以播放受击动画
     if (_enemyType == EnemyType::BOSS && _stateMachine && !isDead()) {
-        _stateMachine->changeState("Hit");
+        _stateMachine->changeState(STATE_HIT);
         return;
     }
 
@@ -279,7 +443,7 @@ void Enemy::onHurtCallback(float damage, Node* attacker) {
 
     // 切换到受击状态
     if (_stateMachine) {
-        _stateMachine->changeState("Hit");
+        _stateMachine->changeState(STATE_HIT);
     }
 
     // 一段时间后恢复移动和攻击能力
@@ -303,8 +467,13 @@ void Enemy::onDeadCallback(Node* attacker) {
 
     CCLOG("Enemy onDeadCallback triggered, changing state to Dead");
 
+    EnemyDeadEvent event;
+    event.enemy = this;
+    event.attacker = attacker;
+    GameApp::getInstance()->getEventBus()->publish(event);
+
     if (_stateMachine) {
-        _stateMachine->changeState("Dead");
+        _stateMachine->changeState(STATE_DEAD);
     }
     else {
         CCLOG("WARNING: Enemy state machine is null, cannot change to Dead state!");
@@ -377,6 +546,12 @@ bool Enemy::initWithResRoot(const std::string& resRoot, const std::string& model
     _sprite->setCullFaceEnabled(false);
     this->addChild(_sprite);
 
+    // 敌人子树只有模型，可以与相邻的敌人在工作线程上并行遍历、生成渲染命令
+    this->setParallelVisit(true);
+
+    // 预加载动画片段
+    loadAnimClips();
+
     // 更新精灵位置（包含 AABB 修正和初始偏移）
     updateSpritePosition();
 
@@ -403,17 +578,24 @@ Enemy* Enemy::createWithResRoot(const std::string& resRoot,
 }
 
 //加载动画
-void Enemy::playAnim(const std::string& name, bool loop) {
-    if (!_sprite) return;
-    _sprite->stopAllActions();
+void Enemy::loadAnimClips() {
+    const AnimClipTable& table = getAnimClipTable(_resRoot);
+    for (int i = 0; i < ANIM_COUNT; ++i) {
+        _clips[i] = table.clips[i];
+    }
+
+    _animator = cocos2d::Animator3D::create();
+    _sprite->addComponent(_animator);
+}
+
+void Enemy::playAnim(AnimClip clip, bool loop) {
+    if (!_animator) return;
 
-    std::string file = _resRoot + "/" + name + ".c3b";
-    auto anim = cocos2d::Animation3D::create(file);
-    if (!anim) { CCLOG("Anim load failed: %s", file.c_str()); return; }
+    auto anim = _clips[clip];
+    if (!anim) { CCLOG("Anim clip %s missing in %s", kAnimClipFiles[clip], _resRoot.c_str()); return; }
 
-    auto act = cocos2d::Animate3D::create(anim);
-    if (loop) _sprite->runAction(cocos2d::RepeatForever::create(act));
-    else _sprite->runAction(act);
+    // 在基础层上从当前动画交叉淡化过去，不再 stopAllActions / 新建动作
+    _animator->play(anim, loop, kAnimFadeTime);
 }
 
 void Enemy::resetEnemy() {
@@ -422,7 +604,7 @@ void Enemy::resetEnemy() {
     }
     this->setPosition3D(_birthPosition);
     if (_stateMachine) {
-        _stateMachine->changeState("Idle");
+        _stateMachine->changeState(STATE_IDLE);
     }
     CCLOG("Enemy %p reset to birth position.", this);
 }
\ No newline at end of file
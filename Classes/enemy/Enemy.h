@@ -5,19 +5,24 @@
 
 #include "cocos2d.h"
 #include "core/StateMachine.h"
+#include "core/AssetLoader.h"
 #include "combat/CharacterCollider.h"
+#include "combat/Collider.h"
+#include "AIPerception.h"
 
 USING_NS_CC;
 class HealthComponent;
 class CombatComponent;
 class TerrainCollider;
 class Wukong;
+class EnemyNavigation;
+class AIScheduler;
 
 /**
  * @class Enemy
  * @brief 敌人基类，所有敌人类型都继承自此类
  */
-class Enemy : public Node {
+class Enemy : public Node, public GroundSnapListener {
 public:
     /**
      * @enum EnemyType
@@ -27,6 +32,46 @@ public:
         NORMAL,  ///< 普通敌人
         BOSS     ///< BOSS敌人
     };
+
+    /**
+     * @enum StateId
+     * @brief 状态 ID（状态机表下标），普通敌人与 Boss 的同名状态共用同一 ID
+     */
+    enum StateId {
+        STATE_IDLE,          ///< 待机
+        STATE_PATROL,        ///< 巡逻（普通敌人）
+        STATE_CHASE,         ///< 追击
+        STATE_ATTACK,        ///< 攻击
+        STATE_HIT,           ///< 受击
+        STATE_DEAD,          ///< 死亡
+        STATE_RETURN,        ///< 回出生点（普通敌人）
+        STATE_PHASE_CHANGE,  ///< 阶段切换（Boss）
+        STATE_COUNT
+    };
+
+    /**
+     * @brief 敌人状态机（状态表容量为 STATE_COUNT）
+     */
+    typedef StateMachine<Enemy, STATE_COUNT> FSM;
+
+    /**
+     * @enum AnimClip
+     * @brief 动画片段 ID，对应 resRoot 下的同名 .c3b 文件（缺失的片段不加载）
+     */
+    enum AnimClip {
+        ANIM_IDLE,        ///< idle.c3b
+        ANIM_PATROL,      ///< patrol.c3b
+        ANIM_CHASE,       ///< chase.c3b
+        ANIM_ATTACK,      ///< attack.c3b
+        ANIM_HITED,       ///< hited.c3b
+        ANIM_DYING,       ///< dying.c3b
+        ANIM_ROAR,        ///< roar.c3b（Boss）
+        ANIM_COMBO3,      ///< combo3.c3b（Boss）
+        ANIM_RUSH,        ///< rush.c3b（Boss）
+        ANIM_GROUNDSLAM,  ///< groundslam.c3b（Boss）
+        ANIM_DODGE,       ///< dodge.c3b（Boss）
+        ANIM_COUNT
+    };
     
     /**
      * @brief 创建敌人实例
@@ -55,6 +100,37 @@ public:
      * @param deltaTime 帧间隔时间
      */
     virtual void update(float deltaTime) override;
+
+    /**
+     * @brief 运行 AI（状态机）一步
+     * 未登记到 AIScheduler 时每帧由 update 调用，否则由调度器按档位调用
+     * @param deltaTime 距上次运行累计的时间
+     */
+    virtual void updateAI(float deltaTime);
+
+    /**
+     * @brief 设置 AI 调度器（由 AIScheduler::add / remove 调用）
+     */
+    void setAIScheduler(AIScheduler* scheduler) { _aiScheduler = scheduler; }
+    AIScheduler* getAIScheduler() const { return _aiScheduler; }
+
+    /**
+     * @brief 采集感知输入快照（主线程）
+     * @param in 输出：感知输入
+     * @param selfWorld 本敌人世界坐标（调用方已算好）
+     * @param targetWorld 目标世界坐标（同一目标的多个敌人共用一次计算）
+     */
+    void gatherPerception(PerceptionInput& in, const Vec3& selfWorld, const Vec3& targetWorld) const;
+
+    /**
+     * @brief 发布感知结果（AI 运行前由调度器或 update 写入）
+     */
+    void setPerception(const PerceptionResult& result) { _perception = result; }
+
+    /**
+     * @brief 本次 AI 运行使用的感知结果（状态机只读，不再自行遍历场景图）
+     */
+    const PerceptionResult& getPerception() const { return _perception; }
     
     /**
      * @brief 获取移动速度
@@ -109,6 +185,28 @@ public:
      */
     void setTerrainCollider(TerrainCollider* collider) { _terrainCollider = collider; }
 
+    /**
+     * @brief 设置导航（敌人需已通过 EnemyNavigation::addEnemy 登记）
+     */
+    void setNavigation(EnemyNavigation* navigation) { _navigation = navigation; }
+    EnemyNavigation* getNavigation() const { return _navigation; }
+
+    /**
+     * @brief 朝世界坐标目标移动一帧
+     * 有人群代理时只提交目标，位移由 EnemyNavigation 统一计算、在 applyMovement 中应用；
+     * 否则沿直线移动（不越过目标）
+     * @param worldTarget 世界坐标目标点
+     * @param speed 移动速度
+     * @param dt 帧间隔
+     * @return Vec3 本帧水平移动方向（世界坐标，单位向量；未移动时为零向量）
+     */
+    Vec3 moveToward(const Vec3& worldTarget, float speed, float dt);
+
+    /**
+     * @brief 停止 moveToward 发起的移动
+     */
+    void stopMoving();
+
     /**
      * @brief 获取碰撞组件
      */
@@ -145,9 +243,9 @@ public:
     
     /**
      * @brief 获取状态机
-     * @return StateMachine<Enemy>* 状态机指针
+     * @return FSM* 状态机指针
      */
-    StateMachine<Enemy>* getStateMachine() const;
+    FSM* getStateMachine() const;
     
     /**
      * @brief 获取3D精灵
@@ -155,6 +253,12 @@ public:
      */
     Sprite3D* getSprite() const;
 
+    /**
+     * @brief 让模型面向水平方向（含模型自身的偏航偏移，gatherPerception 据此反推视线方向）
+     * @param dir 朝向（世界空间，y 分量忽略；零向量时不改变朝向）
+     */
+    void faceDirection(const Vec3& dir);
+
     /**
     * @brief 设置出生点（一般在 init 中调用）
     */
@@ -183,9 +287,27 @@ public:
     bool initWithResRoot(const std::string& resRoot,
         const std::string& modelFile);
 
+    /**
+     * @brief 向加载器登记该原型的模型与动画片段，加载后 createWithResRoot 直接命中缓存
+     * @param modelDeps 模型的依赖（通常为其材质贴图）
+     */
+    static void preloadAssets(AssetLoader* loader, const std::string& resRoot,
+        const std::string& modelFile,
+        const std::vector<AssetLoader::AssetId>& modelDeps = {});
+
     const std::string& getResRoot() const { return _resRoot; }
 
-    void playAnim(const std::string& name, bool loop); // name="idle"/"chase"..
+    /**
+     * @brief 播放动画片段（在 Animator3D 基础层上交叉淡化，切换时不做字符串处理与分配）
+     * @param clip 动画片段 ID
+     * @param loop 是否循环
+     */
+    void playAnim(AnimClip clip, bool loop);
+
+    /**
+     * @brief 贴地批量检测结果回调（由 TerrainCollider 每帧统一调用）
+     */
+    void onGroundSnap(bool hit, float groundY, const Vec3& groundNormal) override;
     
     /**
      * @brief 重置敌人状态（用于复活时重置）
@@ -213,6 +335,11 @@ protected:
      */
     void applyMovement(float dt);
 
+    /**
+     * @brief 加载本原型的动画片段表（同一 resRoot 只加载一次），并为 _sprite 挂载 Animator3D
+     */
+    void loadAnimClips();
+
     /**
      * @brief 检查是否处于低血量状态
      * @return bool 是否处于低血量状态
@@ -247,7 +374,7 @@ protected:
     void onDeadCallback(Node* attacker);
     
     EnemyType _enemyType;              // 敌人类型
-    StateMachine<Enemy>* _stateMachine; // 状态机指针
+    FSM* _stateMachine;                 // 状态机指针
     
     HealthComponent* _health;          // 生命值组件
     CombatComponent* _combat;          // 战斗组件
@@ -270,13 +397,24 @@ protected:
     std::string _resRoot;   // 例如 "Enemy/enemy1" 或 "Enemy/boss"
     std::string _modelFile; // 例如 "enemy1.c3b" 或 "boss.c3b"
 
+    // 动画片段（按 AnimClip 索引，缺失的片段为 nullptr）
+    cocos2d::Animation3D* _clips[ANIM_COUNT];  // 由原型片段表持有
+    cocos2d::Animator3D* _animator;            // 挂在 _sprite 上的动画组件，由 _sprite 持有
+
     // 物理与碰撞
     TerrainCollider* _terrainCollider = nullptr;
+    EnemyNavigation* _navigation = nullptr; // 只是引用，由场景持有
+    AIScheduler* _aiScheduler = nullptr;    // 只是引用，非空时状态机由调度器驱动
+    PerceptionResult _perception;           // 最近一次发布的感知结果
+    bool _navMoving = false;                // 本帧 XZ 位置是否取自人群代理
     CharacterCollider _collider;
     Vec3 _velocity = Vec3::ZERO;
     bool _onGround = true;
     const float _gravity = 980.0f;
     float _spriteOffsetY = 0.0f; // 模型额外偏移
+    Vec3 _snapOldPos;            // 贴地请求时的原位置
+    Vec3 _snapNewPos;            // 贴地请求时的目标位置
+    float _snapDt = 0.0f;        // 贴地请求时的帧间隔
 
 };
 
@@ -0,0 +1,475 @@
+#include "EnemyNavigation.h"
+#include "Enemy.h"
+#include "combat/Collider.h"
+#include "combat/CookedCollisionMesh.h"
+#include "recast/Recast/Recast.h"
+#include "recast/Detour/DetourAlloc.h"
+#include "recast/Detour/DetourNavMesh.h"
+#include "recast/Detour/DetourNavMeshBuilder.h"
+#include "recast/Detour/DetourNavMeshQuery.h"
+#include "recast/DetourCrowd/DetourCrowd.h"
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+USING_NS_CC;
+
+// 人群更新在所有角色 update（优先级 0）之前执行，角色本帧直接读取积分后的代理位置
+static const int kCrowdPriority = -1;
+// 目标点移动超过该距离才重新寻路（单位：代理半径的倍数）
+static const float kRetargetRadiusScale = 0.5f;
+// 敌人位置与代理位置偏差超过该距离时视为被外部移动（冲刺、复位、贴地失败），重建代理（单位：代理半径的倍数）
+static const float kResyncRadiusScale = 0.5f;
+// 可走多边形的 Detour 标记（默认过滤器要求 flags 非 0）
+static const unsigned short kPolyFlagWalk = 0x01;
+// 单次寻路的多边形 / 拐点上限
+static const int kMaxPathPolys = 256;
+
+namespace {
+    const char kNavCacheMagic[4] = { 'W', 'K', 'N', 'V' };
+    const uint32_t kNavCacheVersion = 1;
+    const char* const kNavCacheExtension = ".wknav";
+
+    /**
+     * @brief 导航缓存文件头，其后紧跟 dtCreateNavMeshData 生成的单块数据
+     */
+    struct NavCacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t geometryHash;  ///< 地形顶点与索引的哈希，地形变化后缓存失效
+        uint32_t configHash;    ///< 烘焙参数的哈希
+        uint32_t dataSize;
+    };
+
+    uint32_t fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ p[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    std::string navCachePathFor(const std::string& objFilePath) {
+        std::string path = CookedCollisionMesh::cachePathFor(objFilePath);
+        size_t dot = path.find_last_of('.');
+        return path.substr(0, dot) + kNavCacheExtension;
+    }
+
+    // 敌人坐标均相对父节点，导航网格在世界空间
+    Vec3 parentToWorld(const Node* node, const Vec3& pos) {
+        auto p = node->getParent();
+        if (!p) return pos;
+        Vec3 out;
+        p->getNodeToWorldTransform().transformPoint(pos, &out);
+        return out;
+    }
+}
+
+struct EnemyNavigation::BakeResult {
+    unsigned char* navData = nullptr;  // dtAlloc 分配，交给 dtNavMesh 后由其释放
+    int navDataSize = 0;
+    bool fromCache = false;
+};
+
+EnemyNavigation* EnemyNavigation::create(TerrainCollider* terrain, const std::string& objFilePath,
+                                         const NavBakeConfig& config, int maxAgents) {
+    auto pRet = new (std::nothrow) EnemyNavigation();
+    if (pRet && pRet->init(terrain, objFilePath, config, maxAgents)) {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return nullptr;
+}
+
+EnemyNavigation::EnemyNavigation() {
+}
+
+EnemyNavigation::~EnemyNavigation() {
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& m : _members) {
+        m.enemy->release();
+    }
+    dtFreeCrowd(_crowd);
+    dtFreeNavMesh(_navMesh);
+}
+
+bool EnemyNavigation::init(TerrainCollider* terrain, const std::string& objFilePath,
+                           const NavBakeConfig& config, int maxAgents) {
+    if (!terrain || maxAgents <= 0) return false;
+    _config = config;
+    _maxAgents = maxAgents;
+    _cachePath = navCachePathFor(objFilePath);
+
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, kCrowdPriority, false);
+
+    // 烘焙期间保持自身与地形存活，回调中释放
+    this->retain();
+    terrain->retain();
+    auto result = std::make_shared<BakeResult>();
+    const std::string cachePath = _cachePath;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER,
+        [this, terrain, result](void*) {
+            onBakeFinished(*result);
+            terrain->release();
+            this->release();
+        },
+        nullptr,
+        [terrain, config, cachePath, result]() {
+            loadOrBake(terrain, config, cachePath, *result);
+        });
+    return true;
+}
+
+void EnemyNavigation::loadOrBake(TerrainCollider* terrain, const NavBakeConfig& config,
+                                 const std::string& cachePath, BakeResult& result) {
+    const float* verts = terrain->getVertices();
+    const uint32_t* tris = terrain->getIndices();
+    const int vertCount = terrain->getVertexCount();
+    const int triCount = terrain->getTriangleCount();
+    if (!verts || !tris || triCount <= 0) return;
+
+    const uint32_t geometryHash = fnv1a(tris, sizeof(uint32_t) * 3 * triCount,
+                                        fnv1a(verts, sizeof(float) * 3 * vertCount));
+    const uint32_t configHash = fnv1a(&config, sizeof(config));
+
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist(cachePath)) {
+        Data data = fileUtils->getDataFromFile(cachePath);
+        NavCacheHeader header;
+        const size_t dataSize = data.getSize() > 0 ? (size_t)data.getSize() : 0;
+        if (dataSize >= sizeof(header)) {
+            memcpy(&header, data.getBytes(), sizeof(header));
+            if (memcmp(header.magic, kNavCacheMagic, sizeof(kNavCacheMagic)) == 0 &&
+                header.version == kNavCacheVersion &&
+                header.geometryHash == geometryHash && header.configHash == configHash &&
+                header.dataSize > 0 && dataSize == sizeof(header) + header.dataSize) {
+                result.navData = static_cast<unsigned char*>(dtAlloc(header.dataSize, DT_ALLOC_PERM));
+                if (result.navData) {
+                    memcpy(result.navData, data.getBytes() + sizeof(header), header.dataSize);
+                    result.navDataSize = (int)header.dataSize;
+                    result.fromCache = true;
+                    return;
+                }
+            }
+        }
+    }
+
+    if (!bake(verts, vertCount, tris, triCount, config, &result.navData, &result.navDataSize)) {
+        return;
+    }
+
+    NavCacheHeader header;
+    memcpy(header.magic, kNavCacheMagic, sizeof(kNavCacheMagic));
+    header.version = kNavCacheVersion;
+    header.geometryHash = geometryHash;
+    header.configHash = configHash;
+    header.dataSize = (uint32_t)result.navDataSize;
+
+    Data out;
+    const ssize_t size = sizeof(header) + result.navDataSize;
+    unsigned char* bytes = static_cast<unsigned char*>(malloc(size));
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + sizeof(header), result.navData, result.navDataSize);
+    out.fastSet(bytes, size);
+    fileUtils->writeDataToFile(out, cachePath);
+}
+
+/**
+ * Recast 单块烘焙：体素化 -> 过滤 -> 紧凑高度场 -> 区域 -> 轮廓 -> 多边形网格 -> 细节网格
+ */
+bool EnemyNavigation::bake(const float* verts, int vertCount, const uint32_t* tris, int triCount,
+                           const NavBakeConfig& config, unsigned char** navData, int* navDataSize) {
+    rcConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.cs = config.cellSize;
+    cfg.ch = config.cellHeight;
+    cfg.walkableSlopeAngle = config.agentMaxSlope;
+    cfg.walkableHeight = (int)std::ceil(config.agentHeight / cfg.ch);
+    cfg.walkableClimb = (int)std::floor(config.agentMaxClimb / cfg.ch);
+    cfg.walkableRadius = (int)std::ceil(config.agentRadius / cfg.cs);
+    cfg.maxEdgeLen = (int)(config.edgeMaxLen * config.agentRadius / cfg.cs);
+    cfg.maxSimplificationError = config.edgeMaxError;
+    cfg.minRegionArea = (int)(config.regionMinSize * config.regionMinSize);
+    cfg.mergeRegionArea = (int)(config.regionMergeSize * config.regionMergeSize);
+    cfg.maxVertsPerPoly = DT_VERTS_PER_POLYGON;
+    cfg.detailSampleDist = config.detailSampleDist < 0.9f ? 0.0f : cfg.cs * config.detailSampleDist;
+    cfg.detailSampleMaxError = cfg.ch * config.detailSampleMaxError;
+    rcCalcBounds(verts, vertCount, cfg.bmin, cfg.bmax);
+    rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+    rcContext ctx(false);
+    const int* triIndices = reinterpret_cast<const int*>(tris);
+
+    rcHeightfield* solid = rcAllocHeightfield();
+    rcCompactHeightfield* chf = rcAllocCompactHeightfield();
+    rcContourSet* cset = rcAllocContourSet();
+    rcPolyMesh* pmesh = rcAllocPolyMesh();
+    rcPolyMeshDetail* dmesh = rcAllocPolyMeshDetail();
+
+    bool ok = solid && chf && cset && pmesh && dmesh &&
+        rcCreateHeightfield(&ctx, *solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch);
+
+    if (ok) {
+        std::vector<unsigned char> areas(triCount, RC_NULL_AREA);
+        rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, vertCount, triIndices, triCount, areas.data());
+        rcRasterizeTriangles(&ctx, verts, vertCount, triIndices, areas.data(), triCount, *solid, cfg.walkableClimb);
+
+        rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *solid);
+        rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid);
+        rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *solid);
+
+        ok = rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *solid, *chf) &&
+             rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf) &&
+             rcBuildDistanceField(&ctx, *chf) &&
+             rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea) &&
+             rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset) &&
+             rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *pmesh) &&
+             rcBuildPolyMeshDetail(&ctx, *pmesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *dmesh);
+    }
+
+    if (ok && pmesh->npolys > 0) {
+        for (int i = 0; i < pmesh->npolys; ++i) {
+            pmesh->flags[i] = pmesh->areas[i] == RC_WALKABLE_AREA ? kPolyFlagWalk : 0;
+        }
+
+        dtNavMeshCreateParams params;
+        memset(&params, 0, sizeof(params));
+        params.verts = pmesh->verts;
+        params.vertCount = pmesh->nverts;
+        params.polys = pmesh->polys;
+        params.polyAreas = pmesh->areas;
+        params.polyFlags = pmesh->flags;
+        params.polyCount = pmesh->npolys;
+        params.nvp = pmesh->nvp;
+        params.detailMeshes = dmesh->meshes;
+        params.detailVerts = dmesh->verts;
+        params.detailVertsCount = dmesh->nverts;
+        params.detailTris = dmesh->tris;
+        params.detailTriCount = dmesh->ntris;
+        params.walkableHeight = config.agentHeight;
+        params.walkableRadius = config.agentRadius;
+        params.walkableClimb = config.agentMaxClimb;
+        rcVcopy(params.bmin, pmesh->bmin);
+        rcVcopy(params.bmax, pmesh->bmax);
+        params.cs = cfg.cs;
+        params.ch = cfg.ch;
+        params.buildBvTree = true;
+        ok = dtCreateNavMeshData(&params, navData, navDataSize);
+    } else {
+        ok = false;
+    }
+
+    rcFreeHeightField(solid);
+    rcFreeCompactHeightfield(chf);
+    rcFreeContourSet(cset);
+    rcFreePolyMesh(pmesh);
+    rcFreePolyMeshDetail(dmesh);
+    return ok;
+}
+
+void EnemyNavigation::onBakeFinished(BakeResult& result) {
+    if (!result.navData) {
+        CCLOG("EnemyNavigation: 导航网格烘焙失败，敌人保持直线移动");
+        return;
+    }
+
+    _navMesh = dtAllocNavMesh();
+    if (!_navMesh || dtStatusFailed(_navMesh->init(result.navData, result.navDataSize, DT_TILE_FREE_DATA))) {
+        if (_navMesh) {
+            dtFreeNavMesh(_navMesh);
+            _navMesh = nullptr;
+        }
+        dtFree(result.navData);
+        result.navData = nullptr;
+        return;
+    }
+    result.navData = nullptr;  // 已归 _navMesh 所有
+
+    // 代理半径上限取烘焙半径的 2 倍（Boss 体型更大）
+    dtCrowd* crowd = dtAllocCrowd();
+    if (!crowd || !crowd->init(_maxAgents, _config.agentRadius * 2.0f, _navMesh)) {
+        dtFreeCrowd(crowd);
+        return;
+    }
+    _crowd = crowd;
+    CCLOG("EnemyNavigation: 导航网格就绪（%s）", result.fromCache ? "缓存" : "烘焙");
+
+    for (auto& m : _members) {
+        createAgent(m);
+    }
+}
+
+EnemyNavigation::Member* EnemyNavigation::findMember(const Enemy* enemy) {
+    for (auto& m : _members) {
+        if (m.enemy == enemy) return &m;
+    }
+    return nullptr;
+}
+
+const EnemyNavigation::Member* EnemyNavigation::findMember(const Enemy* enemy) const {
+    for (auto& m : _members) {
+        if (m.enemy == enemy) return &m;
+    }
+    return nullptr;
+}
+
+void EnemyNavigation::addEnemy(Enemy* enemy) {
+    if (!enemy || findMember(enemy)) return;
+
+    Member m;
+    m.enemy = enemy;
+    m.agent = -1;
+    m.target = Vec3::ZERO;
+    m.speed = enemy->getMoveSpeed();
+    m.moving = false;
+    enemy->retain();
+    _members.push_back(m);
+    if (_crowd) {
+        createAgent(_members.back());
+    }
+}
+
+void EnemyNavigation::removeEnemy(Enemy* enemy) {
+    for (auto it = _members.begin(); it != _members.end(); ++it) {
+        if (it->enemy == enemy) {
+            if (_crowd && it->agent >= 0) {
+                _crowd->removeAgent(it->agent);
+            }
+            enemy->release();
+            _members.erase(it);
+            return;
+        }
+    }
+}
+
+void EnemyNavigation::createAgent(Member& m) {
+    if (m.agent >= 0) {
+        _crowd->removeAgent(m.agent);
+        m.agent = -1;
+    }
+
+    // 半径取碰撞盒 XZ 较短边的一半
+    const AABB& box = m.enemy->getCollider().worldAABB;
+    float radius = 0.5f * std::min(box._max.x - box._min.x, box._max.z - box._min.z);
+    radius = std::max(10.0f, std::min(radius, _config.agentRadius * 2.0f));
+
+    dtCrowdAgentParams ap;
+    memset(&ap, 0, sizeof(ap));
+    ap.radius = radius;
+    ap.height = _config.agentHeight;
+    ap.maxSpeed = m.speed;
+    ap.maxAcceleration = m.speed * 8.0f;
+    ap.collisionQueryRange = radius * 12.0f;
+    ap.pathOptimizationRange = radius * 30.0f;
+    ap.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO |
+                     DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION;
+    ap.obstacleAvoidanceType = 0;
+    ap.separationWeight = 2.0f;
+    ap.queryFilterType = 0;
+
+    const Vec3 pos = parentToWorld(m.enemy, m.enemy->getPosition3D());
+    m.agent = _crowd->addAgent(&pos.x, &ap);
+    if (m.agent >= 0 && m.moving) {
+        submitTarget(m);
+    }
+}
+
+void EnemyNavigation::submitTarget(Member& m) {
+    const dtNavMeshQuery* query = _crowd->getNavMeshQuery();
+    const float ext[3] = { _config.agentRadius * 4.0f, _config.agentHeight * 2.0f, _config.agentRadius * 4.0f };
+    dtPolyRef ref = 0;
+    float nearest[3];
+    if (dtStatusSucceed(query->findNearestPoly(&m.target.x, ext, _crowd->getFilter(0), &ref, nearest)) && ref) {
+        _crowd->requestMoveTarget(m.agent, ref, nearest);
+    }
+    // 目标不在网格附近（如玩家跳起）时保留上一次请求
+}
+
+bool EnemyNavigation::requestMove(Enemy* enemy, const Vec3& worldTarget, float speed) {
+    Member* m = findMember(enemy);
+    if (!m || !_crowd || m->agent < 0) return false;
+
+    if (speed != m->speed) {
+        m->speed = speed;
+        dtCrowdAgentParams ap = _crowd->getAgent(m->agent)->params;
+        ap.maxSpeed = speed;
+        ap.maxAcceleration = speed * 8.0f;
+        _crowd->updateAgentParameters(m->agent, &ap);
+    }
+
+    const float retarget = _config.agentRadius * kRetargetRadiusScale;
+    if (!m->moving || m->target.distanceSquared(worldTarget) > retarget * retarget) {
+        m->target = worldTarget;
+        m->moving = true;
+        submitTarget(*m);
+    }
+    return true;
+}
+
+void EnemyNavigation::stopMove(Enemy* enemy) {
+    Member* m = findMember(enemy);
+    if (!m || !m->moving) return;
+    m->moving = false;
+    if (_crowd && m->agent >= 0) {
+        _crowd->resetMoveTarget(m->agent);
+    }
+}
+
+bool EnemyNavigation::getAgentState(const Enemy* enemy, Vec3& position, Vec3& velocity) const {
+    const Member* m = findMember(enemy);
+    if (!m || !_crowd || m->agent < 0) return false;
+    const dtCrowdAgent* ag = _crowd->getAgent(m->agent);
+    if (!ag || !ag->active) return false;
+    position.set(ag->npos);
+    velocity.set(ag->vel);
+    return true;
+}
+
+bool EnemyNavigation::findPath(const Vec3& start, const Vec3& end, std::vector<Vec3>& path) const {
+    path.clear();
+    if (!_crowd) return false;
+
+    const dtNavMeshQuery* query = _crowd->getNavMeshQuery();
+    const dtQueryFilter* filter = _crowd->getFilter(0);
+    const float ext[3] = { _config.agentRadius * 4.0f, _config.agentHeight * 2.0f, _config.agentRadius * 4.0f };
+    dtPolyRef startRef = 0, endRef = 0;
+    float startPt[3], endPt[3];
+    query->findNearestPoly(&start.x, ext, filter, &startRef, startPt);
+    query->findNearestPoly(&end.x, ext, filter, &endRef, endPt);
+    if (!startRef || !endRef) return false;
+
+    dtPolyRef polys[kMaxPathPolys];
+    int polyCount = 0;
+    query->findPath(startRef, endRef, startPt, endPt, filter, polys, &polyCount, kMaxPathPolys);
+    if (polyCount == 0) return false;
+
+    float straight[kMaxPathPolys * 3];
+    int straightCount = 0;
+    query->findStraightPath(startPt, endPt, polys, polyCount, straight, nullptr, nullptr,
+                            &straightCount, kMaxPathPolys);
+    for (int i = 0; i < straightCount; ++i) {
+        path.push_back(Vec3(straight[i * 3], straight[i * 3 + 1], straight[i * 3 + 2]));
+    }
+    return !path.empty();
+}
+
+void EnemyNavigation::update(float dt) {
+    if (!_crowd || dt <= 0.0f) return;
+
+    // 被外部直接移动的敌人（冲刺、复位）在新位置重建代理
+    const float resync = _config.agentRadius * kResyncRadiusScale;
+    for (auto& m : _members) {
+        if (m.agent < 0) continue;
+        const dtCrowdAgent* ag = _crowd->getAgent(m.agent);
+        const Vec3 pos = parentToWorld(m.enemy, m.enemy->getPosition3D());
+        const float dx = pos.x - ag->npos[0];
+        const float dz = pos.z - ag->npos[2];
+        if (dx * dx + dz * dz > resync * resync) {
+            createAgent(m);
+        }
+    }
+
+    _crowd->update(dt, nullptr);
+}
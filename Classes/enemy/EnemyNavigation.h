@@ -0,0 +1,142 @@
+#ifndef __ENEMY_NAVIGATION_H__
+#define __ENEMY_NAVIGATION_H__
+
+#include "cocos2d.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class TerrainCollider;
+class Enemy;
+class dtNavMesh;
+class dtCrowd;
+
+/**
+ * @struct NavBakeConfig
+ * @brief 导航网格烘焙参数（世界单位，1 米 = 100）
+ */
+struct NavBakeConfig {
+    float cellSize = 15.0f;          ///< 体素 XZ 边长
+    float cellHeight = 10.0f;        ///< 体素高度
+    float agentHeight = 180.0f;      ///< 角色高度（低于此净空的区域不可走）
+    float agentRadius = 40.0f;       ///< 烘焙时收缩边界的半径
+    float agentMaxClimb = 40.0f;     ///< 可跨越台阶高度（与 Enemy 的 MAX_STEP_HEIGHT 一致）
+    float agentMaxSlope = 60.0f;     ///< 最大坡度（度，与贴地法线阈值 0.5 一致）
+    float regionMinSize = 8.0f;      ///< 小于该边长（体素）的孤立区域被剔除
+    float regionMergeSize = 20.0f;   ///< 小于该边长（体素）的区域尝试合并
+    float edgeMaxLen = 12.0f;        ///< 轮廓边最大长度（体素）
+    float edgeMaxError = 1.3f;       ///< 轮廓简化误差（体素）
+    float detailSampleDist = 6.0f;   ///< 细节网格采样间距（体素）
+    float detailSampleMaxError = 1.0f; ///< 细节网格高度误差（体素高度）
+};
+
+/**
+ * @class EnemyNavigation
+ * @brief 敌人导航：由地形碰撞网格在工作线程烘焙 Recast 导航网格，并用 DetourCrowd 统一驱动敌人
+ *
+ * 烘焙结果按几何哈希缓存到可写目录，下次启动直接加载。
+ * 烘焙完成前以及未加入人群的敌人仍按直线移动。
+ * 加入人群的敌人只提交目标点，寻路、局部避让与位移在每帧一次 dtCrowd::update 中批量完成，
+ * 敌人的 XZ 位置取自人群代理，高度仍由贴地检测决定。
+ */
+class EnemyNavigation : public cocos2d::Ref {
+public:
+    /**
+     * @brief 创建导航并开始异步加载 / 烘焙
+     * @param terrain 地形碰撞器（烘焙期间被 retain）
+     * @param objFilePath 地形 .obj 路径，用于生成缓存文件名
+     * @param config 烘焙参数
+     * @param maxAgents 人群代理上限
+     */
+    static EnemyNavigation* create(TerrainCollider* terrain, const std::string& objFilePath,
+                                   const NavBakeConfig& config = NavBakeConfig(), int maxAgents = 64);
+
+    EnemyNavigation();
+    virtual ~EnemyNavigation();
+
+    bool init(TerrainCollider* terrain, const std::string& objFilePath,
+              const NavBakeConfig& config, int maxAgents);
+
+    /**
+     * @brief 导航网格是否已可用
+     */
+    bool isReady() const { return _crowd != nullptr; }
+
+    /**
+     * @brief 登记敌人（登记期间被 retain），导航网格就绪后自动创建人群代理
+     */
+    void addEnemy(Enemy* enemy);
+
+    /**
+     * @brief 注销敌人并移除其代理
+     */
+    void removeEnemy(Enemy* enemy);
+
+    /**
+     * @brief 为敌人提交移动目标（目标变化不大时不重新寻路）
+     * @param enemy 已登记的敌人
+     * @param worldTarget 世界坐标目标点
+     * @param speed 最大移动速度
+     * @return bool 敌人是否由人群驱动（false 时调用方自行移动）
+     */
+    bool requestMove(Enemy* enemy, const cocos2d::Vec3& worldTarget, float speed);
+
+    /**
+     * @brief 停止敌人的移动请求（代理仍参与避让）
+     */
+    void stopMove(Enemy* enemy);
+
+    /**
+     * @brief 读取代理位置与速度（世界坐标）
+     * @return bool 敌人是否有代理
+     */
+    bool getAgentState(const Enemy* enemy, cocos2d::Vec3& position, cocos2d::Vec3& velocity) const;
+
+    /**
+     * @brief 在导航网格上寻路（世界坐标），网格未就绪时返回 false
+     */
+    bool findPath(const cocos2d::Vec3& start, const cocos2d::Vec3& end, std::vector<cocos2d::Vec3>& path) const;
+
+    /**
+     * @brief 每帧在角色 update 之前批量更新人群
+     */
+    void update(float dt);
+
+private:
+    struct BakeResult;
+
+    struct Member {
+        Enemy* enemy;
+        int agent;                  // dtCrowd 代理下标，-1 表示尚未创建
+        cocos2d::Vec3 target;       // 最近一次提交的目标
+        float speed;
+        bool moving;
+    };
+
+    NavBakeConfig _config;
+    int _maxAgents = 64;
+    std::string _cachePath;
+
+    dtNavMesh* _navMesh = nullptr;
+    dtCrowd* _crowd = nullptr;
+
+    std::vector<Member> _members;
+
+    /** 工作线程：读取缓存或烘焙，结果写入 result */
+    static void loadOrBake(TerrainCollider* terrain, const NavBakeConfig& config,
+                           const std::string& cachePath, BakeResult& result);
+
+    /** 工作线程：Recast 烘焙单块导航网格数据 */
+    static bool bake(const float* verts, int vertCount, const uint32_t* tris, int triCount,
+                     const NavBakeConfig& config, unsigned char** navData, int* navDataSize);
+
+    /** 主线程：由烘焙数据创建 dtNavMesh / dtCrowd，并为已登记的敌人创建代理 */
+    void onBakeFinished(BakeResult& result);
+
+    Member* findMember(const Enemy* enemy);
+    const Member* findMember(const Enemy* enemy) const;
+    void createAgent(Member& m);
+    void submitTarget(Member& m);
+};
+
+#endif // __ENEMY_NAVIGATION_H__
@@ -4,45 +4,23 @@
 #include "combat/CombatComponent.h"
 #include "player/Wukong.h"
 #include "scene_ui/UIManager.h"
+#include "core/GameApp.h"
 
 USING_NS_CC;
 
-static inline bool HasTarget(const Enemy* e) {
-    if (!e || !e->getTarget()) return false;
-    // 如果目标是悟空，且已经死亡，视为没有有效目标
-    return !e->getTarget()->isDead();
+// 状态机只读取 AIScheduler（或 Enemy::update）本次运行前发布的感知结果，不再自行遍历场景图
+static inline const PerceptionResult& Sense(const Enemy* e) {
+    return e->getPerception();
 }
 
-// 敌人 world 坐标（你 Enemy.cpp 里已经实现了）
-static inline cocos2d::Vec3 EnemyWorldPos(const Enemy* e) {
-    return e->getWorldPosition3D();
-}
-
-// 玩家(悟空) world 坐标（你 Enemy.cpp 里已经实现了）
-static inline cocos2d::Vec3 PlayerWorldPos(const Enemy* e) {
-    return e->getTargetWorldPos();
-}
-
-static inline cocos2d::Vec3 BirthWorldPos(const Enemy* e) {
-    auto p = e->getParent();
-    if (!p) return e->getBirthPosition();  // 没父节点就当作世界坐标用
-
-    cocos2d::Vec3 out = cocos2d::Vec3::ZERO;
-    cocos2d::Mat4 m = p->getNodeToWorldTransform();   // parent local -> world
-    m.transformPoint(e->getBirthPosition(), &out);     // birthPosition 是“父节点坐标系”的点
-    return out;
-}
-
-
-// 把 world 坐标转换成“Enemy 父节点坐标”，用于 setPosition3D（很关键，避免坐标系错）
-static inline cocos2d::Vec3 WorldToParentSpace(const cocos2d::Node* node,
-    const cocos2d::Vec3& worldPos) {
+// 把“Enemy 父节点坐标”转换成 world 坐标（moveToward 的目标是 world 坐标）
+static inline cocos2d::Vec3 ParentToWorldSpace(const cocos2d::Node* node,
+    const cocos2d::Vec3& localPos) {
     auto p = node->getParent();
-    if (!p) return worldPos;
+    if (!p) return localPos;
 
     cocos2d::Vec3 out = cocos2d::Vec3::ZERO;
-    cocos2d::Mat4 inv = p->getWorldToNodeTransform(); // world -> parent local
-    inv.transformPoint(worldPos, &out);
+    p->getNodeToWorldTransform().transformPoint(localPos, &out);
     return out;
 }
 
@@ -66,13 +44,13 @@ void EnemyIdleState::onEnter(Enemy* enemy) {
     // 随机设置最大待机时间（1-3秒）
     _maxIdleTime = RandomHelper::random_real(1.0f, 3.0f);
     
-    enemy->playAnim("idle", true);
+    enemy->playAnim(Enemy::ANIM_IDLE, true);
 }
 
 void EnemyIdleState::onUpdate(Enemy* enemy, float deltaTime) {
     // 统一死亡判断
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
     
@@ -80,29 +58,30 @@ void EnemyIdleState::onUpdate(Enemy* enemy, float deltaTime) {
     
     // 待机时间结束后，切换到巡逻状态
     if (_idleTimer >= _maxIdleTime) {
-        enemy->getStateMachine()->changeState("Patrol");
+        enemy->getStateMachine()->changeState(Enemy::STATE_PATROL);
     }
     
-    // 感知玩家：在视野范围内 -> 追击
-    if (HasTarget(enemy)) {
-        float d = EnemyWorldPos(enemy).distance(PlayerWorldPos(enemy));
-        if (d <= enemy->getViewRange()) {
-            enemy->getStateMachine()->changeState("Chase");
-            return;
-        }
+    // 感知玩家：视野内且未被遮挡 -> 追击
+    if (Sense(enemy).canSeeTarget()) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
+        return;
     }
 }
 
 void EnemyIdleState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited idle state");
     
-    // 清理待机动画（可选，因为下一个状态会停止并替换）
+    // 清理待机动画（可选，因为下一个状态会交叉淡化到新动画）
     if (enemy->getSprite()) {
-        // 不需要在这里停止所有动作，因为下一个状态的onEnter会调用stopAllActions
+        // 不需要在这里停止动画，下一个状态的onEnter会通过playAnim切换
     }
 }
 
-std::string EnemyIdleState::getStateName() const {
+int EnemyIdleState::getStateId() const {
+    return Enemy::STATE_IDLE;
+}
+
+const char* EnemyIdleState::getStateName() const {
     return "Idle";
 }
 
@@ -137,62 +116,61 @@ void EnemyPatrolState::onEnter(Enemy* enemy) {
     _patrolTarget.z = birthPos.z + sinf(angle) * patrolRadius;
     
     // 播放巡逻动画
-    enemy->playAnim("patrol", true);
+    enemy->playAnim(Enemy::ANIM_PATROL, true);
 }
 
 void EnemyPatrolState::onUpdate(Enemy* enemy, float deltaTime) {
     // 统一死亡判断
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
     
     _patrolTimer += deltaTime;
     
-    // 感知玩家：在视野范围内 -> 追击
-    if (HasTarget(enemy)) {
-        float d = EnemyWorldPos(enemy).distance(PlayerWorldPos(enemy));
-        if (d <= enemy->getViewRange()) {
-            enemy->getStateMachine()->changeState("Chase");
-            return;
-        }
+    // 感知玩家：视野内且未被遮挡 -> 追击
+    if (Sense(enemy).canSeeTarget()) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
+        return;
     }
 
     // 移动向巡逻目标点
     if (enemy->canMove()) {
         Vec3 currentPos = enemy->getPosition3D();
         Vec3 direction = _patrolTarget - currentPos;
+        direction.y = 0.0f; // 高度由贴地决定，只比较水平距离
         float distance = direction.length();
         
         if (distance > 10.0f) { // 接近目标点（阈值10单位）
-            direction.normalize();
+            // 有导航时沿路径绕开障碍，返回实际移动方向
+            Vec3 moveDir = enemy->moveToward(ParentToWorldSpace(enemy, _patrolTarget),
+                                             enemy->getMoveSpeed(), deltaTime);
             
-            // 根据移动方向调整模型朝向（考虑初始180度旋转）
-            if (enemy->getSprite()) {
-                float angle = atan2f(direction.x, direction.z) * 180.0f / M_PI+45.0f;
-                enemy->getSprite()->setRotation3D(Vec3(0, angle, 0));
-            }
-            
-            Vec3 newPos = currentPos + direction * enemy->getMoveSpeed() * deltaTime;
-            enemy->setPosition3D(newPos);
+            // 根据移动方向调整模型朝向
+            enemy->faceDirection(moveDir);
         } else {
             // 到达目标点，切换到待机状态
-            enemy->getStateMachine()->changeState("Idle");
+            enemy->getStateMachine()->changeState(Enemy::STATE_IDLE);
         }
     }
     
     // 巡逻时间过长，切换到待机状态
     if (_patrolTimer >= _maxPatrolTime) {
-        enemy->getStateMachine()->changeState("Idle");
+        enemy->getStateMachine()->changeState(Enemy::STATE_IDLE);
     }
     
 }
 
 void EnemyPatrolState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited patrol state");
+    enemy->stopMoving();
+}
+
+int EnemyPatrolState::getStateId() const {
+    return Enemy::STATE_PATROL;
 }
 
-std::string EnemyPatrolState::getStateName() const {
+const char* EnemyPatrolState::getStateName() const {
     return "Patrol";
 }
 
@@ -212,13 +190,13 @@ void EnemyChaseState::onEnter(Enemy* enemy) {
     _chaseTimer = 0.0f;
     
     // 追逐动画（如果有）
-    enemy->playAnim("chase", false);
+    enemy->playAnim(Enemy::ANIM_CHASE, false);
 }
 
 void EnemyChaseState::onUpdate(Enemy* enemy, float deltaTime) {
     // 统一死亡判断
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -229,7 +207,7 @@ void EnemyChaseState::onUpdate(Enemy* enemy, float deltaTime) {
     float distanceFromBirth = currentPos.distance(enemy->getBirthPosition());
     if (distanceFromBirth > enemy->getMaxChaseRange()) {
         // 追得太远，强制回家
-        enemy->getStateMachine()->changeState("Return");
+        enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         return;
     }
     // TODO: 获取玩家位置
@@ -240,7 +218,7 @@ void EnemyChaseState::onUpdate(Enemy* enemy, float deltaTime) {
     if (distanceToPlayer <= enemy->getViewRange()) {
         if (enemy->canAttack()) {
             // 进入攻击状态
-            enemy->getStateMachine()->changeState("Attack");
+            enemy->getStateMachine()->changeState(Enemy::STATE_ATTACK);
         } else if (enemy->canMove()) {
             // 继续追逐
             Vec3 direction = playerPosition - currentPos;
@@ -252,69 +230,59 @@ void EnemyChaseState::onUpdate(Enemy* enemy, float deltaTime) {
         }
     } else {
         // 玩家超出视野范围，切换到待机状态
-        enemy->getStateMachine()->changeState("Return");
+        enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
     }*/
     _chaseTimer += deltaTime;
 
     // 没目标直接回家
-    if (!HasTarget(enemy)) {
-        enemy->getStateMachine()->changeState("Return");
+    const PerceptionResult& sense = Sense(enemy);
+    if (!sense.hasTarget) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         return;
     }
 
-    // 用 world 坐标做所有距离判断
-    const Vec3 enemyWorld = EnemyWorldPos(enemy);
-    const Vec3 birthWorld = BirthWorldPos(enemy);
-
-    // 距离出生点太远 -> Return
-    float distanceFromBirth = enemyWorld.distance(birthWorld);
-    if (distanceFromBirth > enemy->getMaxChaseRange()) {
-        enemy->getStateMachine()->changeState("Return");
+    // 距离出生点太远 -> Return（感知结果均为 world 坐标）
+    if (sense.distanceFromBirth > enemy->getMaxChaseRange()) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         return;
     }
 
-    const Vec3 playerWorld = PlayerWorldPos(enemy);
-    float distanceToPlayer = enemyWorld.distance(playerWorld);
+    const Vec3& playerWorld = sense.targetPos;
+    float distanceToPlayer = sense.distanceToTarget;
 
     // 超出视野 -> Return
     if (distanceToPlayer > enemy->getViewRange()) {
-        enemy->getStateMachine()->changeState("Return");
+        enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         return;
     }
 
     // 追上了再攻击（给一个简单攻击距离，增加到 80，配合攻击判定的膨胀）
     const float kAttackRange = 80.0f;
     if (distanceToPlayer <= kAttackRange && enemy->canAttack()) {
-        enemy->getStateMachine()->changeState("Attack");
+        enemy->getStateMachine()->changeState(Enemy::STATE_ATTACK);
         return;
     }
 
     // 继续追击移动
     if (enemy->canMove()) {
-        Vec3 dir = playerWorld - enemyWorld;
-        dir.y = 0;
-
-        if (dir.lengthSquared() > 1e-6f) {
-            dir.normalize();
+        // 有导航时由人群寻路并与其他敌人互相避让，否则直线追击
+        Vec3 dir = enemy->moveToward(playerWorld, enemy->getMoveSpeed(), deltaTime);
 
-            // 先在 world 空间算新位置，再转回父节点空间 setPosition3D（关键）
-            Vec3 newWorld = enemyWorld + dir * enemy->getMoveSpeed() * deltaTime;
-            enemy->setPosition3D(WorldToParentSpace(enemy, newWorld));
-
-            // 朝向（沿用你 Patrol 的方式）
-            if (enemy->getSprite()) {
-                float angle = atan2f(dir.x, dir.z) * 180.0f / M_PI + 45.0f;
-                enemy->getSprite()->setRotation3D(Vec3(0, angle, 0));
-            }
-        }
+        // 朝向（与 Patrol / Return 相同）
+        enemy->faceDirection(dir);
     }
 }
 
 void EnemyChaseState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited chase state");
+    enemy->stopMoving();
 }
 
-std::string EnemyChaseState::getStateName() const {
+int EnemyChaseState::getStateId() const {
+    return Enemy::STATE_CHASE;
+}
+
+const char* EnemyChaseState::getStateName() const {
     return "Chase";
 }
 
@@ -336,13 +304,13 @@ void EnemyAttackState::onEnter(Enemy* enemy) {
     _attacked = false;
     
     // 播放攻击动画
-    enemy->playAnim("attack", false);
+    enemy->playAnim(Enemy::ANIM_ATTACK, false);
 }
 
 void EnemyAttackState::onUpdate(Enemy* enemy, float deltaTime) {
     // 统一死亡判断
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -352,45 +320,36 @@ void EnemyAttackState::onUpdate(Enemy* enemy, float deltaTime) {
     if (!_attacked && _attackTimer >= 0.3f) {
         _attacked = true;
         auto combat = enemy->getCombat();
-        auto target = enemy->getTarget();
-        CCLOG("EnemyAttackState: Attempting attack. Combat: %p, Target: %p", combat, target);
-        if (combat && target) {
-            // 将目标（悟空）放入列表
-            std::vector<cocos2d::Node*> targets = { static_cast<cocos2d::Node*>(target) };
-            int hits = combat->executeMeleeAttack(enemy->getCollider(), targets);
-            if (hits > 0) {
-                CCLOG("Enemy hit player! Damage dealt. Hits: %d", hits);
-            } else {
-                CCLOG("Enemy attack missed.");
-            }
+        if (combat && enemy->getTarget()) {
+            // 提交判定请求，命中与伤害在本帧末尾由 CombatSystem 批量结算
+            combat->queueMeleeAttack(enemy->getCollider(), BroadPhase::LAYER_PLAYER);
         }
     }
 
     // 攻击冷却结束后，检查玩家是否仍在视野范围内
     if (_attackTimer >= _attackCooldown) {
         //获取玩家位置
-        if (!HasTarget(enemy)) {
-            enemy->getStateMachine()->changeState("Return");
+        const PerceptionResult& sense = Sense(enemy);
+        if (!sense.hasTarget) {
+            enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
             return;
         }
-        float distance = EnemyWorldPos(enemy).distance(PlayerWorldPos(enemy));
-
 
-        if (distance <= enemy->getViewRange()) {
+        if (sense.inViewRange) {
             if (enemy->canAttack()) {
                 // 再次攻击
                 _attackTimer = 0.0f;
                 _attacked = false; // 重置标志位
-                enemy->playAnim("attack", false); //再播一次
+                enemy->playAnim(Enemy::ANIM_ATTACK, false); //再播一次
             }
             else {
                 // 无法攻击，切换到追逐状态
-                enemy->getStateMachine()->changeState("Chase");
+                enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
             }
         }
         else {
             // 玩家超出视野范围，切换到待机状态
-            enemy->getStateMachine()->changeState("Return");
+            enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         }
     }
 }
@@ -399,7 +358,11 @@ void EnemyAttackState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited attack state");
 }
 
-std::string EnemyAttackState::getStateName() const {
+int EnemyAttackState::getStateId() const {
+    return Enemy::STATE_ATTACK;
+}
+
+const char* EnemyAttackState::getStateName() const {
     return "Attack";
 }
 
@@ -420,13 +383,13 @@ void EnemyHitState::onEnter(Enemy* enemy) {
     _hitTimer = 0.0f;
     
     // 受击动画（如果有）
-    enemy->playAnim("hited", false);
+    enemy->playAnim(Enemy::ANIM_HITED, false);
 }
 
 void EnemyHitState::onUpdate(Enemy* enemy, float deltaTime) {
     // 统一死亡判断
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
@@ -435,22 +398,23 @@ void EnemyHitState::onUpdate(Enemy* enemy, float deltaTime) {
     // 受击时间结束后，根据情况切换状态
     if (_hitTimer >= _hitDuration) {
         //获取玩家位置
-        if (!HasTarget(enemy)) {
-            enemy->getStateMachine()->changeState("Return");
+        const PerceptionResult& sense = Sense(enemy);
+        if (!sense.hasTarget) {
+            enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
             return;
         }
-        float distance = EnemyWorldPos(enemy).distance(PlayerWorldPos(enemy));
+        float distance = sense.distanceToTarget;
 
         if (distance <= 80.0f) { // 使用与 ChaseState 一致的攻击距离
             if (enemy->canAttack()) {
-                enemy->getStateMachine()->changeState("Attack");
+                enemy->getStateMachine()->changeState(Enemy::STATE_ATTACK);
             } else {
-                enemy->getStateMachine()->changeState("Chase");
+                enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
             }
         } else if (distance <= enemy->getViewRange()) {
-            enemy->getStateMachine()->changeState("Chase");
+            enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
         } else {
-            enemy->getStateMachine()->changeState("Return");
+            enemy->getStateMachine()->changeState(Enemy::STATE_RETURN);
         }
     }
 }
@@ -459,7 +423,11 @@ void EnemyHitState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited hit state");
 }
 
-std::string EnemyHitState::getStateName() const {
+int EnemyHitState::getStateId() const {
+    return Enemy::STATE_HIT;
+}
+
+const char* EnemyHitState::getStateName() const {
     return "Hit";
 }
 
@@ -475,21 +443,20 @@ EnemyDeadState::~EnemyDeadState() {
 void EnemyDeadState::onEnter(Enemy* enemy) {
     CCLOG("Enemy entered dead state");
     _isDeadProcessed = false;
-    enemy->playAnim("dying", false); // 死亡动画
+    enemy->playAnim(Enemy::ANIM_DYING, false); // 死亡动画
 
     // 死亡动画结束后自动移除敌人
-    // 注意：这个是跑在 enemy Node 上，不会被 playAnim stop 掉
+    // 注意：这个是跑在 enemy Node 上，与 _sprite 上的动画组件无关
     // 只有在onEnter中执行一次，onUpdate中不再执行
     enemy->runAction(Sequence::create(
         DelayTime::create(1.5f),
         CallFunc::create([enemy]() {
             CCLOG("Enemy is being removed after death animation");
             
-            // 通知游戏管理器从敌人列表中移除此敌人
-            // 通过一个全局事件通知系统
-            cocos2d::EventCustom event("enemy_died");
-            event.setUserData(enemy);
-            cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&event);
+            // 通知场景从敌人列表中移除此敌人
+            EnemyRemovedEvent event;
+            event.enemy = enemy;
+            GameApp::getInstance()->getEventBus()->publish(event);
             
             // 执行实际的移除操作
             enemy->removeFromParent();
@@ -508,7 +475,11 @@ void EnemyDeadState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited dead state");
 }
 
-std::string EnemyDeadState::getStateName() const {
+int EnemyDeadState::getStateId() const {
+    return Enemy::STATE_DEAD;
+}
+
+const char* EnemyDeadState::getStateName() const {
     return "Dead";
 }
 
@@ -525,22 +496,18 @@ void ReturnState::onEnter(Enemy* enemy) {
 
     // 改：回家目标直接用父节点坐标系
     _returnTarget = enemy->getBirthPosition();
-    enemy->playAnim("patrol", true);
+    enemy->playAnim(Enemy::ANIM_PATROL, true);
 }
 
 void ReturnState::onUpdate(Enemy* enemy, float dt) {
     if (enemy->isDead()) {
-        enemy->getStateMachine()->changeState("Dead");
+        enemy->getStateMachine()->changeState(Enemy::STATE_DEAD);
         return;
     }
 
-    // 玩家回到感知范围 -> Chase（保持你原逻辑）
-    float distanceToPlayer = FLT_MAX;
-    if (HasTarget(enemy)) {
-        distanceToPlayer = EnemyWorldPos(enemy).distance(PlayerWorldPos(enemy));
-    }
-    if (distanceToPlayer <= enemy->getViewRange()) {
-        enemy->getStateMachine()->changeState("Chase");
+    // 玩家回到感知范围 -> Chase
+    if (Sense(enemy).canSeeTarget()) {
+        enemy->getStateMachine()->changeState(Enemy::STATE_CHASE);
         return;
     }
 
@@ -552,17 +519,10 @@ void ReturnState::onUpdate(Enemy* enemy, float dt) {
 
     float dist = dir.length();
     if (dist > 10.0f) {
-        dir.normalize();
-
-        float step = enemy->getMoveSpeed() * dt;
-        if (step > dist) step = dist;      // 防止 overshoot 抖动/跳
-
-        enemy->setPosition3D(pos + dir * step);
+        // moveToward 内部限制步长，防止 overshoot 抖动/跳
+        Vec3 moveDir = enemy->moveToward(Sense(enemy).birthPos, enemy->getMoveSpeed(), dt);
 
-        if (enemy->getSprite()) {
-            float angle = atan2f(dir.x, dir.z) * 180.0f / M_PI;
-            enemy->getSprite()->setRotation3D(Vec3(0, angle, 0));
-        }
+        enemy->faceDirection(moveDir);
     }
     else {
         // 锁死到出生点，再切 Patrol，避免“阈值边缘卡住”
@@ -570,16 +530,21 @@ void ReturnState::onUpdate(Enemy* enemy, float dt) {
         pos.z = _returnTarget.z;
         enemy->setPosition3D(pos);
 
-        enemy->getStateMachine()->changeState("Patrol");
+        enemy->getStateMachine()->changeState(Enemy::STATE_PATROL);
     }
 }
 
 
 void ReturnState::onExit(Enemy* enemy) {
     CCLOG("Enemy exited return state");
+    enemy->stopMoving();
+}
+
+int ReturnState::getStateId() const {
+    return Enemy::STATE_RETURN;
 }
 
-std::string ReturnState::getStateName() const {
+const char* ReturnState::getStateName() const {
     return "Return";
 }
 
@@ -32,7 +32,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;                    //刚进入这个状态做什么
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;  //每一帧这个状态下应该做什么
     virtual void onExit(Enemy* enemy) override;                     //离开这个状态之前做什么
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     float _idleTimer;       ///< 待机计时器
@@ -50,7 +51,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     Vec3 _patrolTarget;     ///< 巡逻目标点
@@ -69,7 +71,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     float _chaseTimer;      ///< 追逐计时器
@@ -86,7 +89,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     float _attackTimer;     ///< 攻击计时器
@@ -105,7 +109,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     float _hitTimer;        ///< 受击计时器
@@ -123,7 +128,8 @@ public:
     virtual void onEnter(Enemy* enemy) override;
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
     
 private:
     bool _isDeadProcessed;  ///< 死亡处理是否完成
@@ -143,7 +149,8 @@ public:
     virtual void onUpdate(Enemy* enemy, float deltaTime) override;
     virtual void onExit(Enemy* enemy) override;
 
-    virtual std::string getStateName() const override;
+    virtual int getStateId() const override;
+    virtual const char* getStateName() const override;
 
 private:
     Vec3 _returnTarget;
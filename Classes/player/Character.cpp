@@ -4,6 +4,7 @@
 #include "enemy/Enemy.h"
 #include "../combat/HealthComponent.h"
 #include "../combat/CombatComponent.h"
+#include "core/GameApp.h"
 
 Character::Character()
     : _visualRoot(nullptr),
@@ -102,14 +103,14 @@ void Character::jump() {
     }
     _velocity.y = jumpSpeed;
     _onGround = false;
-    _fsm.changeState("Jump");
+    _fsm.changeState(STATE_JUMP);
 }
 
 void Character::roll() {
     if (isDead()) {
         return;
     }
-    _fsm.changeState("Roll");
+    _fsm.changeState(STATE_ROLL);
 }
 
 void Character::attackLight() {
@@ -117,17 +118,16 @@ void Character::attackLight() {
         return;
     }
 
-    BaseState<Character>* cur = _fsm.getCurrentState();
-    const std::string curName = cur ? cur->getStateName() : "";
+    const int cur = _fsm.getCurrentStateId();
 
     // 若正在攻击，按一次只做“输入缓冲”，由 AttackState 在窗口内接续
-    if (!curName.empty() && curName.rfind("Attack", 0) == 0) {
+    if (cur >= STATE_ATTACK1 && cur <= STATE_ATTACK3) {
         _comboBuffered = true;
         return;
     }
 
     _comboBuffered = false;
-    _fsm.changeState("Attack1");
+    _fsm.changeState(STATE_ATTACK1);
 }
 
 int Character::getHP() const {
@@ -152,11 +152,17 @@ void Character::takeHit(int damage) {
         _hp -= damage;
     }
 
+    PlayerHurtEvent event;
+    event.player = this;
+    event.damage = damage;
+    event.hp = std::max(_hp, 0);
+    GameApp::getInstance()->getEventBus()->publish(event);
+
     if (_hp <= 0) {
         die();
         return;
     }
-    _fsm.changeState("Hurt");
+    _fsm.changeState(STATE_HURT);
 }
 
 void Character::die() {
@@ -165,7 +171,11 @@ void Character::die() {
     }
     _hp = 0;
     _lifeState = LifeState::Dead;
-    _fsm.changeState("Dead");
+    _fsm.changeState(STATE_DEAD);
+
+    PlayerDeadEvent event;
+    event.player = this;
+    GameApp::getInstance()->getEventBus()->publish(event);
 
 }
 
@@ -179,7 +189,7 @@ void Character::respawn() {
         _hp = 100;
     }
     
-    _fsm.changeState("Idle");
+    _fsm.changeState(STATE_IDLE);
     CCLOG("Character::respawn: Entity respawned, HP: %d", _hp);
 }
 
@@ -211,7 +221,7 @@ bool Character::consumeComboBuffered() {
     return had;
 }
 
-StateMachine<Character>& Character::getStateMachine() {
+Character::FSM& Character::getStateMachine() {
     return _fsm;
 }
 
@@ -228,8 +238,8 @@ void Character::applyMovement(float dt) {
     cocos2d::Vec3 oldPos = this->getPosition3D();
     cocos2d::Vec3 newPos = oldPos + _velocity * dt;
 
-    // 1. 与敌人的 AABB 碰撞检测
-    if (_enemies && !_enemies->empty()) {
+    // 1. 与敌人的 AABB 碰撞检测（由宽相位筛选附近存活的敌人）
+    if (_broadPhase) {
         // 先临时计算新位置下的世界 AABB
         // 获取当前变换并替换位置部分
         Mat4 nextTransform = this->getNodeToWorldTransform();
@@ -240,10 +250,18 @@ void Character::applyMovement(float dt) {
         AABB nextWorldAABB = _collider.aabb;
         nextWorldAABB.transform(nextTransform);
 
-        for (auto enemy : *_enemies) {
-            if (!enemy || enemy->isDead()) continue;
-
-            const AABB& enemyAABB = enemy->getCollider().worldAABB;
+        // 推开后包围盒会移动，查询范围在 XZ 上外扩一个自身宽度
+        AABB queryAABB = nextWorldAABB;
+        float reach = std::max(nextWorldAABB._max.x - nextWorldAABB._min.x,
+                               nextWorldAABB._max.z - nextWorldAABB._min.z);
+        queryAABB._min.x -= reach;
+        queryAABB._max.x += reach;
+        queryAABB._min.z -= reach;
+        queryAABB._max.z += reach;
+        _broadPhase->queryAABB(queryAABB, BroadPhase::LAYER_ENEMY, _nearbyActors, this);
+
+        for (const auto& actor : _nearbyActors) {
+            const AABB& enemyAABB = actor.collider->worldAABB;
             
             if (nextWorldAABB.intersects(enemyAABB)) {
                 // 计算碰撞偏移并修正 newPos
@@ -261,44 +279,11 @@ void Character::applyMovement(float dt) {
     }
 
     if (_terrainCollider) {
-        // 2. 射线检测新位置地面（从上方 500 个单位向下发射，覆盖更广的高度差）
-        CustomRay ray(newPos + cocos2d::Vec3(0, 500, 0), cocos2d::Vec3(0, -1, 0));
-        float hitDist;
-
-        if (_terrainCollider->rayIntersects(ray, hitDist)) {
-            float groundY = ray.origin.y - hitDist;
-            const float MAX_STEP_HEIGHT = 40.0f; // 稍微增大跨越高度
-
-            // 2. 坡度 / 台阶判断
-            // 如果新位置的地面高度与当前位置高度差在允许范围内，或者正在下坡
-            if (groundY - oldPos.y < MAX_STEP_HEIGHT) {
-                newPos.y = groundY;
-                this->setPosition3D(newPos);
-                
-                // 落地判定
-                if (!_onGround && _velocity.y <= 0) {
-                    _onGround = true;
-                    _velocity.y = 0;
-                }
-            } else {
-                // 坡度太陡（墙壁）
-                // 限制水平位移，保持原位置，但允许垂直重力/跳跃
-                cocos2d::Vec3 finalPos = oldPos;
-                finalPos.y += _velocity.y * dt; 
-                
-                if (finalPos.y <= groundY) {
-                    finalPos.y = groundY;
-                    _onGround = true;
-                    _velocity.y = 0;
-                }
-                this->setPosition3D(finalPos);
-            }
-        } else {
-            // 3. 没检测到地面（可能出界）
-            // 维持重力下降，但 _onGround 设为 false
-            this->setPosition3D(newPos);
-            _onGround = false;
-        }
+        // 2. 射线检测新位置地面：提交到 TerrainCollider，本帧所有角色合并为一次批量检测
+        _snapOldPos = oldPos;
+        _snapNewPos = newPos;
+        _snapDt = dt;
+        _terrainCollider->requestGroundSnap(this, this, newPos);
     } else {
         // 4. 无碰撞器，维持原有的简单 y=0 判定
         this->setPosition3D(newPos);
@@ -311,3 +296,49 @@ void Character::applyMovement(float dt) {
         }
     }
 }
+
+void Character::onGroundSnap(bool hit, float groundY, const cocos2d::Vec3& groundNormal) {
+    const cocos2d::Vec3& oldPos = _snapOldPos;
+    cocos2d::Vec3 newPos = _snapNewPos;
+    const float dt = _snapDt;
+
+    if (hit) {
+        const float MAX_STEP_HEIGHT = 40.0f; // 稍微增大跨越高度
+        const float MIN_GROUND_NORMAL_Y = 0.5f; // 可行走的最大坡度约 60°
+
+        // 2. 坡度 / 台阶判断
+        // 如果新位置的地面高度与当前位置高度差在允许范围内，或者正在下坡
+        // 上坡时坡面过陡（法线接近水平）同样视为墙壁
+        bool tooSteep = groundY > oldPos.y && groundNormal.y < MIN_GROUND_NORMAL_Y;
+        if (groundY - oldPos.y < MAX_STEP_HEIGHT && !tooSteep) {
+            newPos.y = groundY;
+            this->setPosition3D(newPos);
+            
+            // 落地判定
+            if (!_onGround && _velocity.y <= 0) {
+                _onGround = true;
+                _velocity.y = 0;
+            }
+        } else {
+            // 坡度太陡（墙壁）
+            // 限制水平位移，保持原位置，但允许垂直重力/跳跃
+            cocos2d::Vec3 finalPos = oldPos;
+            finalPos.y += _velocity.y * dt; 
+            
+            if (finalPos.y <= groundY) {
+                finalPos.y = groundY;
+                _onGround = true;
+                _velocity.y = 0;
+            }
+            this->setPosition3D(finalPos);
+        }
+    } else {
+        // 3. 没检测到地面（可能出界）
+        // 维持重力下降，但 _onGround 设为 false
+        this->setPosition3D(newPos);
+        _onGround = false;
+    }
+
+    // 位置已确定，刷新世界空间 AABB
+    _collider.update(this);
+}
@@ -5,6 +5,7 @@
 #include "cocos2d.h"
 #include "../combat/Collider.h"
 #include "../combat/CharacterCollider.h"
+#include "../combat/BroadPhase.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -17,7 +18,7 @@ class CombatComponent;
  * @class Character
  * @brief 角色基类（继承 cocos2d::Node），提供移动、跳跃、翻滚、普攻连招、受击、死亡等通用接口
  */
-class Character : public cocos2d::Node {
+class Character : public cocos2d::Node, public GroundSnapListener {
 public:
     /**
      * @brief 移动意图（由输入或 AI 生成）
@@ -35,6 +36,28 @@ public:
         Dead       ///< 死亡
     };
 
+    /**
+     * @brief 状态 ID（状态机表下标）
+     */
+    enum StateId {
+        STATE_IDLE,     ///< 待机
+        STATE_MOVE,     ///< 移动
+        STATE_JUMP,     ///< 跳跃
+        STATE_ROLL,     ///< 翻滚
+        STATE_ATTACK1,  ///< 普攻第 1 段（2、3 段 ID 连续）
+        STATE_ATTACK2,  ///< 普攻第 2 段
+        STATE_ATTACK3,  ///< 普攻第 3 段
+        STATE_SKILL,    ///< 技能
+        STATE_HURT,     ///< 受击
+        STATE_DEAD,     ///< 死亡
+        STATE_COUNT
+    };
+
+    /**
+     * @brief 角色状态机（状态表容量为 STATE_COUNT）
+     */
+    typedef StateMachine<Character, STATE_COUNT> FSM;
+
 public:
     /**
      * @brief 构造函数
@@ -78,7 +101,17 @@ public:
     void setTerrainCollider(TerrainCollider* collider) { _terrainCollider = collider; }
 
     /**
-     * @brief 设置敌人列表（用于碰撞检测）
+     * @brief 设置场景宽相位（用于与敌人的碰撞检测、近战目标查询）
+     */
+    void setBroadPhase(BroadPhase* broadPhase) { _broadPhase = broadPhase; }
+
+    /**
+     * @brief 获取场景宽相位
+     */
+    BroadPhase* getBroadPhase() const { return _broadPhase; }
+
+    /**
+     * @brief 设置敌人列表
      */
     void setEnemies(const std::vector<Enemy*>* enemies) { _enemies = enemies; }
 
@@ -183,9 +216,9 @@ public:
 
     /**
      * @brief 获取角色状态机
-     * @return StateMachine<Character>& 状态机引用
+     * @return FSM& 状态机引用
      */
-    StateMachine<Character>& getStateMachine();
+    FSM& getStateMachine();
 
     // ======================= 派生类需实现（体现多态） =======================
 
@@ -196,6 +229,14 @@ public:
      */
     virtual void playAnim(const std::string& name, bool loop) = 0;
 
+    /**
+     * @brief 贴地批量检测结果回调（由 TerrainCollider 每帧统一调用）
+     * @param hit 是否检测到地面
+     * @param groundY 地面高度
+     * @param groundNormal 地面法线（用于判断坡度是否可行走）
+     */
+    void onGroundSnap(bool hit, float groundY, const cocos2d::Vec3& groundNormal) override;
+
 public:
     // ======================= 参数（可后续改为读配置/数值表） =======================
 
@@ -228,7 +269,7 @@ protected:
 
     bool _comboBuffered;                 ///< 连招输入缓冲
 
-    StateMachine<Character> _fsm;         ///< 角色状态机（拥有状态映射）
+    FSM _fsm;                            ///< 角色状态机（按状态 ID 索引）
 
     std::vector<std::unique_ptr<BaseState<Character>>> _ownedStates; ///< 状态对象所有权（由角色持有）
 
@@ -238,6 +279,12 @@ protected:
     TerrainCollider* _terrainCollider = nullptr; ///< 地形碰撞器
     CharacterCollider _collider;                 ///< 角色碰撞器
     const std::vector<Enemy*>* _enemies = nullptr; ///< 敌人列表引用
+    BroadPhase* _broadPhase = nullptr;           ///< 场景宽相位
+    std::vector<BroadPhaseProxy> _nearbyActors;  ///< 宽相位查询结果（复用容量）
+
+    cocos2d::Vec3 _snapOldPos;                   ///< 贴地请求时的原位置
+    cocos2d::Vec3 _snapNewPos;                   ///< 贴地请求时的目标位置
+    float _snapDt = 0.0f;                        ///< 贴地请求时的帧间隔
 };
 
 #endif // CHARACTER_H
@@ -4,6 +4,36 @@
 #include "scene_ui/UIManager.h"
 #include "combat/HealthComponent.h"
 
+// ģԤصĶkey -> ļ
+static const char* const kModelFile = "WuKong/wukong.c3b";
+
+static const struct {
+    const char* key;
+    const char* file;
+} kAnimClips[] = {
+    { "idle",      "WuKong/Idle.c3b" },
+    { "run_fwd",   "WuKong/Jog_Fwd.c3b" },
+    { "run_bwd",   "WuKong/Jog_Bwd.c3b" },
+    { "run_left",  "WuKong/Jog_Left.c3b" },    // о
+    { "run_right", "WuKong/Jog_Right.c3b" },
+    { "jump",      "WuKong/Jump.c3b" },
+    { "attack1",   "WuKong/attack1.c3b" },
+    { "attack2",   "WuKong/attack2.c3b" },
+    { "attack3",   "WuKong/attack3.c3b" },
+    { "dead",      "WuKong/Death.c3b" },
+    { "roll",      "WuKong/Roll.c3b" },
+    { "skill",     "WuKong/Skills.c3b" },
+    { "hurt",      "WuKong/Hurt.c3b" },
+};
+
+void Wukong::preloadAssets(AssetLoader* loader, const std::vector<AssetLoader::AssetId>& modelDeps) {
+    if (!loader) return;
+    loader->addModel(kModelFile, modelDeps);
+    for (const auto& clip : kAnimClips) {
+        loader->addAnimation(clip.file);
+    }
+}
+
 Wukong* Wukong::create() {
     Wukong* p = new (std::nothrow) Wukong();
     if (p && p->init()) {
@@ -20,11 +50,11 @@ bool Wukong::init() {
     }
 
     this->setCameraMask((unsigned short)cocos2d::CameraFlag::USER1, true);
-    auto full = cocos2d::FileUtils::getInstance()->fullPathForFilename("WuKong/wukong.c3b");
+    auto full = cocos2d::FileUtils::getInstance()->fullPathForFilename(kModelFile);
     cocos2d::log("[Wukong] fullPath=%s", full.c_str());
 
     //ģ
-    _model = cocos2d::Sprite3D::create("WuKong/wukong.c3b");
+    _model = cocos2d::Sprite3D::create(kModelFile);
     auto aabb = _model->getAABB();
     auto center = (aabb._min + aabb._max) * 0.5f;
 
@@ -47,19 +77,9 @@ bool Wukong::init() {
         _visualRoot->addChild(_model);
 
         // Ԥ
-        _anims["idle"] = cocos2d::Animation3D::create("WuKong/Idle.c3b");
-        _anims["run_fwd"] = cocos2d::Animation3D::create("WuKong/Jog_Fwd.c3b");
-        _anims["run_bwd"] = cocos2d::Animation3D::create("WuKong/Jog_Bwd.c3b");
-        _anims["run_left"] = cocos2d::Animation3D::create("WuKong/Jog_Left.c3b");   // о
-        _anims["run_right"] = cocos2d::Animation3D::create("WuKong/Jog_Right.c3b");
-        _anims["jump"] = cocos2d::Animation3D::create("WuKong/Jump.c3b");
-        _anims["attack1"] = cocos2d::Animation3D::create("WuKong/attack1.c3b");
-        _anims["attack2"] = cocos2d::Animation3D::create("WuKong/attack2.c3b");
-        _anims["attack3"] = cocos2d::Animation3D::create("WuKong/attack3.c3b");
-        _anims["dead"] = cocos2d::Animation3D::create("WuKong/Death.c3b");
-        _anims["roll"] = cocos2d::Animation3D::create("WuKong/Roll.c3b");
-        _anims["skill"] = cocos2d::Animation3D::create("WuKong/Skills.c3b");
-        _anims["hurt"] = cocos2d::Animation3D::create("WuKong/Hurt.c3b");
+        for (const auto& clip : kAnimClips) {
+            _anims[clip.key] = cocos2d::Animation3D::create(clip.file);
+        }
         _anims["run"] = _anims["run_fwd"];
         playAnim("idle", true);
 
@@ -148,10 +168,10 @@ void Wukong::onJumpLanded()
 {
     const auto intent = this->getMoveIntent();
     if (intent.dirWS.lengthSquared() > 1e-6f) {
-        this->getStateMachine().changeState("Move");
+        this->getStateMachine().changeState(STATE_MOVE);
     }
     else {
-        this->getStateMachine().changeState("Idle");
+        this->getStateMachine().changeState(STATE_IDLE);
     }
 }
 
@@ -236,11 +256,11 @@ void Wukong::castSkill() {
     }
 
     // л״̬
-    this->getStateMachine().changeState("Skill");
+    this->getStateMachine().changeState(STATE_SKILL);
 }
 
-void Wukong::triggerHurt() { this->getStateMachine().changeState("Hurt"); }
-void Wukong::triggerDead() { this->getStateMachine().changeState("Dead"); }
+void Wukong::triggerHurt() { this->getStateMachine().changeState(STATE_HURT); }
+void Wukong::triggerDead() { this->getStateMachine().changeState(STATE_DEAD); }
 
 void Wukong::resetSkill() {
     _skillCount = 3;
@@ -3,6 +3,7 @@
 #define WUKONG_H
 
 #include "Character.h"
+#include "core/AssetLoader.h"
 #include <string>
 #include"cocos2d.h"
 #include <unordered_map>
@@ -26,6 +27,14 @@ public:
      */
     virtual bool init() override;
 
+    /**
+     * @brief 向加载器登记悟空的模型与动画，加载后 create 直接命中缓存
+     * @param loader 资源加载器
+     * @param modelDeps 模型的依赖（通常为其材质贴图）
+     */
+    static void preloadAssets(AssetLoader* loader,
+        const std::vector<AssetLoader::AssetId>& modelDeps = {});
+
     /**
      * @brief 播放指定名称的动画
      * @param name 动画名称
@@ -46,6 +55,9 @@ public:
     void updateLocomotionAnim(bool running);
     float getAnimDuration(const std::string& key) const;
 
+    // 角色模型（攻击判定读取骨骼位置）
+    cocos2d::Sprite3D* getModel() const { return _model; }
+
     // 给敌人/AI 用：返回悟空“世界坐标系”的位置（推荐用这个做距离/追击判断）
     cocos2d::Vec3 getWorldPosition3D() const;
 
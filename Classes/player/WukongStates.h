@@ -7,6 +7,7 @@
 #include "Wukong.h"
 #include "enemy/Enemy.h"
 #include "../combat/CombatComponent.h"
+#include "../combat/WeaponSweep.h"
 #include "../scene_ui/UIManager.h"
 #include <string>
 #include <cmath>
@@ -31,7 +32,7 @@ public:
 
         const auto intent = entity->getMoveIntent();
         if (intent.dirWS.lengthSquared() > 1e-6f) {
-            entity->getStateMachine().changeState("Move");
+            entity->getStateMachine().changeState(Character::STATE_MOVE);
         }
     }
 
@@ -39,7 +40,11 @@ public:
         (void)entity;
     }
 
-    std::string getStateName() const override {
+    int getStateId() const override {
+        return Character::STATE_IDLE;
+    }
+
+    const char* getStateName() const override {
         return "Idle";
     }
 };
@@ -72,7 +77,7 @@ public:
 
         if (len2 <= 1e-6f) {
             entity->stopHorizontal();
-            entity->getStateMachine().changeState("Idle");
+            entity->getStateMachine().changeState(Character::STATE_IDLE);
             return;
         }
 
@@ -90,7 +95,11 @@ public:
         entity->stopHorizontal();
     }
 
-    std::string getStateName() const override {
+    int getStateId() const override {
+        return Character::STATE_MOVE;
+    }
+
+    const char* getStateName() const override {
         return "Move";
     }
 };
@@ -130,7 +139,8 @@ public:
     }
 
     void onExit(Character* entity) override { (void)entity; }
-    std::string getStateName() const override { return "Jump"; }
+    int getStateId() const override { return Character::STATE_JUMP; }
+    const char* getStateName() const override { return "Jump"; }
 
 private:
     bool  _landTriggered;
@@ -205,7 +215,7 @@ public:
             entity->stopHorizontal();
             const auto intent = entity->getMoveIntent();
             entity->getStateMachine().changeState(
-                intent.dirWS.lengthSquared() > 1e-6f ? "Move" : "Idle"
+                intent.dirWS.lengthSquared() > 1e-6f ? Character::STATE_MOVE : Character::STATE_IDLE
             );
         }
     }
@@ -215,7 +225,8 @@ public:
         entity->stopHorizontal();
     }
 
-    std::string getStateName() const override { return "Roll"; }
+    int getStateId() const override { return Character::STATE_ROLL; }
+    const char* getStateName() const override { return "Roll"; }
 
 private:
     float _t;
@@ -279,21 +290,26 @@ public:
         const float endTime = 0.95f * _dur;
         if (_t >= endTime) {
             if (_queuedNext && _step < 3) {
-                entity->getStateMachine().changeState(_step == 1 ? "Attack2" : "Attack3");
+                entity->getStateMachine().changeState(_step == 1 ? Character::STATE_ATTACK2 : Character::STATE_ATTACK3);
                 return;
             }
 
             const auto intent = entity->getMoveIntent();
-            if (intent.dirWS.lengthSquared() > 1e-6f) entity->getStateMachine().changeState("Move");
-            else                                      entity->getStateMachine().changeState("Idle");
+            if (intent.dirWS.lengthSquared() > 1e-6f) entity->getStateMachine().changeState(Character::STATE_MOVE);
+            else                                      entity->getStateMachine().changeState(Character::STATE_IDLE);
         }
     }
 
     void onExit(Character* entity) override {
         (void)entity;
+        _sweep.end();
+    }
+
+    int getStateId() const override {
+        return Character::STATE_ATTACK1 + (_step - 1);
     }
 
-    std::string getStateName() const override {
+    const char* getStateName() const override {
         if (_step == 1) return "Attack1";
         if (_step == 2) return "Attack2";
         return "Attack3";
@@ -331,53 +347,40 @@ private:
         }
 
         float hitTime = hitTimeRatio * _dur;
+        if (_t < hitTime) return;
 
-        // 在合适的时机执行一次伤害检测
-        if (_t >= hitTime && _t <= hitTime + hitWindow) {
-            auto* combat = entity->getCombat();
-            if (combat) {
-                // 获取敌人列表
-                auto* enemies = entity->getEnemies();
-                if (enemies && !enemies->empty()) {
-                    // 将 Enemy* 转换为 Node* 以匹配函数参数类型
-                    // 同时只保留存活的敌人
-                    std::vector<Node*> nodeTargets;
-                    nodeTargets.reserve(enemies->size());
-                    for (auto* enemy : *enemies) {
-                        // 只对存活的敌人进行攻击检测
-                        if (enemy && !enemy->isDead()) {
-                            nodeTargets.push_back(dynamic_cast<Node*>(enemy));
-                        }
-                    }
-                    
-                    // 执行近战攻击
-                    if (!nodeTargets.empty()) {
-                        int hitCount = combat->executeMeleeAttack(
-                            entity->getCollider(), 
-                            nodeTargets
-                        );
-
-                        if (hitCount > 0) {
-                            CCLOG("AttackState: %s hit %d enemies!", getStateName().c_str(), hitCount);
-                            
-                            // 可以在这里添加攻击命中特效或音效
-                            // TODO: 添加攻击命中反馈
-                        }
-                    } else {
-                        CCLOG("AttackState: %s - no alive enemies to attack", getStateName().c_str());
-                    }
-                }
-            }
+        auto* combat = entity->getCombat();
+        if (!combat) {
+            _damageDealt = true;
+            return;
+        }
+
+        // 检测窗口内逐帧提交右臂（武器）从上一帧到本帧的扫掠判定，
+        // 整个窗口对同一敌人只命中一次；即使一帧跨过整个窗口也至少判定一次
+        // TODO: 添加攻击命中反馈（可订阅 EnemyHurtEvent）
+        if (!_sweep.isActive()) {
+            auto* wk = dynamic_cast<Wukong*>(entity);
+            _sweep.begin(combat->getCombatSystem(), entity, wk ? wk->getModel() : nullptr,
+                         "lowerarm_r", "hand_r", kWeaponRadius, kWeaponReach);
+        }
+        _sweep.update(combat->makeHitRequest(BroadPhase::LAYER_ENEMY));
+
+        if (_t >= hitTime + hitWindow) {
+            _sweep.end();
             _damageDealt = true; // 标记已经执行过伤害检测，避免重复伤害
         }
     }
 
 private:
+    static constexpr float kWeaponRadius = 40.0f;  ///< 武器胶囊半径
+    static constexpr float kWeaponReach = 60.0f;   ///< 胶囊从手部外延的长度
+
     int _step;  ///< 连招段数
     float _t;   ///< 计时
     bool _queuedNext;
     bool _damageDealt;  ///< 是否已经执行过伤害检测
     float _dur;
+    WeaponSweep _sweep; ///< 检测窗口内的扫掠判定
 };
 
 /**
@@ -410,7 +413,7 @@ public:
         if (_t >= 0.95f * _dur) {
             const auto intent = entity->getMoveIntent();
             entity->getStateMachine().changeState(
-                intent.dirWS.lengthSquared() > 1e-6f ? "Move" : "Idle"
+                intent.dirWS.lengthSquared() > 1e-6f ? Character::STATE_MOVE : Character::STATE_IDLE
             );
         }
     }
@@ -419,7 +422,11 @@ public:
         (void)entity;
     }
 
-    std::string getStateName() const override {
+    int getStateId() const override {
+        return Character::STATE_HURT;
+    }
+
+    const char* getStateName() const override {
         return "Hurt";
     }
 
@@ -471,7 +478,11 @@ public:
         (void)entity;
     }
 
-    std::string getStateName() const override {
+    int getStateId() const override {
+        return Character::STATE_DEAD;
+    }
+
+    const char* getStateName() const override {
         return "Dead";
     }
     
@@ -483,11 +494,12 @@ private:
 
 class SkillState : public BaseState<Character> {
 public:
-    SkillState() : _t(0.0f), _dur(0.8f) {}
+    SkillState() : _t(0.0f), _dur(0.8f), _damageDealt(false) {}
 
     void onEnter(Character* entity) override {
         if (!entity) return;
         _t = 0.0f;
+        _damageDealt = false;
 
         entity->stopHorizontal();
         entity->playAnim("skill", false);
@@ -507,22 +519,37 @@ public:
         if (!entity) return;
         _t += dt;
 
-        // TODO：示例：在 25%~45% 动画区间做判定（你后续接 hitbox 就放这里）
+        // 动画过 25% 后对周围所有敌人做一次范围判定；
+        // 不设上限，即使一帧卡顿跨过整个出招区间也会判定一次
+        if (!_damageDealt && _t >= 0.25f * _dur) {
+            _damageDealt = true;
+            if (auto* combat = entity->getCombat()) {
+                Vec3 center;
+                entity->getNodeToWorldTransform().transformPoint(Vec3::ZERO, &center);
+                combat->queueAreaAttack(center, kSkillRadius, BroadPhase::LAYER_ENEMY, kSkillDamageScale);
+            }
+        }
 
         if (_t >= 0.95f * _dur) {
             const auto intent = entity->getMoveIntent();
             entity->getStateMachine().changeState(
-                intent.dirWS.lengthSquared() > 1e-6f ? "Move" : "Idle"
+                intent.dirWS.lengthSquared() > 1e-6f ? Character::STATE_MOVE : Character::STATE_IDLE
             );
         }
     }
 
     void onExit(Character* entity) override { (void)entity; }
-    std::string getStateName() const override { return "Skill"; }
+    int getStateId() const override { return Character::STATE_SKILL; }
+    const char* getStateName() const override { return "Skill"; }
 
 private:
+    // 新增的调参值（原先技能没有伤害），需按手感再调
+    static constexpr float kSkillRadius = 250.0f;       ///< 技能判定半径
+    static constexpr float kSkillDamageScale = 1.5f;    ///< 技能伤害倍率
+
     float _t;
     float _dur;
+    bool _damageDealt;  ///< 是否已经执行过伤害检测
 };
 
 #endif // WUKONGSTATES_H
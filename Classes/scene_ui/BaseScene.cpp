@@ -7,13 +7,17 @@
 #include "BaseScene.h"
 
 #include <algorithm>
+#include <map>
 
 #include "3d/CCSprite3D.h"
 #include "3d/CCTerrain.h"
+#include "AIScheduler.h"
 #include "AudioManager.h"
 #include "Boss.h"
 #include "BossAI.h"
+#include "CombatComponent.h"
 #include "Enemy.h"
+#include "EnemyNavigation.h"
 #include "GameApp.h"
 #include "HealthComponent.h"
 #include "InputController.h"
@@ -31,6 +35,27 @@ static float s_aspect = 1.0f;
 static float s_nearPlane = 1.0f;
 static float s_farPlane = 2000.0f;
 
+// ģͣײλú決еĵα֮һ¡
+static const char* const kTerrainModel = "scene/terrain.obj";
+static const float kTerrainScale = 100.0f;
+
+// ԭ㡣
+struct EnemySpawn {
+  const char* root;
+  const char* model;
+  const char* texture;  // ģͲͼԤʱΪģ͵
+  cocos2d::Vec3 pos;
+};
+
+static const EnemySpawn kEnemySpawns[] = {
+    {"Enemy/enemy1", "enemy1.c3b", "Enemy/enemy1/PolygonMinis_Texture_01_A.png",
+     cocos2d::Vec3(400, 0, -400)},
+    {"Enemy/enemy2", "enemy2.c3b", "Enemy/enemy2/PolygonMinis_Texture_Yellow_A.png",
+     cocos2d::Vec3(450, 0, -420)},
+    {"Enemy/enemy3", "enemy3.c3b", "Enemy/enemy3/PolygonMinis_Texture_Blue_A.png",
+     cocos2d::Vec3(380, 0, -450)},
+};
+
 Scene* BaseScene::createScene() { return BaseScene::create(); }
 
 bool BaseScene::init() {
@@ -44,16 +69,20 @@ bool BaseScene::init() {
   // ʼϷΪڵײ
   // ࣨ CampSceneڼκӦʽ initGameObjects()
 
-  // ʼ͵ǡ
+  // ʼ͵ǡбͬһģͣһʵУ
+  // ÿֻύһλơ
   auto points = AreaManager::getInstance()->getTeleportPoints();
-  for (const auto& pt : points) {
-    auto marker = Sprite3D::create("WuKong/wukong.c3b");
-    if (marker) {
+  auto markers = Sprite3DInstanceGroup::create("WuKong/wukong.c3b");
+  if (markers) {
+    markers->setCameraMask((unsigned short)CameraFlag::USER1);
+    this->addChild(markers);
+
+    for (const auto& pt : points) {
+      auto marker = markers->addInstance();
+      if (!marker) continue;
       marker->setPosition3D(pt.position);
       marker->setScale(0.5f);
       marker->setColor(Color3B(255, 215, 0));  // ɫ
-      marker->setCameraMask((unsigned short)CameraFlag::USER1);
-      this->addChild(marker);
 
       // ΪӼ򵥵ת
       marker->runAction(
@@ -81,11 +110,59 @@ bool BaseScene::init() {
   return true;
 }
 
+BaseScene::~BaseScene() {
+  GameApp::getInstance()->getEventBus()->unsubscribe(_enemyRemovedHandle);
+  CC_SAFE_RELEASE(_aiScheduler);
+  CC_SAFE_RELEASE(_navigation);
+  CC_SAFE_RELEASE(_combatSystem);
+  CC_SAFE_RELEASE(_broadPhase);
+}
+
 void BaseScene::initGameObjects() {
+  // ɫ֮ĿλҡˡBoss Ǽǡ
+  _broadPhase = BroadPhase::create();
+  CC_SAFE_RETAIN(_broadPhase);
+
+  // ֻύжÿ֡ڿλؽͳһ㡣
+  _combatSystem = CombatSystem::create(_broadPhase);
+  CC_SAFE_RETAIN(_combatSystem);
+
+  // ˵ں̨ػ決ǰֱƶ
+  if (_terrainCollider) {
+    _navigation = EnemyNavigation::create(_terrainCollider, "scene/terrain.obj");
+    CC_SAFE_RETAIN(_navigation);
+  }
+
+  //  AI ҵľֵƵС
+  _aiScheduler = AIScheduler::create();
+  CC_SAFE_RETAIN(_aiScheduler);
+
   initPlayer();
+  if (_aiScheduler) {
+    _aiScheduler->setFocus(_player);
+  }
   initEnemy();
   initBoss();
 
+  // ˣ BossӸϵͳעBoss ʱʾʤ档
+  _enemyRemovedHandle =
+      GameApp::getInstance()->getEventBus()->subscribe<EnemyRemovedEvent>(
+          [this](const EnemyRemovedEvent& event) {
+            Enemy* deadEnemy = event.enemy;
+            if (!deadEnemy) {
+              return;
+            }
+            CCLOG("BaseScene: Ƴ %p", (void*)deadEnemy);
+            const bool isBoss =
+                deadEnemy->getEnemyType() == Enemy::EnemyType::BOSS;
+            this->removeDeadEnemy(deadEnemy);
+
+            if (isBoss) {
+              // ʾʤ档
+              UIManager::getInstance()->showVictoryUI();
+            }
+          });
+
   // ʼ HUD
   UIManager::getInstance()->showHUD(this);
 }
@@ -134,33 +211,21 @@ bool BaseScene::chooseSkyboxFaces(std::array<std::string, 6>& outFaces) {
 }
 
 // ֤ͼǷΪҳߴһ¡
+// ֻȡļͷأ TextureCube ڴʱɣȡԤصĽ
 bool BaseScene::verifyCubeFacesSquare(const std::array<std::string, 6>& faces) {
   int faceSize = -1;
   for (int i = 0; i < 6; ++i) {
-    std::string full = FileUtils::getInstance()->fullPathForFilename(faces[i]);
-    if (full.empty()) return false;
-
-    auto img = new (std::nothrow) Image();
-    if (!img || !img->initWithImageFile(full)) {
-      CC_SAFE_DELETE(img);
-      return false;
-    }
+    Image::ProbeInfo info;
+    if (!Image::probeFile(faces[i], &info)) return false;
 
     // ͼǷΪΡ
-    if (img->getWidth() != img->getHeight()) {
-      CC_SAFE_DELETE(img);
-      return false;
-    }
+    if (info.width != info.height) return false;
 
     // ǷСͬ
     if (faceSize < 0)
-      faceSize = img->getWidth();
-    else if (faceSize != img->getWidth()) {
-      CC_SAFE_DELETE(img);
+      faceSize = info.width;
+    else if (faceSize != info.width)
       return false;
-    }
-
-    CC_SAFE_DELETE(img);
   }
   return true;
 }
@@ -280,10 +345,10 @@ void BaseScene::teleportPlayerToCenter() {
   if (_player) {
     cocos2d::Vec3 teleportPos(0, 0, -960);
     if (_terrainCollider) {
-        CustomRay ray(teleportPos + cocos2d::Vec3(0, 500, 0), cocos2d::Vec3(0, -1, 0));
-        float hitDist;
-        if (_terrainCollider->rayIntersects(ray, hitDist)) {
-            teleportPos.y = ray.origin.y - hitDist;
+        float groundY;
+        if (_terrainCollider->getGroundHeight(teleportPos.x, teleportPos.z, groundY, nullptr,
+                                              teleportPos.y + 500.0f)) {
+            teleportPos.y = groundY;
         }
     }
     _player->setPosition3D(teleportPos);  // ص͵ 2
@@ -304,19 +369,68 @@ void BaseScene::teleportPlayerToCenter() {
 
 Scene* CampScene::createScene() { return CampScene::create(); }
 
+bool CampScene::cookCollisionMeshes() {
+  std::string objPath = FileUtils::getInstance()->fullPathForFilename(kTerrainModel);
+  if (objPath.empty()) return false;
+
+  std::string outPath = CookedCollisionMesh::cookedPathFor(objPath);
+  bool ok = TerrainCollider::cook(kTerrainModel, kTerrainScale, Vec3::ZERO, outPath);
+  CCLOG("CampScene: cook %s -> %s %s", kTerrainModel, outPath.c_str(), ok ? "done" : "failed");
+  return ok;
+}
+
+void CampScene::preloadAssets(AssetLoader* loader) {
+  if (!loader) return;
+
+  // պͼڹ߳̽룬պʱ TextureCube ֱȡãٽ롣
+  loader->addTask([]() {
+    std::array<std::string, 6> faces;
+    if (!chooseSkyboxFaces(faces) || !verifyCubeFacesSquare(faces)) return;
+    for (const auto& face : faces) {
+      DecodedImageCache::getInstance()->preload(face);
+    }
+  });
+
+  // ΣȼزͼģͳʼʱֱӴ TextureCache ȡá
+  static const char* const kTerrainTextures[] = {
+      "scene/bridge.png",     "scene/house_green.png", "scene/house_pink.png",
+      "scene/leaves_two.png", "scene/pine tree.png",   "scene/river_white.png",
+      "scene/rocks.png",      "scene/roof.png",        "scene/shed.png",
+      "scene/stone.png",      "scene/yellow house.png"};
+  std::vector<AssetLoader::AssetId> terrainDeps;
+  for (const char* tex : kTerrainTextures) {
+    terrainDeps.push_back(loader->addTexture(tex));
+  }
+  loader->addModel(kTerrainModel, terrainDeps);
+
+  // գ͵Ҳʹͬһģͣ
+  Wukong::preloadAssets(
+      loader, {loader->addTexture("WuKong/PolygonMinis_Texture_Purple_B.png"),
+               loader->addTexture("WuKong/PolygonMinis_Texture_Red_B.png")});
+
+  //  Boss
+  for (const auto& s : kEnemySpawns) {
+    Enemy::preloadAssets(loader, s.root, s.model,
+                         {loader->addTexture(s.texture)});
+  }
+  Enemy::preloadAssets(
+      loader, "Enemy/boss", "boss.c3b",
+      {loader->addTexture("Enemy/boss/PolygonMinis_Texture_Purple_A.png")});
+}
+
 bool CampScene::init() {
   if (!BaseScene::init()) return false;
 
   // صģ͡
-  auto terrain = Sprite3D::create("scene/terrain.obj");
+  auto terrain = Sprite3D::create(kTerrainModel);
   if (terrain) {
-    terrain->setPosition3D(Vec3(0, 0, 0));
-    terrain->setScale(100.0f);
+    terrain->setPosition3D(Vec3::ZERO);
+    terrain->setScale(kTerrainScale);
     terrain->setCameraMask((unsigned short)CameraFlag::USER1);
     addChild(terrain);
 
     // ʼײ
-    _terrainCollider = TerrainCollider::create(terrain, "scene/terrain.obj");
+    _terrainCollider = TerrainCollider::create(terrain, kTerrainModel);
     if (_terrainCollider) {
       _terrainCollider->retain();
       if (_player) {
@@ -346,11 +460,11 @@ void BaseScene::initPlayer() {
   // ڴ͵ 2 ҡ
   cocos2d::Vec3 playerSpawnPos(0.0f, 0.0f, -960.0f);
   if (_terrainCollider) {
-      CustomRay ray(playerSpawnPos + cocos2d::Vec3(0, 500, 0), cocos2d::Vec3(0, -1, 0));
-      float hitDist;
-      if (_terrainCollider->rayIntersects(ray, hitDist)) {
-          playerSpawnPos.y = ray.origin.y - hitDist;
-          CCLOG("Player spawned at ground Y: %f (hitDist: %f)", playerSpawnPos.y, hitDist);
+      float groundY;
+      if (_terrainCollider->getGroundHeight(playerSpawnPos.x, playerSpawnPos.z, groundY, nullptr,
+                                            playerSpawnPos.y + 500.0f)) {
+          playerSpawnPos.y = groundY;
+          CCLOG("Player spawned at ground Y: %f", playerSpawnPos.y);
       } else {
           CCLOG("Warning: Player terrain raycast failed!");
       }
@@ -362,6 +476,14 @@ void BaseScene::initPlayer() {
     _player->setTerrainCollider(_terrainCollider);
   }
 
+  if (_broadPhase) {
+    _player->setBroadPhase(_broadPhase);
+    _broadPhase->add(_player, &_player->getCollider(), BroadPhase::LAYER_PLAYER);
+  }
+  if (_player->getCombat()) {
+    _player->getCombat()->setCombatSystem(_combatSystem);
+  }
+
   addChild(_player, 10);
 
   // ʼҿ
@@ -373,29 +495,21 @@ void BaseScene::initPlayer() {
 }
 
 void BaseScene::initEnemy() {
-  struct Spawn {
-    const char* root;
-    const char* model;
-    cocos2d::Vec3 pos;
-  };
-
-  const Spawn spawns[] = {
-      {"Enemy/enemy1", "enemy1.c3b", cocos2d::Vec3(400, 0, -400)},
-      {"Enemy/enemy2", "enemy2.c3b", cocos2d::Vec3(450, 0, -420)},
-      {"Enemy/enemy3", "enemy3.c3b", cocos2d::Vec3(380, 0, -450)},
-  };
+  // ͬһԭ͵ĵһʵƣÿֻύһλƣ
+  // ˵Ĺɫ尴дʵѡڵС
+  std::map<std::string, Sprite3DInstanceGroup*> enemyGroups;
 
-  for (auto& s : spawns) {
+  for (auto& s : kEnemySpawns) {
     auto e = Enemy::createWithResRoot(s.root, s.model);
     if (!e) continue;
 
     cocos2d::Vec3 spawnPos = s.pos;
     if (_terrainCollider) {
-        CustomRay ray(spawnPos + cocos2d::Vec3(0, 500, 0), cocos2d::Vec3(0, -1, 0));
-        float hitDist;
-        if (_terrainCollider->rayIntersects(ray, hitDist)) {
-            spawnPos.y = ray.origin.y - hitDist;
-            CCLOG("Enemy spawned at ground Y: %f (hitDist: %f)", spawnPos.y, hitDist);
+        float groundY;
+        if (_terrainCollider->getGroundHeight(spawnPos.x, spawnPos.z, groundY, nullptr,
+                                              spawnPos.y + 500.0f)) {
+            spawnPos.y = groundY;
+            CCLOG("Enemy spawned at ground Y: %f", spawnPos.y);
         } else {
             CCLOG("Warning: Enemy terrain raycast failed!");
         }
@@ -413,24 +527,40 @@ void BaseScene::initEnemy() {
 
     this->addChild(e);
     _enemies.push_back(e);
+
+    // 豸֧ʵʱ addSprite  falseģɾԼơ
+    const std::string modelPath = std::string(s.root) + "/" + s.model;
+    auto& group = enemyGroups[modelPath];
+    if (!group) {
+      group = Sprite3DInstanceGroup::create(modelPath);
+      if (group) {
+        group->setCameraMask((unsigned short)CameraFlag::USER1);
+        group->setCullFaceEnabled(false);
+        this->addChild(group);
+      }
+    }
+    if (group) {
+      group->addSprite(e->getSprite());
+    }
+
+    if (_broadPhase) {
+      _broadPhase->add(e, &e->getCollider(), BroadPhase::LAYER_ENEMY);
+    }
+    if (e->getCombat()) {
+      e->getCombat()->setCombatSystem(_combatSystem);
+    }
+    if (_navigation) {
+      _navigation->addEnemy(e);
+      e->setNavigation(_navigation);
+    }
+    if (_aiScheduler) {
+      _aiScheduler->add(e);
+    }
   }
 
   if (_player) {
     _player->setEnemies(&_enemies);
   }
-
-  // 
-  auto enemyDeathListener = cocos2d::EventListenerCustom::create(
-      "enemy_died", [this](cocos2d::EventCustom* event) {
-        CCLOG("BaseScene: ¼");
-        Enemy* deadEnemy = static_cast<Enemy*>(event->getUserData());
-        if (deadEnemy) {
-          CCLOG("BaseScene: Ƴ %p", (void*)deadEnemy);
-          this->removeDeadEnemy(deadEnemy);
-        }
-      });
-
-  _eventDispatcher->addEventListenerWithFixedPriority(enemyDeathListener, 1);
 }
 
 void BaseScene::removeDeadEnemy(Enemy* deadEnemy) {
@@ -441,6 +571,17 @@ void BaseScene::removeDeadEnemy(Enemy* deadEnemy) {
 
   CCLOG("BaseScene::removeDeadEnemy: Ƴ %p", (void*)deadEnemy);
 
+  if (_broadPhase) {
+    _broadPhase->remove(deadEnemy);
+  }
+  if (_navigation) {
+    deadEnemy->setNavigation(nullptr);
+    _navigation->removeEnemy(deadEnemy);
+  }
+  if (_aiScheduler) {
+    _aiScheduler->remove(deadEnemy);
+  }
+
   // ӵƳ
   auto it = std::find(_enemies.begin(), _enemies.end(), deadEnemy);
   if (it != _enemies.end()) {
@@ -483,13 +624,11 @@ void BaseScene::initBoss() {
 
   // Ըݵζʼ߶
   if (_terrainCollider) {
-      CustomRay ray(cocos2d::Vec3(-200, 500, 600), cocos2d::Vec3(0, -1, 0));
-      float hitDist;
-      if (_terrainCollider->rayIntersects(ray, hitDist)) {
-          float groundY = ray.origin.y - hitDist;
+      float groundY;
+      if (_terrainCollider->getGroundHeight(-200.0f, 600.0f, groundY, nullptr, 500.0f)) {
           boss->setPosition3D(cocos2d::Vec3(-200, groundY, 600));
           boss->setBirthPosition(boss->getPosition3D());
-          CCLOG("Boss spawned at ground Y: %f (hitDist: %f)", groundY, hitDist);
+          CCLOG("Boss spawned at ground Y: %f", groundY);
       } else {
           CCLOG("Warning: Boss terrain raycast failed!");
       }
@@ -497,6 +636,19 @@ void BaseScene::initBoss() {
 
   this->addChild(boss);
   _enemies.push_back(boss);
+  if (_broadPhase) {
+    _broadPhase->add(boss, &boss->getCollider(), BroadPhase::LAYER_ENEMY);
+  }
+  if (boss->getCombat()) {
+    boss->getCombat()->setCombatSystem(_combatSystem);
+  }
+  if (_navigation) {
+    _navigation->addEnemy(boss);
+    boss->setNavigation(_navigation);
+  }
+  if (_aiScheduler) {
+    _aiScheduler->add(boss);
+  }
 
   if (_player) {
     _player->setEnemies(&_enemies);
@@ -504,20 +656,4 @@ void BaseScene::initBoss() {
 
   CCLOG("Boss ѳʼ: %f, %f, %f  AI", boss->getPositionX(),
         boss->getPositionY(), boss->getPositionZ());
-
-  //  Boss ¼
-  auto bossDeathListener = cocos2d::EventListenerCustom::create(
-      "enemy_died", [this](cocos2d::EventCustom* event) {
-        CCLOG("BaseScene:  Boss ¼");
-        Enemy* deadEnemy = static_cast<Enemy*>(event->getUserData());
-        if (deadEnemy && deadEnemy->getEnemyType() == Enemy::EnemyType::BOSS) {
-          CCLOG("BaseScene: Ƴ Boss %p", (void*)deadEnemy);
-          this->removeDeadEnemy(deadEnemy);
-
-          // ʾʤ档
-          UIManager::getInstance()->showVictoryUI();
-        }
-      });
-
-  _eventDispatcher->addEventListenerWithFixedPriority(bossDeathListener, 1);
 }
@@ -9,19 +9,26 @@
 #include <string>
 #include <vector>
 
+#include "../combat/BroadPhase.h"
 #include "../combat/Collider.h"
+#include "../combat/CombatSystem.h"
+#include "../core/AssetLoader.h"
+#include "../core/EventBus.h"
 #include "Enemy.h"
 #include "Wukong.h"
 #include "cocos2d.h"
 
 class Wukong;
 class TerrainCollider;
+class EnemyNavigation;
+class AIScheduler;
 
 // BaseScene 是所有 3D 游戏场景的基础类。
 // 它处理摄像机、天空盒、光照、输入、玩家和敌人管理。
 class BaseScene : public cocos2d::Scene {
  public:
   static cocos2d::Scene* createScene();
+  virtual ~BaseScene();
   virtual bool init() override;
 
   // 将玩家传送到重生点并重置敌人。
@@ -44,9 +51,9 @@ class BaseScene : public cocos2d::Scene {
   virtual void update(float dt) override;
   void updateCamera(float dt);
 
-  // 天空盒辅助方法。
-  bool chooseSkyboxFaces(std::array<std::string, 6>& outFaces);
-  bool verifyCubeFacesSquare(const std::array<std::string, 6>& faces);
+  // 天空盒辅助方法（不访问场景状态，可在加载线程调用）。
+  static bool chooseSkyboxFaces(std::array<std::string, 6>& outFaces);
+  static bool verifyCubeFacesSquare(const std::array<std::string, 6>& faces);
 
   // 敌人管理。
   void removeDeadEnemy(Enemy* deadEnemy);
@@ -93,6 +100,11 @@ class BaseScene : public cocos2d::Scene {
   // 游戏对象。
   Wukong* _player = nullptr;
   TerrainCollider* _terrainCollider = nullptr;
+  BroadPhase* _broadPhase = nullptr;  // 角色之间的宽相位。
+  CombatSystem* _combatSystem = nullptr;   // 命中与伤害批量结算。
+  EnemyNavigation* _navigation = nullptr;  // 敌人导航与人群避让。
+  AIScheduler* _aiScheduler = nullptr;     // 敌人 AI 分档调度。
+  EventHandle _enemyRemovedHandle;         // 敌人移除事件的订阅。
   std::vector<Enemy*> _enemies;
 };
 
@@ -101,6 +113,14 @@ class CampScene : public BaseScene {
  public:
   static cocos2d::Scene* createScene();
   virtual bool init() override;
+
+  // 向加载器登记营地场景用到的模型、贴图与动画（见 LoadingScene）。
+  static void preloadAssets(AssetLoader* loader);
+
+  // 离线烘焙营地地形的碰撞网格，写到资源目录中 .obj 的旁边，随资源一起发布
+  // （桌面版以 --cook-collision 启动时调用，见 proj.win32/main.cpp）。
+  static bool cookCollisionMeshes();
+
   CREATE_FUNC(CampScene);
 };
 
@@ -0,0 +1,123 @@
+// Copyright 2025 The Black Myth Wukong Authors. All Rights Reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma execution_character_set("utf-8")
+
+#include "LoadingScene.h"
+
+#include <algorithm>
+
+#include "UIManager.h"
+
+USING_NS_CC;
+
+// 加载完成后切换到目标场景的淡入淡出时长（秒）。
+static const float kFadeTime = 0.3f;
+
+LoadingScene* LoadingScene::create(const Manifest& manifest,
+                                   const SceneCreator& nextScene) {
+  auto scene = new (std::nothrow) LoadingScene();
+  if (scene && scene->init(manifest, nextScene)) {
+    scene->autorelease();
+    return scene;
+  }
+  CC_SAFE_DELETE(scene);
+  return nullptr;
+}
+
+LoadingScene::~LoadingScene() {
+  if (_loader) {
+    // 在途的后台加载持有加载器，结束后自行释放；这里只断开回调。
+    _loader->cancel();
+    CC_SAFE_RELEASE_NULL(_loader);
+  }
+}
+
+bool LoadingScene::init(const Manifest& manifest,
+                        const SceneCreator& nextScene) {
+  if (!Scene::init()) return false;
+
+  _nextScene = nextScene;
+  _loader = AssetLoader::create();
+  CC_SAFE_RETAIN(_loader);
+  if (_loader && manifest) {
+    manifest(_loader);
+  }
+
+  initUI();
+  scheduleUpdate();
+  return true;
+}
+
+void LoadingScene::initUI() {
+  auto vs = Director::getInstance()->getVisibleSize();
+  Vec2 origin = Director::getInstance()->getVisibleOrigin();
+
+  auto bg = LayerColor::create(Color4B(8, 9, 11, 255));
+  addChild(bg, 0);
+
+  auto title = Label::createWithSystemFont("加载中", "Arial", 36);
+  title->setPosition(Vec2(vs.width / 2 + origin.x, 120 + origin.y));
+  addChild(title, 1);
+
+  // 进度条：背景 + 填充条（锚点在左端，进度通过缩放改变）。
+  Vec2 barPos(vs.width / 2 + origin.x, 70 + origin.y);
+  auto barBg = UIManager::createRectSprite(_barWidth + 4, _barHeight + 4,
+                                           Color4F(1, 1, 1, 0.15f));
+  barBg->setPosition(barPos);
+  addChild(barBg, 1);
+
+  _barFill = UIManager::createRectSprite(_barWidth, _barHeight,
+                                         Color4F(0.85f, 0.65f, 0.25f, 1.0f));
+  _barFill->setAnchorPoint(Vec2(0, 0.5f));
+  _barFill->setPosition(barPos - Vec2(_barWidth / 2, 0));
+  _barFill->setScaleX(0.0f);
+  addChild(_barFill, 2);
+
+  _percentLabel = Label::createWithSystemFont("0%", "Arial", 18);
+  _percentLabel->setPosition(barPos + Vec2(0, -24));
+  addChild(_percentLabel, 1);
+}
+
+void LoadingScene::onEnter() {
+  Scene::onEnter();
+
+  // 进入场景后再开始，保证加载界面先显示出来。
+  if (_loader && !_loader->isFinished()) {
+    _loader->start(
+        [this](float progress) { onProgress(progress); },
+        [this](int failedCount) { onLoaded(failedCount); });
+  }
+}
+
+void LoadingScene::onProgress(float progress) {
+  _barFill->setScaleX(std::max(0.0f, std::min(progress, 1.0f)));
+
+  // 百分比文本只在整数变化时重新排版。
+  int percent = (int)(progress * 100.0f);
+  if (percent != _shownPercent) {
+    _shownPercent = percent;
+    _percentLabel->setString(StringUtils::format("%d%%", percent));
+  }
+}
+
+void LoadingScene::onLoaded(int failedCount) {
+  if (failedCount > 0) {
+    CCLOG("加载完成，%d 个资源加载失败，将在场景中同步重试。", failedCount);
+  }
+
+  _loaded = true;
+}
+
+void LoadingScene::update(float dt) {
+  // 等进入本场景的过渡动画结束后再切换，过渡期间切换场景会打乱过渡的收尾。
+  if (!_loaded || _switched) return;
+  if (Director::getInstance()->getRunningScene() != this) return;
+
+  _switched = true;
+  Scene* next = _nextScene ? _nextScene() : nullptr;
+  if (!next) return;
+  Director::getInstance()->replaceScene(
+      TransitionFade::create(kFadeTime, next, Color3B::BLACK));
+}
@@ -0,0 +1,48 @@
+// Copyright 2025 The Black Myth Wukong Authors. All Rights Reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __LOADING_SCENE_H__
+#define __LOADING_SCENE_H__
+
+#include <functional>
+
+#include "../core/AssetLoader.h"
+#include "cocos2d.h"
+
+// LoadingScene 在后台加载下一个场景的资源并显示进度，完成后切换到该场景。
+// 目标场景的同步创建代码不需要修改：资源已在缓存中，create 直接命中缓存。
+class LoadingScene : public cocos2d::Scene {
+ public:
+  // 向加载器登记资源清单。
+  typedef std::function<void(AssetLoader*)> Manifest;
+  // 创建加载完成后要进入的场景。
+  typedef std::function<cocos2d::Scene*()> SceneCreator;
+
+  static LoadingScene* create(const Manifest& manifest,
+                              const SceneCreator& nextScene);
+
+  virtual ~LoadingScene();
+  bool init(const Manifest& manifest, const SceneCreator& nextScene);
+
+  virtual void onEnter() override;
+  virtual void update(float dt) override;
+
+ private:
+  void initUI();
+  void onProgress(float progress);
+  void onLoaded(int failedCount);
+
+  AssetLoader* _loader = nullptr;
+  SceneCreator _nextScene;
+
+  cocos2d::Sprite* _barFill = nullptr;  // 锚点在左端，按进度缩放 X。
+  cocos2d::Label* _percentLabel = nullptr;
+  float _barWidth = 600.0f;
+  float _barHeight = 12.0f;
+  int _shownPercent = -1;
+  bool _loaded = false;
+  bool _switched = false;
+};
+
+#endif  // __LOADING_SCENE_H__
@@ -95,86 +95,109 @@ Scene* UIManager::createStartMenuScene() {
   return scene;
 }
 
+Sprite* UIManager::createRectSprite(float width, float height,
+                                    const Color4F& color) {
+  // ָʱʹ滺 2x2 ɫѪͬһʡ
+  auto sprite = Sprite::create();
+  sprite->setTextureRect(Rect(0, 0, width, height));
+  sprite->setColor(Color3B(color));
+  sprite->setOpacity((GLubyte)(color.a * 255));
+  return sprite;
+}
+
 void UIManager::showHUD(Node* parent) {
   if (!parent) return;
 
   auto vs = Director::getInstance()->getVisibleSize();
   Vec2 origin = Director::getInstance()->getVisibleOrigin();
 
-  // 1. Ѫ
-  auto bg = DrawNode::create();
-  bg->drawSolidRect(Vec2(-_hpBarWidth / 2 - 2, -_hpBarHeight / 2 - 2),
-                    Vec2(_hpBarWidth / 2 + 2, _hpBarHeight / 2 + 2),
-                    Color4F(0, 0, 0, 0.5f));
-  bg->setPosition(Vec2(vs.width / 2 + origin.x, 50 + origin.y));
-  parent->addChild(bg, 999);
-
-  // 2. Ѫ DrawNode
-  _hpBarDrawNode = DrawNode::create();
-  _hpBarDrawNode->setPosition(Vec2(vs.width / 2 + origin.x, 50 + origin.y));
-  parent->addChild(_hpBarDrawNode, 1000);
-
-  // 3. ֵı
+  // ѪıҲͬȾϲΪһλơ
+  auto hudRoot = Node::create();
+  parent->addChild(hudRoot, 999);
+
+  // 1. Ѫ + êˣͨŸı䣩
+  Vec2 hpPos(vs.width / 2 + origin.x, 50 + origin.y);
+  auto bg = createRectSprite(_hpBarWidth + 4, _hpBarHeight + 4,
+                             Color4F(0, 0, 0, 0.5f));
+  bg->setPosition(hpPos);
+  hudRoot->addChild(bg, 0);
+
+  _hpBarFill = createRectSprite(_hpBarWidth, _hpBarHeight, Color4F::RED);
+  _hpBarFill->setAnchorPoint(Vec2(0, 0.5f));
+  _hpBarFill->setPosition(hpPos - Vec2(_hpBarWidth / 2, 0));
+  hudRoot->addChild(_hpBarFill, 1);
+
+  // 2. Boss Ѫ߿ + ɫ + 
+  _bossHpBar = Node::create();
+  _bossHpBar->setPosition(
+      Vec2(vs.width / 2 + origin.x, vs.height - 60 + origin.y));
+  _bossHpBar->setVisible(false);
+  hudRoot->addChild(_bossHpBar, 0);
+
+  _bossHpBar->addChild(createRectSprite(_bossHpBarWidth + 4,
+                                        _bossHpBarHeight + 4,
+                                        Color4F(0, 0, 0, 0.6f)),
+                       0);
+  _bossHpBar->addChild(createRectSprite(_bossHpBarWidth, _bossHpBarHeight,
+                                        Color4F(0.3f, 0, 0, 1.0f)),
+                       1);
+  _bossHpBarFill = createRectSprite(_bossHpBarWidth, _bossHpBarHeight,
+                                    Color4F(1.0f, 0.7f, 0.0f, 1.0f));
+  _bossHpBarFill->setAnchorPoint(Vec2(0, 0.5f));
+  _bossHpBarFill->setPosition(Vec2(-_bossHpBarWidth / 2, 0));
+  _bossHpBar->addChild(_bossHpBarFill, 2);
+
+  // 3. ı
   _hpLabel = Label::createWithSystemFont("100 / 100", "Arial", 16);
-  _hpLabel->setPosition(Vec2(vs.width / 2 + origin.x, 50 + origin.y));
+  _hpLabel->setPosition(hpPos);
   _hpLabel->setTextColor(Color4B::WHITE);
-  parent->addChild(_hpLabel, 1001);
-
-  updatePlayerHP(1.0f);
-
-  // 4. Boss Ѫ
-  _bossHpBarDrawNode = DrawNode::create();
-  _bossHpBarDrawNode->setPosition(
-      Vec2(vs.width / 2 + origin.x, vs.height - 60 + origin.y));
-  _bossHpBarDrawNode->setVisible(false);
-  parent->addChild(_bossHpBarDrawNode, 1000);
+  hudRoot->addChild(_hpLabel, 10);
 
   _bossNameLabel = Label::createWithSystemFont("BOSS", "Arial", 24);
   _bossNameLabel->setPosition(
       Vec2(vs.width / 2 + origin.x, vs.height - 35 + origin.y));
   _bossNameLabel->setTextColor(Color4B::YELLOW);
   _bossNameLabel->setVisible(false);
-  parent->addChild(_bossNameLabel, 1001);
+  hudRoot->addChild(_bossNameLabel, 10);
+
+  _hpShownPixels = -1;
+  _hpShownValue = 100;
+  _bossHpShownPixels = -1;
+  updatePlayerHP(1.0f);
 }
 
 void UIManager::updatePlayerHP(float percent) {
-  if (!_hpBarDrawNode) return;
+  if (!_hpBarFill) return;
 
-  _hpBarDrawNode->clear();
   percent = std::max(0.0f, std::min(1.0f, percent));
-  float currentWidth = _hpBarWidth * percent;
 
-  _hpBarDrawNode->drawSolidRect(
-      Vec2(-_hpBarWidth / 2, -_hpBarHeight / 2),
-      Vec2(-_hpBarWidth / 2 + currentWidth, _hpBarHeight / 2), Color4F::RED);
+  // ȰرȽϣδ仯ʱ޸Ľڵ㡣
+  int pixels = (int)(_hpBarWidth * percent + 0.5f);
+  if (pixels != _hpShownPixels) {
+    _hpShownPixels = pixels;
+    _hpBarFill->setScaleX(pixels / _hpBarWidth);
+  }
 
-  if (_hpLabel) {
+  // ıֻʾ仯ʱŰ档
+  int value = (int)(percent * 100);
+  if (_hpLabel && value != _hpShownValue) {
+    _hpShownValue = value;
     char buf[32];
-    sprintf(buf, "%d / 100", (int)(percent * 100));
+    snprintf(buf, sizeof(buf), "%d / 100", value);
     _hpLabel->setString(buf);
   }
 }
 
 void UIManager::updateBossHP(float percent) {
-  if (!_bossHpBarDrawNode) return;
+  if (!_bossHpBarFill) return;
 
-  _bossHpBarDrawNode->clear();
   percent = std::max(0.0f, std::min(1.0f, percent));
 
-  _bossHpBarDrawNode->drawSolidRect(
-      Vec2(-_bossHpBarWidth / 2 - 2, -_bossHpBarHeight / 2 - 2),
-      Vec2(_bossHpBarWidth / 2 + 2, _bossHpBarHeight / 2 + 2),
-      Color4F(0, 0, 0, 0.6f));
-
-  _bossHpBarDrawNode->drawSolidRect(
-      Vec2(-_bossHpBarWidth / 2, -_bossHpBarHeight / 2),
-      Vec2(_bossHpBarWidth / 2, _bossHpBarHeight / 2), Color4F(0.3f, 0, 0, 1.0f));
-
-  float currentWidth = _bossHpBarWidth * percent;
-  _bossHpBarDrawNode->drawSolidRect(
-      Vec2(-_bossHpBarWidth / 2, -_bossHpBarHeight / 2),
-      Vec2(-_bossHpBarWidth / 2 + currentWidth, _bossHpBarHeight / 2),
-      Color4F(1.0f, 0.7f, 0.0f, 1.0f));
+  int pixels = (int)(_bossHpBarWidth * percent + 0.5f);
+  if (pixels != _bossHpShownPixels) {
+    _bossHpShownPixels = pixels;
+    _bossHpBarFill->setScaleX(pixels / _bossHpBarWidth);
+  }
 
   if (percent > 0 && percent < 1.0f) {
     showBossHPBar(true);
@@ -182,7 +205,7 @@ void UIManager::updateBossHP(float percent) {
 }
 
 void UIManager::showBossHPBar(bool show) {
-  if (_bossHpBarDrawNode) _bossHpBarDrawNode->setVisible(show);
+  if (_bossHpBar) _bossHpBar->setVisible(show);
   if (_bossNameLabel) _bossNameLabel->setVisible(show);
 }
 
@@ -30,13 +30,15 @@ class UIManager {
   void showDeathMenu();
 
   // 在指定的父节点上显示 HUD（抬头显示）。
+  // HUD 为常驻节点：血条由共用白色纹理的精灵组成（合批为一次绘制），
+  // 数值变化时只调整填充条的缩放，文本只在显示的整数变化时重新排版。
   void showHUD(cocos2d::Node* parent);
 
-  // 更新玩家的血条。
+  // 更新玩家的血条，可每帧调用；显示结果不变时不做任何修改。
   // |percent| 是生命值百分比（0.0 到 1.0）。
   void updatePlayerHP(float percent);
 
-  // 更新 Boss 的血条。
+  // 更新 Boss 的血条，显示结果不变时不做任何修改。
   // |percent| 是生命值百分比（0.0 到 1.0）。
   void updateBossHP(float percent);
 
@@ -50,6 +52,11 @@ class UIManager {
   void showNotification(const std::string& text,
                         const cocos2d::Color3B& color = cocos2d::Color3B::WHITE);
 
+  // 创建纯色矩形精灵（共用引擎内置的白色纹理，便于合批），
+  // 也供加载界面等其他界面使用。
+  static cocos2d::Sprite* createRectSprite(float width, float height,
+                                           const cocos2d::Color4F& color);
+
  private:
   UIManager();
   ~UIManager();
@@ -73,15 +80,19 @@ class UIManager {
 
   static UIManager* _instance;
 
-  cocos2d::DrawNode* _hpBarDrawNode = nullptr;
+  cocos2d::Sprite* _hpBarFill = nullptr;   // 锚点在左端，按比例缩放 X。
   cocos2d::Label* _hpLabel = nullptr;
   float _hpBarWidth = 400.0f;
   float _hpBarHeight = 20.0f;
+  int _hpShownPixels = -1;  // 当前显示的填充宽度（像素），-1 表示未显示。
+  int _hpShownValue = -1;   // 当前文本显示的数值。
 
-  cocos2d::DrawNode* _bossHpBarDrawNode = nullptr;
+  cocos2d::Node* _bossHpBar = nullptr;  // 边框、底色与填充条的容器。
+  cocos2d::Sprite* _bossHpBarFill = nullptr;
   cocos2d::Label* _bossNameLabel = nullptr;
   float _bossHpBarWidth = 800.0f;
   float _bossHpBarHeight = 15.0f;
+  int _bossHpShownPixels = -1;
 };
 
 #endif  // __UI_MANAGER_H__
@@ -333,14 +333,19 @@ void Camera::unprojectGL(const Size& viewport, const Vec3* src, Vec3* dst) const
 
  bool Camera::isVisibleInFrustum(const AABB* aabb) const
  {
-     if (_frustumDirty)
-     {
-         _frustum.initFrustum(this);
-         _frustumDirty = false;
-     }
+     updateFrustum();
      return !_frustum.isOutOfFrustum(*aabb);
  }
 
+void Camera::updateFrustum() const
+{
+    if (_frustumDirty)
+    {
+        _frustum.initFrustum(this);
+        _frustumDirty = false;
+    }
+}
+
 float Camera::getDepthInView(const Mat4& transform) const
 {
     Mat4 camWorldMat = getNodeToWorldTransform();
@@ -204,6 +204,12 @@ public:
      * Is this aabb visible in frustum
      */
     bool isVisibleInFrustum(const AABB* aabb) const;
+
+    /**
+     * Rebuilds the frustum if the view or projection changed. isVisibleInFrustum does it on first use,
+     * call it first when several threads cull against this camera.
+     */
+    void updateFrustum() const;
     
     /**
      * Get object depth towards camera
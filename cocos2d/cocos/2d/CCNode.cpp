@@ -30,10 +30,12 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <regex>
 
 #include "base/CCDirector.h"
+#include "base/CCJobSystem.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
 #include "base/ccUTF8.h"
@@ -42,6 +44,7 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 
@@ -57,6 +60,8 @@ NS_CC_BEGIN
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
 int Node::__attachedNodeCount = 0;
+// command lists of the children visited in parallel, one per child, reused every frame
+static std::vector<std::unique_ptr<RenderCommandList>> s_parallelVisitCommandLists;
 
 // MARK: Constructor, Destructor, Init
 
@@ -95,6 +100,7 @@ Node::Node()
 , _userObject(nullptr)
 , _running(false)
 , _visible(true)
+, _parallelVisit(false)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
@@ -1236,17 +1242,16 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         {
             auto node = _children.at(i);
 
-            if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
-            else
+            if (!node || node->_localZOrder >= 0)
                 break;
         }
+        visitChildren(renderer, 0, i, flags);
+
         // self draw
         if (visibleByCamera)
             this->draw(renderer, _modelViewTransform, flags);
 
-        for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+        visitChildren(renderer, i, _children.size(), flags);
     }
     else if (visibleByCamera)
     {
@@ -1261,6 +1266,68 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildren(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t flags)
+{
+    // nodes visited on a worker thread visit their own children one by one
+    bool parallel = _director->isParallelVisitEnabled() && !renderer->isRecording();
+
+    ssize_t i = begin;
+    while (i < end)
+    {
+        ssize_t runEnd = i;
+        if (parallel)
+        {
+            while (runEnd < end && _children.at(runEnd)->_parallelVisit)
+                ++runEnd;
+        }
+
+        if (runEnd - i > 1)
+        {
+            visitChildrenInParallel(renderer, i, runEnd, flags);
+            i = runEnd;
+        }
+        else
+        {
+            _children.at(i)->visit(renderer, _modelViewTransform, flags);
+            ++i;
+        }
+    }
+}
+
+void Node::visitChildrenInParallel(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t flags)
+{
+    int count = static_cast<int>(end - begin);
+    while (static_cast<int>(s_parallelVisitCommandLists.size()) < count)
+    {
+        auto commandList = new (std::nothrow) RenderCommandList();
+        if (!commandList)
+        {
+            // out of memory, visit one by one
+            for (ssize_t i = begin; i < end; ++i)
+                _children.at(i)->visit(renderer, _modelViewTransform, flags);
+            return;
+        }
+        s_parallelVisitCommandLists.emplace_back(commandList);
+    }
+
+    // the camera builds its frustum on first use, build it before the workers cull against it
+    if (auto camera = Camera::getVisitingCamera())
+        camera->updateFrustum();
+
+    // every child records into its own list, so the commands keep the order of a serial visit
+    JobSystem::getInstance()->parallelFor(count, [this, renderer, begin, flags](int index) {
+        auto commandList = s_parallelVisitCommandLists[index].get();
+        _director->beginThreadMatrixStack(_modelViewTransform);
+        renderer->beginRecording(commandList);
+        _children.at(begin + index)->visit(renderer, _modelViewTransform, flags);
+        renderer->endRecording();
+        _director->endThreadMatrixStack();
+    });
+
+    for (int index = 0; index < count; ++index)
+        renderer->addCommands(*s_parallelVisitCommandLists[index]);
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1122,6 +1122,25 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the node and its children can be visited on a worker thread, at the same time as other nodes.
+     * When Director::isParallelVisitEnabled() is true, consecutive children marked with it are visited on the
+     * JobSystem, and their render commands are added in the same order as when visiting them one by one.
+     *
+     * Only mark nodes whose visit and draw change nothing outside their own subtree: no objects are created or
+     * autoreleased, no GL calls are made (labels updating their texture), no group commands are used
+     * (ClippingNode, RenderTexture) and no other nodes are modified.
+     *
+     * @param parallelVisit Whether the node can be visited in parallel.
+     */
+    void setParallelVisit(bool parallelVisit) { _parallelVisit = parallelVisit; }
+    /**
+     * Returns whether the node can be visited in parallel.
+     *
+     * @return Whether the node can be visited in parallel.
+     */
+    bool isParallelVisit() const { return _parallelVisit; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1793,6 +1812,10 @@ protected:
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    /// Visits the children in [begin, end), the ones marked with setParallelVisit() on the JobSystem.
+    void visitChildren(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t flags);
+    void visitChildrenInParallel(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t flags);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1897,6 +1920,8 @@ protected:
 
     bool _visible;                  ///< is this node visible
 
+    bool _parallelVisit;            ///< can be visited on a worker thread
+
     bool _ignoreAnchorPointForPosition; ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false otherwise.
                                           ///< Used by Layer and Scene.
 
@@ -29,10 +29,13 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "2d/CCCamera.h"
+#include "2d/CCLight.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCRenderer.h"
+#include "3d/CCSkeleton3D.h"
+#include "3d/CCSprite3D.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsWorld.h"
@@ -178,6 +181,17 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+    // work Sprite3D does on its first visit of a frame and that must stay on this thread:
+    // evaluating the deferred animations of all sprites and generating materials
+    if (director->isParallelVisitEnabled())
+    {
+        Sprite3D::updateLightingMaterials();
+        Skeleton3D::evaluatePending();
+        // meshes read the light transforms, compute the cached ones before the workers do
+        for (const auto light : _lights)
+            light->getNodeToWorldTransform();
+    }
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -11,6 +11,7 @@ CCRay.cpp \
 CCAABB.cpp \
 CCOBB.cpp \
 CCAnimate3D.cpp \
+CCAnimator3D.cpp \
 CCAnimation3D.cpp \
 CCAttachNode.cpp \
 CCBillBoard.cpp \
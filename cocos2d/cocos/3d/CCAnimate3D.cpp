@@ -31,12 +31,14 @@
 #include "base/CCEventCustom.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeInAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeOutAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_runningAnimates;
+bool       Animate3D::s_parallelEvaluation = true;
 float      Animate3D::_transTime = 0.1f;
 
 //create Animate3D using Animation.
@@ -147,7 +149,14 @@ Node* findChildByNameRecursively(Node* node, const std::string &childName)
 //! called before the action start. It will also set the target.
 void Animate3D::startWithTarget(Node *target)
 {
-    bool needReMap = (_target != target);
+    Sprite3D* sprite = dynamic_cast<Sprite3D*>(target);
+    Skeleton3D* skeleton = sprite ? sprite->getSkeleton() : nullptr;
+    
+    // A stopped Animate3D restarted on the same sprite keeps its bone curve binding, the mapped
+    // skeleton is retained so the bone pointers in _boneCurves stay valid. Node curves point to
+    // child nodes that may be gone by then, those are always bound again.
+    bool keepMapping = skeleton && target == _mappedTarget && skeleton == _mappedSkeleton && _nodeCurves.empty();
+    bool needReMap = (_target != target) && !keepMapping;
     ActionInterval::startWithTarget(target);
     
     if (needReMap)
@@ -155,8 +164,12 @@ void Animate3D::startWithTarget(Node *target)
         _boneCurves.clear();
         _nodeCurves.clear();
         
+        CC_SAFE_RETAIN(skeleton);
+        CC_SAFE_RELEASE(_mappedSkeleton);
+        _mappedSkeleton = skeleton;
+        _mappedTarget = target;
+        
         bool hasCurve = false;
-        Sprite3D* sprite = dynamic_cast<Sprite3D*>(target);
         
         if(sprite)
         {
@@ -274,6 +287,7 @@ void Animate3D::startWithTarget(Node *target)
 void Animate3D::stop()
 {
     removeFromMap();
+    Skeleton3D::cancelEvaluation(this);
     
     ActionInterval::stop();
 }
@@ -335,7 +349,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float* trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse){
                     t = 1 - t;
                     lastTime = 1.0f - lastTime;
@@ -344,25 +357,18 @@ void Animate3D::update(float t)
                 t = _start + t * _last;
                 lastTime = _start + lastTime * _last;
                 
-                for (const auto& it : _boneCurves) {
-                    auto bone = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
+                if (!_boneCurves.empty())
+                {
+                    if (s_parallelEvaluation)
                     {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
+                        // bones are only written by Skeleton3D::evaluatePending, once per frame
+                        _evaluateTime = t;
+                        Skeleton3D::queueEvaluation(static_cast<Sprite3D*>(_target)->getSkeleton(), this);
                     }
-                    if (curve->scaleCurve)
+                    else
                     {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
+                        evaluateBoneCurves(t);
                     }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
                 }
                 
                 for (const auto& it : _nodeCurves)
@@ -485,6 +491,44 @@ void Animate3D::setKeyFrameUserInfo(int keyFrame, const ValueMap &userInfo)
     _keyFrameUserInfos[keyFrame] = userInfo;
 }
 
+void Animate3D::evaluateBoneCurves(float t)
+{
+    float transDst[3], rotDst[4], scaleDst[3];
+    float* trans = nullptr, *rot = nullptr, *scale = nullptr;
+    for (const auto& it : _boneCurves) {
+        auto bone = it.first;
+        auto curve = it.second;
+        if (curve->translateCurve)
+        {
+            curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
+            trans = &transDst[0];
+        }
+        if (curve->rotCurve)
+        {
+            curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
+            rot = &rotDst[0];
+        }
+        if (curve->scaleCurve)
+        {
+            curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
+            scale = &scaleDst[0];
+        }
+        bone->setAnimationValue(trans, rot, scale, this, _weight);
+    }
+}
+
+void Animate3D::setParallelEvaluation(bool enabled)
+{
+    if (!enabled)
+        Skeleton3D::evaluatePending();
+    s_parallelEvaluation = enabled;
+}
+
+void Animate3D::evaluateBones()
+{
+    evaluateBoneCurves(_evaluateTime);
+}
+
 Animate3D::Animate3D()
 : _state(Animate3D::Animate3DState::Running)
 , _animation(nullptr)
@@ -497,12 +541,16 @@ Animate3D::Animate3D()
 , _lastTime(0.0f)
 , _originInterval(0.0f)
 , _frameRate(30.0f)
+, _evaluateTime(0.0f)
+, _mappedTarget(nullptr)
+, _mappedSkeleton(nullptr)
 {
     setQuality(Animate3DQuality::QUALITY_HIGH);
 }
 Animate3D::~Animate3D()
 {
     removeFromMap();
+    Skeleton3D::cancelEvaluation(this);
     
     for (auto& it : _keyFrameEvent) {
         delete it.second;
@@ -510,6 +558,7 @@ Animate3D::~Animate3D()
     _keyFrameEvent.clear();
     
     CC_SAFE_RELEASE(_animation);
+    CC_SAFE_RELEASE(_mappedSkeleton);
 }
 
 void Animate3D::removeFromMap()
@@ -28,15 +28,16 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "3d/CCAnimation3D.h"
+#include "3d/CCSkeleton3D.h"
 #include "base/ccMacros.h"
 #include "base/CCRef.h"
 #include "2d/CCActionInterval.h"
 
 NS_CC_BEGIN
 
-class Bone3D;
 class Sprite3D;
 class EventCustom;
 
@@ -55,7 +56,7 @@ enum class Animate3DQuality
 /**
  * @brief Animate3D, Animates a Sprite3D given with an Animation3D
  */
-class CC_DLL Animate3D: public ActionInterval
+class CC_DLL Animate3D: public ActionInterval, public BoneAnimationSource
 {
 public:
     
@@ -115,6 +116,18 @@ public:
     
     /**get animate quality*/
     Animate3DQuality getQuality() const;
+    
+    /**
+     * Enable or disable deferred bone evaluation (enabled by default).
+     * When enabled, update() only records the sample time and queues the action on its skeleton;
+     * the bone curves are evaluated by Skeleton3D::evaluatePending(), in parallel across skeletons
+     * on the JobSystem, together with the bone world matrices of those skeletons.
+     */
+    static void setParallelEvaluation(bool enabled);
+    static bool isParallelEvaluation() { return s_parallelEvaluation; }
+    
+    /**evaluate the bone curves at the time recorded by the last update()*/
+    virtual void evaluateBones() override;
 
 
     struct Animate3DDisplayedEventInfo
@@ -169,6 +182,14 @@ protected:
     EvaluateType _scaleEvaluate;
     Animate3DQuality _quality;
     
+    /** evaluate the bone curves at time t (already mapped to [_start, _start + _last]) and apply them */
+    void evaluateBoneCurves(float t);
+    
+    float      _evaluateTime;    // bone curve time recorded by update() for deferred evaluation
+    
+    Node*       _mappedTarget;   // target the curves were bound to, weak ref
+    Skeleton3D* _mappedSkeleton; // skeleton of _mappedTarget, retained
+    
     std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves; //weak ref
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
     
@@ -180,6 +201,8 @@ protected:
     static std::unordered_map<Node*, Animate3D*> s_fadeInAnimates;
     static std::unordered_map<Node*, Animate3D*> s_fadeOutAnimates;
     static std::unordered_map<Node*, Animate3D*> s_runningAnimates;
+    
+    static bool s_parallelEvaluation; //deferred bone evaluation
 };
 
 // end of 3d group
@@ -0,0 +1,520 @@
+/****************************************************************************
+ Copyright (c) 2014-2016 Chukong Technologies Inc.
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/CCAnimator3D.h"
+#include "3d/CCSprite3D.h"
+#include <algorithm>
+#include <cmath>
+
+NS_CC_BEGIN
+
+const std::string Animator3D::COMPONENT_NAME = "Animator3D";
+
+// normalized lerp along the shorter arc
+static void nlerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst)
+{
+    float t2 = (q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w) < 0.0f ? -t : t;
+    float t1 = 1.0f - t;
+    dst->set(q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2, q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2);
+    dst->normalize();
+}
+
+// normalized time of a slot, the curves are keyed in [0, 1]
+static float sampleTime(Animation3D* animation, float time)
+{
+    float duration = animation->getDuration();
+    if (duration <= 0.0f)
+        return 0.0f;
+    return std::min(std::max(time / duration, 0.0f), 1.0f);
+}
+
+Animator3D* Animator3D::create()
+{
+    auto animator = new (std::nothrow) Animator3D();
+    if (animator && animator->init())
+    {
+        animator->autorelease();
+        return animator;
+    }
+    CC_SAFE_DELETE(animator);
+    return nullptr;
+}
+
+Animator3D::Animator3D()
+: _skeleton(nullptr)
+, _poseDirty(false)
+{
+    for (auto& layer : _layers)
+    {
+        layer.slotCount = 0;
+        layer.weight = 1.0f;
+        layer.mode = BlendMode::OVERRIDE;
+    }
+}
+
+Animator3D::~Animator3D()
+{
+    bindSkeleton(nullptr);
+}
+
+bool Animator3D::init()
+{
+    if (!Component::init())
+        return false;
+    
+    setName(COMPONENT_NAME);
+    return true;
+}
+
+void Animator3D::onAdd()
+{
+    Component::onAdd();
+    
+    auto sprite = dynamic_cast<Sprite3D*>(_owner);
+    bindSkeleton(sprite ? sprite->getSkeleton() : nullptr);
+    if (!_skeleton)
+        CCLOG("warning: Animator3D added to a node without skeleton");
+}
+
+void Animator3D::onRemove()
+{
+    bindSkeleton(nullptr);
+    
+    Component::onRemove();
+}
+
+void Animator3D::bindSkeleton(Skeleton3D* skeleton)
+{
+    if (skeleton == _skeleton)
+        return;
+    
+    Skeleton3D::cancelEvaluation(this);
+    
+    // slots point into the bindings of the old skeleton
+    for (auto& layer : _layers)
+        layer.slotCount = 0;
+    for (auto& it : _bindings)
+        it.first->release();
+    _bindings.clear();
+    
+    CC_SAFE_RETAIN(skeleton);
+    CC_SAFE_RELEASE(_skeleton);
+    _skeleton = skeleton;
+    
+    size_t boneCount = _skeleton ? static_cast<size_t>(_skeleton->getBoneCount()) : 0;
+    _pose.resize(boneCount);
+    _layerPose.resize(boneCount);
+}
+
+const Animator3D::ClipBinding* Animator3D::getBinding(Animation3D* animation)
+{
+    auto it = _bindings.find(animation);
+    if (it != _bindings.end())
+        return &it->second;
+    
+    animation->retain();
+    ClipBinding& binding = _bindings[animation];
+    float dst[4];
+    for (int i = 0, count = static_cast<int>(_skeleton->getBoneCount()); i < count; ++i)
+    {
+        auto curve = animation->getBoneCurveByName(_skeleton->getBoneByIndex(i)->getName());
+        if (!curve)
+            continue;
+        
+        BoneBinding bone;
+        bone.boneIndex = i;
+        bone.curve = curve;
+        bone.refTranslate = Vec3::ZERO;
+        bone.refRot = Quaternion::identity();
+        bone.refScale = Vec3::ONE;
+        if (curve->translateCurve)
+        {
+            curve->translateCurve->evaluate(0.0f, dst, EvaluateType::INT_NEAR);
+            bone.refTranslate.set(dst);
+        }
+        if (curve->rotCurve)
+        {
+            curve->rotCurve->evaluate(0.0f, dst, EvaluateType::INT_NEAR);
+            bone.refRot.set(dst);
+        }
+        if (curve->scaleCurve)
+        {
+            curve->scaleCurve->evaluate(0.0f, dst, EvaluateType::INT_NEAR);
+            bone.refScale.set(dst);
+        }
+        binding.push_back(bone);
+    }
+    return &binding;
+}
+
+void Animator3D::play(Animation3D* animation, bool loop, float fadeTime, int layer, float speed)
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    if (!animation || !_skeleton)
+        return;
+    
+    auto& l = _layers[layer];
+    speed = std::max(speed, 0.0f);
+    _poseDirty = true;
+    
+    if (l.slotCount > 0)
+    {
+        auto& current = l.slots[l.slotCount - 1];
+        if (current.animation == animation && current.loop && loop)
+        {
+            current.speed = speed;
+            current.fadeSpeed = fadeTime > 0.0f ? (1.0f - current.weight) / fadeTime : 0.0f;
+            if (fadeTime <= 0.0f)
+                current.weight = 1.0f;
+            return;
+        }
+    }
+    
+    if (fadeTime > 0.0f)
+    {
+        fadeOutSlots(l, fadeTime);
+        
+        // keep the blend bounded, drop the slot that contributes least
+        if (l.slotCount == MAX_SLOTS)
+        {
+            int weakest = 0;
+            for (int i = 1; i < l.slotCount; ++i)
+            {
+                if (l.slots[i].weight < l.slots[weakest].weight)
+                    weakest = i;
+            }
+            removeSlot(l, weakest);
+        }
+    }
+    else
+    {
+        l.slotCount = 0;
+    }
+    
+    auto& slot = l.slots[l.slotCount++];
+    slot.animation = animation;
+    slot.binding = getBinding(animation);
+    slot.time = 0.0f;
+    slot.speed = speed;
+    slot.loop = loop;
+    slot.weight = fadeTime > 0.0f ? 0.0f : 1.0f;
+    slot.fadeSpeed = fadeTime > 0.0f ? 1.0f / fadeTime : 0.0f;
+}
+
+void Animator3D::stop(int layer, float fadeTime)
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    auto& l = _layers[layer];
+    _poseDirty = true;
+    if (fadeTime <= 0.0f)
+        l.slotCount = 0;
+    else
+        fadeOutSlots(l, fadeTime);
+}
+
+void Animator3D::fadeOutSlots(Layer& layer, float fadeTime)
+{
+    for (int i = layer.slotCount - 1; i >= 0; --i)
+    {
+        if (layer.slots[i].weight <= 0.0f)
+            removeSlot(layer, i);
+        else
+            layer.slots[i].fadeSpeed = -layer.slots[i].weight / fadeTime;
+    }
+}
+
+void Animator3D::removeSlot(Layer& layer, int index)
+{
+    for (int i = index + 1; i < layer.slotCount; ++i)
+        layer.slots[i - 1] = layer.slots[i];
+    --layer.slotCount;
+}
+
+void Animator3D::setLayerWeight(int layer, float weight)
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    _layers[layer].weight = std::min(std::max(weight, 0.0f), 1.0f);
+    _poseDirty = true;
+}
+
+float Animator3D::getLayerWeight(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    return _layers[layer].weight;
+}
+
+void Animator3D::setLayerBlendMode(int layer, BlendMode mode)
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    _layers[layer].mode = mode;
+    _poseDirty = true;
+}
+
+Animator3D::BlendMode Animator3D::getLayerBlendMode(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    return _layers[layer].mode;
+}
+
+void Animator3D::setSpeed(int layer, float speed)
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    auto& l = _layers[layer];
+    if (l.slotCount > 0)
+        l.slots[l.slotCount - 1].speed = std::max(speed, 0.0f);
+}
+
+float Animator3D::getSpeed(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    auto& l = _layers[layer];
+    return l.slotCount > 0 ? l.slots[l.slotCount - 1].speed : 0.0f;
+}
+
+Animation3D* Animator3D::getCurrentAnimation(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    auto& l = _layers[layer];
+    if (l.slotCount == 0 || l.slots[l.slotCount - 1].fadeSpeed < 0.0f)
+        return nullptr;
+    return l.slots[l.slotCount - 1].animation;
+}
+
+float Animator3D::getCurrentTime(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < MAX_LAYERS, "invalid layer");
+    auto& l = _layers[layer];
+    return l.slotCount > 0 ? l.slots[l.slotCount - 1].time : 0.0f;
+}
+
+bool Animator3D::isPlaying(int layer) const
+{
+    auto animation = getCurrentAnimation(layer);
+    if (!animation)
+        return false;
+    auto& current = _layers[layer].slots[_layers[layer].slotCount - 1];
+    return current.loop || current.time < animation->getDuration();
+}
+
+void Animator3D::update(float delta)
+{
+    if (!_skeleton)
+        return;
+    
+    bool changed = _poseDirty;
+    bool active = false;
+    for (auto& layer : _layers)
+    {
+        // backwards, removeSlot only shifts the slots already updated
+        for (int i = layer.slotCount - 1; i >= 0; --i)
+        {
+            auto& slot = layer.slots[i];
+            if (slot.fadeSpeed != 0.0f)
+            {
+                slot.weight += slot.fadeSpeed * delta;
+                if (slot.weight <= 0.0f && slot.fadeSpeed < 0.0f)
+                {
+                    removeSlot(layer, i);
+                    changed = true;
+                    continue;
+                }
+                if (slot.weight >= 1.0f)
+                {
+                    slot.weight = 1.0f;
+                    slot.fadeSpeed = 0.0f;
+                }
+                changed = true;
+            }
+            
+            float duration = slot.animation->getDuration();
+            if (slot.speed > 0.0f && duration > 0.0f && (slot.loop || slot.time < duration))
+            {
+                slot.time += delta * slot.speed;
+                if (slot.loop)
+                    slot.time = std::fmod(slot.time, duration);
+                else if (slot.time > duration)
+                    slot.time = duration;
+                changed = true;
+            }
+        }
+        active = active || layer.slotCount > 0;
+    }
+    
+    // a finished clip holds its pose, the bones keep it without being written again
+    if (changed && active)
+        Skeleton3D::queueEvaluation(_skeleton, this);
+    _poseDirty = false;
+}
+
+void Animator3D::sampleLayer(const Layer& layer)
+{
+    for (auto& pose : _layerPose)
+    {
+        pose.translate.setZero();
+        pose.rot.set(0.0f, 0.0f, 0.0f, 0.0f);
+        pose.scale.setZero();
+        pose.weight = 0.0f;
+    }
+    
+    float trans[3], rot[4], scale[3];
+    for (int i = 0; i < layer.slotCount; ++i)
+    {
+        const auto& slot = layer.slots[i];
+        if (slot.weight <= 0.0f)
+            continue;
+        
+        float t = sampleTime(slot.animation, slot.time);
+        float weight = slot.weight;
+        for (const auto& bone : *slot.binding)
+        {
+            auto& pose = _layerPose[bone.boneIndex];
+            auto curve = bone.curve;
+            
+            // channels without a curve take the defaults, as Bone3D::setAnimationValue does
+            trans[0] = trans[1] = trans[2] = 0.0f;
+            rot[0] = rot[1] = rot[2] = 0.0f; rot[3] = 1.0f;
+            scale[0] = scale[1] = scale[2] = 1.0f;
+            if (curve->translateCurve)
+                curve->translateCurve->evaluate(t, trans, EvaluateType::INT_LINEAR);
+            if (curve->rotCurve)
+                curve->rotCurve->evaluate(t, rot, EvaluateType::INT_QUAT_SLERP);
+            if (curve->scaleCurve)
+                curve->scaleCurve->evaluate(t, scale, EvaluateType::INT_LINEAR);
+            
+            pose.translate.add(trans[0] * weight, trans[1] * weight, trans[2] * weight);
+            pose.scale.add(scale[0] * weight, scale[1] * weight, scale[2] * weight);
+            
+            auto& q = pose.rot;
+            float rotWeight = (q.x * rot[0] + q.y * rot[1] + q.z * rot[2] + q.w * rot[3]) < 0.0f ? -weight : weight;
+            q.set(q.x + rot[0] * rotWeight, q.y + rot[1] * rotWeight, q.z + rot[2] * rotWeight, q.w + rot[3] * rotWeight);
+            
+            pose.weight += weight;
+        }
+    }
+}
+
+void Animator3D::addLayer(const Layer& layer)
+{
+    float dst[4];
+    for (int i = 0; i < layer.slotCount; ++i)
+    {
+        const auto& slot = layer.slots[i];
+        float weight = slot.weight * layer.weight;
+        if (weight <= 0.0f)
+            continue;
+        
+        float t = sampleTime(slot.animation, slot.time);
+        for (const auto& bone : *slot.binding)
+        {
+            auto& pose = _pose[bone.boneIndex];
+            if (pose.weight <= 0.0f)
+                continue; // nothing below to add onto
+            
+            auto curve = bone.curve;
+            if (curve->translateCurve)
+            {
+                curve->translateCurve->evaluate(t, dst, EvaluateType::INT_LINEAR);
+                pose.translate.add((dst[0] - bone.refTranslate.x) * weight,
+                                   (dst[1] - bone.refTranslate.y) * weight,
+                                   (dst[2] - bone.refTranslate.z) * weight);
+            }
+            if (curve->rotCurve)
+            {
+                curve->rotCurve->evaluate(t, dst, EvaluateType::INT_QUAT_SLERP);
+                Quaternion delta = bone.refRot.getInversed() * Quaternion(dst[0], dst[1], dst[2], dst[3]);
+                nlerp(Quaternion::identity(), delta, weight, &delta);
+                pose.rot *= delta;
+            }
+            if (curve->scaleCurve)
+            {
+                curve->scaleCurve->evaluate(t, dst, EvaluateType::INT_LINEAR);
+                const auto& ref = bone.refScale;
+                pose.scale.x *= 1.0f + (ref.x != 0.0f ? dst[0] / ref.x - 1.0f : 0.0f) * weight;
+                pose.scale.y *= 1.0f + (ref.y != 0.0f ? dst[1] / ref.y - 1.0f : 0.0f) * weight;
+                pose.scale.z *= 1.0f + (ref.z != 0.0f ? dst[2] / ref.z - 1.0f : 0.0f) * weight;
+            }
+        }
+    }
+}
+
+void Animator3D::evaluateBones()
+{
+    if (!_skeleton)
+        return;
+    
+    for (auto& pose : _pose)
+        pose.weight = 0.0f;
+    
+    for (int i = 0; i < MAX_LAYERS; ++i)
+    {
+        const auto& layer = _layers[i];
+        if (layer.slotCount == 0 || layer.weight <= 0.0f)
+            continue;
+        
+        if (i > 0 && layer.mode == BlendMode::ADDITIVE)
+        {
+            addLayer(layer);
+            continue;
+        }
+        
+        sampleLayer(layer);
+        for (size_t bone = 0, count = _pose.size(); bone < count; ++bone)
+        {
+            auto& src = _layerPose[bone];
+            if (src.weight <= 0.0f)
+                continue;
+            
+            float invWeight = 1.0f / src.weight;
+            src.translate *= invWeight;
+            src.scale *= invWeight;
+            src.rot.normalize();
+            
+            auto& dst = _pose[bone];
+            if (dst.weight <= 0.0f)
+            {
+                // first layer touching the bone, nothing to blend with
+                dst.translate = src.translate;
+                dst.rot = src.rot;
+                dst.scale = src.scale;
+                dst.weight = 1.0f;
+                continue;
+            }
+            
+            float alpha = std::min(src.weight, 1.0f) * layer.weight;
+            dst.translate += (src.translate - dst.translate) * alpha;
+            dst.scale += (src.scale - dst.scale) * alpha;
+            nlerp(dst.rot, src.rot, alpha, &dst.rot);
+        }
+    }
+    
+    for (size_t bone = 0, count = _pose.size(); bone < count; ++bone)
+    {
+        auto& pose = _pose[bone];
+        if (pose.weight > 0.0f)
+            _skeleton->getBoneByIndex(static_cast<unsigned int>(bone))->setAnimationValue(&pose.translate.x, &pose.rot.x, &pose.scale.x, this, 1.0f);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2014-2016 Chukong Technologies Inc.
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCANIMATOR3D_H__
+#define __CCANIMATOR3D_H__
+
+#include <unordered_map>
+#include <vector>
+
+#include "2d/CCComponent.h"
+#include "3d/CCAnimation3D.h"
+#include "3d/CCSkeleton3D.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * @brief Animator3D, plays Animation3Ds on the skeleton of its owner Sprite3D with layered blending.
+ *
+ * Each layer holds a fixed number of blend slots. play() crossfades from whatever the layer is
+ * playing into the new clip; when all slots are taken the weakest one is dropped, so the cost of a
+ * layer never exceeds MAX_SLOTS clips. Layers are combined bottom up: an OVERRIDE layer blends
+ * towards its pose by the layer weight, an ADDITIVE layer adds the difference between its clips and
+ * their first frame. All layers are evaluated in a single pass through Skeleton3D::evaluatePending().
+ *
+ * Unlike Animate3D no action object is created per play(): the bone bindings of a clip are resolved
+ * once and kept for the lifetime of the component. Bones keep their last pose while nothing plays.
+ */
+class CC_DLL Animator3D : public Component, public BoneAnimationSource
+{
+public:
+    enum class BlendMode
+    {
+        OVERRIDE,
+        ADDITIVE,
+    };
+    
+    static const int MAX_LAYERS = 4;
+    static const int MAX_SLOTS = 4;
+    
+    /**name of the component, use it with Node::getComponent()*/
+    static const std::string COMPONENT_NAME;
+    
+    static Animator3D* create();
+    
+    /**
+     * crossfade the layer into an animation
+     * @param animation clip to play, its bones are bound to the owner skeleton the first time it is played
+     * @param loop repeat the clip, otherwise the last frame is held once it ends
+     * @param fadeTime crossfade duration in seconds, 0 switches immediately
+     * @param layer layer index, [0, MAX_LAYERS)
+     * @param speed playing speed, must not be negative
+     *
+     * Playing the looped clip the layer is already playing keeps its time and only cancels the fade out.
+     */
+    void play(Animation3D* animation, bool loop = true, float fadeTime = 0.2f, int layer = 0, float speed = 1.0f);
+    
+    /**fade out everything on the layer*/
+    void stop(int layer = 0, float fadeTime = 0.2f);
+    
+    /**get & set layer weight, [0, 1]*/
+    void setLayerWeight(int layer, float weight);
+    float getLayerWeight(int layer) const;
+    
+    /**get & set layer blend mode, layer 0 is always blended as OVERRIDE*/
+    void setLayerBlendMode(int layer, BlendMode mode);
+    BlendMode getLayerBlendMode(int layer) const;
+    
+    /**get & set the speed of the clip the layer is playing*/
+    void setSpeed(int layer, float speed);
+    float getSpeed(int layer) const;
+    
+    /**clip the layer is playing, nullptr if stopped*/
+    Animation3D* getCurrentAnimation(int layer) const;
+    
+    /**seconds since the current clip of the layer started, wraps for looped clips*/
+    float getCurrentTime(int layer) const;
+    
+    /**is the layer playing a looped clip, or a clip which has not reached its end*/
+    bool isPlaying(int layer) const;
+    
+    //
+    // Overrides
+    //
+    virtual void update(float delta) override;
+    virtual void onAdd() override;
+    virtual void onRemove() override;
+    virtual void evaluateBones() override;
+    
+CC_CONSTRUCTOR_ACCESS:
+    Animator3D();
+    virtual ~Animator3D();
+    
+    virtual bool init() override;
+    
+protected:
+    /**curve of one bone and its pose on the first frame, the reference of additive blending*/
+    struct BoneBinding
+    {
+        int                 boneIndex;
+        Animation3D::Curve* curve;
+        Vec3                refTranslate;
+        Quaternion          refRot;
+        Vec3                refScale;
+    };
+    typedef std::vector<BoneBinding> ClipBinding;
+    
+    struct Slot
+    {
+        Animation3D*       animation; // weak ref, retained by _bindings
+        const ClipBinding* binding;
+        float              time;
+        float              speed;
+        float              weight;
+        float              fadeSpeed;  // weight change per second, negative when fading out
+        bool               loop;
+    };
+    
+    struct Layer
+    {
+        Slot      slots[MAX_SLOTS]; // oldest first, the last one is the current clip
+        int       slotCount;
+        float     weight;
+        BlendMode mode;
+    };
+    
+    /**blended local transform of a bone, weight is 0 if no layer touched it*/
+    struct BonePose
+    {
+        Vec3       translate;
+        Quaternion rot;
+        Vec3       scale;
+        float      weight;
+    };
+    
+    /**bind the skeleton of the owner, drops the bindings of the previous one*/
+    void bindSkeleton(Skeleton3D* skeleton);
+    const ClipBinding* getBinding(Animation3D* animation);
+    
+    /**blend the slots of an OVERRIDE layer into _layerPose, per bone*/
+    void sampleLayer(const Layer& layer);
+    /**add the slots of an ADDITIVE layer onto _pose*/
+    void addLayer(const Layer& layer);
+    
+    /**fade every slot of the layer to 0 in fadeTime seconds, slots already at 0 are removed*/
+    void fadeOutSlots(Layer& layer, float fadeTime);
+    void removeSlot(Layer& layer, int index);
+    
+    Layer       _layers[MAX_LAYERS];
+    Skeleton3D* _skeleton;   // skeleton of the owner, retained
+    bool        _poseDirty;  // evaluate on the next update even if no clip moved
+    
+    std::unordered_map<Animation3D*, ClipBinding> _bindings; // key retained
+    std::vector<BonePose> _pose;      // per bone, result of all layers
+    std::vector<BonePose> _layerPose; // per bone, scratch of the layer being blended
+};
+
+// end of 3d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCANIMATOR3D_H__
@@ -26,6 +26,7 @@
 #include "3d/CCMeshSkin.h"
 #include "3d/CCBundle3D.h"
 #include "3d/CCSkeleton3D.h"
+#include "math/MathUtil.h"
 
 NS_CC_BEGIN
 
@@ -101,14 +102,18 @@ int MeshSkin::getBoneIndex(Bone3D* bone) const
 Vec4* MeshSkin::getMatrixPalette()
 {
     _matrixPalette.resize(_skinBones.size() * PALETTE_ROWS);
-    int i = 0, paletteIndex = 0;
-    static Mat4 t;
-    for (auto it : _skinBones )
+    // Each bone writes its 3 rows straight into the palette, no shared scratch matrix,
+    // so palettes of different skins can be computed concurrently.
+    float* palette = reinterpret_cast<float*>(_matrixPalette.data());
+    for (ssize_t i = 0, size = _skinBones.size(); i < size; ++i, palette += PALETTE_ROWS * 4)
     {
-        Mat4::multiply(it->getWorldMat(), _invBindPoses[i++], &t);
-        _matrixPalette[paletteIndex++].set(t.m[0], t.m[4], t.m[8], t.m[12]);
-        _matrixPalette[paletteIndex++].set(t.m[1], t.m[5], t.m[9], t.m[13]);
-        _matrixPalette[paletteIndex++].set(t.m[2], t.m[6], t.m[10], t.m[14]);
+        const Mat4& world = _skinBones.at(i)->getWorldMat();
+        const Mat4& invBindPose = _invBindPoses[i];
+#ifdef __SSE__
+        MathUtil::multiplyMatrixPalette(world.col, invBindPose.col, palette);
+#else
+        MathUtil::multiplyMatrixPalette(world.m, invBindPose.m, palette);
+#endif
     }
     
     return _matrixPalette.data();
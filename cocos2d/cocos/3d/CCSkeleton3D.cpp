@@ -24,6 +24,10 @@
  ****************************************************************************/
 
 #include "3d/CCSkeleton3D.h"
+#include "base/CCDirector.h"
+#include "base/CCJobSystem.h"
+#include <algorithm>
+#include <climits>
 
 
 NS_CC_BEGIN
@@ -246,7 +250,11 @@ void Bone3D::updateLocalMat()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+std::vector<Skeleton3D::PendingEvaluation> Skeleton3D::s_pendingEvaluations;
+std::vector<int> Skeleton3D::s_pendingGroups;
+
 Skeleton3D::Skeleton3D()
+: _updatedFrame(UINT_MAX)
 {
     
 }
@@ -321,6 +329,79 @@ void Skeleton3D::updateBoneMatrix()
     }
 }
 
+void Skeleton3D::updateBoneMatrix(unsigned int frame)
+{
+    if (_updatedFrame == frame)
+        return;
+    
+    updateBoneMatrix();
+    _updatedFrame = frame;
+}
+
+void Skeleton3D::queueEvaluation(Skeleton3D* skeleton, BoneAnimationSource* source)
+{
+    if (source->_evaluationQueued)
+        return;
+    
+    skeleton->retain();
+    s_pendingEvaluations.push_back({skeleton, source});
+    source->_evaluationQueued = true;
+}
+
+void Skeleton3D::cancelEvaluation(BoneAnimationSource* source)
+{
+    if (!source->_evaluationQueued)
+        return;
+    
+    for (auto it = s_pendingEvaluations.begin(); it != s_pendingEvaluations.end(); ++it)
+    {
+        if (it->source == source)
+        {
+            it->skeleton->release();
+            s_pendingEvaluations.erase(it);
+            break;
+        }
+    }
+    source->_evaluationQueued = false;
+}
+
+void Skeleton3D::evaluatePending()
+{
+    if (s_pendingEvaluations.empty())
+        return;
+    
+    // sources sharing a skeleton write the same bones, evaluate them in the same job
+    std::stable_sort(s_pendingEvaluations.begin(), s_pendingEvaluations.end(), [](const PendingEvaluation& a, const PendingEvaluation& b) {
+        return a.skeleton < b.skeleton;
+    });
+    s_pendingGroups.clear();
+    for (int i = 0, size = static_cast<int>(s_pendingEvaluations.size()); i < size; ++i)
+    {
+        if (i == 0 || s_pendingEvaluations[i].skeleton != s_pendingEvaluations[i - 1].skeleton)
+            s_pendingGroups.push_back(i);
+    }
+    s_pendingGroups.push_back(static_cast<int>(s_pendingEvaluations.size()));
+    
+    const unsigned int frame = Director::getInstance()->getTotalFrames();
+    JobSystem::getInstance()->parallelFor(static_cast<int>(s_pendingGroups.size()) - 1, [frame](int group) {
+        Skeleton3D* skeleton = nullptr;
+        for (int i = s_pendingGroups[group], end = s_pendingGroups[group + 1]; i < end; ++i)
+        {
+            auto& pending = s_pendingEvaluations[i];
+            pending.source->evaluateBones();
+            skeleton = pending.skeleton;
+        }
+        skeleton->updateBoneMatrix(frame);
+    });
+    
+    for (auto& pending : s_pendingEvaluations)
+    {
+        pending.source->_evaluationQueued = false;
+        pending.skeleton->release();
+    }
+    s_pendingEvaluations.clear();
+}
+
 void Skeleton3D::removeAllBones()
 {
     _bones.clear();
@@ -29,6 +29,7 @@
 #include "3d/CCBundle3DData.h"
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include <vector>
 
 
 NS_CC_BEGIN
@@ -183,6 +184,29 @@ protected:
     
 };
 
+/**
+ * @brief Something that writes sampled animation values into the bones of a skeleton.
+ *
+ * Sources are queued with Skeleton3D::queueEvaluation() and evaluated by
+ * Skeleton3D::evaluatePending(), possibly on a worker thread.
+ */
+class CC_DLL BoneAnimationSource
+{
+    friend class Skeleton3D;
+public:
+    BoneAnimationSource() : _evaluationQueued(false) {}
+    virtual ~BoneAnimationSource() {}
+    
+    /**sample the animation and apply it with Bone3D::setAnimationValue, only the bones of the queued skeleton may be touched*/
+    virtual void evaluateBones() = 0;
+    
+    /**is the source waiting in the pending evaluation list*/
+    bool isEvaluationQueued() const { return _evaluationQueued; }
+    
+protected:
+    bool _evaluationQueued;
+};
+
 /**
  * Skeleton
  *
@@ -212,6 +236,25 @@ public:
     /**refresh bone world matrix*/
     void updateBoneMatrix();
     
+    /**refresh bone world matrix, skipped if it was already refreshed for this frame (Director::getTotalFrames())*/
+    void updateBoneMatrix(unsigned int frame);
+    
+    /**
+     * Queue a source to be evaluated by the next evaluatePending(), the skeleton is retained until then.
+     * A source is queued at most once, queueing it again is a no-op.
+     */
+    static void queueEvaluation(Skeleton3D* skeleton, BoneAnimationSource* source);
+    
+    /**remove a source from the pending list, must be called before a queued source is destroyed*/
+    static void cancelEvaluation(BoneAnimationSource* source);
+    
+    /**
+     * Evaluates all queued sources and refreshes the bone matrices of their skeletons.
+     * Each skeleton is one job on the JobSystem, sources sharing a skeleton run in the same job in queue order.
+     * Called by Sprite3D before the first sprite of the frame is drawn.
+     */
+    static void evaluatePending();
+    
 CC_CONSTRUCTOR_ACCESS:
     
     Skeleton3D();
@@ -232,6 +275,16 @@ protected:
     Vector<Bone3D*> _bones; // bones
 
     Vector<Bone3D*> _rootBones;
+    
+    unsigned int _updatedFrame; // frame of the last updateBoneMatrix(frame)
+    
+    struct PendingEvaluation
+    {
+        Skeleton3D*          skeleton; // retained until evaluated, keeps the bones alive
+        BoneAnimationSource* source;
+    };
+    static std::vector<PendingEvaluation> s_pendingEvaluations;
+    static std::vector<int> s_pendingGroups; // start index of each skeleton in s_pendingEvaluations
 };
 
 // end of 3d group
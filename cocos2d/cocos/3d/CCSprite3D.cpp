@@ -50,6 +50,9 @@ NS_CC_BEGIN
 
 static Sprite3DMaterial* getSprite3DMaterialForAttribs(MeshVertexData* meshVertexData, bool usesLight);
 
+// sprites between onEnter and onExit, their materials are updated by updateLightingMaterials
+static std::vector<Sprite3D*> s_runningSprites;
+
 Sprite3D* Sprite3D::create()
 {
     //
@@ -262,7 +265,9 @@ Sprite3D::Sprite3D()
 , _lightMask(-1)
 , _shaderUsingLight(false)
 , _forceDepthWrite(false)
+, _drawnByInstanceGroup(false)
 , _usingAutogeneratedGLProgram(true)
+, _runningIndex(-1)
 {
 }
 
@@ -486,6 +491,61 @@ Material* Sprite3D::getMaterial(int meshIndex) const
 }
 
 
+void Sprite3D::onEnter()
+{
+    Node::onEnter();
+
+    if (_runningIndex < 0)
+    {
+        _runningIndex = static_cast<ssize_t>(s_runningSprites.size());
+        s_runningSprites.push_back(this);
+    }
+}
+
+void Sprite3D::onExit()
+{
+    if (_runningIndex >= 0)
+    {
+        // swap with the last one
+        auto last = s_runningSprites.back();
+        s_runningSprites[_runningIndex] = last;
+        last->_runningIndex = _runningIndex;
+        s_runningSprites.pop_back();
+        _runningIndex = -1;
+    }
+
+    Node::onExit();
+}
+
+void Sprite3D::updateLightingMaterials()
+{
+    const auto scene = Director::getInstance()->getRunningScene();
+    if (!scene)
+        return;
+
+    for (auto sprite : s_runningSprites)
+        sprite->updateLightingMaterial(scene);
+}
+
+void Sprite3D::updateLightingMaterial(const Scene* scene)
+{
+    // Don't override GLProgramState if using manually set Material
+    if (!_usingAutogeneratedGLProgram)
+        return;
+
+    bool usingLight = false;
+    for (const auto light : scene->getLights())
+    {
+        usingLight = light->isEnabled() && ((static_cast<unsigned int>(light->getLightFlag()) & _lightMask) > 0);
+        if (usingLight)
+            break;
+    }
+    if (usingLight != _shaderUsingLight)
+    {
+        genMaterial(usingLight);
+    }
+}
+
 void Sprite3D::genMaterial(bool useLight)
 {
     _shaderUsingLight = useLight;
@@ -716,6 +776,12 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
         return;
     }
     
+    // the first sprite visited this frame evaluates the deferred bone animation of all sprites,
+    // a parallel visit records on workers after Scene::render already evaluated them, and the
+    // pending list is only touched on the main thread
+    if (!renderer->isRecording())
+        Skeleton3D::evaluatePending();
+    
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
     flags |= FLAGS_RENDER_AS_3D;
     
@@ -726,6 +792,13 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     
     bool visibleByCamera = isVisitableByVisitingCamera();
     
+#if CC_USE_CULLING
+    // _modelViewTransform is the node-to-world transform here (and only updated when visible by
+    // the camera), refresh the cached world aabb only when it or a mesh's aabb/visibility changed
+    if (visibleByCamera && ((flags & FLAGS_TRANSFORM_DIRTY) || _aabbDirty))
+        updateAABB(_modelViewTransform);
+#endif
+    
     int i = 0;
     
     if(!_children.empty())
@@ -758,37 +831,32 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
 
 void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    // the meshes are drawn by an instance group, which also updates the skeleton
+    bool skipMeshes = _drawnByInstanceGroup;
 #if CC_USE_CULLING
-    //TODO new-renderer: interface isVisibleInFrustum removal
-    // camera clipping
-//    if(_children.size() == 0 && Camera::getVisitingCamera() && !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
-//        return;
+    // camera clipping, children are visited separately so only this sprite's meshes are skipped
+    auto visitingCamera = Camera::getVisitingCamera();
+    if (!skipMeshes && visitingCamera && !_meshes.empty() && !visitingCamera->isVisibleInFrustum(&_aabb))
+        skipMeshes = true;
 #endif
+    if (skipMeshes)
+    {
+        // attach nodes read the bone matrices, keep them current even when the meshes are skipped
+        if (_skeleton && !_attachments.empty())
+            _skeleton->updateBoneMatrix(Director::getInstance()->getTotalFrames());
+        return;
+    }
     
     if (_skeleton)
-        _skeleton->updateBoneMatrix();
+        _skeleton->updateBoneMatrix(Director::getInstance()->getTotalFrames());
     
     Color4F color(getDisplayedColor());
     color.a = getDisplayedOpacity() / 255.0f;
     
-    //check light and determine the shader used
+    //check light and determine the shader used, when visited in parallel updateLightingMaterials() already did it
     const auto& scene = Director::getInstance()->getRunningScene();
-
-    // Don't override GLProgramState if using manually set Material
-    if (_usingAutogeneratedGLProgram && scene)
-    {
-        const auto lights = scene->getLights();
-        bool usingLight = false;
-        for (const auto light : lights) {
-            usingLight = light->isEnabled() && ((static_cast<unsigned int>(light->getLightFlag()) & _lightMask) > 0);
-            if (usingLight)
-                break;
-        }
-        if (usingLight != _shaderUsingLight)
-        {
-            genMaterial(usingLight);
-        }
-    }
+    if (scene && !renderer->isRecording())
+        updateLightingMaterial(scene);
     
     for (auto mesh: _meshes)
     {
@@ -837,28 +905,28 @@ const AABB& Sprite3D::getAABB() const
     Mat4 nodeToWorldTransform(getNodeToWorldTransform());
     
     // If nodeToWorldTransform matrix isn't changed, we don't need to transform aabb.
-    if (memcmp(_nodeToWorldTransform.m, nodeToWorldTransform.m, sizeof(Mat4)) == 0 && !_aabbDirty)
+    if (memcmp(_nodeToWorldTransform.m, nodeToWorldTransform.m, sizeof(Mat4)) != 0 || _aabbDirty)
     {
-        return _aabb;
+        updateAABB(nodeToWorldTransform);
     }
-    else
+    
+    return _aabb;
+}
+
+void Sprite3D::updateAABB(const Mat4& nodeToWorldTransform) const
+{
+    _aabb.reset();
+    if (_meshes.size())
     {
-        _aabb.reset();
-        if (_meshes.size())
-        {
-            Mat4 transform(nodeToWorldTransform);
-            for (const auto& it : _meshes) {
-                if (it->isVisible())
-                    _aabb.merge(it->getAABB());
-            }
-            
-            _aabb.transform(transform);
-            _nodeToWorldTransform = nodeToWorldTransform;
-            _aabbDirty = false;
+        for (const auto& it : _meshes) {
+            if (it->isVisible())
+                _aabb.merge(it->getAABB());
         }
+        
+        _aabb.transform(nodeToWorldTransform);
+        _nodeToWorldTransform = nodeToWorldTransform;
+        _aabbDirty = false;
     }
-    
-    return _aabb;
 }
 
 Action* Sprite3D::runAction(Action *action)
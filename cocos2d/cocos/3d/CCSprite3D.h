@@ -154,6 +154,13 @@ public:
     void setForceDepthWrite(bool value) { _forceDepthWrite = value; }
     bool isForceDepthWrite() const { return _forceDepthWrite;};
     
+    /**
+     * Whether the meshes are drawn by a Sprite3DInstanceGroup, set by Sprite3DInstanceGroup::addSprite.
+     * The sprite still animates and visits its children, only its own meshes are not drawn.
+     */
+    void setDrawnByInstanceGroup(bool value) { _drawnByInstanceGroup = value; }
+    bool isDrawnByInstanceGroup() const { return _drawnByInstanceGroup; }
+    
     /**
      * Returns 2d bounding-box
      * Note: the bounding-box is just get from the AABB which as Z=0, so that is not very accurate.
@@ -172,6 +179,16 @@ public:
     /**draw*/
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    /**
+     * Switches the autogenerated materials of all running sprites between lit and unlit for the lights of the running scene.
+     * draw() does it for each sprite, but generating materials is not thread safe, so call this on the main thread
+     * before the scene graph is visited in parallel, see Director::setParallelVisitEnabled.
+     */
+    static void updateLightingMaterials();
+
     /** Adds a new material to the sprite.
      The Material will be applied to all the meshes that belong to the sprite.
      Internally it will call `setMaterial(material,-1)`
@@ -226,6 +243,9 @@ CC_CONSTRUCTOR_ACCESS:
     /**generate default material*/
     void genMaterial(bool useLight = false);
 
+    /**regenerate the autogenerated material if the lights used by this sprite were turned on or off*/
+    void updateLightingMaterial(const Scene* scene);
+
     void createNode(NodeData* nodedata, Node* root, const MaterialDatas& materialdatas, bool singleSprite);
     void createAttachSprite3DNode(NodeData* nodedata, const MaterialDatas& materialdatas);
     Sprite3D* createSprite3DNode(NodeData* nodedata, ModelData* modeldata, const MaterialDatas& materialdatas);
@@ -237,6 +257,9 @@ CC_CONSTRUCTOR_ACCESS:
     
     void onAABBDirty() { _aabbDirty = true; }
     
+    /**recompute the cached world aabb from the given node-to-world transform*/
+    void updateAABB(const Mat4& nodeToWorldTransform) const;
+    
     void afterAsyncLoad(void* param);
 
     static AABB getAABBRecursivelyImp(Node *node);
@@ -259,7 +282,9 @@ protected:
     unsigned int                 _lightMask;
     bool                         _shaderUsingLight; // is current shader using light ?
     bool                         _forceDepthWrite; // Always write to depth buffer
+    bool                         _drawnByInstanceGroup; // meshes are drawn by a Sprite3DInstanceGroup
     bool                         _usingAutogeneratedGLProgram;
+    ssize_t                      _runningIndex; // index in the list of running sprites, -1 when not running
     
     struct AsyncLoadParam
     {
@@ -0,0 +1,755 @@
+/****************************************************************************
+ Copyright (c) 2014-2016 Chukong Technologies Inc.
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "3d/CCSprite3DInstanceGroup.h"
+#include "3d/CCSprite3D.h"
+#include "3d/CCMesh.h"
+#include "3d/CCMeshSkin.h"
+#include "3d/CCSkeleton3D.h"
+#include "3d/CC3DProgramInfo.h"
+#include <algorithm>
+
+#include "2d/CCCamera.h"
+#include "2d/CCLight.h"
+#include "2d/CCScene.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/ccShaders.h"
+#include "renderer/backend/Buffer.h"
+#include "renderer/backend/Device.h"
+#include "renderer/backend/ProgramState.h"
+#include "renderer/backend/Texture.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // A column-major model matrix, an RGBA color and the row of the instance's matrix palette.
+    const std::size_t FLOATS_PER_INSTANCE = 16 + 4 + 1;
+    const std::size_t BYTES_PER_INSTANCE = FLOATS_PER_INSTANCE * sizeof(float);
+
+    const char* INSTANCE_ATTRIBUTE_NAMES[] = {
+        "a_instanceColumn0",
+        "a_instanceColumn1",
+        "a_instanceColumn2",
+        "a_instanceColumn3",
+        "a_instanceColor",
+        "a_instancePalette",
+    };
+    const int INSTANCE_ATTRIBUTE_SIZES[] = { 4, 4, 4, 4, 4, 1 };
+
+    // the texture unit of u_paletteTexture, u_texture uses 0
+    const uint32_t PALETTE_TEXTURE_SLOT = 1;
+
+    // the same light counts as the programs of ProgramCache
+    std::string getShaderMacros(bool skinned)
+    {
+        char def[256];
+        auto conf = Configuration::getInstance();
+
+        snprintf(def, sizeof(def) - 1, "\n#define MAX_DIRECTIONAL_LIGHT_NUM %d \n"
+            "\n#define MAX_POINT_LIGHT_NUM %d \n"
+            "\n#define MAX_SPOT_LIGHT_NUM %d \n"
+            "%s",
+            conf->getMaxSupportDirLightInShader(),
+            conf->getMaxSupportPointLightInShader(),
+            conf->getMaxSupportSpotLightInShader(),
+            skinned ? "\n#define USE_SKINNING 1 \n" : "");
+
+        return std::string(def);
+    }
+
+    // the meshes of a sprite and of its child Sprite3Ds, in the order of Sprite3DInstanceGroup::collectMeshParts
+    void collectMeshes(Sprite3D* sprite, std::vector<Mesh*>& meshes)
+    {
+        for (auto mesh : sprite->getMeshes())
+            meshes.push_back(mesh);
+
+        for (auto child : sprite->getChildren())
+        {
+            auto childSprite = dynamic_cast<Sprite3D*>(child);
+            if (childSprite)
+                collectMeshes(childSprite, meshes);
+        }
+    }
+
+    void setDrawnByInstanceGroup(Sprite3D* sprite, bool value)
+    {
+        sprite->setDrawnByInstanceGroup(value);
+
+        for (auto child : sprite->getChildren())
+        {
+            auto childSprite = dynamic_cast<Sprite3D*>(child);
+            if (childSprite)
+                setDrawnByInstanceGroup(childSprite, value);
+        }
+    }
+
+    // whether the node and all its ancestors are visible
+    bool isVisibleInScene(const Node* node)
+    {
+        for (; node; node = node->getParent())
+        {
+            if (!node->isVisible())
+                return false;
+        }
+        return true;
+    }
+}
+
+Sprite3DInstanceGroup* Sprite3DInstanceGroup::create(const std::string& modelPath)
+{
+    auto group = new (std::nothrow) Sprite3DInstanceGroup();
+    if (group && group->initWithFile(modelPath))
+    {
+        group->autorelease();
+        return group;
+    }
+    CC_SAFE_DELETE(group);
+    return nullptr;
+}
+
+Sprite3DInstanceGroup::Sprite3DInstanceGroup()
+{
+}
+
+Sprite3DInstanceGroup::~Sprite3DInstanceGroup()
+{
+    for (auto& instance : _sprites)
+    {
+        setDrawnByInstanceGroup(instance.sprite, false);
+        instance.sprite->release();
+    }
+    _sprites.clear();
+
+    for (auto batch : _batches)
+    {
+        CC_SAFE_RELEASE(batch->instanceBuffer);
+        for (auto programState : batch->programStates)
+            CC_SAFE_RELEASE(programState);
+        for (auto command : batch->commands)
+            delete command;
+        delete batch;
+    }
+    _batches.clear();
+
+    for (auto part : _meshParts)
+    {
+        CC_SAFE_RELEASE(part->mesh);
+        CC_SAFE_RELEASE(part->programState);
+        delete part;
+    }
+    _meshParts.clear();
+
+    CC_SAFE_RELEASE(_paletteTexture);
+    CC_SAFE_RELEASE(_staticProgram.program);
+    CC_SAFE_RELEASE(_skinnedProgram.program);
+    CC_SAFE_RELEASE(_model);
+}
+
+bool Sprite3DInstanceGroup::initWithFile(const std::string& modelPath)
+{
+    if (!Node::init())
+        return false;
+
+    _modelPath = modelPath;
+    _model = Sprite3D::create(modelPath);
+    if (!_model)
+        return false;
+    _model->retain();
+
+    auto deviceInfo = backend::Device::getInstance()->getDeviceInfo();
+    _instanced = deviceInfo && deviceInfo->checkForFeatureSupported(backend::FeatureType::INSTANCING);
+    if (!_instanced)
+        return true;
+
+    // the model is never added to the scene, so its node-to-world transform is its local transform
+    _modelAABB = _model->getAABBRecursively();
+    collectMeshParts(_model, Mat4::IDENTITY);
+
+    // row 0 of the palettes is the pose of the model, for the nodes of addInstance()
+    if (_paletteWidth > 0)
+    {
+        if (_model->getSkeleton())
+            _model->getSkeleton()->updateBoneMatrix();
+
+        _paletteData.assign(_paletteWidth * 4, 0.0f);
+        for (auto part : _meshParts)
+        {
+            if (part->paletteSize > 0)
+                memcpy(&_paletteData[part->paletteColumn * 4], part->mesh->getSkin()->getMatrixPalette(), part->paletteSize * sizeof(Vec4));
+        }
+    }
+    return true;
+}
+
+void Sprite3DInstanceGroup::initProgram(InstanceProgram* program, bool skinned)
+{
+    std::string def = getShaderMacros(skinned);
+    program->program = backend::Device::getInstance()->newProgram(def + CC3D_instanced_vert, def + CC3D_instanced_frag);
+
+    const auto& attributeInfo = program->program->getActiveAttributes();
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < sizeof(INSTANCE_ATTRIBUTE_NAMES) / sizeof(INSTANCE_ATTRIBUTE_NAMES[0]); ++i)
+    {
+        const auto iter = attributeInfo.find(INSTANCE_ATTRIBUTE_NAMES[i]);
+        if (iter != attributeInfo.end())
+        {
+            auto format = INSTANCE_ATTRIBUTE_SIZES[i] == 4 ? backend::VertexFormat::FLOAT4 : backend::VertexFormat::FLOAT;
+            program->instanceLayout.setAttribute(INSTANCE_ATTRIBUTE_NAMES[i], iter->second.location, format, offset, false);
+        }
+        offset += INSTANCE_ATTRIBUTE_SIZES[i] * sizeof(float);
+    }
+    program->instanceLayout.setLayout(BYTES_PER_INSTANCE);
+
+    auto p = program->program;
+    program->vpMatrixLocation = p->getUniformLocation("u_VPMatrix");
+    program->meshMatrixLocation = p->getUniformLocation("u_MeshMatrix");
+    program->paletteTextureLocation = p->getUniformLocation("u_paletteTexture");
+    program->paletteTexelSizeLocation = p->getUniformLocation("u_paletteTexelSize");
+    program->paletteColumnLocation = p->getUniformLocation("u_paletteColumn");
+    program->ambientColorLocation = p->getUniformLocation("u_AmbientLightSourceColor");
+    program->dirLightColorLocation = p->getUniformLocation("u_DirLightSourceColor");
+    program->dirLightDirLocation = p->getUniformLocation("u_DirLightSourceDirection");
+    program->pointLightColorLocation = p->getUniformLocation("u_PointLightSourceColor");
+    program->pointLightPositionLocation = p->getUniformLocation("u_PointLightSourcePosition");
+    program->pointLightRangeInverseLocation = p->getUniformLocation("u_PointLightSourceRangeInverse");
+    program->spotLightColorLocation = p->getUniformLocation("u_SpotLightSourceColor");
+    program->spotLightPositionLocation = p->getUniformLocation("u_SpotLightSourcePosition");
+    program->spotLightDirLocation = p->getUniformLocation("u_SpotLightSourceDirection");
+    program->spotLightInnerAngleCosLocation = p->getUniformLocation("u_SpotLightSourceInnerAngleCos");
+    program->spotLightOuterAngleCosLocation = p->getUniformLocation("u_SpotLightSourceOuterAngleCos");
+    program->spotLightRangeInverseLocation = p->getUniformLocation("u_SpotLightSourceRangeInverse");
+}
+
+void Sprite3DInstanceGroup::collectMeshParts(Sprite3D* sprite, const Mat4& parentTransform)
+{
+    for (auto mesh : sprite->getMeshes())
+    {
+        auto part = new MeshPart();
+        part->mesh = mesh;
+        part->mesh->retain();
+        part->meshTransform = parentTransform;
+        initMeshPart(part);
+        _meshParts.push_back(part);
+    }
+
+    // the node hierarchy of the model is made of child Sprite3Ds
+    for (auto child : sprite->getChildren())
+    {
+        auto childSprite = dynamic_cast<Sprite3D*>(child);
+        if (childSprite)
+            collectMeshParts(childSprite, parentTransform * childSprite->getNodeToParentTransform());
+    }
+}
+
+void Sprite3DInstanceGroup::initMeshPart(MeshPart* part)
+{
+    auto mesh = part->mesh;
+    auto skin = mesh->getSkin();
+    bool skinned = skin && skin->getMatrixPaletteSize() > 0;
+    part->program = skinned ? &_skinnedProgram : &_staticProgram;
+    if (!part->program->program)
+        initProgram(part->program, skinned);
+
+    // the palettes of the skinned meshes are side by side in a row of the palette texture
+    if (skinned)
+    {
+        part->paletteColumn = _paletteWidth;
+        part->paletteSize = skin->getMatrixPaletteSize();
+        _paletteWidth += part->paletteSize;
+    }
+    part->hasNormal = mesh->hasVertexAttrib(shaderinfos::VertexKey::VERTEX_ATTRIB_NORMAL);
+
+    auto program = part->program->program;
+    part->programState = new (std::nothrow) backend::ProgramState(program);
+    auto programState = part->programState;
+
+    // bind the attributes of the mesh the shader uses, the same way as VertexAttribBinding
+    auto layout = programState->getVertexLayout();
+    const auto& attributeInfo = program->getActiveAttributes();
+    std::size_t offset = 0;
+    auto attributeCount = mesh->getMeshVertexAttribCount();
+    for (int i = 0; i < attributeCount; ++i)
+    {
+        const auto& meshAttribute = mesh->getMeshVertexAttribute(i);
+        const auto name = shaderinfos::getAttributeName(meshAttribute.vertexAttrib);
+        const auto iter = attributeInfo.find(name);
+        if (iter != attributeInfo.end())
+            layout->setAttribute(name, iter->second.location, meshAttribute.type, offset, false);
+        offset += meshAttribute.getAttribSizeBytes();
+    }
+    layout->setLayout(mesh->getVertexSizeInBytes());
+
+    // meshes whose material has no diffuse texture get the dummy texture, like Sprite3D does when it is missing
+    auto texture = mesh->getTexture(NTextureData::Usage::Diffuse);
+    if (!texture)
+    {
+        mesh->setTexture(nullptr, NTextureData::Usage::Diffuse);
+        texture = mesh->getTexture(NTextureData::Usage::Diffuse);
+    }
+    programState->setTexture(programState->getUniformLocation("u_texture"), 0, texture->getBackendTexture());
+    programState->setUniform(part->program->meshMatrixLocation, part->meshTransform.m, sizeof(part->meshTransform.m));
+    if (skinned)
+    {
+        float column = static_cast<float>(part->paletteColumn);
+        programState->setUniform(part->program->paletteColumnLocation, &column, sizeof(column));
+    }
+}
+
+Node* Sprite3DInstanceGroup::addInstance()
+{
+    Node* instance = nullptr;
+    if (_instanced)
+        instance = Node::create();
+    else
+        instance = Sprite3D::create(_modelPath);
+
+    if (instance)
+    {
+        instance->setCameraMask(getCameraMask());
+        addChild(instance);
+    }
+    return instance;
+}
+
+void Sprite3DInstanceGroup::removeInstance(Node* instance)
+{
+    removeChild(instance);
+}
+
+bool Sprite3DInstanceGroup::addSprite(Sprite3D* sprite)
+{
+    if (!_instanced || !sprite || sprite->isDrawnByInstanceGroup())
+        return false;
+
+    // the sprite has to share the mesh data of the model, as sprites created from the same file do
+    SpriteInstance instance;
+    collectMeshes(sprite, instance.meshes);
+    if (instance.meshes.size() != _meshParts.size())
+        return false;
+    for (std::size_t i = 0; i < _meshParts.size(); ++i)
+    {
+        const auto mesh = instance.meshes[i];
+        const auto part = _meshParts[i];
+        if (mesh->getMeshIndexData() != part->mesh->getMeshIndexData())
+            return false;
+        if (part->paletteSize > 0 && (!mesh->getSkin() || static_cast<std::size_t>(mesh->getSkin()->getMatrixPaletteSize()) != part->paletteSize))
+            return false;
+    }
+
+    instance.sprite = sprite;
+    sprite->retain();
+    setDrawnByInstanceGroup(sprite, true);
+    _sprites.push_back(instance);
+    return true;
+}
+
+void Sprite3DInstanceGroup::removeSprite(Sprite3D* sprite)
+{
+    auto iter = std::find_if(_sprites.begin(), _sprites.end(), [sprite](const SpriteInstance& instance) {
+        return instance.sprite == sprite;
+    });
+    if (iter == _sprites.end())
+        return;
+
+    setDrawnByInstanceGroup(sprite, false);
+    sprite->release();
+    _sprites.erase(iter);
+}
+
+Sprite3DInstanceGroup::DrawBatch* Sprite3DInstanceGroup::nextBatch()
+{
+    if (_batchesUsed == _batches.size())
+    {
+        auto batch = new DrawBatch();
+        for (auto part : _meshParts)
+        {
+            auto mesh = part->mesh;
+            auto programState = part->programState->clone();
+            auto command = new CustomCommand();
+            command->setVertexBuffer(mesh->getVertexBuffer());
+            command->setIndexBuffer(mesh->getIndexBuffer(), mesh->getIndexFormat());
+            command->setIndexDrawInfo(0, mesh->getIndexCount());
+            command->setPrimitiveType(mesh->getPrimitiveType());
+            command->setDrawType(CustomCommand::DrawType::ELEMENT);
+            command->getPipelineDescriptor().programState = programState;
+            command->setBeforeCallback(CC_CALLBACK_0(Sprite3DInstanceGroup::onBeforeDraw, this));
+            command->setAfterCallback(CC_CALLBACK_0(Sprite3DInstanceGroup::onAfterDraw, this));
+            batch->programStates.push_back(programState);
+            batch->commands.push_back(command);
+        }
+        _batches.push_back(batch);
+    }
+    return _batches[_batchesUsed++];
+}
+
+void Sprite3DInstanceGroup::updateSprites()
+{
+    for (auto iter = _sprites.begin(); iter != _sprites.end(); )
+    {
+        // only the group still holds the sprite, it was removed from the game
+        if (iter->sprite->getReferenceCount() == 1)
+        {
+            setDrawnByInstanceGroup(iter->sprite, false);
+            iter->sprite->release();
+            iter = _sprites.erase(iter);
+            continue;
+        }
+
+        iter->drawn = iter->sprite->isRunning() && isVisibleInScene(iter->sprite);
+        ++iter;
+    }
+}
+
+void Sprite3DInstanceGroup::updatePalettes()
+{
+    if (_paletteWidth == 0)
+        return;
+
+    // the animations of the frame, when no sprite was visited before the group
+    Skeleton3D::evaluatePending();
+
+    const auto frame = Director::getInstance()->getTotalFrames();
+    const std::size_t rowFloats = _paletteWidth * 4;
+    const std::size_t rows = _sprites.size() + 1;
+    _paletteData.resize(rows * rowFloats);
+
+    for (std::size_t i = 0; i < _sprites.size(); ++i)
+    {
+        const auto& instance = _sprites[i];
+        if (!instance.drawn)
+            continue;
+
+        if (instance.sprite->getSkeleton())
+            instance.sprite->getSkeleton()->updateBoneMatrix(frame);
+
+        float* row = &_paletteData[(i + 1) * rowFloats];
+        for (std::size_t j = 0; j < _meshParts.size(); ++j)
+        {
+            const auto part = _meshParts[j];
+            if (part->paletteSize > 0)
+                memcpy(row + part->paletteColumn * 4, instance.meshes[j]->getSkin()->getMatrixPalette(), part->paletteSize * sizeof(Vec4));
+        }
+    }
+
+    if (rows > _paletteRows)
+    {
+        // grow by doubling, like the instance buffers
+        std::size_t capacity = std::max<std::size_t>(_paletteRows * 2, 16);
+        while (capacity < rows)
+            capacity *= 2;
+
+        backend::TextureDescriptor descriptor;
+        descriptor.textureFormat = backend::PixelFormat::RGBA32F;
+        descriptor.width = static_cast<uint32_t>(_paletteWidth);
+        descriptor.height = static_cast<uint32_t>(capacity);
+        descriptor.samplerDescriptor = backend::SamplerDescriptor(backend::SamplerFilter::NEAREST,
+                                                                  backend::SamplerFilter::NEAREST,
+                                                                  backend::SamplerAddressMode::CLAMP_TO_EDGE,
+                                                                  backend::SamplerAddressMode::CLAMP_TO_EDGE);
+        CC_SAFE_RELEASE(_paletteTexture);
+        _paletteTexture = static_cast<backend::Texture2DBackend*>(backend::Device::getInstance()->newTexture(descriptor));
+        _paletteRows = _paletteTexture ? capacity : 0;
+        if (!_paletteTexture)
+            return;
+    }
+
+    _paletteTexture->updateSubData(0, 0, _paletteWidth, rows, 0, reinterpret_cast<uint8_t*>(_paletteData.data()));
+}
+
+void Sprite3DInstanceGroup::updateLights()
+{
+    // the same values as Mesh::setLightUniforms
+    const auto& conf = Configuration::getInstance();
+    _dirLightColors.assign(conf->getMaxSupportDirLightInShader(), Vec3::ZERO);
+    _dirLightDirs.assign(conf->getMaxSupportDirLightInShader(), Vec3::ZERO);
+    _pointLightColors.assign(conf->getMaxSupportPointLightInShader(), Vec3::ZERO);
+    _pointLightPositions.assign(conf->getMaxSupportPointLightInShader(), Vec3::ZERO);
+    _pointLightRangeInverses.assign(conf->getMaxSupportPointLightInShader(), 0.0f);
+    _spotLightColors.assign(conf->getMaxSupportSpotLightInShader(), Vec3::ZERO);
+    _spotLightPositions.assign(conf->getMaxSupportSpotLightInShader(), Vec3::ZERO);
+    _spotLightDirs.assign(conf->getMaxSupportSpotLightInShader(), Vec3::ZERO);
+    _spotLightInnerAngleCos.assign(conf->getMaxSupportSpotLightInShader(), 0.0f);
+    _spotLightOuterAngleCos.assign(conf->getMaxSupportSpotLightInShader(), 0.0f);
+    _spotLightRangeInverses.assign(conf->getMaxSupportSpotLightInShader(), 0.0f);
+    _ambientLightColor.setZero();
+    // meshes without normals are drawn with the color alone, or modulated by the ambient lights if there are any
+    _unlitAmbientColor.set(1.0f, 1.0f, 1.0f);
+
+    std::size_t enabledDirLightNum = 0;
+    std::size_t enabledPointLightNum = 0;
+    std::size_t enabledSpotLightNum = 0;
+    bool usingLight = false;
+    bool hasAmbient = false;
+    const auto scene = Director::getInstance()->getRunningScene();
+    const auto& lights = scene ? scene->getLights() : std::vector<BaseLight*>();
+    for (const auto& light : lights)
+    {
+        if (!light->isEnabled() || !((unsigned int)light->getLightFlag() & _lightMask))
+            continue;
+
+        usingLight = true;
+        float intensity = light->getIntensity();
+        const Color3B& col = light->getDisplayedColor();
+        Vec3 color(col.r / 255.0f * intensity, col.g / 255.0f * intensity, col.b / 255.0f * intensity);
+        switch (light->getLightType())
+        {
+            case LightType::DIRECTIONAL:
+                if (enabledDirLightNum < _dirLightColors.size())
+                {
+                    Vec3 dir = static_cast<DirectionLight*>(light)->getDirectionInWorld();
+                    dir.normalize();
+                    _dirLightColors[enabledDirLightNum] = color;
+                    _dirLightDirs[enabledDirLightNum] = dir;
+                    ++enabledDirLightNum;
+                }
+                break;
+            case LightType::POINT:
+                if (enabledPointLightNum < _pointLightColors.size())
+                {
+                    auto pointLight = static_cast<PointLight*>(light);
+                    Mat4 mat = pointLight->getNodeToWorldTransform();
+                    _pointLightColors[enabledPointLightNum] = color;
+                    _pointLightPositions[enabledPointLightNum].set(mat.m[12], mat.m[13], mat.m[14]);
+                    _pointLightRangeInverses[enabledPointLightNum] = 1.0f / pointLight->getRange();
+                    ++enabledPointLightNum;
+                }
+                break;
+            case LightType::SPOT:
+                if (enabledSpotLightNum < _spotLightColors.size())
+                {
+                    auto spotLight = static_cast<SpotLight*>(light);
+                    Vec3 dir = spotLight->getDirectionInWorld();
+                    dir.normalize();
+                    Mat4 mat = spotLight->getNodeToWorldTransform();
+                    _spotLightColors[enabledSpotLightNum] = color;
+                    _spotLightPositions[enabledSpotLightNum].set(mat.m[12], mat.m[13], mat.m[14]);
+                    _spotLightDirs[enabledSpotLightNum] = dir;
+                    _spotLightInnerAngleCos[enabledSpotLightNum] = spotLight->getCosInnerAngle();
+                    _spotLightOuterAngleCos[enabledSpotLightNum] = spotLight->getCosOuterAngle();
+                    _spotLightRangeInverses[enabledSpotLightNum] = 1.0f / spotLight->getRange();
+                    ++enabledSpotLightNum;
+                }
+                break;
+            case LightType::AMBIENT:
+                _ambientLightColor.add(color);
+                hasAmbient = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // without lights Sprite3D uses the unlit shaders
+    if (!usingLight)
+        _ambientLightColor = _unlitAmbientColor;
+    else if (hasAmbient)
+        _unlitAmbientColor = _ambientLightColor;
+}
+
+void Sprite3DInstanceGroup::setLightUniforms(const MeshPart* part, backend::ProgramState* programState) const
+{
+    const auto& program = *part->program;
+    const auto& ambientColor = part->hasNormal ? _ambientLightColor : _unlitAmbientColor;
+    programState->setUniform(program.ambientColorLocation, &ambientColor, sizeof(ambientColor));
+    if (!part->hasNormal)
+        return;
+
+    if (!_dirLightColors.empty())
+    {
+        programState->setUniform(program.dirLightColorLocation, _dirLightColors.data(), _dirLightColors.size() * sizeof(_dirLightColors[0]));
+        programState->setUniform(program.dirLightDirLocation, _dirLightDirs.data(), _dirLightDirs.size() * sizeof(_dirLightDirs[0]));
+    }
+
+    if (!_pointLightColors.empty())
+    {
+        programState->setUniform(program.pointLightColorLocation, _pointLightColors.data(), _pointLightColors.size() * sizeof(_pointLightColors[0]));
+        programState->setUniform(program.pointLightPositionLocation, _pointLightPositions.data(), _pointLightPositions.size() * sizeof(_pointLightPositions[0]));
+        programState->setUniform(program.pointLightRangeInverseLocation, _pointLightRangeInverses.data(), _pointLightRangeInverses.size() * sizeof(_pointLightRangeInverses[0]));
+    }
+
+    if (!_spotLightColors.empty())
+    {
+        programState->setUniform(program.spotLightColorLocation, _spotLightColors.data(), _spotLightColors.size() * sizeof(_spotLightColors[0]));
+        programState->setUniform(program.spotLightPositionLocation, _spotLightPositions.data(), _spotLightPositions.size() * sizeof(_spotLightPositions[0]));
+        programState->setUniform(program.spotLightDirLocation, _spotLightDirs.data(), _spotLightDirs.size() * sizeof(_spotLightDirs[0]));
+        programState->setUniform(program.spotLightInnerAngleCosLocation, _spotLightInnerAngleCos.data(), _spotLightInnerAngleCos.size() * sizeof(_spotLightInnerAngleCos[0]));
+        programState->setUniform(program.spotLightOuterAngleCosLocation, _spotLightOuterAngleCos.data(), _spotLightOuterAngleCos.size() * sizeof(_spotLightOuterAngleCos[0]));
+        programState->setUniform(program.spotLightRangeInverseLocation, _spotLightRangeInverses.data(), _spotLightRangeInverses.size() * sizeof(_spotLightRangeInverses[0]));
+    }
+}
+
+bool Sprite3DInstanceGroup::uploadInstances(DrawBatch* batch, const Mat4& transform)
+{
+    batch->instanceCount = 0;
+    _instanceData.resize((_children.size() + _sprites.size()) * FLOATS_PER_INSTANCE);
+
+    auto visitingCamera = Camera::getVisitingCamera();
+    auto writeInstance = [this, batch](const Mat4& world, const Node* node, std::size_t paletteRow) {
+        float* data = &_instanceData[batch->instanceCount * FLOATS_PER_INSTANCE];
+        memcpy(data, world.m, sizeof(world.m));
+        const Color3B& color = node->getDisplayedColor();
+        data[16] = color.r / 255.0f;
+        data[17] = color.g / 255.0f;
+        data[18] = color.b / 255.0f;
+        data[19] = node->getDisplayedOpacity() / 255.0f;
+        data[20] = static_cast<float>(paletteRow);
+        ++batch->instanceCount;
+    };
+
+    for (auto child : _children)
+    {
+        if (!child->isVisible())
+            continue;
+
+        // children are visited after draw(), compute their transforms here
+        Mat4 world = transform * child->getNodeToParentTransform();
+
+#if CC_USE_CULLING
+        if (visitingCamera)
+        {
+            AABB aabb = _modelAABB;
+            aabb.transform(world);
+            if (!visitingCamera->isVisibleInFrustum(&aabb))
+                continue;
+        }
+#endif
+
+        writeInstance(world, child, 0);
+    }
+
+    for (std::size_t i = 0; i < _sprites.size(); ++i)
+    {
+        const auto sprite = _sprites[i].sprite;
+        if (!_sprites[i].drawn)
+            continue;
+
+        // the sprites are drawn by the cameras they would be visited by
+        if (visitingCamera && !(sprite->getCameraMask() & (unsigned short)visitingCamera->getCameraFlag()))
+            continue;
+
+#if CC_USE_CULLING
+        if (visitingCamera && !visitingCamera->isVisibleInFrustum(&sprite->getAABB()))
+            continue;
+#endif
+
+        writeInstance(sprite->getNodeToWorldTransform(), sprite, i + 1);
+    }
+
+    if (batch->instanceCount == 0)
+        return false;
+
+    if (batch->instanceCount > batch->instanceCapacity)
+    {
+        // grow by doubling so instances added over time do not recreate the buffer every frame
+        std::size_t capacity = std::max<std::size_t>(batch->instanceCapacity * 2, 16);
+        while (capacity < batch->instanceCount)
+            capacity *= 2;
+
+        CC_SAFE_RELEASE(batch->instanceBuffer);
+        batch->instanceBuffer = backend::Device::getInstance()->newBuffer(capacity * BYTES_PER_INSTANCE, backend::BufferType::VERTEX, backend::BufferUsage::DYNAMIC);
+        batch->instanceCapacity = batch->instanceBuffer ? capacity : 0;
+        if (!batch->instanceBuffer)
+        {
+            batch->instanceCount = 0;
+            return false;
+        }
+    }
+
+    batch->instanceBuffer->updateData(_instanceData.data(), batch->instanceCount * BYTES_PER_INSTANCE);
+    return true;
+}
+
+void Sprite3DInstanceGroup::onBeforeDraw()
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    _savedCullMode = renderer->getCullMode();
+    if (!_cullFaceEnabled)
+        renderer->setCullMode(backend::CullMode::NONE);
+}
+
+void Sprite3DInstanceGroup::onAfterDraw()
+{
+    Director::getInstance()->getRenderer()->setCullMode(_savedCullMode);
+}
+
+void Sprite3DInstanceGroup::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (!_instanced || _meshParts.empty())
+        return;
+
+    // the sprites, palettes and lights are the same for every camera of a frame
+    const auto frame = Director::getInstance()->getTotalFrames();
+    if (_frame != frame)
+    {
+        _frame = frame;
+        _batchesUsed = 0;
+        updateSprites();
+        updatePalettes();
+        updateLights();
+    }
+
+    // every camera visit records its own batch, so a later camera does not overwrite the instances
+    // and the view-projection of an earlier one before Renderer::render
+    auto batch = nextBatch();
+    if (!uploadInstances(batch, transform))
+        return;
+
+    const auto& vpMatrix = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Vec2 paletteTexelSize;
+    if (_paletteTexture)
+        paletteTexelSize.set(1.0f / _paletteWidth, 1.0f / _paletteRows);
+
+    for (std::size_t i = 0; i < _meshParts.size(); ++i)
+    {
+        const auto part = _meshParts[i];
+        if (!part->mesh->isVisible())
+            continue;
+
+        const auto& program = *part->program;
+        auto programState = batch->programStates[i];
+        programState->setUniform(program.vpMatrixLocation, vpMatrix.m, sizeof(vpMatrix.m));
+        setLightUniforms(part, programState);
+        if (part->paletteSize > 0)
+        {
+            if (!_paletteTexture)
+                continue;
+            programState->setTexture(program.paletteTextureLocation, PALETTE_TEXTURE_SLOT, _paletteTexture);
+            programState->setUniform(program.paletteTexelSizeLocation, &paletteTexelSize, sizeof(paletteTexelSize));
+        }
+
+        auto command = batch->commands[i];
+        command->init(_globalZOrder, transform, flags);
+        command->set3D(true);
+        command->setTransparent(false);
+        command->setInstanceDrawInfo(batch->instanceBuffer, &program.instanceLayout, batch->instanceCount);
+        renderer->addCommand(command);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,233 @@
+/****************************************************************************
+ Copyright (c) 2014-2016 Chukong Technologies Inc.
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSPRITE3DINSTANCEGROUP_H__
+#define __CCSPRITE3DINSTANCEGROUP_H__
+
+#include <vector>
+
+#include "2d/CCNode.h"
+#include "3d/CCAABB.h"
+#include "renderer/CCCustomCommand.h"
+#include "renderer/backend/VertexLayout.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+class Sprite3D;
+class Mesh;
+
+namespace backend
+{
+    class Buffer;
+    class Program;
+    class ProgramState;
+    class Texture2DBackend;
+}
+
+/**
+ * @brief Sprite3DInstanceGroup: draws many copies of one 3D model with a single draw call per mesh.
+ *
+ * There are two kinds of instances:
+ * - nodes returned by addInstance(), owned by the group. They are moved, rotated, scaled and colored
+ *   like any node and can run actions, skinned models show the pose of the group's own model.
+ * - sprites of the same model added with addSprite(). They stay where they are in the scene and keep
+ *   animating, the group draws their meshes with their own matrix palettes instead of the sprites.
+ *
+ * Each camera visit writes the transforms and colors of the visible instances to an instance buffer
+ * of its own and draws every mesh of the model once for all of them. The matrix palettes of all the
+ * instances are packed once per frame into a float texture, one row per instance, and the skinned
+ * meshes read their bones from the row given by a per-instance attribute. The lights are the same as
+ * for Sprite3D.
+ *
+ * If the device does not support backend::FeatureType::INSTANCING, addInstance() returns a Sprite3D
+ * of the model and addSprite() returns false, the sprites are then drawn as usual.
+ */
+class CC_DLL Sprite3DInstanceGroup : public Node
+{
+public:
+    /**
+     * Creates a group drawing the model of a .obj, .c3t or .c3b file.
+     * @param modelPath The path of the model, the same as for Sprite3D::create.
+     */
+    static Sprite3DInstanceGroup* create(const std::string& modelPath);
+
+    /**
+     * Adds an instance of the model.
+     * @return The node of the instance, owned by the group.
+     */
+    Node* addInstance();
+
+    /** Removes an instance added with addInstance(). */
+    void removeInstance(Node* instance);
+
+    /**
+     * Draws a sprite created from the same model with the group, the sprite's own draw is skipped.
+     * The sprite is retained, it is dropped once the group holds the last reference, or with removeSprite().
+     * @return false if the sprite's meshes are not the ones of the model or instancing is not supported.
+     */
+    bool addSprite(Sprite3D* sprite);
+
+    /** Removes a sprite added with addSprite(), it draws itself again. */
+    void removeSprite(Sprite3D* sprite);
+
+    /** Whether the instances are drawn with hardware instancing. */
+    bool isInstanced() const { return _instanced; }
+
+    /** Light mask, lights are used if (light flag & mask) != 0, see Sprite3D::setLightMask. */
+    void setLightMask(unsigned int mask) { _lightMask = mask; }
+    unsigned int getLightMask() const { return _lightMask; }
+
+    /** Back face culling, enabled by default, see Sprite3D::setCullFaceEnabled. */
+    void setCullFaceEnabled(bool enable) { _cullFaceEnabled = enable; }
+    bool isCullFaceEnabled() const { return _cullFaceEnabled; }
+
+    // overrides
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    Sprite3DInstanceGroup();
+    virtual ~Sprite3DInstanceGroup();
+
+    bool initWithFile(const std::string& modelPath);
+
+protected:
+    // The instanced program for skinned or for static meshes.
+    struct InstanceProgram
+    {
+        backend::Program* program = nullptr;
+        backend::VertexLayout instanceLayout;
+        backend::UniformLocation vpMatrixLocation;
+        backend::UniformLocation meshMatrixLocation;
+        backend::UniformLocation paletteTextureLocation;
+        backend::UniformLocation paletteTexelSizeLocation;
+        backend::UniformLocation paletteColumnLocation;
+        backend::UniformLocation ambientColorLocation;
+        backend::UniformLocation dirLightColorLocation;
+        backend::UniformLocation dirLightDirLocation;
+        backend::UniformLocation pointLightColorLocation;
+        backend::UniformLocation pointLightPositionLocation;
+        backend::UniformLocation pointLightRangeInverseLocation;
+        backend::UniformLocation spotLightColorLocation;
+        backend::UniformLocation spotLightPositionLocation;
+        backend::UniformLocation spotLightDirLocation;
+        backend::UniformLocation spotLightInnerAngleCosLocation;
+        backend::UniformLocation spotLightOuterAngleCosLocation;
+        backend::UniformLocation spotLightRangeInverseLocation;
+    };
+
+    // One mesh of the model, drawn with its own command for all the instances.
+    struct MeshPart
+    {
+        Mesh* mesh = nullptr;
+        Mat4 meshTransform;  // relative to the model root
+        InstanceProgram* program = nullptr;
+        backend::ProgramState* programState = nullptr;  // cloned by every batch
+        std::size_t paletteColumn = 0;  // first texel of the mesh's palette in a palette texture row
+        std::size_t paletteSize = 0;    // 0 if the mesh is not skinned
+        bool hasNormal = false;
+    };
+
+    // The commands and instances recorded by one camera visit.
+    struct DrawBatch
+    {
+        backend::Buffer* instanceBuffer = nullptr;
+        std::size_t instanceCapacity = 0;
+        std::size_t instanceCount = 0;
+        std::vector<backend::ProgramState*> programStates;  // one per mesh part
+        std::vector<CustomCommand*> commands;
+    };
+
+    // A sprite added with addSprite(), its meshes in the order of the mesh parts.
+    struct SpriteInstance
+    {
+        Sprite3D* sprite = nullptr;
+        std::vector<Mesh*> meshes;
+        bool drawn = false;  // running and visible this frame
+    };
+
+    void initProgram(InstanceProgram* program, bool skinned);
+    void collectMeshParts(Sprite3D* sprite, const Mat4& parentTransform);
+    void initMeshPart(MeshPart* part);
+    DrawBatch* nextBatch();
+    void updateSprites();
+    void updatePalettes();
+    void updateLights();
+    void setLightUniforms(const MeshPart* part, backend::ProgramState* programState) const;
+    bool uploadInstances(DrawBatch* batch, const Mat4& transform);
+    void onBeforeDraw();
+    void onAfterDraw();
+
+    std::string _modelPath;
+    Sprite3D* _model = nullptr;
+    AABB _modelAABB;
+    InstanceProgram _staticProgram;
+    InstanceProgram _skinnedProgram;
+    std::vector<MeshPart*> _meshParts;
+    std::vector<SpriteInstance> _sprites;
+
+    // per-visit batches, reused from the next frame on
+    std::vector<DrawBatch*> _batches;
+    std::size_t _batchesUsed = 0;
+    unsigned int _frame = -1;
+    std::vector<float> _instanceData;
+
+    // row 0 is the palette of _model, used by the nodes of addInstance(), row i + 1 of _sprites[i]
+    backend::Texture2DBackend* _paletteTexture = nullptr;
+    std::size_t _paletteWidth = 0;
+    std::size_t _paletteRows = 0;
+    std::vector<float> _paletteData;
+
+    // light uniform values of the frame, laid out as in Mesh
+    Vec3 _ambientLightColor;
+    Vec3 _unlitAmbientColor;
+    std::vector<Vec3> _dirLightColors;
+    std::vector<Vec3> _dirLightDirs;
+    std::vector<Vec3> _pointLightColors;
+    std::vector<Vec3> _pointLightPositions;
+    std::vector<float> _pointLightRangeInverses;
+    std::vector<Vec3> _spotLightColors;
+    std::vector<Vec3> _spotLightPositions;
+    std::vector<Vec3> _spotLightDirs;
+    std::vector<float> _spotLightInnerAngleCos;
+    std::vector<float> _spotLightOuterAngleCos;
+    std::vector<float> _spotLightRangeInverses;
+
+    backend::CullMode _savedCullMode = backend::CullMode::NONE;
+    unsigned int _lightMask = -1;
+    bool _cullFaceEnabled = true;
+    bool _instanced = false;
+};
+
+// end of 3d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSPRITE3DINSTANCEGROUP_H__
@@ -57,8 +57,10 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
+#include "platform/CCImage.h"
 #include "renderer/backend/ProgramCache.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -82,6 +84,9 @@ NS_CC_BEGIN
 // singleton stuff
 static Director *s_SharedDirector = nullptr;
 
+// modelview stack of a thread visiting nodes in parallel, see Director::beginThreadMatrixStack()
+static thread_local std::stack<Mat4>* t_modelViewMatrixStack = nullptr;
+
 #define kDefaultFPS        60  // 60 frames per second
 extern const char* cocos2dVersion();
 
@@ -471,7 +476,8 @@ void Director::popMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.pop();
+        auto& modelViewMatrixStack = t_modelViewMatrixStack ? *t_modelViewMatrixStack : _modelViewMatrixStack;
+        modelViewMatrixStack.pop();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -491,7 +497,8 @@ void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = Mat4::IDENTITY;
+        auto& modelViewMatrixStack = t_modelViewMatrixStack ? *t_modelViewMatrixStack : _modelViewMatrixStack;
+        modelViewMatrixStack.top() = Mat4::IDENTITY;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -512,7 +519,8 @@ void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() = mat;
+        auto& modelViewMatrixStack = t_modelViewMatrixStack ? *t_modelViewMatrixStack : _modelViewMatrixStack;
+        modelViewMatrixStack.top() = mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -532,7 +540,8 @@ void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.top() *= mat;
+        auto& modelViewMatrixStack = t_modelViewMatrixStack ? *t_modelViewMatrixStack : _modelViewMatrixStack;
+        modelViewMatrixStack.top() *= mat;
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -552,7 +561,8 @@ void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
     if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
+        auto& modelViewMatrixStack = t_modelViewMatrixStack ? *t_modelViewMatrixStack : _modelViewMatrixStack;
+        modelViewMatrixStack.push(modelViewMatrixStack.top());
     }
     else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
     {
@@ -572,7 +582,7 @@ const Mat4& Director::getMatrix(MATRIX_STACK_TYPE type) const
 {
     if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
-        return _modelViewMatrixStack.top();
+        return t_modelViewMatrixStack ? t_modelViewMatrixStack->top() : _modelViewMatrixStack.top();
     }
     else if(type == MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION)
     {
@@ -587,6 +597,22 @@ const Mat4& Director::getMatrix(MATRIX_STACK_TYPE type) const
     return  _modelViewMatrixStack.top();
 }
 
+void Director::beginThreadMatrixStack(const Mat4& modelView)
+{
+    static thread_local std::stack<Mat4> threadMatrixStack;
+    while (!threadMatrixStack.empty())
+    {
+        threadMatrixStack.pop();
+    }
+    threadMatrixStack.push(modelView);
+    t_modelViewMatrixStack = &threadMatrixStack;
+}
+
+void Director::endThreadMatrixStack()
+{
+    t_modelViewMatrixStack = nullptr;
+}
+
 void Director::setProjection(Projection projection)
 {
     Size size = _winSizeInPoints;
@@ -657,6 +683,7 @@ void Director::purgeCachedData()
         // There should be no test textures left in the cache
         log("%s\n", _textureCache->getCachedTextureInfo().c_str());
     }
+    DecodedImageCache::purgeCachedData();
     FileUtils::getInstance()->purgeCachedEntries();
 }
 
@@ -1020,6 +1047,8 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    JobSystem::destroyInstance();
+    DecodedImageCache::destroyInstance();
     backend::ProgramCache::destroyInstance();
     
     
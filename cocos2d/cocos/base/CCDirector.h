@@ -496,6 +496,28 @@ public:
      */
     void resetMatrixStack();
 
+    /**
+     * Makes the modelview matrix functions called from the calling thread use a stack of
+     * that thread, starting with the given matrix, until endThreadMatrixStack() is called
+     * on the same thread. Used to visit nodes on worker threads.
+     * @js NA
+     */
+    void beginThreadMatrixStack(const Mat4& modelView);
+
+    /**
+     * Makes the calling thread use the modelview matrix stack of the director again.
+     * @js NA
+     */
+    void endThreadMatrixStack();
+
+    /**
+     * Sets whether the children marked with Node::setParallelVisit() are visited on the
+     * JobSystem worker threads. Disabled by default.
+     * @js NA
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
     /**
      * returns the cocos2d thread id.
      Useful to know if certain code is already running on the cocos2d thread
@@ -644,6 +666,9 @@ protected:
     /* whether or not the director is in a valid state */
     bool _invalid = false;
 
+    /* whether children marked for it are visited in parallel */
+    bool _parallelVisitEnabled = false;
+
     // GLView will recreate stats labels to fit visible rect
     friend class GLView;
 };
@@ -0,0 +1,167 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCJobSystem.h"
+#include <algorithm>
+
+NS_CC_BEGIN
+
+// upper bound of worker threads, the per-frame batches are small
+static const unsigned int MAX_WORKER_COUNT = 7;
+
+static thread_local bool s_isWorkerThread = false;
+// set while the thread that called parallelFor runs chunks of its batch, it holds _dispatchMutex
+static thread_local bool s_isDispatchingThread = false;
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new (std::nothrow) JobSystem();
+    }
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_jobSystem;
+    s_jobSystem = nullptr;
+}
+
+bool JobSystem::isWorkerThread()
+{
+    return s_isWorkerThread;
+}
+
+JobSystem::JobSystem()
+: _generation(0)
+, _busyWorkers(0)
+, _stop(false)
+, _job(nullptr)
+, _count(0)
+, _grainSize(1)
+, _nextIndex(0)
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    unsigned int workerCount = cores > 1 ? std::min(cores - 1, MAX_WORKER_COUNT) : 0;
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::workerLoop()
+{
+    s_isWorkerThread = true;
+    unsigned int seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCondition.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+            if (_stop)
+                return;
+            seenGeneration = _generation;
+        }
+
+        runChunks();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (--_busyWorkers == 0)
+                _doneCondition.notify_one();
+        }
+    }
+}
+
+void JobSystem::runChunks()
+{
+    for (;;)
+    {
+        int begin = _nextIndex.fetch_add(_grainSize);
+        if (begin >= _count)
+            return;
+        int end = std::min(begin + _grainSize, _count);
+        for (int i = begin; i < end; ++i)
+        {
+            (*_job)(i);
+        }
+    }
+}
+
+void JobSystem::parallelFor(int count, const Job& job, int grainSize)
+{
+    if (count <= 0)
+        return;
+    grainSize = std::max(grainSize, 1);
+
+    // nothing to split, nested call from a job, or another batch in flight: run inline.
+    // A nested call on the dispatching thread must not try_lock the mutex it already owns.
+    std::unique_lock<std::mutex> dispatchLock(_dispatchMutex, std::defer_lock);
+    if (_workers.empty() || count <= grainSize || s_isWorkerThread || s_isDispatchingThread || !dispatchLock.try_lock())
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _job = &job;
+        _count = count;
+        _grainSize = grainSize;
+        _nextIndex.store(0);
+        _busyWorkers = static_cast<int>(_workers.size());
+        ++_generation;
+    }
+    _wakeCondition.notify_all();
+
+    s_isDispatchingThread = true;
+    runChunks();
+    s_isDispatchingThread = false;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return _busyWorkers == 0; });
+    _job = nullptr;
+}
+
+NS_CC_END
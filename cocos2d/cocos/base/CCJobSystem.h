@@ -0,0 +1,122 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCJOB_SYSTEM_H_
+#define __CCJOB_SYSTEM_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief A pool of worker threads for fork-join work inside a frame.
+ *
+ * Unlike AsyncTaskPool, whose tasks complete some time later, parallelFor() blocks until
+ * every job index has been processed, so it can be used to split per-frame work
+ * (animation, AI, visiting) across cores. The calling thread takes part in the work.
+ * @js NA
+ */
+class CC_DLL JobSystem
+{
+public:
+    typedef std::function<void(int)> Job;
+
+    /**
+     * Returns the shared instance of the job system.
+     */
+    static JobSystem* getInstance();
+
+    /**
+     * Destroys the job system, joining its worker threads.
+     */
+    static void destroyInstance();
+
+    /**
+     * Number of threads that take part in parallelFor(), including the calling thread.
+     */
+    int getThreadCount() const { return static_cast<int>(_workers.size()) + 1; }
+
+    /**
+     * Returns true when called from one of the worker threads.
+     */
+    static bool isWorkerThread();
+
+    /**
+     * Calls job(i) for every i in [0, count) and returns once all of them have finished.
+     *
+     * Indices are handed out in chunks of grainSize. Jobs must not touch shared state
+     * without their own synchronization. Calls made from a job (on a worker or on the
+     * thread running the batch), or while another parallelFor() is in flight, run
+     * serially on the calling thread.
+     *
+     * @param count number of job indices.
+     * @param job function called once per index, from any thread.
+     * @param grainSize number of consecutive indices claimed at once.
+     * @lua NA
+     */
+    void parallelFor(int count, const Job& job, int grainSize = 1);
+
+CC_CONSTRUCTOR_ACCESS:
+    JobSystem();
+    ~JobSystem();
+
+protected:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;   // workers wait for a new batch
+    std::condition_variable _doneCondition;   // caller waits for the workers to finish
+    unsigned int _generation;                 // incremented for every batch
+    int _busyWorkers;
+    bool _stop;
+
+    std::mutex _dispatchMutex;                // one batch in flight at a time
+
+    const Job* _job;
+    int _count;
+    int _grainSize;
+    std::atomic<int> _nextIndex;
+
+    static JobSystem* s_jobSystem;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif //__CCJOB_SYSTEM_H_
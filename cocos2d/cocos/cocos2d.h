@@ -40,6 +40,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -251,6 +252,7 @@ THE SOFTWARE.
 //3d
 #include "3d/CCAABB.h"
 #include "3d/CCAnimate3D.h"
+#include "3d/CCAnimator3D.h"
 #include "3d/CCAnimation3D.h"
 #include "3d/CCAttachNode.h"
 #include "3d/CCBillBoard.h"
@@ -265,6 +267,7 @@ THE SOFTWARE.
 #include "3d/CCSkeleton3D.h"
 #include "3d/CCSkybox.h"
 #include "3d/CCSprite3D.h"
+#include "3d/CCSprite3DInstanceGroup.h"
 #include "3d/CCSprite3DMaterial.h"
 #include "3d/CCTerrain.h"
 #include "3d/CCVertexAttribBinding.h"
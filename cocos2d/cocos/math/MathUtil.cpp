@@ -206,6 +206,20 @@ void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
 #endif
 }
 
+void MathUtil::multiplyMatrixPalette(const float* m1, const float* m2, float* dst)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::multiplyMatrixPalette(m1, m2, dst);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::multiplyMatrixPalette(m1, m2, dst);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::multiplyMatrixPalette(m1, m2, dst);
+    else MathUtilC::multiplyMatrixPalette(m1, m2, dst);
+#else
+    MathUtilC::multiplyMatrixPalette(m1, m2, dst);
+#endif
+}
+
 void MathUtil::negateMatrix(const float* m, float* dst)
 {
 #ifdef USE_NEON32
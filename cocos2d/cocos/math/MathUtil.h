@@ -88,6 +88,24 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
+
+    /**
+     * Multiplies m1 by m2 and writes the first three rows of the product
+     * (12 floats, row-major) to dst, the layout of a skinning matrix palette entry.
+     * dst must not alias m1 or m2.
+     *
+     * @param m1 the first column-major matrix (16 floats).
+     * @param m2 the second column-major matrix (16 floats).
+     * @param dst receives the 3 palette rows.
+     */
+    static void multiplyMatrixPalette(const float* m1, const float* m2, float* dst);
+
+#ifdef __SSE__
+    /**
+     * SSE version of multiplyMatrixPalette, taking the matrix columns (Mat4::col).
+     */
+    static void multiplyMatrixPalette(const __m128 m1[4], const __m128 m2[4], float* dst);
+#endif
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
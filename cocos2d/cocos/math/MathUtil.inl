@@ -42,6 +42,8 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void multiplyMatrixPalette(const float* m1, const float* m2, float* dst);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -152,6 +154,19 @@ inline void MathUtilC::multiplyMatrix(const float* m1, const float* m2, float* d
     memcpy(dst, product, MATRIX_SIZE);
 }
 
+inline void MathUtilC::multiplyMatrixPalette(const float* m1, const float* m2, float* dst)
+{
+    // Row r of the product is (M[r], M[r+4], M[r+8], M[r+12]), the fourth row is not needed.
+    for (int r = 0; r < 3; ++r)
+    {
+        float* row = dst + r * 4;
+        row[0] = m1[r] * m2[0]  + m1[r + 4] * m2[1]  + m1[r + 8] * m2[2]  + m1[r + 12] * m2[3];
+        row[1] = m1[r] * m2[4]  + m1[r + 4] * m2[5]  + m1[r + 8] * m2[6]  + m1[r + 12] * m2[7];
+        row[2] = m1[r] * m2[8]  + m1[r + 4] * m2[9]  + m1[r + 8] * m2[10] + m1[r + 12] * m2[11];
+        row[3] = m1[r] * m2[12] + m1[r + 4] * m2[13] + m1[r + 8] * m2[14] + m1[r + 12] * m2[15];
+    }
+}
+
 inline void MathUtilC::negateMatrix(const float* m, float* dst)
 {
     dst[0]  = -m[0];
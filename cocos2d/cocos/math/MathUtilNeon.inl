@@ -41,6 +41,8 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void multiplyMatrixPalette(const float* m1, const float* m2, float* dst);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -165,6 +167,44 @@ inline void MathUtilNeon::multiplyMatrix(const float* m1, const float* m2, float
                  );
 }
 
+inline void MathUtilNeon::multiplyMatrixPalette(const float* m1, const float* m2, float* dst)
+{
+    asm volatile(
+                 "vld1.32     {d16 - d19}, [%1]! \n\t"       // M1[m0-m7]
+                 "vld1.32     {d20 - d23}, [%1]  \n\t"       // M1[m8-m15]
+                 "vld1.32     {d0 - d3}, [%2]!   \n\t"       // M2[m0-m7]
+                 "vld1.32     {d4 - d7}, [%2]    \n\t"       // M2[m8-m15]
+                 
+                 "vmul.f32    q12, q8, d0[0]     \n\t"         // T[m0-m3] = M1[m0-m3] * M2[m0]
+                 "vmul.f32    q13, q8, d2[0]     \n\t"         // T[m4-m7] = M1[m4-m7] * M2[m4]
+                 "vmul.f32    q14, q8, d4[0]     \n\t"         // T[m8-m11] = M1[m8-m11] * M2[m8]
+                 "vmul.f32    q15, q8, d6[0]     \n\t"         // T[m12-m15] = M1[m12-m15] * M2[m12]
+                 
+                 "vmla.f32    q12, q9, d0[1]     \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m1]
+                 "vmla.f32    q13, q9, d2[1]     \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m5]
+                 "vmla.f32    q14, q9, d4[1]     \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m9]
+                 "vmla.f32    q15, q9, d6[1]     \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m13]
+                 
+                 "vmla.f32    q12, q10, d1[0]    \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m2]
+                 "vmla.f32    q13, q10, d3[0]    \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m6]
+                 "vmla.f32    q14, q10, d5[0]    \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m10]
+                 "vmla.f32    q15, q10, d7[0]    \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m14]
+                 
+                 "vmla.f32    q12, q11, d1[1]    \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m3]
+                 "vmla.f32    q13, q11, d3[1]    \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m7]
+                 "vmla.f32    q14, q11, d5[1]    \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m11]
+                 "vmla.f32    q15, q11, d7[1]    \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m15]
+                 
+                 "vst4.32     {d24[0], d26[0], d28[0], d30[0]}, [%0]! \n\t" // DST[0-3] = T[m0, m4, m8, m12]
+                 "vst4.32     {d24[1], d26[1], d28[1], d30[1]}, [%0]! \n\t" // DST[4-7] = T[m1, m5, m9, m13]
+                 "vst4.32     {d25[0], d27[0], d29[0], d31[0]}, [%0]  \n\t" // DST[8-11] = T[m2, m6, m10, m14]
+                 
+                 : "+r"(dst), "+r"(m1), "+r"(m2) // post-increment addressing advances the pointers
+                 :
+                 : "memory", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+                 );
+}
+
 inline void MathUtilNeon::negateMatrix(const float* m, float* dst)
 {
     asm volatile(
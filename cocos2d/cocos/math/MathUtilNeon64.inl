@@ -42,6 +42,8 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void multiplyMatrixPalette(const float* m1, const float* m2, float* dst);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -151,6 +153,42 @@ inline void MathUtilNeon64::multiplyMatrix(const float* m1, const float* m2, flo
      );
 }
 
+inline void MathUtilNeon64::multiplyMatrixPalette(const float* m1, const float* m2, float* dst)
+{
+    asm volatile(
+        "ld1     {v8.4s, v9.4s, v10.4s, v11.4s}, [%1] \n\t"       // M1[m0-m7] M1[m8-m15]
+        "ld4     {v0.4s, v1.4s, v2.4s, v3.4s},  [%2]   \n\t"       // M2[m0-m15]
+
+        "fmul    v12.4s, v8.4s, v0.s[0]     \n\t"         // T[m0-m3] = M1[m0-m3] * M2[m0]
+        "fmul    v13.4s, v8.4s, v0.s[1]     \n\t"         // T[m4-m7] = M1[m4-m7] * M2[m4]
+        "fmul    v14.4s, v8.4s, v0.s[2]     \n\t"         // T[m8-m11] = M1[m8-m11] * M2[m8]
+        "fmul    v15.4s, v8.4s, v0.s[3]     \n\t"         // T[m12-m15] = M1[m12-m15] * M2[m12]
+
+        "fmla    v12.4s, v9.4s, v1.s[0]     \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m1]
+        "fmla    v13.4s, v9.4s, v1.s[1]     \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m5]
+        "fmla    v14.4s, v9.4s, v1.s[2]     \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m9]
+        "fmla    v15.4s, v9.4s, v1.s[3]     \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m13]
+
+        "fmla    v12.4s, v10.4s, v2.s[0]    \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m2]
+        "fmla    v13.4s, v10.4s, v2.s[1]    \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m6]
+        "fmla    v14.4s, v10.4s, v2.s[2]    \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m10]
+        "fmla    v15.4s, v10.4s, v2.s[3]    \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m14]
+
+        "fmla    v12.4s, v11.4s, v3.s[0]    \n\t"         // T[m0-m3] += M1[m0-m3] * M2[m3]
+        "fmla    v13.4s, v11.4s, v3.s[1]    \n\t"         // T[m4-m7] += M1[m4-m7] * M2[m7]
+        "fmla    v14.4s, v11.4s, v3.s[2]    \n\t"         // T[m8-m11] += M1[m8-m11] * M2[m11]
+        "fmla    v15.4s, v11.4s, v3.s[3]    \n\t"         // T[m12-m15] += M1[m12-m15] * M2[m15]
+
+        "st4     {v12.s, v13.s, v14.s, v15.s}[0], [%0], #16 \n\t" // DST[0-3] = T[m0, m4, m8, m12]
+        "st4     {v12.s, v13.s, v14.s, v15.s}[1], [%0], #16 \n\t" // DST[4-7] = T[m1, m5, m9, m13]
+        "st4     {v12.s, v13.s, v14.s, v15.s}[2], [%0]      \n\t" // DST[8-11] = T[m2, m6, m10, m14]
+
+        : "+r"(dst) // post-increment addressing advances the pointer
+        : "r"(m1), "r"(m2)
+        : "memory", "v0", "v1", "v2", "v3", "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15"
+     );
+}
+
 inline void MathUtilNeon64::negateMatrix(const float* m, float* dst)
 {
     asm volatile(
@@ -116,6 +116,17 @@ void MathUtil::multiplyMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst
     dst[3] = dst3;
 }
 
+void MathUtil::multiplyMatrixPalette(const __m128 m1[4], const __m128 m2[4], float* dst)
+{
+    __m128 col[4];
+    multiplyMatrix(m1, m2, col);
+    // columns -> rows, the fourth row is dropped
+    _MM_TRANSPOSE4_PS(col[0], col[1], col[2], col[3]);
+    _mm_storeu_ps(dst, col[0]);
+    _mm_storeu_ps(dst + 4, col[1]);
+    _mm_storeu_ps(dst + 8, col[2]);
+}
+
 void MathUtil::negateMatrix(const __m128 m[4], __m128 dst[4])
 {
     __m128 z = _mm_setzero_ps();
@@ -2197,5 +2197,332 @@ void Image::setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
     _PVRHaveAlphaPremultiplied = haveAlphaPremultiplied;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// header probing
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+    // Bytes read before looking at the header. Enough for every supported format except JPEG files
+    // with large metadata segments in front of the frame header; those are read completely.
+    static const size_t PROBE_HEAD_SIZE = 4096;
+
+    enum ProbeResult
+    {
+        PROBE_UNKNOWN,  // not a supported header
+        PROBE_OK,
+        PROBE_NEED_MORE // supported format, but the dimensions lie beyond the buffer
+    };
+
+    uint16_t readBE16(const unsigned char* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+    uint32_t readBE32(const unsigned char* p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]; }
+    uint16_t readLE16(const unsigned char* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    uint32_t readLE24(const unsigned char* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16); }
+
+    ProbeResult probePng(const unsigned char* data, ssize_t dataLen, Image::ProbeInfo* info)
+    {
+        static const unsigned char PNG_SIGNATURE[] = {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a};
+        if (dataLen < 8 || memcmp(data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0)
+            return PROBE_UNKNOWN;
+        // IHDR is always the first chunk: length(4) type(4) width(4) height(4)
+        if (dataLen < 24)
+            return PROBE_NEED_MORE;
+        if (memcmp(data + 12, "IHDR", 4) != 0)
+            return PROBE_UNKNOWN;
+
+        info->format = Image::Format::PNG;
+        info->width = (int)readBE32(data + 16);
+        info->height = (int)readBE32(data + 20);
+        return PROBE_OK;
+    }
+
+    ProbeResult probeJpg(const unsigned char* data, ssize_t dataLen, Image::ProbeInfo* info)
+    {
+        if (dataLen < 2 || data[0] != 0xFF || data[1] != 0xD8)
+            return PROBE_UNKNOWN;
+
+        // walk the marker segments until the first start-of-frame
+        ssize_t pos = 2;
+        while (true)
+        {
+            if (pos >= dataLen)
+                return PROBE_NEED_MORE;
+            if (data[pos] != 0xFF)
+                return PROBE_UNKNOWN;
+            while (pos < dataLen && data[pos] == 0xFF)
+                ++pos;
+            if (pos >= dataLen)
+                return PROBE_NEED_MORE;
+
+            const unsigned char marker = data[pos++];
+            // markers without a payload
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+                continue;
+            // end of image or start of scan before any frame header
+            if (marker == 0xD9 || marker == 0xDA)
+                return PROBE_UNKNOWN;
+
+            if (pos + 2 > dataLen)
+                return PROBE_NEED_MORE;
+            const uint16_t segmentLen = readBE16(data + pos);
+            if (segmentLen < 2)
+                return PROBE_UNKNOWN;
+
+            // SOF0..SOF15, except DHT (C4), JPG (C8) and DAC (CC)
+            if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+            {
+                // length(2) precision(1) height(2) width(2)
+                if (pos + 7 > dataLen)
+                    return PROBE_NEED_MORE;
+                info->format = Image::Format::JPG;
+                info->height = readBE16(data + pos + 3);
+                info->width = readBE16(data + pos + 5);
+                return PROBE_OK;
+            }
+            pos += segmentLen;
+        }
+    }
+
+    ProbeResult probeWebp(const unsigned char* data, ssize_t dataLen, Image::ProbeInfo* info)
+    {
+        if (dataLen < 16 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WEBP", 4) != 0)
+            return PROBE_UNKNOWN;
+        if (dataLen < 30)
+            return PROBE_NEED_MORE;
+
+        const unsigned char* chunk = data + 12;
+        if (memcmp(chunk, "VP8 ", 4) == 0)
+        {
+            // lossy: frame tag(3), start code 9d 01 2a, then 14-bit width and height
+            if (data[23] != 0x9d || data[24] != 0x01 || data[25] != 0x2a)
+                return PROBE_UNKNOWN;
+            info->width = readLE16(data + 26) & 0x3FFF;
+            info->height = readLE16(data + 28) & 0x3FFF;
+        }
+        else if (memcmp(chunk, "VP8L", 4) == 0)
+        {
+            // lossless: signature 0x2f, then 14-bit width-1 and height-1
+            if (data[20] != 0x2f)
+                return PROBE_UNKNOWN;
+            const unsigned char* b = data + 21;
+            info->width = 1 + (int)(b[0] | ((b[1] & 0x3F) << 8));
+            info->height = 1 + (int)((b[1] >> 6) | (b[2] << 2) | ((b[3] & 0x0F) << 10));
+        }
+        else if (memcmp(chunk, "VP8X", 4) == 0)
+        {
+            // extended: flags(4), then 24-bit canvas width-1 and height-1
+            info->width = 1 + (int)readLE24(data + 24);
+            info->height = 1 + (int)readLE24(data + 27);
+        }
+        else
+        {
+            return PROBE_UNKNOWN;
+        }
+
+        info->format = Image::Format::WEBP;
+        return PROBE_OK;
+    }
+
+    ProbeResult probePvr(const unsigned char* data, ssize_t dataLen, Image::ProbeInfo* info)
+    {
+        // copy the headers out, the buffer may not be aligned
+        if (static_cast<size_t>(dataLen) >= sizeof(PVRv2TexHeader))
+        {
+            PVRv2TexHeader header;
+            memcpy(&header, data, sizeof(header));
+            if (memcmp(&header.pvrTag, gPVRTexIdentifier, strlen(gPVRTexIdentifier)) == 0)
+            {
+                info->format = Image::Format::PVR;
+                info->width = (int)CC_SWAP_INT32_LITTLE_TO_HOST(header.width);
+                info->height = (int)CC_SWAP_INT32_LITTLE_TO_HOST(header.height);
+                return PROBE_OK;
+            }
+        }
+
+        if (static_cast<size_t>(dataLen) >= sizeof(PVRv3TexHeader))
+        {
+            PVRv3TexHeader header;
+            memcpy(&header, data, sizeof(header));
+            if (CC_SWAP_INT32_BIG_TO_HOST(header.version) == 0x50565203)
+            {
+                info->format = Image::Format::PVR;
+                info->width = (int)CC_SWAP_INT32_LITTLE_TO_HOST(header.width);
+                info->height = (int)CC_SWAP_INT32_LITTLE_TO_HOST(header.height);
+                return PROBE_OK;
+            }
+        }
+        return PROBE_UNKNOWN;
+    }
+
+    ProbeResult probeHeader(const unsigned char* data, ssize_t dataLen, Image::ProbeInfo* info)
+    {
+        if (!data || dataLen <= 0)
+            return PROBE_UNKNOWN;
+
+        ProbeResult result = probePng(data, dataLen, info);
+        if (result == PROBE_UNKNOWN)
+            result = probeJpg(data, dataLen, info);
+        if (result == PROBE_UNKNOWN)
+            result = probeWebp(data, dataLen, info);
+        if (result == PROBE_UNKNOWN)
+            result = probePvr(data, dataLen, info);
+        return result;
+    }
+}
+
+bool Image::probeData(const unsigned char* data, ssize_t dataLen, ProbeInfo* info)
+{
+    if (!info)
+        return false;
+
+    ProbeInfo result;
+    if (probeHeader(data, dataLen, &result) != PROBE_OK)
+        return false;
+
+    *info = result;
+    return true;
+}
+
+bool Image::probeFile(const std::string& path, ProbeInfo* info)
+{
+    if (!info)
+        return false;
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string fullPath = fileUtils->fullPathForFilename(path);
+    if (fullPath.empty())
+        return false;
+
+    ProbeInfo result;
+    ProbeResult probe = PROBE_NEED_MORE;
+
+    // read only the head of files on disk; files that can't be opened directly
+    // (such as those packed in the apk) fall back to a full read below
+    FILE* fp = fopen(fileUtils->getSuitableFOpen(fullPath).c_str(), "rb");
+    if (fp)
+    {
+        unsigned char head[PROBE_HEAD_SIZE];
+        size_t headLen = fread(head, 1, sizeof(head), fp);
+        fclose(fp);
+
+        probe = probeHeader(head, (ssize_t)headLen, &result);
+        if (probe == PROBE_NEED_MORE && headLen < sizeof(head))
+            probe = PROBE_UNKNOWN;    // the whole file was read
+    }
+
+    if (probe == PROBE_NEED_MORE)
+    {
+        Data data = fileUtils->getDataFromFile(fullPath);
+        probe = probeHeader(data.getBytes(), data.getSize(), &result);
+    }
+
+    if (probe != PROBE_OK)
+        return false;
+
+    *info = result;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// DecodedImageCache
+//////////////////////////////////////////////////////////////////////////
+
+DecodedImageCache* DecodedImageCache::s_instance = nullptr;
+std::mutex DecodedImageCache::s_instanceMutex;
+
+DecodedImageCache* DecodedImageCache::getInstance()
+{
+    // the first call may come from a loading thread
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (s_instance == nullptr)
+    {
+        s_instance = new (std::nothrow) DecodedImageCache();
+    }
+    return s_instance;
+}
+
+void DecodedImageCache::destroyInstance()
+{
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    CC_SAFE_DELETE(s_instance);
+}
+
+void DecodedImageCache::purgeCachedData()
+{
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (s_instance)
+    {
+        s_instance->removeAll();
+    }
+}
+
+DecodedImageCache::DecodedImageCache()
+{
+}
+
+DecodedImageCache::~DecodedImageCache()
+{
+    removeAll();
+}
+
+bool DecodedImageCache::preload(const std::string& path)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+    if (fullPath.empty())
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_images.find(fullPath) != _images.end())
+            return true;
+    }
+
+    // decode outside the lock so that several threads can preload at once
+    Image* image = new (std::nothrow) Image();
+    if (!image || !image->initWithImageFile(fullPath))
+    {
+        CC_SAFE_RELEASE(image);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_images.emplace(fullPath, image).second)
+    {
+        // another thread preloaded the same file meanwhile
+        image->release();
+    }
+    return true;
+}
+
+Image* DecodedImageCache::take(const std::string& path)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _images.find(fullPath);
+    if (it == _images.end())
+        return nullptr;
+
+    Image* image = it->second;
+    _images.erase(it);
+    return image;
+}
+
+void DecodedImageCache::remove(const std::string& path)
+{
+    Image* image = take(path);
+    CC_SAFE_RELEASE(image);
+}
+
+void DecodedImageCache::removeAll()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& it : _images)
+    {
+        it.second->release();
+    }
+    _images.clear();
+}
+
 NS_CC_END
 
@@ -28,6 +28,10 @@ THE SOFTWARE.
 #define __CC_IMAGE_H__
 /// @cond DO_NOT_SHOW
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 
@@ -110,6 +114,30 @@ public:
      */
     static void setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied);
 
+    /** Image format and dimensions read from a file header. */
+    struct ProbeInfo
+    {
+        Format format = Format::UNKNOWN;
+        int width = 0;
+        int height = 0;
+    };
+
+    /**
+    @brief Reads only the header of an image file to get its format and dimensions, without decoding any pixels.
+    Supports PNG, JPEG, WebP and PVR (v2 and v3). Compressed (ccz / gzip) and other formats are not recognized.
+    It is thread safe.
+    @param path   the file path, resolved with FileUtils.
+    @param info   receives the format and dimensions.
+    @return true if the header was recognized.
+    */
+    static bool probeFile(const std::string& path, ProbeInfo* info);
+
+    /**
+    @brief Same as probeFile, but reads from a buffer holding the beginning of the file.
+    @return true if the header was recognized within the buffer.
+    */
+    static bool probeData(const unsigned char* data, ssize_t dataLen, ProbeInfo* info);
+
     /**
     @brief Load the image from the specified path.
     @param path   the absolute file path.
@@ -222,6 +250,49 @@ protected:
     bool isATITC(const unsigned char *data, ssize_t dataLen);
 };
 
+/**
+ * Decoded images waiting to be uploaded, keyed by full path.
+ *
+ * Lets image decoding run ahead of texture creation (for example on a loading thread) so that the
+ * consumer, such as TextureCube, takes the pixels instead of decoding the file a second time.
+ * Images are handed over with take() and leave the cache, so pixel memory is released after upload.
+ * All methods are thread safe.
+ */
+class CC_DLL DecodedImageCache
+{
+public:
+    static DecodedImageCache* getInstance();
+    static void destroyInstance();
+
+    /** Releases the cached images if the cache has been created, without creating it. */
+    static void purgeCachedData();
+
+    /**
+    @brief Decodes the file and keeps the image until it is taken. Does nothing if it is already cached.
+    @return true if the image is in the cache.
+    */
+    bool preload(const std::string& path);
+
+    /**
+    @brief Removes the image from the cache and hands it over.
+    @return the image with one reference owned by the caller, or nullptr if the file was not preloaded.
+    */
+    Image* take(const std::string& path);
+
+    void remove(const std::string& path);
+    void removeAll();
+
+protected:
+    DecodedImageCache();
+    ~DecodedImageCache();
+
+    static DecodedImageCache* s_instance;
+    static std::mutex s_instanceMutex;
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Image*> _images;
+};
+
 // end of platform group
 /// @}
 
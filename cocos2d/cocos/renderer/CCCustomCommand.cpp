@@ -39,6 +39,7 @@ CustomCommand::~CustomCommand()
 {
     CC_SAFE_RELEASE(_vertexBuffer);
     CC_SAFE_RELEASE(_indexBuffer);
+    CC_SAFE_RELEASE(_instanceBuffer);
 }
 
 void CustomCommand::init(float depth, const cocos2d::Mat4 &modelViewTransform, unsigned int flags)
@@ -118,6 +119,19 @@ void CustomCommand::setIndexBuffer(backend::Buffer *indexBuffer, IndexFormat for
     _indexSize = computeIndexSize();
 }
 
+void CustomCommand::setInstanceDrawInfo(backend::Buffer* instanceBuffer, const backend::VertexLayout* instanceLayout, std::size_t instanceCount)
+{
+    if (_instanceBuffer != instanceBuffer)
+    {
+        CC_SAFE_RETAIN(instanceBuffer);
+        CC_SAFE_RELEASE(_instanceBuffer);
+        _instanceBuffer = instanceBuffer;
+    }
+
+    _instanceLayout = instanceLayout;
+    _instanceCount = instanceCount;
+}
+
 void CustomCommand::updateVertexBuffer(void* data, std::size_t length)
 {
     assert(_vertexBuffer);
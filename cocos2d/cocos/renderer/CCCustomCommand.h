@@ -36,6 +36,7 @@ NS_CC_BEGIN
 namespace backend
 {
     class Buffer;
+    class VertexLayout;
 }
 
 /**
@@ -192,6 +193,18 @@ public:
 
     inline IndexFormat getIndexFormat() const { return _indexFormat; }
 
+    /**
+    Draw several instances of the indices if the drawing type is ELEMENT. Only works if
+    the device supports backend::FeatureType::INSTANCING.
+    @instanceBuffer the buffer holding the per-instance attributes, it will be retained
+    @instanceLayout the layout of the per-instance attributes, should outlive the command
+    @instanceCount the number of instances to draw, 0 to draw without instancing
+    */
+    void setInstanceDrawInfo(backend::Buffer* instanceBuffer, const backend::VertexLayout* instanceLayout, std::size_t instanceCount);
+    inline backend::Buffer* getInstanceBuffer() const { return _instanceBuffer; }
+    inline const backend::VertexLayout* getInstanceLayout() const { return _instanceLayout; }
+    inline std::size_t getInstanceCount() const { return _instanceCount; }
+
     /**Callback function.*/
     //TODO:minggo: should remove it.
     std::function<void()> func;
@@ -215,6 +228,9 @@ protected:
 
     backend::Buffer* _vertexBuffer = nullptr;
     backend::Buffer* _indexBuffer = nullptr;
+    backend::Buffer* _instanceBuffer = nullptr;
+    const backend::VertexLayout* _instanceLayout = nullptr;
+    std::size_t _instanceCount = 0;
     
     std::size_t _vertexDrawStart = 0;
     std::size_t _vertexDrawCount = 0;
@@ -25,6 +25,7 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCCustomCommand.h"
@@ -50,14 +51,181 @@
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
-{
-    return a->getGlobalOrder() < b->getGlobalOrder();
-}
+namespace
+{
+    // the list the calling thread records into, see Renderer::beginRecording()
+    thread_local RenderCommandList* t_recordingList = nullptr;
+
+    // Sort key layout, from the most significant bit:
+    //   63-61 layer (the queue group), 60 translucency (transparent 3D only), then
+    //   opaque 3D:  59-52 depth bucket, 51-36 program, 35-20 texture, 19-0 material
+    //   the others: 59-28 global order, or view depth for transparent 3D
+    const int LAYER_SHIFT = 61;
+    const int TRANSLUCENT_SHIFT = 60;
+    const int DEPTH_BUCKET_SHIFT = 52;
+    const int PROGRAM_SHIFT = 36;
+    const int TEXTURE_SHIFT = 20;
+    const int ORDER_SHIFT = 28;
+
+    const int PROGRAM_BITS = 16;
+    const int TEXTURE_BITS = 16;
+    const int MATERIAL_BITS = 20;
+
+    // Maps a float to an unsigned integer with the same order.
+    uint32_t orderedFloatBits(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
-{
-    return  a->getDepth() > b->getDepth();
+    // Equal values give equal ids, different values rarely collide.
+    uint64_t compactID(uint64_t value, int bits)
+    {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        return value & ((1ULL << bits) - 1);
+    }
+
+    uint64_t compactID(const void* object, int bits)
+    {
+        return compactID((uint64_t)(uintptr_t)object, bits);
+    }
+
+    // The texture in slot 0 and a hash of the textures in the other slots.
+    // ProgramGL reports every uniform as a vertex stage uniform, so on GL the textures
+    // are in the vertex texture infos, on Metal in the fragment ones: look at both.
+    void textureIDs(const backend::ProgramState* programState, uint64_t& mainTexture, uint64_t& otherTextures)
+    {
+        for (const auto textureInfos : { &programState->getVertexTextureInfos(), &programState->getFragmentTextureInfos() })
+        {
+            for (const auto& iter : *textureInfos)
+            {
+                const auto& info = iter.second;
+                for (size_t i = 0; i < info.textures.size() && i < info.slot.size(); ++i)
+                {
+                    if (info.slot[i] == 0)
+                        mainTexture = compactID(info.textures[i], TEXTURE_BITS);
+                    else
+                        // xor keeps the hash independent of the map order
+                        otherTextures ^= compactID((uint64_t)(uintptr_t)info.textures[i] + info.slot[i], 64);
+                }
+            }
+        }
+    }
+
+    // Blend state packed into an integer, all the disabled blend states are equal.
+    uint64_t blendID(const backend::BlendDescriptor& blend)
+    {
+        uint64_t value = (uint64_t)blend.writeMask;
+        if (blend.blendEnabled)
+        {
+            value |= 1ULL << 8;
+            value |= (uint64_t)blend.rgbBlendOperation << 12;
+            value |= (uint64_t)blend.alphaBlendOperation << 16;
+            value |= (uint64_t)blend.sourceRGBBlendFactor << 20;
+            value |= (uint64_t)blend.destinationRGBBlendFactor << 28;
+            value |= (uint64_t)blend.sourceAlphaBlendFactor << 36;
+            value |= (uint64_t)blend.destinationAlphaBlendFactor << 44;
+        }
+        return value;
+    }
+
+    // Coarse distance from the camera: the exponent and first mantissa bit of the depth,
+    // so every bucket covers half an octave and nearby objects still group by state.
+    uint64_t depthBucket(float depth)
+    {
+        if (!(depth > 0.0f))
+            return 0;
+
+        uint32_t bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        int bucket = (int)(bits >> 22) - 200;
+        return (uint64_t)std::max(0, std::min(bucket, 255));
+    }
+
+    uint64_t makeSortKey(RenderQueue::QUEUE_GROUP group, RenderCommand* command)
+    {
+        uint64_t key = (uint64_t)group << LAYER_SHIFT;
+
+        switch (group)
+        {
+            case RenderQueue::QUEUE_GROUP::OPAQUE_3D:
+            {
+                const auto& pipelineDescriptor = command->getPipelineDescriptor();
+                const auto programState = pipelineDescriptor.programState;
+                uint64_t program = 0;
+                uint64_t texture = 0;
+                uint64_t otherTextures = 0;
+                if (programState)
+                {
+                    program = compactID(programState->getProgram(), PROGRAM_BITS);
+                    textureIDs(programState, texture, otherTextures);
+                }
+                // the state shared between draws besides program and main texture,
+                // uniform values differ per draw and are left out
+                uint64_t material = compactID(otherTextures ^ blendID(pipelineDescriptor.blendDescriptor), MATERIAL_BITS);
+                // triangles with the same material id are batched together
+                if (command->getType() == RenderCommand::Type::TRIANGLES_COMMAND)
+                    material = static_cast<TrianglesCommand*>(command)->getMaterialID();
+
+                key |= depthBucket(command->getDepth()) << DEPTH_BUCKET_SHIFT;
+                key |= program << PROGRAM_SHIFT;
+                key |= texture << TEXTURE_SHIFT;
+                key |= material & ((1ULL << MATERIAL_BITS) - 1);
+                break;
+            }
+            case RenderQueue::QUEUE_GROUP::TRANSPARENT_3D:
+                // back to front
+                key |= 1ULL << TRANSLUCENT_SHIFT;
+                key |= (uint64_t)~orderedFloatBits(command->getDepth()) << ORDER_SHIFT;
+                break;
+            default:
+                // 2D commands keep their order within the same global order, translucent or not
+                key |= (uint64_t)orderedFloatBits(command->getGlobalOrder()) << ORDER_SHIFT;
+                break;
+        }
+        return key;
+    }
+
+    // Stable LSD radix sort on 8 bit digits, skipping the digits all keys share.
+    // Returns the buffer holding the result, either entries or scratch.
+    template <typename Entry>
+    Entry* radixSortByKey(Entry* entries, Entry* scratch, size_t count)
+    {
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            size_t offsets[256] = { 0 };
+            for (size_t i = 0; i < count; ++i)
+                ++offsets[(entries[i].key >> shift) & 0xFF];
+
+            if (offsets[(entries[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t offset = 0;
+            for (auto& bucket : offsets)
+            {
+                size_t bucketSize = bucket;
+                bucket = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                scratch[offsets[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+            std::swap(entries, scratch);
+        }
+        return entries;
+    }
+
+    // Callback and group commands may change state for the commands around them.
+    bool isReorderable(RenderCommand* command)
+    {
+        auto type = command->getType();
+        return type == RenderCommand::Type::MESH_COMMAND ||
+               type == RenderCommand::Type::CUSTOM_COMMAND ||
+               type == RenderCommand::Type::TRIANGLES_COMMAND;
+    }
 }
 
 // queue
@@ -110,9 +278,57 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortByKey(QUEUE_GROUP::OPAQUE_3D);
+    sortByKey(QUEUE_GROUP::TRANSPARENT_3D);
+    sortByKey(QUEUE_GROUP::GLOBALZ_NEG);
+    sortByKey(QUEUE_GROUP::GLOBALZ_POS);
+}
+
+void RenderQueue::sortByKey(QUEUE_GROUP group)
+{
+    auto& commands = _commands[group];
+    if (group != QUEUE_GROUP::OPAQUE_3D)
+    {
+        sortRange(group, 0, commands.size());
+        return;
+    }
+
+    // Opaque commands are depth tested and can be reordered, but only between the
+    // commands that must stay in place.
+    size_t begin = 0;
+    for (size_t i = 0; i <= commands.size(); ++i)
+    {
+        if (i == commands.size() || !isReorderable(commands[i]))
+        {
+            sortRange(group, begin, i);
+            begin = i + 1;
+        }
+    }
+}
+
+void RenderQueue::sortRange(QUEUE_GROUP group, size_t begin, size_t end)
+{
+    if (end <= begin + 1)
+        return;
+
+    auto& commands = _commands[group];
+    size_t count = end - begin;
+    if (_sortEntries.size() < count)
+    {
+        _sortEntries.resize(count);
+        _sortScratch.resize(count);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto command = commands[begin + i];
+        _sortEntries[i].key = makeSortKey(group, command);
+        _sortEntries[i].command = command;
+    }
+
+    auto sorted = radixSortByKey(_sortEntries.data(), _sortScratch.data(), count);
+    for (size_t i = 0; i < count; ++i)
+        commands[begin + i] = sorted[i].command;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -196,7 +412,7 @@ void Renderer::init()
 
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueueID =_commandGroupStack.top();
+    int renderQueueID = t_recordingList ? t_recordingList->_groupStack.back() : _commandGroupStack.top();
     addCommand(command, renderQueueID);
 }
 
@@ -206,23 +422,67 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
     CCASSERT(renderQueueID >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (t_recordingList)
+    {
+        t_recordingList->_entries.push_back({command, renderQueueID});
+        return;
+    }
+
     _renderGroups[renderQueueID].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (t_recordingList)
+    {
+        t_recordingList->_groupStack.push_back(renderQueueID);
+        return;
+    }
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (t_recordingList)
+    {
+        CCASSERT(t_recordingList->_groupStack.size() > 1, "Cannot pop a render queue pushed before recording");
+        t_recordingList->_groupStack.pop_back();
+        return;
+    }
     _commandGroupStack.pop();
 }
 
+void Renderer::beginRecording(RenderCommandList* commandList)
+{
+    CCASSERT(!t_recordingList, "Already recording");
+    commandList->_entries.clear();
+    commandList->_groupStack.clear();
+    commandList->_groupStack.push_back(_commandGroupStack.top());
+    t_recordingList = commandList;
+}
+
+void Renderer::endRecording()
+{
+    t_recordingList = nullptr;
+}
+
+bool Renderer::isRecording() const
+{
+    return t_recordingList != nullptr;
+}
+
+void Renderer::addCommands(const RenderCommandList& commandList)
+{
+    CCASSERT(!t_recordingList, "Cannot add recorded commands while recording");
+    for (const auto& entry : commandList._entries)
+        addCommand(entry.command, entry.renderQueueID);
+}
+
 int Renderer::createRenderQueue()
 {
+    CCASSERT(!t_recordingList, "Cannot create a render queue while recording");
     RenderQueue newRenderQueue;
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
@@ -667,11 +927,25 @@ void Renderer::drawCustomCommand(RenderCommand *command)
     if (CustomCommand::DrawType::ELEMENT == drawType)
     {
         _commandBuffer->setIndexBuffer(cmd->getIndexBuffer());
-        _commandBuffer->drawElements(cmd->getPrimitiveType(),
-                                     cmd->getIndexFormat(),
-                                     cmd->getIndexDrawCount(),
-                                     cmd->getIndexDrawOffset());
-        _drawnVertices += cmd->getIndexDrawCount();
+        auto instanceCount = cmd->getInstanceCount();
+        if (instanceCount > 0 && cmd->getInstanceBuffer())
+        {
+            _commandBuffer->setInstanceBuffer(cmd->getInstanceBuffer(), cmd->getInstanceLayout());
+            _commandBuffer->drawElementsInstanced(cmd->getPrimitiveType(),
+                                                  cmd->getIndexFormat(),
+                                                  cmd->getIndexDrawCount(),
+                                                  cmd->getIndexDrawOffset(),
+                                                  instanceCount);
+            _drawnVertices += cmd->getIndexDrawCount() * instanceCount;
+        }
+        else
+        {
+            _commandBuffer->drawElements(cmd->getPrimitiveType(),
+                                         cmd->getIndexFormat(),
+                                         cmd->getIndexDrawCount(),
+                                         cmd->getIndexDrawOffset());
+            _drawnVertices += cmd->getIndexDrawCount();
+        }
     }
     else
     {
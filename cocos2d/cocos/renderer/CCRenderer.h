@@ -63,7 +63,9 @@ class Texture2D;
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
  the correct order, the only `RenderCommand` objects that need to be sorted,
- are the ones that have `z < 0` and `z > 0`.
+ are the ones that have `z < 0` and `z > 0`, the transparent 3D objects (back to front)
+ and the opaque 3D objects (roughly front to back, then by program, texture and material).
+ Commands are sorted by a packed 64 bit key with a stable radix sort.
 */
 class RenderQueue
 {
@@ -107,8 +109,23 @@ public:
     ssize_t getSubQueueSize(QUEUE_GROUP group) const { return _commands[group].size(); }
     
 protected:
+    /**A render command with its sort key.*/
+    struct SortEntry
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+
+    /**Sort a sub group of the render queue by the sort keys of its commands.*/
+    void sortByKey(QUEUE_GROUP group);
+    /**Sort the commands in [begin, end) of a sub group.*/
+    void sortRange(QUEUE_GROUP group, size_t begin, size_t end);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Sort buffers, kept between frames so sorting does not allocate.*/
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -120,6 +137,32 @@ protected:
 
 class GroupCommandManager;
 
+/** Render commands recorded on a thread other than the render thread.
+ The commands are added to the render queues later, in the order they were recorded,
+ with Renderer::addCommands().
+ */
+class CC_DLL RenderCommandList
+{
+public:
+    /**A recorded command and the render queue it was added to.*/
+    struct Entry
+    {
+        RenderCommand* command;
+        int renderQueueID;
+    };
+
+    /**Get the recorded commands.*/
+    const std::vector<Entry>& getEntries() const { return _entries; }
+
+protected:
+    friend class Renderer;
+
+    /**The recorded commands, the capacity is kept when the list is reused.*/
+    std::vector<Entry> _entries;
+    /**The render queues pushed while recording, the first one is the queue on top when recording began.*/
+    std::vector<int> _groupStack;
+};
+
 
 /* Class responsible for the rendering in.
 
@@ -160,6 +203,21 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Records the commands added by the calling thread into a list instead of the render queues,
+     until endRecording() is called on the same thread. Used to visit nodes on several threads,
+     the render queues must not be changed while a thread is recording.
+     */
+    void beginRecording(RenderCommandList* commandList);
+
+    /** Stops recording the commands added by the calling thread. */
+    void endRecording();
+
+    /** Whether the calling thread is recording commands. */
+    bool isRecording() const;
+
+    /** Adds the commands recorded in a list into the render queues. */
+    void addCommands(const RenderCommandList& commandList);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -133,17 +133,19 @@ Image* createImage(const std::string& path)
         return nullptr;
     }
 
-    // all images are handled by UIImage except PVR extension that is handled by our own handler
-    Image* image = nullptr;
-    do
+    // use the pixels decoded ahead of time (e.g. by a loading screen) instead of decoding again
+    Image* image = DecodedImageCache::getInstance()->take(fullpath);
+    if (image)
     {
-        image = new (std::nothrow) Image();
-        CC_BREAK_IF(nullptr == image);
+        return image;
+    }
 
-        bool bRet = image->initWithImageFile(fullpath);
-        CC_BREAK_IF(!bRet);
+    // all images are handled by UIImage except PVR extension that is handled by our own handler
+    image = new (std::nothrow) Image();
+    if (image && !image->initWithImageFile(fullpath))
+    {
+        CC_SAFE_RELEASE_NULL(image);
     }
-    while (0);
 
     return image;
 }
@@ -192,6 +194,24 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
     images[4] = createImage(positive_z);
     images[5] = createImage(negative_z);
 
+    auto releaseImages = [&images]()
+    {
+        for (auto img: images)
+        {
+            CC_SAFE_RELEASE(img);
+        }
+    };
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (images[i] == nullptr)
+        {
+            CCLOG("TextureCubemap: failed to load %s", _imgPath[i].c_str());
+            releaseImages();
+            return false;
+        }
+    }
+
     int imageSize = images[0]->getHeight();
     for (int i = 0; i < 6; i++)
     {
@@ -199,11 +219,13 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
         if(img->getWidth() != img->getHeight())
         {
             CCASSERT(false, "TextureCubemap: width should be equal to height!");
+            releaseImages();
             return false;
         }
         if(imageSize != img->getWidth())
         {
             CCASSERT(imageSize == img->getWidth(), "TextureCubmap: texture of each face should have same dimension");
+            releaseImages();
             return false;
         }
     }
@@ -251,10 +273,7 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
             free(pData);
     }
 
-    for (auto img: images)
-    {
-        CC_SAFE_RELEASE(img);
-    }
+    releaseImages();
 
     return true;
 }
@@ -134,6 +134,27 @@ public:
      * @see `drawArrays(PrimitiveType primitiveType, unsigned int start,  unsigned int count)`
     */
     virtual void drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset) = 0;
+
+    /**
+     * Set a buffer whose attributes advance once per instance, used by the next instanced draw.
+     * Only supported if the device supports FeatureType::INSTANCING.
+     * @param buffer The buffer holding per-instance attributes.
+     * @param layout The per-instance attributes, their locations are taken from the program.
+     * @see `drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)`
+     */
+    virtual void setInstanceBuffer(Buffer* buffer, const VertexLayout* layout) {}
+
+    /**
+     * Draw several instances of primitives with an index list.
+     * Only supported if the device supports FeatureType::INSTANCING.
+     * @param primitiveType The type of primitives that elements are assembled into.
+     * @param indexType The type if indexes, either 16 bit integer or 32 bit integer.
+     * @param count The number of indexes to read from the index buffer for each instance.
+     * @param offset Byte offset within indexBuffer to start reading indexes from.
+     * @param instanceCount The number of instances to draw.
+     * @see `setInstanceBuffer(Buffer* buffer, const VertexLayout* layout)`
+     */
+    virtual void drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount) {}
     
     /**
      * Do some resources release.
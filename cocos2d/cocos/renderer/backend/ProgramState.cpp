@@ -32,6 +32,7 @@
 #include "base/CCDirector.h"
 
 #include <algorithm>
+#include <atomic>
 
 #ifdef CC_USE_METAL
 #include "glsl_optimizer.h"
@@ -80,6 +81,12 @@ namespace {
         dst[4] = src[3]; dst[5] = src[4]; dst[6] = src[5];
         dst[8] = src[6]; dst[9] = src[7]; dst[10] = src[8];
     }
+
+    uint32_t generateUniformStateID()
+    {
+        static std::atomic<uint32_t> nextID(1);
+        return nextID++;
+    }
 }
 
 //static field
@@ -156,6 +163,7 @@ TextureInfo& TextureInfo::operator=(const TextureInfo& rhs)
 }
 
 ProgramState::ProgramState(Program* program)
+: _uniformStateID(generateUniformStateID())
 {
     init(program);
 }
@@ -204,6 +212,7 @@ void ProgramState::resetUniforms()
 }
 
 ProgramState::ProgramState()
+: _uniformStateID(generateUniformStateID())
 {
 }
 
@@ -358,7 +367,21 @@ void ProgramState::setVertexUniform(int location, const void* data, std::size_t
         memcpy(_vertexUniformBuffer + location, data, size);
     }
 #else
+    // Setting the same value again leaves the uniform clean, so it is not uploaded again.
+    if (memcmp(_vertexUniformBuffer + offset, data, size) == 0)
+        return;
+
     memcpy(_vertexUniformBuffer + offset, data, size);
+    if (_vertexUniformDirtyBegin == _vertexUniformDirtyEnd)
+    {
+        _vertexUniformDirtyBegin = offset;
+        _vertexUniformDirtyEnd = offset + size;
+    }
+    else
+    {
+        _vertexUniformDirtyBegin = std::min(_vertexUniformDirtyBegin, offset);
+        _vertexUniformDirtyEnd = std::max(_vertexUniformDirtyEnd, offset + size);
+    }
 #endif
 }
 
@@ -473,6 +496,13 @@ ProgramState::AutoBindingResolver::~AutoBindingResolver()
     list.erase(std::remove(list.begin(), list.end(), this), list.end());
 }
 
+bool ProgramState::getVertexUniformDirtyRange(std::size_t& begin, std::size_t& end) const
+{
+    begin = _vertexUniformDirtyBegin;
+    end = _vertexUniformDirtyEnd;
+    return begin < end;
+}
+
 void ProgramState::getVertexUniformBuffer(char** buffer, std::size_t& size) const
 {
     *buffer = _vertexUniformBuffer;
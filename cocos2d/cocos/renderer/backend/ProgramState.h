@@ -253,6 +253,26 @@ public:
     void setParameterAutoBinding(const std::string &uniformName, const std::string &autoBinding);
 
     inline std::shared_ptr<VertexLayout> getVertexLayout() const { return _vertexLayout; }
+
+    /**
+     * Get the byte range of the vertex uniform buffer that changed since the range was last cleared.
+     * Setting a uniform to the value it already has does not change the range.
+     * @param begin The first changed byte.
+     * @param end The byte after the last changed byte.
+     * @return false if no uniform changed.
+     */
+    bool getVertexUniformDirtyRange(std::size_t& begin, std::size_t& end) const;
+
+    /**
+     * Clear the changed range after the backend uploaded the uniforms.
+     */
+    inline void clearVertexUniformDirtyRange() { _vertexUniformDirtyBegin = _vertexUniformDirtyEnd = 0; }
+
+    /**
+     * Get the id of this program state, unique in the process.
+     * The backend uses it to know which program state last uploaded the uniforms of a program.
+     */
+    inline uint32_t getUniformStateID() const { return _uniformStateID; }
 protected:
 
     ProgramState();
@@ -323,6 +343,9 @@ protected:
     char* _fragmentUniformBuffer = nullptr;
     std::size_t _vertexUniformBufferSize = 0;
     std::size_t _fragmentUniformBufferSize = 0;
+    std::size_t _vertexUniformDirtyBegin = 0;
+    std::size_t _vertexUniformDirtyEnd = 0;
+    uint32_t _uniformStateID = 0;
 
     std::unordered_map<int, TextureInfo>                    _vertexTextureInfos;
     std::unordered_map<int, TextureInfo>                    _fragmentTextureInfos;
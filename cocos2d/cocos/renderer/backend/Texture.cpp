@@ -87,6 +87,8 @@ namespace
                 //mac and opengl use Depth24_Stnicl8 combined format, its 32 bits
                 return byte(4);
 #endif
+            case PixelFormat::RGBA32F:
+                return byte(16);
             default:
                 return byte(0); //"textureFormat pixel size in bytes not defined!";
         }
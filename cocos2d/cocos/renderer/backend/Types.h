@@ -124,6 +124,9 @@ enum class PixelFormat
     // a stencil render target.
     D24S8,
 
+    //! 128-bit float texture: RGBA32F, for data read by shaders such as matrix palettes
+    RGBA32F,
+
     DEFAULT = AUTO,
 
     NONE = -1
@@ -140,6 +140,8 @@ MTLPixelFormat Utils::toMTLPixelFormat(PixelFormat textureFormat)
             return MTLPixelFormatA8Unorm;
         case PixelFormat::BGRA8888:
             return MTLPixelFormatBGRA8Unorm;
+        case PixelFormat::RGBA32F:
+            return MTLPixelFormatRGBA32Float;
            
         //on mac, D24S8 means MTLPixelFormatDepth24Unorm_Stencil8, while on ios it means MTLPixelFormatDepth32Float_Stencil8
         case PixelFormat::D24S8:
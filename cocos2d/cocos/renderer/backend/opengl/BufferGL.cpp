@@ -23,6 +23,7 @@
  ****************************************************************************/
  
 #include "BufferGL.h"
+#include "StateCacheGL.h"
 #include <cassert>
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
@@ -62,7 +63,7 @@ BufferGL::BufferGL(std::size_t size, BufferType type, BufferUsage usage)
 BufferGL::~BufferGL()
 {
     if (_buffer)
-        glDeleteBuffers(1, &_buffer);
+        StateCacheGL::deleteBuffer(_buffer);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     CC_SAFE_DELETE_ARRAY(_data);
@@ -112,12 +113,12 @@ void BufferGL::updateData(void* data, std::size_t size)
     {
         if (BufferType::VERTEX == _type)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _buffer);
             glBufferData(GL_ARRAY_BUFFER, size, data, toGLUsage(_usage));
         }
         else
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, toGLUsage(_usage));
         }
         CHECK_GL_ERROR_DEBUG();
@@ -140,12 +141,12 @@ void BufferGL::updateSubData(void* data, std::size_t offset, std::size_t size)
         CHECK_GL_ERROR_DEBUG();
         if (BufferType::VERTEX == _type)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, _buffer);
             glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
         }
         else
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffer);
             glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data);
         }
 
@@ -28,6 +28,7 @@
 #include "TextureGL.h"
 #include "DepthStencilStateGL.h"
 #include "ProgramGL.h"
+#include "StateCacheGL.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
@@ -77,10 +78,12 @@ CommandBufferGL::CommandBufferGL()
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     _backToForegroundListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*){
+       StateCacheGL::onContextRecreated();
        if(_generatedFBO)
            glGenFramebuffers(1, &_generatedFBO); //recreate framebuffer
     });
-    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_backToForegroundListener, -1);
+    // Run before the buffers, textures and programs are recreated, so their bindings are not skipped by stale cached values.
+    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_backToForegroundListener, -2);
 #endif
 }
 
@@ -98,6 +101,8 @@ CommandBufferGL::~CommandBufferGL()
 
 void CommandBufferGL::beginFrame()
 {
+    // GL state may have been changed outside the backend since the last frame.
+    StateCacheGL::invalidate();
 }
 
 void CommandBufferGL::beginRenderPass(const RenderPassDescriptor& descirptor)
@@ -234,22 +239,13 @@ void CommandBufferGL::applyRenderPassDescriptor(const RenderPassDescriptor& desc
     
     CHECK_GL_ERROR_DEBUG();
     
-    GLboolean oldDepthWrite = GL_FALSE;
-    GLboolean oldDepthTest = GL_FALSE;
-    GLfloat oldDepthClearValue = 0.f;
-    GLint oldDepthFunc = GL_LESS;
     if (descirptor.needClearDepth)
     {
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &oldDepthWrite);
-        glGetBooleanv(GL_DEPTH_TEST, &oldDepthTest);
-        glGetFloatv(GL_DEPTH_CLEAR_VALUE, &oldDepthClearValue);
-        glGetIntegerv(GL_DEPTH_FUNC, &oldDepthFunc);
-        
+        // Clearing ignores the depth test but respects the depth write mask. Every draw sets its own
+        // depth state, so nothing has to be queried from GL and restored afterwards.
         mask |= GL_DEPTH_BUFFER_BIT;
         glClearDepth(descirptor.clearDepthValue);
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(GL_TRUE);
-        glDepthFunc(GL_ALWAYS);
+        StateCacheGL::depthMask(true);
     }
     
     CHECK_GL_ERROR_DEBUG();
@@ -263,19 +259,6 @@ void CommandBufferGL::applyRenderPassDescriptor(const RenderPassDescriptor& desc
     if(mask) glClear(mask);
     
     CHECK_GL_ERROR_DEBUG();
-    
-    // restore depth test
-    if (descirptor.needClearDepth)
-    {
-        if (!oldDepthTest)
-            glDisable(GL_DEPTH_TEST);
-        
-        glDepthMask(oldDepthWrite);
-        glDepthFunc(oldDepthFunc);
-        glClearDepth(oldDepthClearValue);
-    }
-    
-    CHECK_GL_ERROR_DEBUG();
 }
 
 void CommandBufferGL::setRenderPipeline(RenderPipeline* renderPipeline)
@@ -292,7 +275,7 @@ void CommandBufferGL::setRenderPipeline(RenderPipeline* renderPipeline)
 
 void CommandBufferGL::setViewport(int x, int y, unsigned int w, unsigned int h)
 {
-    glViewport(x, y, w, h);
+    StateCacheGL::viewport(x, y, w, h);
     _viewPort.x = x;
     _viewPort.y = y;
     _viewPort.w = w;
@@ -306,7 +289,7 @@ void CommandBufferGL::setCullMode(CullMode mode)
 
 void CommandBufferGL::setWinding(Winding winding)
 {
-    glFrontFace(UtilsGL::toGLFrontFace(winding));
+    StateCacheGL::frontFace(UtilsGL::toGLFrontFace(winding));
 }
 
 void CommandBufferGL::setIndexBuffer(Buffer* buffer)
@@ -339,7 +322,7 @@ void CommandBufferGL::setProgramState(ProgramState* programState)
 
 void CommandBufferGL::drawArrays(PrimitiveType primitiveType, std::size_t start,  std::size_t count)
 {
-    prepareDrawing();
+    prepareDrawing(0);
     glDrawArrays(UtilsGL::toGLPrimitiveType(primitiveType), start, count);
     
     cleanResources();
@@ -347,13 +330,32 @@ void CommandBufferGL::drawArrays(PrimitiveType primitiveType, std::size_t start,
 
 void CommandBufferGL::drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset)
 {
-    prepareDrawing();
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer->getHandler());
+    prepareDrawing(_indexBuffer->getHandler());
     glDrawElements(UtilsGL::toGLPrimitiveType(primitiveType), count, UtilsGL::toGLIndexType(indexType), (GLvoid*)offset);
     CHECK_GL_ERROR_DEBUG();
     cleanResources();
 }
 
+void CommandBufferGL::setInstanceBuffer(Buffer* buffer, const VertexLayout* layout)
+{
+    CC_SAFE_RETAIN(buffer);
+    CC_SAFE_RELEASE(_instanceBuffer);
+    _instanceBuffer = static_cast<BufferGL*>(buffer);
+    _instanceLayout = layout;
+}
+
+void CommandBufferGL::drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)
+{
+#ifdef CC_PLATFORM_PC
+    prepareDrawing(_indexBuffer->getHandler());
+    glDrawElementsInstanced(UtilsGL::toGLPrimitiveType(primitiveType), count, UtilsGL::toGLIndexType(indexType), (GLvoid*)offset, instanceCount);
+    CHECK_GL_ERROR_DEBUG();
+#else
+    CCASSERT(false, "Instanced drawing is not supported on this platform");
+#endif
+    cleanResources();
+}
+
 void CommandBufferGL::endRenderPass()
 {
 }
@@ -374,12 +376,12 @@ void CommandBufferGL::setDepthStencilState(DepthStencilState* depthStencilState)
     }	
 }
 
-void CommandBufferGL::prepareDrawing() const
+void CommandBufferGL::prepareDrawing(GLuint indexBuffer) const
 {   
     const auto& program = _renderPipeline->getProgram();
-    glUseProgram(program->getHandler());
+    StateCacheGL::useProgram(program->getHandler());
     
-    bindVertexBuffer(program);
+    bindVertexBuffer(indexBuffer);
     setUniforms(program);
 
     // Set depth/stencil state.
@@ -394,37 +396,31 @@ void CommandBufferGL::prepareDrawing() const
     // Set cull mode.
     if (CullMode::NONE == _cullMode)
     {
-        glDisable(GL_CULL_FACE);
+        StateCacheGL::setEnabled(GL_CULL_FACE, false);
     }
     else
     {
-        glEnable(GL_CULL_FACE);
-        glCullFace(UtilsGL::toGLCullMode(_cullMode));
+        StateCacheGL::setEnabled(GL_CULL_FACE, true);
+        StateCacheGL::cullFace(UtilsGL::toGLCullMode(_cullMode));
     }
 }
 
-void CommandBufferGL::bindVertexBuffer(ProgramGL *program) const
+void CommandBufferGL::bindVertexBuffer(GLuint indexBuffer) const
 {
     // Bind vertex buffers and set the attributes.
     auto vertexLayout = _programState->getVertexLayout();
     
     if (!vertexLayout->isValid())
-        return;
-    
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer->getHandler());
-
-    const auto& attributes = vertexLayout->getAttributes();
-    for (const auto& attributeInfo : attributes)
     {
-        const auto& attribute = attributeInfo.second;
-        glEnableVertexAttribArray(attribute.index);
-        glVertexAttribPointer(attribute.index,
-            UtilsGL::getGLAttributeSize(attribute.format),
-            UtilsGL::toGLAttributeType(attribute.format),
-            attribute.needToBeNormallized,
-            vertexLayout->getStride(),
-            (GLvoid*)attribute.offset);
+        if (indexBuffer)
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        return;
     }
+
+    if (_instanceBuffer && _instanceLayout && _instanceLayout->isValid())
+        StateCacheGL::bindVertexInput(*vertexLayout, _vertexBuffer->getHandler(), indexBuffer, _instanceLayout, _instanceBuffer->getHandler());
+    else
+        StateCacheGL::bindVertexInput(*vertexLayout, _vertexBuffer->getHandler(), indexBuffer);
 }
 
 void CommandBufferGL::setUniforms(ProgramGL* program) const
@@ -442,20 +438,52 @@ void CommandBufferGL::setUniforms(ProgramGL* program) const
             cb.second(_programState, cb.first);
         }
 
-        int i = 0;
+        // The program keeps the uniform values of the last draw. When this program state made the last
+        // upload, only its changed range can differ; otherwise compare each uniform with the uploaded value.
+        auto& uploaded = program->getUploadedUniforms();
+        bool uploadAll = !uploaded.valid || uploaded.data.size() != bufferSize;
+        if (uploadAll)
+            uploaded.data.assign(buffer, buffer + bufferSize);
+
+        std::size_t rangeBegin = 0;
+        std::size_t rangeEnd = bufferSize;
+        if (!uploadAll && uploaded.stateID == _programState->getUniformStateID() &&
+            !_programState->getVertexUniformDirtyRange(rangeBegin, rangeEnd))
+        {
+            rangeBegin = rangeEnd = 0;
+        }
+
         for(auto& iter : uniformInfos)
         {
+            if (rangeBegin >= rangeEnd)
+                break;
+
             auto& uniformInfo = iter.second;
             if(uniformInfo.size <= 0)
                 continue;
 
+            std::size_t begin = uniformInfo.bufferOffset;
+            std::size_t end = begin + uniformInfo.size * uniformInfo.count;
+            if (end <= rangeBegin || begin >= rangeEnd)
+                continue;
+
+            if (!uploadAll)
+            {
+                if (memcmp(uploaded.data.data() + begin, buffer + begin, end - begin) == 0)
+                    continue;
+                memcpy(uploaded.data.data() + begin, buffer + begin, end - begin);
+            }
+
             int elementCount = uniformInfo.count;
             setUniform(uniformInfo.isArray,
                 uniformInfo.location,
                 elementCount,
                 uniformInfo.type,
-                (void*)(buffer + uniformInfo.bufferOffset));
+                (void*)(buffer + begin));
         }
+        uploaded.valid = true;
+        uploaded.stateID = _programState->getUniformStateID();
+        _programState->clearVertexUniformDirtyRange();
         
         const auto& textureInfo = _programState->getVertexTextureInfos();
         for(const auto& iter : textureInfo)
@@ -475,9 +503,18 @@ void CommandBufferGL::setUniforms(ProgramGL* program) const
             
             auto arrayCount = slot.size();
             if (arrayCount > 1)
+            {
                 glUniform1iv(location, (uint32_t)arrayCount, (GLint*)slot.data());
+            }
             else
-                glUniform1i(location, slot[0]);
+            {
+                auto result = uploaded.samplerSlots.emplace(location, (GLint)slot[0]);
+                if (result.second || result.first->second != (GLint)slot[0])
+                {
+                    result.first->second = slot[0];
+                    glUniform1i(location, slot[0]);
+                }
+            }
         }
     }
 }
@@ -579,6 +616,8 @@ void CommandBufferGL::cleanResources()
     CC_SAFE_RELEASE_NULL(_indexBuffer);
     CC_SAFE_RELEASE_NULL(_programState);  
     CC_SAFE_RELEASE_NULL(_vertexBuffer);
+    CC_SAFE_RELEASE_NULL(_instanceBuffer);
+    _instanceLayout = nullptr;
 }
 
 void CommandBufferGL::setLineWidth(float lineWidth)
@@ -595,12 +634,12 @@ void CommandBufferGL::setScissorRect(bool isEnabled, float x, float y, float wid
 {
     if(isEnabled)
     {
-        glEnable(GL_SCISSOR_TEST);
+        StateCacheGL::setEnabled(GL_SCISSOR_TEST, true);
         glScissor(x, y, width, height);
     }
     else
     {
-        glDisable(GL_SCISSOR_TEST);
+        StateCacheGL::setEnabled(GL_SCISSOR_TEST, false);
     }
 }
 
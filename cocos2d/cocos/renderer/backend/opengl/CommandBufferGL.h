@@ -132,6 +132,25 @@ public:
      * @see `drawArrays(PrimitiveType primitiveType, unsigned int start,  unsigned int count)`
     */
     virtual void drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset) override;
+
+    /**
+     * Set the buffer holding per-instance attributes for the next instanced draw.
+     * @param buffer The buffer the per-instance attributes are read from.
+     * @param layout The layout of the per-instance attributes, advanced once per instance.
+     * @see `drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount)`
+     */
+    virtual void setInstanceBuffer(Buffer* buffer, const VertexLayout* layout) override;
+
+    /**
+     * Draw several instances of primitives with an index list.
+     * @param primitiveType The type of primitives that elements are assembled into.
+     * @param indexType The type if indexes, either 16 bit integer or 32 bit integer.
+     * @param count The number of indexes to read from the index buffer for each instance.
+     * @param offset Byte offset within indexBuffer to start reading indexes from.
+     * @param instanceCount The number of instances to draw.
+     * @see `setInstanceBuffer(Buffer* buffer, const VertexLayout* layout)`
+     */
+    virtual void drawElementsInstanced(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset, std::size_t instanceCount) override;
     
     /**
      * Do some resources release.
@@ -178,8 +197,8 @@ private:
         unsigned int h = 0;
     };
     
-    void prepareDrawing() const;
-    void bindVertexBuffer(ProgramGL* program) const;
+    void prepareDrawing(GLuint indexBuffer) const;
+    void bindVertexBuffer(GLuint indexBuffer) const;
     void setUniforms(ProgramGL* program) const;
     void setUniform(bool isArray, GLuint location, unsigned int size, GLenum uniformType, void* data) const;
     void cleanResources();
@@ -196,6 +215,8 @@ private:
     BufferGL* _vertexBuffer;
     ProgramState* _programState = nullptr;
     BufferGL* _indexBuffer = nullptr;
+    BufferGL* _instanceBuffer = nullptr;
+    const VertexLayout* _instanceLayout = nullptr;
     RenderPipelineGL* _renderPipeline = nullptr;
     CullMode _cullMode = CullMode::NONE;
     DepthStencilStateGL* _depthStencilStateGL = nullptr;
@@ -27,13 +27,14 @@
 
 #include "base/ccMacros.h"
 #include "renderer/backend/opengl/UtilsGL.h"
+#include "renderer/backend/opengl/StateCacheGL.h"
 
 CC_BACKEND_BEGIN
 
 void DepthStencilStateGL::reset()
 {
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_STENCIL_TEST);
+    StateCacheGL::setEnabled(GL_DEPTH_TEST, false);
+    StateCacheGL::setEnabled(GL_STENCIL_TEST, false);
 }
 
 DepthStencilStateGL::DepthStencilStateGL(const DepthStencilDescriptor& descriptor)
@@ -44,26 +45,10 @@ void DepthStencilStateGL::apply(unsigned int stencilReferenceValueFront, unsigne
 {
     // depth test
     
-    if (_depthStencilInfo.depthTestEnabled)
-    {
-        glEnable(GL_DEPTH_TEST); 
-    }
-    else
-    {
-        glDisable(GL_DEPTH_TEST);
-    }
-    
-    if (_depthStencilInfo.depthWriteEnabled)
-        glDepthMask(GL_TRUE);
-    else
-        glDepthMask(GL_FALSE);
-    
-    glDepthFunc(UtilsGL::toGLComareFunction(_depthStencilInfo.depthCompareFunction));
-    
-    if (_depthStencilInfo.stencilTestEnabled)
-        glEnable(GL_STENCIL_TEST);
-    else
-        glDisable(GL_STENCIL_TEST);
+    StateCacheGL::setEnabled(GL_DEPTH_TEST, _depthStencilInfo.depthTestEnabled);
+    StateCacheGL::depthMask(_depthStencilInfo.depthWriteEnabled);
+    StateCacheGL::depthFunc(UtilsGL::toGLComareFunction(_depthStencilInfo.depthCompareFunction));
+    StateCacheGL::setEnabled(GL_STENCIL_TEST, _depthStencilInfo.stencilTestEnabled);
 
     // stencil test
     if (_depthStencilInfo.stencilTestEnabled)
@@ -98,6 +98,11 @@ bool DeviceInfoGL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::DEPTH24:
         featureSupported = checkForGLExtension("GL_OES_depth24");
         break;
+    case FeatureType::INSTANCING:
+#ifdef CC_PLATFORM_PC
+        featureSupported = checkForGLExtension("GL_ARB_instanced_arrays") && checkForGLExtension("GL_ARB_draw_instanced");
+#endif
+        break;
     default:
         break;
     }
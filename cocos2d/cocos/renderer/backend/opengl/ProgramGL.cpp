@@ -24,6 +24,7 @@
  
 #include "ProgramGL.h"
 #include "ShaderModuleGL.h"
+#include "StateCacheGL.h"
 #include "renderer/backend/Types.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
@@ -75,7 +76,7 @@ ProgramGL::~ProgramGL()
     CC_SAFE_RELEASE(_vertexShaderModule);
     CC_SAFE_RELEASE(_fragmentShaderModule);
     if (_program)
-        glDeleteProgram(_program);
+        StateCacheGL::deleteProgram(_program);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_backToForegroundListener);
@@ -88,6 +89,7 @@ void ProgramGL::reloadProgram()
     _activeUniformInfos.clear();
     _mapToCurrentActiveLocation.clear();
     _mapToOriginalLocation.clear();
+    _uploadedUniforms = UploadedUniforms();
     static_cast<ShaderModuleGL*>(_vertexShaderModule)->compileShader(backend::ShaderStage::VERTEX, std::move(vsPreDefine + _vertexShader));
     static_cast<ShaderModuleGL*>(_fragmentShaderModule)->compileShader(backend::ShaderStage::FRAGMENT, std::move(fsPreDefine + _fragmentShader));
     compileProgram();
@@ -128,7 +130,7 @@ void ProgramGL::compileProgram()
     if (GL_FALSE == status)
     {
         printf("cocos2d: ERROR: %s: failed to link program ", __FUNCTION__);
-        glDeleteProgram(_program);
+        StateCacheGL::deleteProgram(_program);
         _program = 0;
     }
 }
@@ -157,6 +157,24 @@ public:
      */
     virtual const std::unordered_map<std::string, UniformInfo>& getAllActiveUniformInfo(ShaderStage stage) const override ;
 
+    /**
+     * The uniform values last uploaded to the program. GL keeps them in the program object,
+     * so uniforms that still hold the same value are not uploaded again.
+     */
+    struct UploadedUniforms
+    {
+        std::vector<char> data;                     ///< Same layout as the uniform buffer of ProgramState.
+        bool valid = false;                         ///< False until the first upload and after the program is reloaded.
+        uint32_t stateID = 0;                       ///< ProgramState::getUniformStateID() of the last uploaded program state.
+        std::unordered_map<int, GLint> samplerSlots;///< Texture slot set to each sampler location.
+    };
+
+    /**
+     * Get the uniform values last uploaded to the program.
+     * @return The uploaded uniform values.
+     */
+    inline UploadedUniforms& getUploadedUniforms() { return _uploadedUniforms; }
+
 private:
     void compileProgram();
     bool getAttributeLocation(const std::string& attributeName, unsigned int& location) const;
@@ -187,6 +205,7 @@ private:
     UniformLocation _builtinUniformLocation[UNIFORM_MAX];
     int _builtinAttributeLocation[Attribute::ATTRIBUTE_MAX];
     std::unordered_map<int, int> _bufferOffset;
+    UploadedUniforms _uploadedUniforms;
 };
 //end of _opengl group
 /// @}
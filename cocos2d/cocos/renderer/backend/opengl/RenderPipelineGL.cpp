@@ -27,6 +27,7 @@
 #include "DepthStencilStateGL.h"
 #include "ProgramGL.h"
 #include "UtilsGL.h"
+#include "StateCacheGL.h"
 
 #include <assert.h>
 
@@ -60,17 +61,17 @@ void RenderPipelineGL::updateBlendState(const BlendDescriptor& descriptor)
 
     if (blendEnabled)
     {
-        glEnable(GL_BLEND);
-        glBlendEquationSeparate(rgbBlendOperation, alphaBlendOperation);
-        glBlendFuncSeparate(sourceRGBBlendFactor,
-                            destinationRGBBlendFactor,
-                            sourceAlphaBlendFactor,
-                            destinationAlphaBlendFactor);
+        StateCacheGL::setEnabled(GL_BLEND, true);
+        StateCacheGL::blendEquationSeparate(rgbBlendOperation, alphaBlendOperation);
+        StateCacheGL::blendFuncSeparate(sourceRGBBlendFactor,
+                                        destinationRGBBlendFactor,
+                                        sourceAlphaBlendFactor,
+                                        destinationAlphaBlendFactor);
     }
     else
-        glDisable(GL_BLEND);
+        StateCacheGL::setEnabled(GL_BLEND, false);
     
-    glColorMask(writeMaskRed, writeMaskGreen, writeMaskBlue, writeMaskAlpha);
+    StateCacheGL::colorMask(writeMaskRed, writeMaskGreen, writeMaskBlue, writeMaskAlpha);
 }
 
 RenderPipelineGL::~RenderPipelineGL()
@@ -0,0 +1,610 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#include "StateCacheGL.h"
+#include "UtilsGL.h"
+#include "../Device.h"
+#include "../VertexLayout.h"
+#include "base/ccMacros.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    // A value that is never set by the backend, so the next call always reaches OpenGL.
+    const GLuint UNKNOWN = 0xFFFFFFFF;
+    const int8_t UNKNOWN_FLAG = -1;
+
+    const int MAX_TEXTURE_UNITS = 16;
+    const int MAX_VERTEX_ATTRIBUTES = 16;
+
+    enum CapabilitySlot
+    {
+        SLOT_BLEND,
+        SLOT_DEPTH_TEST,
+        SLOT_STENCIL_TEST,
+        SLOT_CULL_FACE,
+        SLOT_SCISSOR_TEST,
+        SLOT_COUNT
+    };
+
+    int toCapabilitySlot(GLenum cap)
+    {
+        switch (cap)
+        {
+        case GL_BLEND:          return SLOT_BLEND;
+        case GL_DEPTH_TEST:     return SLOT_DEPTH_TEST;
+        case GL_STENCIL_TEST:   return SLOT_STENCIL_TEST;
+        case GL_CULL_FACE:      return SLOT_CULL_FACE;
+        case GL_SCISSOR_TEST:   return SLOT_SCISSOR_TEST;
+        default:                return -1;
+        }
+    }
+
+    struct VertexAttributeDesc
+    {
+        GLuint index = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        GLboolean normalized = GL_FALSE;
+        GLuint divisor = 0;     // 1 for per-instance attributes, read from the instance buffer
+        std::size_t offset = 0;
+
+        bool operator==(const VertexAttributeDesc& other) const
+        {
+            return index == other.index && size == other.size && type == other.type &&
+                   normalized == other.normalized && divisor == other.divisor && offset == other.offset;
+        }
+    };
+
+    // Everything a vertex array object captures: the buffers and the attributes sorted by index.
+    struct VertexArrayKey
+    {
+        GLuint vertexBuffer = 0;
+        GLuint indexBuffer = 0;
+        GLuint instanceBuffer = 0;
+        GLsizei stride = 0;
+        GLsizei instanceStride = 0;
+        int attributeCount = 0;
+        VertexAttributeDesc attributes[MAX_VERTEX_ATTRIBUTES];
+
+        bool operator==(const VertexArrayKey& other) const
+        {
+            if (vertexBuffer != other.vertexBuffer || indexBuffer != other.indexBuffer ||
+                instanceBuffer != other.instanceBuffer || stride != other.stride ||
+                instanceStride != other.instanceStride || attributeCount != other.attributeCount)
+                return false;
+            for (int i = 0; i < attributeCount; ++i)
+            {
+                if (!(attributes[i] == other.attributes[i]))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    struct VertexArrayKeyHash
+    {
+        std::size_t operator()(const VertexArrayKey& key) const
+        {
+            std::size_t seed = key.vertexBuffer;
+            auto combine = [&seed](std::size_t value) {
+                seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            };
+            combine(key.indexBuffer);
+            combine(key.instanceBuffer);
+            combine(key.stride);
+            combine(key.instanceStride);
+            for (int i = 0; i < key.attributeCount; ++i)
+            {
+                const auto& attribute = key.attributes[i];
+                combine(attribute.index | (attribute.size << 8) | (attribute.normalized << 16) | (attribute.divisor << 17));
+                combine(attribute.type);
+                combine(attribute.offset);
+            }
+            return seed;
+        }
+    };
+
+    // Attribute pointer state of vertex array 0, used when vertex array objects are not supported.
+    struct AttributePointer
+    {
+        GLuint buffer = UNKNOWN;
+        GLsizei stride = 0;
+        VertexAttributeDesc desc;
+    };
+
+    struct CachedState
+    {
+        GLuint program = UNKNOWN;
+        GLuint arrayBuffer = UNKNOWN;
+        GLuint elementBuffer = UNKNOWN;     // element buffer of the bound vertex array
+        GLuint vertexArray = UNKNOWN;
+        GLuint activeUnit = UNKNOWN;
+        GLuint textures2D[MAX_TEXTURE_UNITS];
+        GLuint texturesCube[MAX_TEXTURE_UNITS];
+
+        int8_t capabilities[SLOT_COUNT];
+        GLenum blendEquationRGB = UNKNOWN;
+        GLenum blendEquationAlpha = UNKNOWN;
+        GLenum blendSrcRGB = UNKNOWN;
+        GLenum blendDstRGB = UNKNOWN;
+        GLenum blendSrcAlpha = UNKNOWN;
+        GLenum blendDstAlpha = UNKNOWN;
+        int8_t colorMask = UNKNOWN_FLAG;    // RGBA in the lower 4 bits
+        int8_t depthMask = UNKNOWN_FLAG;
+        GLenum depthFunc = UNKNOWN;
+        GLenum cullFaceMode = UNKNOWN;
+        GLenum frontFace = UNKNOWN;
+        GLint viewport[4];
+
+        bool enabledAttributesKnown = false;
+        uint32_t enabledAttributes = 0;
+        AttributePointer attributes[MAX_VERTEX_ATTRIBUTES];
+
+        CachedState()
+        {
+            std::fill(textures2D, textures2D + MAX_TEXTURE_UNITS, UNKNOWN);
+            std::fill(texturesCube, texturesCube + MAX_TEXTURE_UNITS, UNKNOWN);
+            std::fill(capabilities, capabilities + SLOT_COUNT, UNKNOWN_FLAG);
+            std::fill(viewport, viewport + 4, -1);
+        }
+    };
+
+    CachedState s_state;
+
+    // The vertex array objects are created lazily and live until their buffers are deleted.
+    std::unordered_map<VertexArrayKey, GLuint, VertexArrayKeyHash> s_vertexArrays;
+    VertexArrayKey s_boundVertexArrayKey;
+    int8_t s_vertexArraySupported = UNKNOWN_FLAG;
+    int8_t s_instancingSupported = UNKNOWN_FLAG;
+
+    bool isVertexArraySupported()
+    {
+        if (s_vertexArraySupported == UNKNOWN_FLAG)
+        {
+            auto deviceInfo = Device::getInstance()->getDeviceInfo();
+            s_vertexArraySupported = deviceInfo && deviceInfo->checkForFeatureSupported(FeatureType::VAO) ? 1 : 0;
+        }
+        return s_vertexArraySupported == 1;
+    }
+
+    bool isInstancingSupported()
+    {
+        if (s_instancingSupported == UNKNOWN_FLAG)
+        {
+            auto deviceInfo = Device::getInstance()->getDeviceInfo();
+            s_instancingSupported = deviceInfo && deviceInfo->checkForFeatureSupported(FeatureType::INSTANCING) ? 1 : 0;
+        }
+        return s_instancingSupported == 1;
+    }
+
+    void vertexAttribDivisor(GLuint index, GLuint divisor)
+    {
+#ifdef CC_PLATFORM_PC
+        glVertexAttribDivisor(index, divisor);
+#endif
+    }
+
+    void bindVertexArray(GLuint vertexArray, GLuint elementBuffer)
+    {
+        if (s_state.vertexArray != vertexArray)
+        {
+            glBindVertexArray(vertexArray);
+            s_state.vertexArray = vertexArray;
+            s_state.elementBuffer = elementBuffer;
+        }
+    }
+
+    void activeTexture(GLuint unit)
+    {
+        if (s_state.activeUnit != unit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            s_state.activeUnit = unit;
+        }
+    }
+
+    void addVertexAttributes(const VertexLayout& layout, GLuint divisor, VertexArrayKey& key)
+    {
+        // The layout is a hash map, sort by index so equal layouts give equal keys.
+        for (const auto& iter : layout.getAttributes())
+        {
+            const auto& attribute = iter.second;
+            CCASSERT(attribute.index < MAX_VERTEX_ATTRIBUTES, "StateCacheGL: vertex attribute index out of range");
+            if (attribute.index >= MAX_VERTEX_ATTRIBUTES || key.attributeCount == MAX_VERTEX_ATTRIBUTES)
+                continue;
+
+            VertexAttributeDesc desc;
+            desc.index = (GLuint)attribute.index;
+            desc.size = UtilsGL::getGLAttributeSize(attribute.format);
+            desc.type = UtilsGL::toGLAttributeType(attribute.format);
+            desc.normalized = attribute.needToBeNormallized ? GL_TRUE : GL_FALSE;
+            desc.divisor = divisor;
+            desc.offset = attribute.offset;
+
+            int i = key.attributeCount++;
+            while (i > 0 && key.attributes[i - 1].index > desc.index)
+            {
+                key.attributes[i] = key.attributes[i - 1];
+                --i;
+            }
+            key.attributes[i] = desc;
+        }
+    }
+
+    void makeVertexArrayKey(const VertexLayout& layout, GLuint vertexBuffer, GLuint indexBuffer,
+                            const VertexLayout* instanceLayout, GLuint instanceBuffer, VertexArrayKey& key)
+    {
+        key.vertexBuffer = vertexBuffer;
+        key.indexBuffer = indexBuffer;
+        key.stride = (GLsizei)layout.getStride();
+        key.attributeCount = 0;
+        addVertexAttributes(layout, 0, key);
+
+        if (instanceLayout && instanceBuffer)
+        {
+            key.instanceBuffer = instanceBuffer;
+            key.instanceStride = (GLsizei)instanceLayout->getStride();
+            addVertexAttributes(*instanceLayout, 1, key);
+        }
+    }
+
+    // Per-instance attributes are read from the instance buffer.
+    GLuint sourceBuffer(const VertexArrayKey& key, const VertexAttributeDesc& desc)
+    {
+        return desc.divisor ? key.instanceBuffer : key.vertexBuffer;
+    }
+
+    GLsizei sourceStride(const VertexArrayKey& key, const VertexAttributeDesc& desc)
+    {
+        return desc.divisor ? key.instanceStride : key.stride;
+    }
+
+    void vertexAttribPointer(const VertexAttributeDesc& desc, GLsizei stride)
+    {
+        glVertexAttribPointer(desc.index, desc.size, desc.type, desc.normalized, stride, (GLvoid*)desc.offset);
+    }
+
+    void bindVertexArrayForKey(const VertexArrayKey& key)
+    {
+        if (s_state.vertexArray != UNKNOWN && s_state.vertexArray != 0 && key == s_boundVertexArrayKey)
+            return;
+
+        auto iter = s_vertexArrays.find(key);
+        if (iter != s_vertexArrays.end())
+        {
+            bindVertexArray(iter->second, key.indexBuffer);
+            s_boundVertexArrayKey = key;
+            return;
+        }
+
+        GLuint vertexArray = 0;
+        glGenVertexArrays(1, &vertexArray);
+        bindVertexArray(vertexArray, key.indexBuffer);
+        // Part of the vertex array state, bind it directly while the new object is bound.
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, key.indexBuffer);
+        for (int i = 0; i < key.attributeCount; ++i)
+        {
+            const auto& desc = key.attributes[i];
+            StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, sourceBuffer(key, desc));
+            glEnableVertexAttribArray(desc.index);
+            vertexAttribPointer(desc, sourceStride(key, desc));
+            if (desc.divisor)
+                vertexAttribDivisor(desc.index, desc.divisor);
+        }
+        CHECK_GL_ERROR_DEBUG();
+
+        s_vertexArrays.emplace(key, vertexArray);
+        s_boundVertexArrayKey = key;
+    }
+
+    void setVertexAttributes(const VertexArrayKey& key)
+    {
+        uint32_t enabled = 0;
+        for (int i = 0; i < key.attributeCount; ++i)
+        {
+            const auto& desc = key.attributes[i];
+            enabled |= 1u << desc.index;
+
+            GLuint buffer = sourceBuffer(key, desc);
+            GLsizei stride = sourceStride(key, desc);
+            auto& pointer = s_state.attributes[desc.index];
+            bool unknown = pointer.buffer == UNKNOWN;
+            if (unknown || pointer.buffer != buffer || pointer.stride != stride || !(pointer.desc == desc))
+            {
+                StateCacheGL::bindBuffer(GL_ARRAY_BUFFER, buffer);
+                vertexAttribPointer(desc, stride);
+                // The divisor is not known after invalidation, a per-instance attribute may have left it set.
+                if (isInstancingSupported() && (unknown || pointer.desc.divisor != desc.divisor))
+                    vertexAttribDivisor(desc.index, desc.divisor);
+                pointer.buffer = buffer;
+                pointer.stride = stride;
+                pointer.desc = desc;
+            }
+        }
+
+        // Attributes left enabled by a previous layout could read past the end of the new buffer.
+        uint32_t changed = s_state.enabledAttributesKnown ? (enabled ^ s_state.enabledAttributes) : 0xFFFFFFFF;
+        for (GLuint index = 0; index < MAX_VERTEX_ATTRIBUTES; ++index)
+        {
+            uint32_t bit = 1u << index;
+            if (!(changed & bit))
+                continue;
+            if (enabled & bit)
+                glEnableVertexAttribArray(index);
+            else
+                glDisableVertexAttribArray(index);
+        }
+        s_state.enabledAttributes = enabled;
+        s_state.enabledAttributesKnown = true;
+
+        if (key.indexBuffer)
+            StateCacheGL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, key.indexBuffer);
+    }
+}
+
+void StateCacheGL::invalidate()
+{
+    s_state = CachedState();
+}
+
+void StateCacheGL::onContextRecreated()
+{
+    // The names belong to the lost context, deleting them could delete new objects.
+    s_vertexArrays.clear();
+    s_boundVertexArrayKey = VertexArrayKey();
+    invalidate();
+}
+
+void StateCacheGL::useProgram(GLuint program)
+{
+    if (s_state.program != program)
+    {
+        glUseProgram(program);
+        s_state.program = program;
+    }
+}
+
+void StateCacheGL::deleteProgram(GLuint program)
+{
+    glDeleteProgram(program);
+    // A program in use is only flagged for deletion, its name must not match a new program.
+    if (s_state.program == program)
+        s_state.program = UNKNOWN;
+}
+
+void StateCacheGL::bindBuffer(GLenum target, GLuint buffer)
+{
+    if (GL_ARRAY_BUFFER == target)
+    {
+        if (s_state.arrayBuffer != buffer)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            s_state.arrayBuffer = buffer;
+        }
+        return;
+    }
+
+    if (GL_ELEMENT_ARRAY_BUFFER == target)
+    {
+        if (s_state.vertexArray != 0 && isVertexArraySupported())
+            bindVertexArray(0, UNKNOWN);
+        if (s_state.elementBuffer != buffer)
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+            s_state.elementBuffer = buffer;
+        }
+        return;
+    }
+
+    glBindBuffer(target, buffer);
+}
+
+void StateCacheGL::deleteBuffer(GLuint buffer)
+{
+    // The buffer name can be reused by a new buffer, drop every vertex array that refers to it.
+    for (auto iter = s_vertexArrays.begin(); iter != s_vertexArrays.end();)
+    {
+        const auto& key = iter->first;
+        if (key.vertexBuffer == buffer || key.indexBuffer == buffer || key.instanceBuffer == buffer)
+        {
+            if (s_state.vertexArray == iter->second)
+            {
+                bindVertexArray(0, UNKNOWN);
+                s_boundVertexArrayKey = VertexArrayKey();
+            }
+            glDeleteVertexArrays(1, &iter->second);
+            iter = s_vertexArrays.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    glDeleteBuffers(1, &buffer);
+
+    // Deleting a bound buffer reverts the binding to 0.
+    if (s_state.arrayBuffer == buffer)
+        s_state.arrayBuffer = 0;
+    if (s_state.elementBuffer == buffer)
+        s_state.elementBuffer = 0;
+    for (auto& pointer : s_state.attributes)
+    {
+        if (pointer.buffer == buffer)
+            pointer.buffer = UNKNOWN;
+    }
+}
+
+void StateCacheGL::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    GLuint* bound = nullptr;
+    if (unit < MAX_TEXTURE_UNITS)
+    {
+        if (GL_TEXTURE_2D == target)
+            bound = &s_state.textures2D[unit];
+        else if (GL_TEXTURE_CUBE_MAP == target)
+            bound = &s_state.texturesCube[unit];
+    }
+
+    if (bound && *bound == texture)
+        return;
+
+    activeTexture(unit);
+    glBindTexture(target, texture);
+    if (bound)
+        *bound = texture;
+}
+
+void StateCacheGL::deleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+
+    // Deleting a bound texture reverts the binding of every unit to 0.
+    for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+    {
+        if (s_state.textures2D[unit] == texture)
+            s_state.textures2D[unit] = 0;
+        if (s_state.texturesCube[unit] == texture)
+            s_state.texturesCube[unit] = 0;
+    }
+}
+
+void StateCacheGL::setEnabled(GLenum cap, bool enabled)
+{
+    int slot = toCapabilitySlot(cap);
+    int8_t value = enabled ? 1 : 0;
+    if (slot >= 0 && s_state.capabilities[slot] == value)
+        return;
+
+    if (enabled)
+        glEnable(cap);
+    else
+        glDisable(cap);
+
+    if (slot >= 0)
+        s_state.capabilities[slot] = value;
+}
+
+void StateCacheGL::blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+{
+    if (s_state.blendEquationRGB != modeRGB || s_state.blendEquationAlpha != modeAlpha)
+    {
+        glBlendEquationSeparate(modeRGB, modeAlpha);
+        s_state.blendEquationRGB = modeRGB;
+        s_state.blendEquationAlpha = modeAlpha;
+    }
+}
+
+void StateCacheGL::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    if (s_state.blendSrcRGB != srcRGB || s_state.blendDstRGB != dstRGB ||
+        s_state.blendSrcAlpha != srcAlpha || s_state.blendDstAlpha != dstAlpha)
+    {
+        glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+        s_state.blendSrcRGB = srcRGB;
+        s_state.blendDstRGB = dstRGB;
+        s_state.blendSrcAlpha = srcAlpha;
+        s_state.blendDstAlpha = dstAlpha;
+    }
+}
+
+void StateCacheGL::colorMask(bool red, bool green, bool blue, bool alpha)
+{
+    int8_t mask = (red ? 1 : 0) | (green ? 2 : 0) | (blue ? 4 : 0) | (alpha ? 8 : 0);
+    if (s_state.colorMask != mask)
+    {
+        glColorMask(red, green, blue, alpha);
+        s_state.colorMask = mask;
+    }
+}
+
+void StateCacheGL::depthMask(bool enabled)
+{
+    int8_t value = enabled ? 1 : 0;
+    if (s_state.depthMask != value)
+    {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        s_state.depthMask = value;
+    }
+}
+
+void StateCacheGL::depthFunc(GLenum func)
+{
+    if (s_state.depthFunc != func)
+    {
+        glDepthFunc(func);
+        s_state.depthFunc = func;
+    }
+}
+
+void StateCacheGL::cullFace(GLenum mode)
+{
+    if (s_state.cullFaceMode != mode)
+    {
+        glCullFace(mode);
+        s_state.cullFaceMode = mode;
+    }
+}
+
+void StateCacheGL::frontFace(GLenum mode)
+{
+    if (s_state.frontFace != mode)
+    {
+        glFrontFace(mode);
+        s_state.frontFace = mode;
+    }
+}
+
+void StateCacheGL::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    GLint* cached = s_state.viewport;
+    if (cached[0] != x || cached[1] != y || cached[2] != width || cached[3] != height)
+    {
+        glViewport(x, y, width, height);
+        cached[0] = x;
+        cached[1] = y;
+        cached[2] = width;
+        cached[3] = height;
+    }
+}
+
+void StateCacheGL::bindVertexInput(const VertexLayout& layout, GLuint vertexBuffer, GLuint indexBuffer,
+                                   const VertexLayout* instanceLayout, GLuint instanceBuffer)
+{
+    VertexArrayKey key;
+    makeVertexArrayKey(layout, vertexBuffer, indexBuffer, instanceLayout, instanceBuffer, key);
+
+    if (isVertexArraySupported())
+        bindVertexArrayForKey(key);
+    else
+        setVertexAttributes(key);
+}
+
+CC_BACKEND_END
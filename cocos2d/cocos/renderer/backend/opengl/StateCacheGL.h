@@ -0,0 +1,118 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macros.h"
+#include "platform/CCGL.h"
+
+CC_BACKEND_BEGIN
+
+class VertexLayout;
+
+/**
+ * @addtogroup _opengl
+ * @{
+ */
+
+/**
+ * @brief Shadows the OpenGL state set by the backend and skips calls that would not change it.
+ * All state changes made by the OpenGL backend go through this class. Code that changes the same
+ * state by calling OpenGL directly should call invalidate() afterwards.
+ * Vertex input is bound through cached vertex array objects when they are supported.
+ * Must only be used on the GL thread.
+ */
+class StateCacheGL
+{
+public:
+    /**
+     * Forget the cached values, the next call of each setter reaches OpenGL.
+     * Cached vertex array objects stay valid.
+     */
+    static void invalidate();
+
+    /**
+     * The GL context was recreated and every GL object is lost.
+     * Forget the cached vertex array objects without deleting them, then invalidate.
+     */
+    static void onContextRecreated();
+
+    /// @name Program
+    static void useProgram(GLuint program);
+    static void deleteProgram(GLuint program);
+
+    /// @name Buffers
+    /**
+     * Bind a buffer to GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+     * Binding an element buffer unbinds the current vertex array object first, so uploads never modify it.
+     */
+    static void bindBuffer(GLenum target, GLuint buffer);
+    /** Delete a buffer and the cached vertex array objects that reference it. */
+    static void deleteBuffer(GLuint buffer);
+
+    /// @name Textures
+    /**
+     * Bind a texture to a texture unit.
+     * @param unit The texture unit, starting from 0.
+     * @param target GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+     * @param texture The texture handler.
+     */
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+    static void deleteTexture(GLuint texture);
+
+    /// @name Fixed-function state
+    /**
+     * Enable or disable a capability.
+     * GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_CULL_FACE and GL_SCISSOR_TEST are cached,
+     * other capabilities are passed to OpenGL.
+     */
+    static void setEnabled(GLenum cap, bool enabled);
+    static void blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha);
+    static void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+    static void colorMask(bool red, bool green, bool blue, bool alpha);
+    static void depthMask(bool enabled);
+    static void depthFunc(GLenum func);
+    static void cullFace(GLenum mode);
+    static void frontFace(GLenum mode);
+    static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /// @name Vertex input
+    /**
+     * Set up the vertex attributes of a layout read from a vertex buffer, and the index buffer.
+     * With vertex array object support, one vertex array object is created and cached for each
+     * combination of buffers and layouts, and drawing only binds it.
+     * Otherwise only the attributes that differ from the previous draw are set.
+     * @param layout The vertex layout, must be valid.
+     * @param vertexBuffer The vertex buffer handler.
+     * @param indexBuffer The index buffer handler, 0 if drawing without an index buffer.
+     * @param instanceLayout The per-instance attributes, nullptr if not drawing instances.
+     * @param instanceBuffer The buffer holding the per-instance attributes.
+     */
+    static void bindVertexInput(const VertexLayout& layout, GLuint vertexBuffer, GLuint indexBuffer,
+                                const VertexLayout* instanceLayout = nullptr, GLuint instanceBuffer = 0);
+};
+
+// end of _opengl group
+/// @}
+CC_BACKEND_END
@@ -30,6 +30,7 @@
 #include "base/CCDirector.h"
 #include "platform/CCPlatformConfig.h"
 #include "renderer/backend/opengl/UtilsGL.h"
+#include "renderer/backend/opengl/StateCacheGL.h"
 
 CC_BACKEND_BEGIN
 
@@ -122,7 +123,7 @@ void Texture2DGL::updateTextureDescriptor(const cocos2d::backend::TextureDescrip
 Texture2DGL::~Texture2DGL()
 {
     if (_textureInfo.texture)
-        glDeleteTextures(1, &_textureInfo.texture);
+        StateCacheGL::deleteTexture(_textureInfo.texture);
     _textureInfo.texture = 0;
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_backToForegroundListener);
@@ -133,8 +134,7 @@ void Texture2DGL::updateSamplerDescriptor(const SamplerDescriptor &sampler) {
     bool isPow2 = ISPOW2(_width) && ISPOW2(_height);
     _textureInfo.applySamplerDescriptor(sampler, isPow2, _hasMipmaps);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
 
     if (sampler.magFilter != SamplerFilter::DONT_CARE)
     {
@@ -187,8 +187,7 @@ void Texture2DGL::updateData(uint8_t* data, std::size_t width , std::size_t heig
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _textureInfo.magFilterGL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _textureInfo.minFilterGL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _textureInfo.sAddressModeGL);
@@ -215,8 +214,7 @@ void Texture2DGL::updateCompressedData(uint8_t *data, std::size_t width, std::si
 {
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _textureInfo.magFilterGL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _textureInfo.minFilterGL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _textureInfo.sAddressModeGL);
@@ -239,8 +237,7 @@ void Texture2DGL::updateCompressedData(uint8_t *data, std::size_t width, std::si
 
 void Texture2DGL::updateSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t level, uint8_t* data)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
 
     glTexSubImage2D(GL_TEXTURE_2D,
                     level,
@@ -261,8 +258,7 @@ void Texture2DGL::updateCompressedSubData(std::size_t xoffset, std::size_t yoffs
                                           std::size_t height, std::size_t dataLen, std::size_t level,
                                           uint8_t *data)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
 
     glCompressedTexSubImage2D(GL_TEXTURE_2D,
                               level,
@@ -281,8 +277,7 @@ void Texture2DGL::updateCompressedSubData(std::size_t xoffset, std::size_t yoffs
 
 void Texture2DGL::apply(int index) const
 {
-    glActiveTexture(GL_TEXTURE0 + index);
-    glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+    StateCacheGL::bindTexture(index, GL_TEXTURE_2D, _textureInfo.texture);
 }
 
 void Texture2DGL::generateMipmaps()
@@ -293,7 +288,7 @@ void Texture2DGL::generateMipmaps()
     if(!_hasMipmaps)
     {
         _hasMipmaps = true;
-        glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
+        StateCacheGL::bindTexture(0, GL_TEXTURE_2D, _textureInfo.texture);
         glGenerateMipmap(GL_TEXTURE_2D);
     }
 }
@@ -356,15 +351,14 @@ TextureCubeGL::TextureCubeGL(const TextureDescriptor& descriptor)
 
 void TextureCubeGL::setTexParameters()
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, _textureInfo.minFilterGL);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, _textureInfo.magFilterGL);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, _textureInfo.sAddressModeGL);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, _textureInfo.tAddressModeGL);
 
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_CUBE_MAP, 0);
 }
 
 void TextureCubeGL::updateTextureDescriptor(const cocos2d::backend::TextureDescriptor &descriptor)
@@ -377,7 +371,7 @@ void TextureCubeGL::updateTextureDescriptor(const cocos2d::backend::TextureDescr
 TextureCubeGL::~TextureCubeGL()
 {
     if(_textureInfo.texture)
-        glDeleteTextures(1, &_textureInfo.texture);
+        StateCacheGL::deleteTexture(_textureInfo.texture);
     _textureInfo.texture = 0;
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -393,15 +387,13 @@ void TextureCubeGL::updateSamplerDescriptor(const SamplerDescriptor &sampler)
 
 void TextureCubeGL::apply(int index) const
 {
-    glActiveTexture(GL_TEXTURE0+ index);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
+    StateCacheGL::bindTexture(index, GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
     CHECK_GL_ERROR_DEBUG();
 }
 
 void TextureCubeGL::updateFaceData(TextureCubeFace side, void *data)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
     CHECK_GL_ERROR_DEBUG();
     int i = static_cast<int>(side);
     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
@@ -415,7 +407,7 @@ void TextureCubeGL::updateFaceData(TextureCubeFace side, void *data)
         data);              // pixel data
 
     CHECK_GL_ERROR_DEBUG();
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    StateCacheGL::bindTexture(0, GL_TEXTURE_CUBE_MAP, 0);
 }
 
 void TextureCubeGL::getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback)
@@ -461,7 +453,7 @@ void TextureCubeGL::generateMipmaps()
     if(!_hasMipmaps)
     {
         _hasMipmaps = true;
-        glBindTexture(GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
+        StateCacheGL::bindTexture(0, GL_TEXTURE_CUBE_MAP, _textureInfo.texture);
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
     }
 }
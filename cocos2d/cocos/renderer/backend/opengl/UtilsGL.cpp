@@ -253,6 +253,13 @@ void UtilsGL::toGLTypes(PixelFormat textureFormat, GLint &internalFormat, GLuint
         format = GL_RGBA;
         type = GL_UNSIGNED_SHORT_5_5_5_1;
         break;
+#ifdef GL_RGBA32F
+    case PixelFormat::RGBA32F:
+        internalFormat = GL_RGBA32F;
+        format = GL_RGBA;
+        type = GL_FLOAT;
+        break;
+#endif // GL_RGBA32F
 #ifdef GL_ETC1_RGB8_OES
     case PixelFormat::ETC:
         internalFormat = GL_ETC1_RGB8_OES;
@@ -70,6 +70,8 @@ extern CC_DLL const char * CC3D_color_frag;
 extern CC_DLL const char * CC3D_colorNormal_frag;
 extern CC_DLL const char * CC3D_colorNormalTexture_frag;
 extern CC_DLL const char * CC3D_colorTexture_frag;
+extern CC_DLL const char * CC3D_instanced_frag;
+extern CC_DLL const char * CC3D_instanced_vert;
 extern CC_DLL const char * CC3D_particleTexture_frag;
 extern CC_DLL const char * CC3D_particleColor_frag;
 extern CC_DLL const char * CC3D_particle_vert;
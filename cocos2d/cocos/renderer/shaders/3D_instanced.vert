@@ -0,0 +1,149 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+
+const char* CC3D_instanced_vert = R"(
+
+#if (MAX_POINT_LIGHT_NUM > 0)
+uniform vec3 u_PointLightSourcePosition[MAX_POINT_LIGHT_NUM];
+#endif
+#if (MAX_SPOT_LIGHT_NUM > 0)
+uniform vec3 u_SpotLightSourcePosition[MAX_SPOT_LIGHT_NUM];
+#endif
+
+attribute vec3 a_position;
+attribute vec3 a_normal;
+attribute vec2 a_texCoord;
+
+// Per-instance attributes: the columns of the model matrix and the color.
+attribute vec4 a_instanceColumn0;
+attribute vec4 a_instanceColumn1;
+attribute vec4 a_instanceColumn2;
+attribute vec4 a_instanceColumn3;
+attribute vec4 a_instanceColor;
+
+#ifdef USE_SKINNING
+attribute vec4 a_blendWeight;
+attribute vec4 a_blendIndex;
+
+// Per-instance row of the palette texture. A row holds the matrix palettes of one instance,
+// 3 texels per bone, each mesh starting at u_paletteColumn.
+attribute float a_instancePalette;
+
+uniform sampler2D u_paletteTexture;
+uniform vec2 u_paletteTexelSize;
+uniform float u_paletteColumn;
+#endif
+
+uniform mat4 u_VPMatrix;
+uniform mat4 u_MeshMatrix;
+
+varying vec2 TextureCoordOut;
+varying vec3 v_normal;
+varying vec4 v_color;
+
+#if MAX_POINT_LIGHT_NUM
+varying vec3 v_vertexToPointLightDirection[MAX_POINT_LIGHT_NUM];
+#endif
+#if MAX_SPOT_LIGHT_NUM
+varying vec3 v_vertexToSpotLightDirection[MAX_SPOT_LIGHT_NUM];
+#endif
+
+#ifdef USE_SKINNING
+void addBone(float boneIndex, float blendWeight, inout vec4 matrixPalette1, inout vec4 matrixPalette2, inout vec4 matrixPalette3)
+{
+    float column = u_paletteColumn + boneIndex * 3.0 + 0.5;
+    float row = (a_instancePalette + 0.5) * u_paletteTexelSize.y;
+    matrixPalette1 += texture2D(u_paletteTexture, vec2(column * u_paletteTexelSize.x, row)) * blendWeight;
+    matrixPalette2 += texture2D(u_paletteTexture, vec2((column + 1.0) * u_paletteTexelSize.x, row)) * blendWeight;
+    matrixPalette3 += texture2D(u_paletteTexture, vec2((column + 2.0) * u_paletteTexelSize.x, row)) * blendWeight;
+}
+
+void getPositionAndNormal(out vec4 position, out vec3 normal)
+{
+    vec4 matrixPalette1 = vec4(0.0);
+    vec4 matrixPalette2 = vec4(0.0);
+    vec4 matrixPalette3 = vec4(0.0);
+
+    addBone(a_blendIndex[0], a_blendWeight[0], matrixPalette1, matrixPalette2, matrixPalette3);
+    if (a_blendWeight[1] > 0.0)
+    {
+        addBone(a_blendIndex[1], a_blendWeight[1], matrixPalette1, matrixPalette2, matrixPalette3);
+        if (a_blendWeight[2] > 0.0)
+        {
+            addBone(a_blendIndex[2], a_blendWeight[2], matrixPalette1, matrixPalette2, matrixPalette3);
+            if (a_blendWeight[3] > 0.0)
+                addBone(a_blendIndex[3], a_blendWeight[3], matrixPalette1, matrixPalette2, matrixPalette3);
+        }
+    }
+
+    vec4 p = vec4(a_position, 1.0);
+    position.x = dot(p, matrixPalette1);
+    position.y = dot(p, matrixPalette2);
+    position.z = dot(p, matrixPalette3);
+    position.w = p.w;
+
+    vec4 n = vec4(a_normal, 0.0);
+    normal.x = dot(n, matrixPalette1);
+    normal.y = dot(n, matrixPalette2);
+    normal.z = dot(n, matrixPalette3);
+}
+#else
+void getPositionAndNormal(out vec4 position, out vec3 normal)
+{
+    position = vec4(a_position, 1.0);
+    normal = a_normal;
+}
+#endif
+
+void main(void)
+{
+    vec4 position;
+    vec3 normal;
+    getPositionAndNormal(position, normal);
+
+    // lights are in world space, as for Sprite3D
+    mat4 modelMatrix = mat4(a_instanceColumn0, a_instanceColumn1, a_instanceColumn2, a_instanceColumn3) * u_MeshMatrix;
+    vec4 worldPosition = modelMatrix * position;
+    gl_Position = u_VPMatrix * worldPosition;
+
+#if MAX_POINT_LIGHT_NUM
+    for (int i = 0; i < MAX_POINT_LIGHT_NUM; ++i)
+    {
+        v_vertexToPointLightDirection[i] = u_PointLightSourcePosition[i] - worldPosition.xyz;
+    }
+#endif
+#if MAX_SPOT_LIGHT_NUM
+    for (int i = 0; i < MAX_SPOT_LIGHT_NUM; ++i)
+    {
+        v_vertexToSpotLightDirection[i] = u_SpotLightSourcePosition[i] - worldPosition.xyz;
+    }
+#endif
+
+    v_normal = (modelMatrix * vec4(normal, 0.0)).xyz;
+    v_color = a_instanceColor;
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+}
+)";
@@ -25,6 +25,16 @@ DetourCrowd/DetourPathQueue.cpp \
 DetourCrowd/DetourProximityGrid.cpp \
 DetourTileCache/DetourTileCache.cpp \
 DetourTileCache/DetourTileCacheBuilder.cpp \
+Recast/Recast.cpp \
+Recast/RecastAlloc.cpp \
+Recast/RecastArea.cpp \
+Recast/RecastContour.cpp \
+Recast/RecastFilter.cpp \
+Recast/RecastLayers.cpp \
+Recast/RecastMesh.cpp \
+Recast/RecastMeshDetail.cpp \
+Recast/RecastRasterization.cpp \
+Recast/RecastRegion.cpp \
 fastlz/fastlz.c
 
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/..
@@ -24,6 +24,7 @@
 
 #include "main.h"
 #include "AppDelegate.h"
+#include "scene_ui/BaseScene.h"
 #include "cocos2d.h"
 
 USING_NS_CC;
@@ -34,7 +35,12 @@ int WINAPI _tWinMain(HINSTANCE hInstance,
                        int       nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
+
+    // offline step: cook collision meshes next to their sources in the resource folder, then exit
+    if (lpCmdLine && _tcsstr(lpCmdLine, _T("--cook-collision")))
+    {
+        return CampScene::cookCollisionMeshes() ? 0 : 1;
+    }
 
     // create the application instance
     AppDelegate app;